@@ -98,6 +98,7 @@
 %ignore qof_session_not_saved;
 %include <qofsession.h>
 
+%newobject qof_book_get_memory_report;
 %include <qofbook.h>
 
 %include <qofid.h>
@@ -216,6 +217,71 @@ static const GncGUID * gncEntryGetGUID(GncEntry *x);
 %include <cap-gains.h>
 %include <Scrub3.h>
 
+// Python wrapper for xaccAccountGetBalancesAtDates: takes a sequence of
+// dates, datetimes or integers and returns a list of
+// ((amount_num, amount_denom), (value_num, value_denom)) tuples in the
+// same order. Account.GetBalancesAtDates turns these into GncNumerics.
+%inline %{
+static PyObject *
+_gnc_account_get_balances_at_dates (Account *acc, PyObject *dates_py)
+{
+    PyObject *seq, *result;
+    Py_ssize_t n_dates, i;
+    time64 *dates;
+    gnc_numeric *amounts, *values;
+
+    PyDateTime_IMPORT;
+
+    seq = PySequence_Fast (dates_py, "a sequence of dates is expected");
+    if (!seq)
+        return NULL;
+    n_dates = PySequence_Fast_GET_SIZE (seq);
+    dates = g_new (time64, n_dates);
+    for (i = 0; i < n_dates; ++i)
+    {
+        PyObject *item = PySequence_Fast_GET_ITEM (seq, i);
+        if (PyDate_Check (item))
+        {
+            struct tm time = {PyDateTime_DATE_GET_SECOND(item),
+                              PyDateTime_DATE_GET_MINUTE(item),
+                              PyDateTime_DATE_GET_HOUR(item),
+                              PyDateTime_GET_DAY(item),
+                              PyDateTime_GET_MONTH(item) - 1,
+                              PyDateTime_GET_YEAR(item) - 1900};
+            dates[i] = gnc_mktime (&time);
+        }
+        else if (PyInt_Check (item))
+            dates[i] = PyInt_AsLong (item);
+        else
+        {
+            g_free (dates);
+            Py_DECREF (seq);
+            PyErr_SetString (PyExc_ValueError,
+                             "date, datetime or integer expected");
+            return NULL;
+        }
+    }
+    Py_DECREF (seq);
+
+    amounts = g_new (gnc_numeric, n_dates);
+    values = g_new (gnc_numeric, n_dates);
+    xaccAccountGetBalancesAtDates (acc, dates, n_dates, amounts, values);
+
+    result = PyList_New (n_dates);
+    for (i = 0; i < n_dates; ++i)
+        PyList_SET_ITEM (result, i,
+                         Py_BuildValue ("((LL)(LL))",
+                                        (long long)amounts[i].num,
+                                        (long long)amounts[i].denom,
+                                        (long long)values[i].num,
+                                        (long long)values[i].denom));
+    g_free (dates);
+    g_free (amounts);
+    g_free (values);
+    return result;
+}
+%}
+
 %init %{
 gnc_environment_setup();
 qof_log_init();
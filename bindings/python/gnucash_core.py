@@ -28,6 +28,8 @@
 #  @author Jeff Green,   ParIT Worker Co-operative <jeff@parit.ca>
 #  @ingroup python_bindings
 
+import json
+
 import gnucash.gnucash_core_c as gnucash_core_c
 
 from gnucash.function_class import \
@@ -172,6 +174,7 @@ class Book(GnuCashCoreClass):
     Methods of interest
     get_root_account -- Returns the root level Account
     get_table -- Returns a commodity lookup table, of type GncCommodityTable
+    get_memory_usage -- Returns the approximate memory used by the book
     """
     def InvoiceLookup(self, guid):
         from gnucash.gnucash_business import Invoice
@@ -198,6 +201,14 @@ class Book(GnuCashCoreClass):
         return self.do_lookup_create_oo_instance(
             gncVendorLookup, Vendor, guid.get_instance() )
 
+    def get_memory_usage(self):
+        """Returns the approximate memory used by the book as a dict.
+
+        'types' maps each type of object in the book to its count, bytes,
+        kvp_slots, kvp_bytes and list_nodes, 'total' adds them up and
+        'string_cache' describes the string cache all books share."""
+        return json.loads(self.get_memory_report())
+
     def EmployeeLookup(self, guid):
         from gnucash.gnucash_business import Employee
         return self.do_lookup_create_oo_instance(
@@ -482,6 +493,23 @@ class Account(GnuCashCoreClass):
     """
     _new_instance = 'xaccMallocAccount'
 
+    def GetBalancesAtDates(self, dates):
+        """Get the balance of the account at each of several dates
+
+        Computed in one pass over the account's splits.
+
+        Args:
+            dates: sequence of dates, datetimes or time64 integers
+
+        Returns:
+            list of tuples (amount, value) of GncNumeric, one per date, in
+            the order of dates. A split is included if its transaction was
+            posted on or before the date."""
+        return [(GncNumeric(*amount), GncNumeric(*value))
+                for amount, value in
+                gnucash_core_c._gnc_account_get_balances_at_dates(
+                    self.instance, dates)]
+
 class GUID(GnuCashCoreClass):
     _new_instance = 'guid_new_return'
 
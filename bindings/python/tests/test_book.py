@@ -13,5 +13,13 @@ class TestBook( BookSession ):
     def test_markclosed(self):
         self.ses.end()
 
+    def test_memory_usage(self):
+        usage = self.book.get_memory_usage()
+        self.assertIn('Commodity', usage['types'])
+        self.assertGreater(usage['types']['Commodity']['count'], 0)
+        self.assertGreaterEqual(usage['total']['bytes'],
+                                usage['types']['Commodity']['bytes'])
+        self.assertGreater(usage['string_cache']['strings'], 0)
+
 if __name__ == '__main__':
     main()
@@ -190,7 +190,10 @@ build_shared_quickfill (QofBook *book, Account *root, const char * key,
     qfb->load_list_store = FALSE;
 
     qfb->listener =
-        qof_event_register_handler (listen_for_account_events, qfb);
+        qof_event_register_type_handler (GNC_ID_ACCOUNT,
+                                         QOF_EVENT_MODIFY | QOF_EVENT_ADD |
+                                         QOF_EVENT_REMOVE,
+                                         listen_for_account_events, qfb);
 
     qof_book_set_data_fin (book, key, qfb, shared_quickfill_destroy);
 
@@ -250,11 +253,6 @@ listen_for_account_events  (QofInstance *entity,  QofEventId event_type,
     GtkTreePath *path;
     GList *tmp;
 
-    if (0 == (event_type & (QOF_EVENT_MODIFY | QOF_EVENT_ADD | QOF_EVENT_REMOVE)))
-        return;
-
-    if (!GNC_IS_ACCOUNT (entity))
-        return;
     account = GNC_ACCOUNT (entity);
 
     ENTER("entity %p, event type %x, user data %p, ecent data %p",
@@ -272,8 +272,10 @@ gnc_tree_model_account_new (Account *root)
     priv->book = gnc_get_current_book();
     priv->root = root;
 
-    priv->event_handler_id = qof_event_register_handler
-                             ((QofEventHandler)gnc_tree_model_account_event_handler, model);
+    priv->event_handler_id = qof_event_register_type_handler
+                             (GNC_ID_ACCOUNT,
+                              QOF_EVENT_ADD | QOF_EVENT_REMOVE | QOF_EVENT_MODIFY,
+                              (QofEventHandler)gnc_tree_model_account_event_handler, model);
 
     LEAVE("model %p", model);
     return GTK_TREE_MODEL (model);
@@ -1264,8 +1266,6 @@ gnc_tree_model_account_event_handler (QofInstance *entity,
     Account *account, *parent;
 
     g_return_if_fail(model);	/* Required */
-    if (!GNC_IS_ACCOUNT(entity))
-        return;
 
     ENTER("entity %p of type %d, model %p, event_data %p",
           entity, event_type, model, ed);
@@ -127,7 +127,7 @@ typedef struct GncTreeModelPricePrivate
 {
     QofBook *book;
     GNCPriceDB *price_db;
-    gint event_handler_id;
+    gint event_handler_ids[3];    /* namespaces, commodities, prices */
     GNCPrintAmountInfo print_info;
 } GncTreeModelPricePrivate;
 
@@ -193,6 +193,7 @@ gnc_tree_model_price_dispose (GObject *object)
 {
     GncTreeModelPrice *model;
     GncTreeModelPricePrivate *priv;
+    guint i;
 
     ENTER("model %p", object);
     g_return_if_fail (object != NULL);
@@ -201,10 +202,13 @@ gnc_tree_model_price_dispose (GObject *object)
     model = GNC_TREE_MODEL_PRICE (object);
     priv = GNC_TREE_MODEL_PRICE_GET_PRIVATE(model);
 
-    if (priv->event_handler_id)
+    for (i = 0; i < G_N_ELEMENTS (priv->event_handler_ids); i++)
     {
-        qof_event_unregister_handler (priv->event_handler_id);
-        priv->event_handler_id = 0;
+        if (priv->event_handler_ids[i])
+        {
+            qof_event_unregister_handler (priv->event_handler_ids[i]);
+            priv->event_handler_ids[i] = 0;
+        }
     }
 
     if (G_OBJECT_CLASS (parent_class)->dispose)
@@ -240,8 +244,19 @@ gnc_tree_model_price_new (QofBook *book, GNCPriceDB *price_db)
     priv->book = book;
     priv->price_db = price_db;
 
-    priv->event_handler_id =
-        qof_event_register_handler (gnc_tree_model_price_event_handler, model);
+    /* The model only shows these three types of entities. */
+    priv->event_handler_ids[0] =
+        qof_event_register_type_handler (GNC_ID_COMMODITY_NAMESPACE, 0,
+                                         gnc_tree_model_price_event_handler,
+                                         model);
+    priv->event_handler_ids[1] =
+        qof_event_register_type_handler (GNC_ID_COMMODITY, 0,
+                                         gnc_tree_model_price_event_handler,
+                                         model);
+    priv->event_handler_ids[2] =
+        qof_event_register_type_handler (GNC_ID_PRICE, 0,
+                                         gnc_tree_model_price_event_handler,
+                                         model);
 
     LEAVE("returning new model %p", model);
     return GTK_TREE_MODEL (model);
@@ -125,7 +125,7 @@ struct GncTreeModelSplitRegPrivate
     GtkListStore *action_list;       // action combo list
     GtkListStore *account_list;      // Account combo list
 
-    gint event_handler_id;
+    gint event_handler_ids[3];          /* splits, transactions, accounts */
 };
 
 
@@ -404,6 +404,7 @@ gnc_tree_model_split_reg_dispose (GObject *object)
 {
     GncTreeModelSplitRegPrivate *priv;
     GncTreeModelSplitReg *model;
+    guint i;
 
     ENTER("model split reg %p", object);
     g_return_if_fail (object != NULL);
@@ -412,10 +413,13 @@ gnc_tree_model_split_reg_dispose (GObject *object)
     model = GNC_TREE_MODEL_SPLIT_REG (object);
     priv = model->priv;
 
-    if (priv->event_handler_id)
+    for (i = 0; i < G_N_ELEMENTS (priv->event_handler_ids); i++)
     {
-        qof_event_unregister_handler (priv->event_handler_id);
-        priv->event_handler_id = 0;
+        if (priv->event_handler_ids[i])
+        {
+            qof_event_unregister_handler (priv->event_handler_ids[i]);
+            priv->event_handler_ids[i] = 0;
+        }
     }
 
     priv->book = NULL;
@@ -497,8 +501,18 @@ gnc_tree_model_split_reg_new (SplitRegisterType2 reg_type, SplitRegisterStyle2 s
     priv->action_list = gtk_list_store_new (1, G_TYPE_STRING);
     priv->account_list = gtk_list_store_new (3, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_POINTER);
 
-    priv->event_handler_id = qof_event_register_handler
-                             ((QofEventHandler)gnc_tree_model_split_reg_event_handler, model);
+    /* Account events of any kind refresh the status bar. */
+    priv->event_handler_ids[0] = qof_event_register_type_handler
+                             (GNC_ID_SPLIT, QOF_EVENT_MODIFY,
+                              (QofEventHandler)gnc_tree_model_split_reg_event_handler, model);
+    priv->event_handler_ids[1] = qof_event_register_type_handler
+                             (GNC_ID_TRANS,
+                              GNC_EVENT_ITEM_ADDED | GNC_EVENT_ITEM_REMOVED |
+                              QOF_EVENT_MODIFY | QOF_EVENT_DESTROY,
+                              (QofEventHandler)gnc_tree_model_split_reg_event_handler, model);
+    priv->event_handler_ids[2] = qof_event_register_type_handler
+                             (GNC_ID_ACCOUNT, 0,
+                              (QofEventHandler)gnc_tree_model_split_reg_event_handler, model);
 
     LEAVE("model %p", model);
     return model;
@@ -95,8 +95,10 @@ static wchar_t     *log_to_filename  = NULL;
 static char        *log_to_filename  = NULL;
 #endif
 static int          nofile           = 0;
+static char        *perf_trace_file  = NULL;
 static const gchar *gsettings_prefix = NULL;
 static const char  *add_quotes_file  = NULL;
+static const char  *memory_report_file = NULL;
 static char        *namespace_regexp = NULL;
 static const char  *file_to_load     = NULL;
 static gchar      **args_remaining   = NULL;
@@ -131,6 +133,14 @@ static GOptionEntry options[] =
         NULL
     },
 
+    {
+        "perf-trace", '\0', 0, G_OPTION_ARG_FILENAME, &perf_trace_file,
+        N_("Record performance counters and a trace of the time spent loading, saving, querying etc. and write them to the given file on exit. The file can be loaded into chrome://tracing."),
+        /* Translators: Argument description for autohelp; see
+           http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
+        N_("FILE")
+    },
+
     {
         "nofile", '\0', 0, G_OPTION_ARG_NONE, &nofile,
         N_("Do not load the last file opened"), NULL
@@ -149,6 +159,13 @@ static GOptionEntry options[] =
            http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
         N_("FILE")
     },
+    {
+        "memory-report", '\0', 0, G_OPTION_ARG_STRING, &memory_report_file,
+        N_("Load the given GnuCash datafile, print an estimate of the memory used by each type of object in it as JSON and exit"),
+        /* Translators: Argument description for autohelp; see
+           http://developer.gnome.org/doc/API/2.0/glib/glib-Commandline-option-parser.html */
+        N_("FILE")
+    },
     {
         "namespace", '\0', 0, G_OPTION_ARG_STRING, &namespace_regexp,
         N_("Regular expression determining which namespace commodities will be retrieved"),
@@ -595,6 +612,36 @@ fail:
     gnc_shutdown(1);
 }
 
+static void
+inner_main_memory_report(void *closure, int argc, char **argv)
+{
+    QofSession *session;
+    gchar *report;
+    int ret = 1;
+
+    gnc_module_load("gnucash/engine", 0);
+    session = qof_session_new();
+    /* The book is only read, never saved, so don't take its lock and
+     * don't fail when it is already open in a running GnuCash. */
+    qof_session_begin(session, memory_report_file, TRUE, FALSE, FALSE);
+    if (qof_session_get_error(session) == ERR_BACKEND_NO_ERR)
+        qof_session_load(session, NULL);
+
+    if (qof_session_get_error(session) == ERR_BACKEND_NO_ERR)
+    {
+        report = qof_book_get_memory_report(qof_session_get_book(session));
+        g_print("%s", report);
+        g_free(report);
+        ret = 0;
+    }
+    else
+        g_warning("Session Error: %s", qof_session_get_error_message(session));
+
+    qof_session_end(session);
+    qof_session_destroy(session);
+    gnc_shutdown(ret);
+}
+
 static char *
 get_file_to_load()
 {
@@ -706,6 +753,9 @@ gnc_log_init()
         g_free(tracefilename);
     }
 
+    if (perf_trace_file != NULL)
+        qof_perf_init(perf_trace_file, TRUE);
+
     // set a reasonable default.
     qof_log_set_default(QOF_LOG_WARNING);
 
@@ -916,6 +966,14 @@ main(int argc, char ** argv)
         exit(0);  /* never reached */
     }
 
+    /* Likewise if only asked for the memory used by a file */
+    if (memory_report_file)
+    {
+        gnc_module_system_init();
+        scm_boot_guile(argc, argv, inner_main_memory_report, 0);
+        exit(0);  /* never reached */
+    }
+
     /* We need to initialize gtk before looking up all modules */
     if(!gtk_init_check (&argc, &argv))
     {
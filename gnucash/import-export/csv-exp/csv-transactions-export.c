@@ -53,331 +53,255 @@ static QofLogModule log_module = GNC_MOD_ASSISTANT;
 
 /*******************************************************************/
 
+/* Lines are gathered in an output buffer which is written to the
+ * file whenever it grows past this size. */
+#define CSV_WRITE_BLOCK_SIZE (256 * 1024)
+
 /*******************************************************
- * write_line_to_file
+ * flush_buffer
  *
- * write a text string to a file pointer, return TRUE if
- * successful.
+ * write the buffered lines to a file pointer and empty
+ * the buffer, return TRUE if successful.
  *******************************************************/
 static
-gboolean write_line_to_file (FILE *fh, char * line)
+gboolean flush_buffer (FILE *fh, GString *buffer)
 {
-    int len, written;
-    DEBUG("Account String: %s", line);
+    size_t written;
 
-    /* Write account line */
-    len = strlen (line);
-    written = fwrite (line, 1, len, fh);
+    if (buffer->len == 0)
+        return TRUE;
 
-    if (written != len)
+    written = fwrite (buffer->str, 1, buffer->len, fh);
+    if (written != buffer->len)
         return FALSE;
-    else
+
+    g_string_truncate (buffer, 0);
+    return TRUE;
+}
+
+/*******************************************************
+ * end_line
+ *
+ * a complete line was added to the buffer, write the
+ * buffer out once it is large enough.
+ *******************************************************/
+static
+gboolean end_line (FILE *fh, GString *buffer)
+{
+    if (buffer->len < CSV_WRITE_BLOCK_SIZE)
         return TRUE;
+    return flush_buffer (fh, buffer);
 }
 
 
 /*******************************************************
- * csv_txn_test_field_string
+ * csv_txn_append_field
  *
- * Test the field string for ," and new lines
+ * Append a field to the line, doubling any " in it and
+ * quoting it if it holds a separator, " or new line,
+ * followed by the field separator.
  *******************************************************/
 static
-gchar *csv_txn_test_field_string (CsvExportInfo *info, const gchar *string_in)
+void csv_txn_append_field (GString *line, const gchar *string_in,
+                           const gchar *sep, CsvExportInfo *info)
 {
-    gboolean need_quote = FALSE;
-    gchar **parts;
-    gchar *string_parts;
-    gchar *string_out;
-
-    /* Check for " and then "" them */
-    parts = g_strsplit (string_in, "\"", -1);
-    string_parts = g_strjoinv ("\"\"", parts);
-    g_strfreev (parts);
-
-    /* Check for separator string and \n and " in field,
-       if so quote field if not already quoted */
-    if (g_strrstr (string_parts, info->separator_str) != NULL)
-        need_quote = TRUE;
-    if (g_strrstr (string_parts, "\n") != NULL)
-        need_quote = TRUE;
-    if (g_strrstr (string_parts, "\"") != NULL)
-        need_quote = TRUE;
+    gboolean has_quote;
+    gboolean need_quote;
+
+    if (!string_in)
+        string_in = "";
+
+    has_quote = (strchr (string_in, '"') != NULL);
+    need_quote = has_quote || (strchr (string_in, '\n') != NULL) ||
+                 (strstr (string_in, info->separator_str) != NULL);
 
     if (!info->use_quotes && need_quote)
-        string_out = g_strconcat ("\"", string_parts, "\"", NULL);
+        g_string_append_c (line, '"');
+
+    if (has_quote)
+    {
+        const gchar *p;
+        for (p = string_in; *p; p++)
+        {
+            if (*p == '"')
+                g_string_append_c (line, '"');
+            g_string_append_c (line, *p);
+        }
+    }
     else
-        string_out = g_strdup (string_parts);
+        g_string_append (line, string_in);
 
-    g_free (string_parts);
-    return string_out;
+    if (!info->use_quotes && need_quote)
+        g_string_append_c (line, '"');
+
+    g_string_append (line, sep);
 }
 
 /******************** Helper functions *********************/
 
 // Transaction Date
-static gchar*
-add_date (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_date (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    gchar *date = qof_print_date (xaccTransGetDate (trans));
-    gchar *result = g_strconcat (so_far, info->end_sep, date, info->mid_sep, NULL);
-    g_free (date);
-    g_free (so_far);
-    return result;
+    char date[MAX_DATE_LENGTH + 1];
+    memset (date, 0, sizeof(date));
+    qof_print_date_buff (date, sizeof(date), xaccTransGetDate (trans));
+    g_string_append (line, info->end_sep);
+    g_string_append (line, date);
+    g_string_append (line, info->mid_sep);
 }
 
 
 // Transaction GUID
-static gchar*
-add_guid (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_guid (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    gchar *result;
-    gchar *guid;
-
-    guid = guid_to_string (xaccTransGetGUID (trans));
-    result = g_strconcat (so_far, guid, info->mid_sep, NULL);
-    g_free (guid);
-    g_free (so_far);
-    return result;
+    gchar guid[GUID_ENCODING_LENGTH + 1];
+
+    guid_to_string_buff (xaccTransGetGUID (trans), guid);
+    g_string_append (line, guid);
+    g_string_append (line, info->mid_sep);
 }
 
 // Reconcile Date
-static gchar*
-add_reconcile_date (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_reconcile_date (GString *line, Split *split, CsvExportInfo *info)
 {
-    gchar *result;
-
     if (xaccSplitGetReconcile (split) == YREC)
     {
         time64 t = xaccSplitGetDateReconciled (split);
         char str_rec_date[MAX_DATE_LENGTH + 1];
         memset (str_rec_date, 0, sizeof(str_rec_date));
         qof_print_date_buff (str_rec_date, sizeof(str_rec_date), t);
-        result = g_strconcat (so_far, str_rec_date, info->mid_sep, NULL);
+        g_string_append (line, str_rec_date);
     }
-    else
-        result = g_strconcat (so_far, info->mid_sep, NULL);
-
-    g_free (so_far);
-    return result;
+    g_string_append (line, info->mid_sep);
 }
 
 // Account Name short or Long
-static gchar*
-add_account_name (gchar *so_far, Split *split, gboolean full, CsvExportInfo *info)
+static void
+add_account_name (GString *line, Split *split, gboolean full, CsvExportInfo *info)
 {
-    gchar       *name = NULL;
-    gchar       *conv;
-    gchar       *result;
+    Account *account = xaccSplitGetAccount (split);
 
-    Account     *account = xaccSplitGetAccount (split);
     if (full)
-        name = gnc_account_get_full_name (account);
+    {
+        gchar *name = gnc_account_get_full_name (account);
+        csv_txn_append_field (line, name, info->mid_sep, info);
+        g_free (name);
+    }
     else
-        name = g_strdup (xaccAccountGetName (account));
-    conv = csv_txn_test_field_string (info, name);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (name);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+        csv_txn_append_field (line, xaccAccountGetName (account), info->mid_sep, info);
 }
 
 // Number
-static gchar*
-add_number (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_number (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *num;
-    gchar       *conv;
-    gchar       *result;
-
-    num = xaccTransGetNum (trans) ? xaccTransGetNum (trans) : "" ;
-    conv = csv_txn_test_field_string (info, num);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, xaccTransGetNum (trans), info->mid_sep, info);
 }
 
 // Description
-static gchar*
-add_description (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_description (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *desc;
-    gchar       *conv;
-    gchar       *result;
-
-    desc = xaccTransGetDescription (trans) ? xaccTransGetDescription (trans) : "" ;
-    conv = csv_txn_test_field_string (info, desc);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, xaccTransGetDescription (trans), info->mid_sep, info);
 }
 
 // Notes
-static gchar*
-add_notes (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_notes (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *notes;
-    gchar       *conv;
-    gchar       *result;
-
-    notes = xaccTransGetNotes (trans) ? xaccTransGetNotes (trans) : "" ;
-    conv = csv_txn_test_field_string (info, notes);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, xaccTransGetNotes (trans), info->mid_sep, info);
 }
 
 // Void reason
-static gchar*
-add_void_reason (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_void_reason (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    gchar       *result;
-
     if (xaccTransGetVoidStatus (trans))
-    {
-        const gchar *void_reason = xaccTransGetVoidReason (trans);
-        gchar *conv = csv_txn_test_field_string (info, void_reason);
-        result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-        g_free (conv);
-    }
+        csv_txn_append_field (line, xaccTransGetVoidReason (trans), info->mid_sep, info);
     else
-        result = g_strconcat (so_far, info->mid_sep, NULL);
-
-    g_free (so_far);
-    return result;
+        g_string_append (line, info->mid_sep);
 }
 
 // Memo
-static gchar*
-add_memo (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_memo (GString *line, Split *split, CsvExportInfo *info)
 {
-    const gchar *memo;
-    gchar       *conv;
-    gchar       *result;
-
-    memo = xaccSplitGetMemo (split) ? xaccSplitGetMemo (split) : "" ;
-    conv = csv_txn_test_field_string (info, memo);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, xaccSplitGetMemo (split), info->mid_sep, info);
 }
 
 // Full Category Path or Not
-static gchar*
-add_category (gchar *so_far, Split *split, gboolean full, CsvExportInfo *info)
+static void
+add_category (GString *line, Split *split, gboolean full, CsvExportInfo *info)
 {
-    gchar       *cat;
-    gchar       *conv;
-    gchar       *result;
-
     if (full)
-        cat = xaccSplitGetCorrAccountFullName (split);
+    {
+        gchar *cat = xaccSplitGetCorrAccountFullName (split);
+        csv_txn_append_field (line, cat, info->mid_sep, info);
+        g_free (cat);
+    }
     else
-        cat = g_strdup(xaccSplitGetCorrAccountName (split));
-
-    conv = csv_txn_test_field_string (info, cat);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (cat);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+        csv_txn_append_field (line, xaccSplitGetCorrAccountName (split), info->mid_sep, info);
 }
 
 // Action
-static gchar*
-add_action (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_action (GString *line, Split *split, CsvExportInfo *info)
 {
-    const gchar *action = xaccSplitGetAction (split);
-    gchar *conv = csv_txn_test_field_string (info, action);
-    gchar *result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, xaccSplitGetAction (split), info->mid_sep, info);
 }
 
 // Reconcile
-static gchar*
-add_reconcile (gchar *so_far, Split *split, CsvExportInfo *info)
+static void
+add_reconcile (GString *line, Split *split, CsvExportInfo *info)
 {
-    const gchar *recon;
-    gchar       *conv;
-    gchar       *result;
-
-    recon = gnc_get_reconcile_str (xaccSplitGetReconcile (split));
-    conv = csv_txn_test_field_string (info, recon);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    const gchar *recon = gnc_get_reconcile_str (xaccSplitGetReconcile (split));
+    csv_txn_append_field (line, recon, info->mid_sep, info);
 }
 
 // Transaction commodity
-static gchar*
-add_commodity (gchar *so_far, Transaction *trans, CsvExportInfo *info)
+static void
+add_commodity (GString *line, Transaction *trans, CsvExportInfo *info)
 {
-    const gchar *comm_m;
-    gchar       *conv;
-    gchar       *result;
-
-    comm_m = gnc_commodity_get_unique_name (xaccTransGetCurrency (trans));
-
-    conv = csv_txn_test_field_string (info, comm_m);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    const gchar *comm_m = gnc_commodity_get_unique_name (xaccTransGetCurrency (trans));
+    csv_txn_append_field (line, comm_m, info->mid_sep, info);
 }
 
 // Amount with Symbol or not
-static gchar*
-add_amount (gchar *so_far, Split *split, gboolean t_void, gboolean symbol, CsvExportInfo *info)
+static void
+add_amount (GString *line, Split *split, gboolean t_void, gboolean symbol, CsvExportInfo *info)
 {
     const gchar *amt;
-    gchar       *conv;
-    gchar       *result;
 
     if (t_void)
         amt = xaccPrintAmount (xaccSplitVoidFormerAmount (split), gnc_split_amount_print_info (split, symbol));
     else
         amt = xaccPrintAmount (xaccSplitGetAmount (split), gnc_split_amount_print_info (split, symbol));
-    conv = csv_txn_test_field_string (info, amt);
-    result = g_strconcat (so_far, conv, info->mid_sep, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, amt, info->mid_sep, info);
 }
 
 // Share Price / Conversion factor
-static gchar*
-add_rate (gchar *so_far, Split *split, gboolean t_void, CsvExportInfo *info)
+static void
+add_rate (GString *line, Split *split, gboolean t_void, CsvExportInfo *info)
 {
     const gchar *amt;
-    gchar       *conv;
-    gchar       *result;
 
     if (t_void)
         amt = xaccPrintAmount (gnc_numeric_zero(), gnc_split_amount_print_info (split, FALSE));
     else
         amt = xaccPrintAmount (xaccSplitGetSharePrice (split), gnc_split_amount_print_info (split, FALSE));
 
-    conv = csv_txn_test_field_string (info, amt);
-    result = g_strconcat (so_far, conv, info->end_sep, EOLSTR, NULL);
-    g_free (conv);
-    g_free (so_far);
-    return result;
+    csv_txn_append_field (line, amt, info->end_sep, info);
+    g_string_append (line, EOLSTR);
 }
 
 // Share Price / Conversion factor
-static gchar*
-add_price (gchar *so_far, Split *split, gboolean t_void, CsvExportInfo *info)
+static void
+add_price (GString *line, Split *split, gboolean t_void, CsvExportInfo *info)
 {
     const gchar *string_amount;
-    gchar       *conv;
-    gchar       *result;
 
     if (t_void)
     {
@@ -388,181 +312,189 @@ add_price (gchar *so_far, Split *split, gboolean t_void, CsvExportInfo *info)
     else
         string_amount = xaccPrintAmount (xaccSplitGetSharePrice (split), gnc_split_amount_print_info (split, FALSE));
 
-    conv = csv_txn_test_field_string (info, string_amount);
-    result = g_strconcat (so_far, conv, info->end_sep, EOLSTR, NULL);
-    g_free (conv);
-    return result;
+    csv_txn_append_field (line, string_amount, info->end_sep, info);
+    g_string_append (line, EOLSTR);
 }
 
 /******************************************************************************/
 
-static gchar*
-make_simple_trans_line (Account *acc, Transaction *trans, Split *split, CsvExportInfo *info)
+static void
+make_simple_trans_line (GString *line, Transaction *trans, Split *split, CsvExportInfo *info)
 {
     gboolean t_void = xaccTransGetVoidStatus (trans);
 
-    gchar *exp_line = g_strdup("");
-    exp_line = add_date (exp_line, trans, info);
-    exp_line = add_account_name (exp_line, split, TRUE, info);
-    exp_line = add_number (exp_line, trans, info);
-    exp_line = add_description (exp_line, trans, info);
-    exp_line = add_category (exp_line, split, TRUE, info);
-    exp_line = add_reconcile (exp_line, split, info);
-    exp_line = add_amount (exp_line, split, t_void, TRUE, info);
-    exp_line = add_amount (exp_line, split, t_void, FALSE, info);
-    exp_line = add_rate (exp_line, split, t_void, info);
-    return exp_line;
+    add_date (line, trans, info);
+    add_account_name (line, split, TRUE, info);
+    add_number (line, trans, info);
+    add_description (line, trans, info);
+    add_category (line, split, TRUE, info);
+    add_reconcile (line, split, info);
+    add_amount (line, split, t_void, TRUE, info);
+    add_amount (line, split, t_void, FALSE, info);
+    add_rate (line, split, t_void, info);
 }
 
-static gchar*
-make_split_part (gchar* exp_line, Split *split, gboolean t_void, CsvExportInfo *info)
+static void
+make_split_part (GString *line, Split *split, gboolean t_void, CsvExportInfo *info)
 {
-    exp_line = add_action (exp_line, split, info);
-    exp_line = add_memo (exp_line, split, info);
-    exp_line = add_account_name (exp_line, split, TRUE, info);
-    exp_line = add_account_name (exp_line, split, FALSE, info);
-    exp_line = add_amount (exp_line, split, t_void, TRUE, info);
-    exp_line = add_amount (exp_line, split, t_void, FALSE, info);
-    exp_line = add_reconcile (exp_line, split, info);
-    exp_line = add_reconcile_date (exp_line, split, info);
-    exp_line = add_price (exp_line, split, t_void, info);
-    return exp_line;
+    add_action (line, split, info);
+    add_memo (line, split, info);
+    add_account_name (line, split, TRUE, info);
+    add_account_name (line, split, FALSE, info);
+    add_amount (line, split, t_void, TRUE, info);
+    add_amount (line, split, t_void, FALSE, info);
+    add_reconcile (line, split, info);
+    add_reconcile_date (line, split, info);
+    add_price (line, split, t_void, info);
 }
 
-static gchar*
-make_complex_trans_line (Account *acc, Transaction *trans, Split *split, CsvExportInfo *info)
+static void
+make_complex_trans_line (GString *line, Transaction *trans, Split *split, CsvExportInfo *info)
 {
-    gchar *exp_line = g_strdup("");
-    exp_line = add_date (exp_line, trans, info);
-    exp_line = add_guid (exp_line, trans, info);
-    exp_line = add_number (exp_line, trans, info);
-    exp_line = add_description (exp_line, trans, info);
-    exp_line = add_notes (exp_line, trans, info);
-    exp_line = add_commodity (exp_line, trans, info);
-    exp_line = add_void_reason (exp_line, trans, info);
-    return make_split_part (exp_line, split, xaccTransGetVoidStatus (trans), info);
+    add_date (line, trans, info);
+    add_guid (line, trans, info);
+    add_number (line, trans, info);
+    add_description (line, trans, info);
+    add_notes (line, trans, info);
+    add_commodity (line, trans, info);
+    add_void_reason (line, trans, info);
+    make_split_part (line, split, xaccTransGetVoidStatus (trans), info);
 }
 
-static gchar*
-make_complex_split_line (Transaction *trans, Split *split, CsvExportInfo *info)
+static void
+make_complex_split_line (GString *line, Transaction *trans, Split *split, CsvExportInfo *info)
 {
+    int i;
+
     /* Pure split lines don't have any transaction information,
      * so start with empty fields for all transaction columns.
      */
-    gchar *result = g_strconcat (info->end_sep, info->mid_sep, info->mid_sep, info->mid_sep,
-            info->mid_sep, info->mid_sep, info->mid_sep, info->mid_sep, NULL);
-    return make_split_part (result, split, xaccTransGetVoidStatus (trans), info);
+    g_string_append (line, info->end_sep);
+    for (i = 0; i < 7; i++)
+        g_string_append (line, info->mid_sep);
+    make_split_part (line, split, xaccTransGetVoidStatus (trans), info);
 }
 
 
 /*******************************************************
- * account_splits
+ * export_split
  *
- * gather the splits / transactions for an account and
- * send them to a file
+ * add the line(s) for a split's transaction to the
+ * output buffer, the complex layout writes each
+ * transaction only once. Return FALSE if writing failed.
  *******************************************************/
 static
-void account_splits (CsvExportInfo *info, Account *acc, FILE *fh )
+gboolean export_split (CsvExportInfo *info, Split *split, FILE *fh, GString *buffer)
 {
-    GSList  *p1, *p2;
-    GList   *splits;
-    QofBook *book;
+    Transaction *trans = xaccSplitGetParent (split);
+    GList       *node;
 
-    // Setup the query for normal transaction export
-    if (info->export_type == XML_EXPORT_TRANS)
+    // Look for blank split
+    if (xaccSplitGetAccount (split) == NULL)
+        return TRUE;
+
+    // This will be a simple layout equivalent to a single line register view.
+    if (info->simple_layout)
     {
-        info->query = qof_query_create_for (GNC_ID_SPLIT);
-        book = gnc_get_current_book();
-        qof_query_set_book (info->query, book);
-
-        /* Sort by transaction date */
-        p1 = g_slist_prepend (NULL, TRANS_DATE_POSTED);
-        p1 = g_slist_prepend (p1, SPLIT_TRANS);
-        p2 = g_slist_prepend (NULL, QUERY_DEFAULT_SORT);
-        qof_query_set_sort_order (info->query, p1, p2, NULL);
-
-        xaccQueryAddSingleAccountMatch (info->query, acc, QOF_QUERY_AND);
-        xaccQueryAddDateMatchTT (info->query, TRUE, info->csvd.start_time, TRUE, info->csvd.end_time, QOF_QUERY_AND);
+        make_simple_trans_line (buffer, trans, split, info);
+        return end_line (fh, buffer);
     }
 
-    /* Run the query */
-    for (splits = qof_query_run (info->query); splits; splits = splits->next)
+    // Skip trans already exported, remember it otherwise
+    if (!g_hash_table_add (info->trans_set, trans))
+        return TRUE;
+
+    // Complex Transaction Line.
+    make_complex_trans_line (buffer, trans, split, info);
+    if (!end_line (fh, buffer))
+        return FALSE;
+
+    /* Loop through the list of splits for the Transaction */
+    for (node = xaccTransGetSplitList (trans); node; node = node->next)
     {
-        Split       *split;
-        Transaction *trans;
-        SplitList   *s_list;
-        GList       *node;
-        Split       *t_split;
-        int          nSplits;
-        int          cnt;
-        gchar       *line;
-
-        split = splits->data;
-        trans = xaccSplitGetParent (split);
-        nSplits = xaccTransCountSplits (trans);
-        s_list = xaccTransGetSplitList (trans);
-
-        // Look for trans already exported in trans_list
-        if (g_list_find (info->trans_list, trans) != NULL)
-            continue;
+        Split *t_split = node->data;
 
-        // Look for blank split
-        if (xaccSplitGetAccount (split) == NULL)
+        // base split is already written on the trans_line
+        if (split == t_split)
             continue;
 
-        // This will be a simple layout equivalent to a single line register view.
-        if (info->simple_layout)
+        // Complex Split Line.
+        make_complex_split_line (buffer, trans, t_split, info);
+        if (!end_line (fh, buffer))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+
+/*******************************************************
+ * account_splits
+ *
+ * gather the splits / transactions for an account and
+ * send them to a file
+ *******************************************************/
+static
+void account_splits (CsvExportInfo *info, Account *acc, FILE *fh, GString *buffer)
+{
+    GList *splits, *node;
+
+    // Normal transaction export, the account's own split list is
+    // already sorted by date so there is no need to query for it.
+    if (info->export_type == XML_EXPORT_TRANS)
+    {
+        for (node = xaccAccountGetSplitList (acc); node; node = node->next)
         {
-            line = make_simple_trans_line (acc, trans, split, info);
+            time64 date = xaccTransGetDate (xaccSplitGetParent (node->data));
 
-            /* Write to file */
-            if (!write_line_to_file (fh, line))
+            if (date < info->csvd.start_time)
+                continue;
+            if (date > info->csvd.end_time)
+                break;
+
+            if (!export_split (info, node->data, fh, buffer))
             {
                 info->failed = TRUE;
                 break;
             }
-            g_free (line);
-            continue;
         }
+        return;
+    }
 
-        // Complex Transaction Line.
-        line = make_complex_trans_line (acc, trans, split, info);
-
-        /* Write to file */
-        if (!write_line_to_file (fh, line))
+    /* Run the register query */
+    splits = qof_query_run (info->query);
+    for (node = splits; node; node = node->next)
+    {
+        if (!export_split (info, node->data, fh, buffer))
         {
             info->failed = TRUE;
             break;
         }
-        g_free (line);
-
-        /* Loop through the list of splits for the Transaction */
-        node = s_list;
-        cnt = 0;
-        while ((cnt < nSplits) && (info->failed == FALSE))
-        {
-            t_split = node->data;
-
-            // base split is already written on the trans_line
-            if (split != t_split)
-            {
-            // Complex Split Line.
-                line = make_complex_split_line (trans, t_split, info);
+    }
+    g_list_free (splits);
+}
 
-                if (!write_line_to_file (fh, line))
-                    info->failed = TRUE;
 
-                g_free (line);
-            }
+/*******************************************************
+ * add_header
+ *
+ * add the header line built from the column titles
+ * to the output buffer
+ *******************************************************/
+static
+void add_header (GString *buffer, const gchar **fields, guint n_fields,
+                 CsvExportInfo *info)
+{
+    guint i;
 
-            cnt++;
-            node = node->next;
-        }
-        info->trans_list = g_list_prepend (info->trans_list, trans); // add trans to trans_list
+    g_string_append (buffer, info->end_sep);
+    for (i = 0; i < n_fields; i++)
+    {
+        if (i > 0)
+            g_string_append (buffer, info->mid_sep);
+        g_string_append (buffer, fields[i]);
     }
-    if (info->export_type == XML_EXPORT_TRANS)
-        qof_query_destroy (info->query);
-    g_list_free (splits);
+    g_string_append (buffer, info->end_sep);
+    g_string_append (buffer, EOLSTR);
 }
 
 
@@ -599,59 +531,57 @@ void csv_transactions_export (CsvExportInfo *info)
     fh = g_fopen (info->file_name, "w" );
     if (fh != NULL)
     {
-        gchar *header;
-        int i;
+        GString *buffer = g_string_sized_new (CSV_WRITE_BLOCK_SIZE + 4096);
 
         /* Header string */
         if (info->simple_layout)
         {
-            header = g_strconcat (info->end_sep,
+            const gchar *fields[] = {
                          /* Translators: The following symbols will build the *
                           * header line of exported CSV files:                */
-                                  _("Date"), info->mid_sep, _("Account Name"),
-                                  info->mid_sep, (num_action ? _("Transaction Number") : _("Number")),
-                                  info->mid_sep, _("Description"), info->mid_sep, _("Full Category Path"),
-                                  info->mid_sep, _("Reconcile"), info->mid_sep, _("Amount With Sym"),
-                                  info->mid_sep, _("Amount Num."), info->mid_sep, _("Rate/Price"),
-                                  info->end_sep, EOLSTR, NULL);
+                                  _("Date"), _("Account Name"),
+                                  (num_action ? _("Transaction Number") : _("Number")),
+                                  _("Description"), _("Full Category Path"),
+                                  _("Reconcile"), _("Amount With Sym"),
+                                  _("Amount Num."), _("Rate/Price") };
+            add_header (buffer, fields, G_N_ELEMENTS (fields), info);
         }
         else
         {
-            header = g_strconcat (info->end_sep, _("Date"), info->mid_sep, _("Transaction ID"),
-                                  info->mid_sep, (num_action ? _("Transaction Number") : _("Number")),
-                                  info->mid_sep, _("Description"), info->mid_sep, _("Notes"),
-                                  info->mid_sep, _("Commodity/Currency"), info->mid_sep, _("Void Reason"),
-                                  info->mid_sep, (num_action ? _("Number/Action") : _("Action")), info->mid_sep, _("Memo"),
-                                  info->mid_sep, _("Full Account Name"), info->mid_sep, _("Account Name"),
-                                  info->mid_sep, _("Amount With Sym"), info->mid_sep, _("Amount Num."),
-                                  info->mid_sep, _("Reconcile"), info->mid_sep, _("Reconcile Date"), info->mid_sep, _("Rate/Price"),
-                                  info->end_sep, EOLSTR, NULL);
+            const gchar *fields[] = { _("Date"), _("Transaction ID"),
+                                      (num_action ? _("Transaction Number") : _("Number")),
+                                      _("Description"), _("Notes"),
+                                      _("Commodity/Currency"), _("Void Reason"),
+                                      (num_action ? _("Number/Action") : _("Action")), _("Memo"),
+                                      _("Full Account Name"), _("Account Name"),
+                                      _("Amount With Sym"), _("Amount Num."),
+                                      _("Reconcile"), _("Reconcile Date"), _("Rate/Price") };
+            add_header (buffer, fields, G_N_ELEMENTS (fields), info);
         }
-        DEBUG("Header String: %s", header);
+        DEBUG("Header String: %s", buffer->str);
 
-        /* Write header line */
-        if (!write_line_to_file (fh, header))
-        {
-            info->failed = TRUE;
-            g_free (header);
-            return;
-        }
-        g_free (header);
+        info->trans_set = g_hash_table_new (NULL, NULL);
 
         if (info->export_type == XML_EXPORT_TRANS)
         {
             /* Go through list of accounts */
-            for (ptr = info->csva.account_list, i = 0; ptr; ptr = g_list_next(ptr), i++)
+            for (ptr = info->csva.account_list; ptr && !info->failed; ptr = g_list_next(ptr))
             {
                 acc = ptr->data;
                 DEBUG("Account being processed is : %s", xaccAccountGetName (acc));
-                account_splits (info, acc, fh);
+                account_splits (info, acc, fh, buffer);
             }
         }
         else
-            account_splits (info, info->account, fh);
+            account_splits (info, info->account, fh, buffer);
 
-        g_list_free (info->trans_list); // free trans_list
+        /* Write what is left in the buffer */
+        if (!info->failed && !flush_buffer (fh, buffer))
+            info->failed = TRUE;
+
+        g_hash_table_destroy (info->trans_set);
+        info->trans_set = NULL;
+        g_string_free (buffer, TRUE);
     }
     else
         info->failed = TRUE;
@@ -659,4 +589,3 @@ void csv_transactions_export (CsvExportInfo *info)
         fclose (fh);
     LEAVE("");
 }
-
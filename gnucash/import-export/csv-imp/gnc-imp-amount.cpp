@@ -0,0 +1,70 @@
+/********************************************************************\
+ * gnc-imp-amount.cpp - helpers shared by the csv importers to      *
+ *                      clean up amounts before parsing them        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+extern "C" {
+#include <glib.h>
+}
+
+#include <algorithm>
+#include "gnc-imp-amount.hpp"
+
+std::string
+strip_currency_symbols (const std::string& str)
+{
+    std::string result;
+    result.reserve (str.size());
+
+    auto pos = str.c_str();
+    auto end = pos + str.size();
+    while (pos < end)
+    {
+        auto byte = static_cast<unsigned char>(*pos);
+        if (byte < 0x80)
+        {
+            if (byte != '$') // The only currency symbol in ascii
+                result.push_back (*pos);
+            ++pos;
+            continue;
+        }
+
+        auto uc = g_utf8_get_char_validated (pos, end - pos);
+        if (uc == (gunichar)-1 || uc == (gunichar)-2)
+        {
+            result.push_back (*pos);
+            ++pos;
+            continue;
+        }
+
+        auto len = g_utf8_skip[byte];
+        if (g_unichar_type (uc) != G_UNICODE_CURRENCY_SYMBOL)
+            result.append (pos, len);
+        pos += len;
+    }
+    return result;
+}
+
+bool
+has_digit (const std::string& str)
+{
+    return std::any_of (str.cbegin(), str.cend(),
+                        [](char c){ return c >= '0' && c <= '9'; });
+}
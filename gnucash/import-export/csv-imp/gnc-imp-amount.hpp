@@ -0,0 +1,43 @@
+/********************************************************************\
+ * gnc-imp-amount.hpp - helpers shared by the csv importers to      *
+ *                      clean up amounts before parsing them        *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/** @file
+     @brief Amount clean-up used by both the transaction and the price
+     csv importers.
+     *
+     gnc-imp-amount.hpp
+ */
+
+#ifndef GNC_IMP_AMOUNT_HPP
+#define GNC_IMP_AMOUNT_HPP
+
+#include <string>
+
+/** Return a copy of str without any currency symbols (unicode category
+ *  Sc). Bytes that aren't valid utf-8 are copied as is.
+ */
+std::string strip_currency_symbols (const std::string& str);
+
+/** Does str contain at least one ascii digit? */
+bool has_digit (const std::string& str);
+
+#endif
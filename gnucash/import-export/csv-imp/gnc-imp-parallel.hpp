@@ -0,0 +1,93 @@
+/********************************************************************\
+ * gnc-imp-parallel.hpp - spread per-line import work over threads  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/** @file
+     @brief Helper to run the per line parsing step of the csv
+     importers on several threads.
+     *
+     gnc-imp-parallel.hpp
+ */
+
+#ifndef GNC_IMP_PARALLEL_HPP
+#define GNC_IMP_PARALLEL_HPP
+
+extern "C" {
+#include <glib.h>
+}
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/** Call func(row) for each row in [0, n_rows), spreading the rows in
+ *  chunks over worker threads. func may only modify data belonging to
+ *  its own row and must not throw. Small inputs are processed on the
+ *  calling thread only.
+ */
+template <typename Func> void
+gnc_imp_parallel_rows (uint32_t n_rows, Func& func)
+{
+    static const uint32_t chunk_size = 1024;
+
+    auto n_chunks = (n_rows + chunk_size - 1) / chunk_size;
+    auto n_threads = std::min<uint32_t> (g_get_num_processors(), n_chunks);
+    if (n_threads <= 1)
+    {
+        for (uint32_t row = 0; row < n_rows; row++)
+            func (row);
+        return;
+    }
+
+    struct Work
+    {
+        Func *func;
+        uint32_t n_rows;
+        std::atomic<uint32_t> next_row;
+    } work;
+    work.func = &func;
+    work.n_rows = n_rows;
+    work.next_row = 0;
+
+    auto worker = [](gpointer data) -> gpointer
+    {
+        auto work = static_cast<Work*>(data);
+        for (;;)
+        {
+            auto start = work->next_row.fetch_add (chunk_size);
+            if (start >= work->n_rows)
+                break;
+            auto end = std::min (start + chunk_size, work->n_rows);
+            for (auto row = start; row < end; row++)
+                (*work->func) (row);
+        }
+        return nullptr;
+    };
+
+    std::vector<GThread*> threads;
+    for (uint32_t i = 1; i < n_threads; i++)
+        threads.push_back (g_thread_new ("csv-import", worker, &work));
+    worker (&work);
+    for (auto thread : threads)
+        g_thread_join (thread);
+}
+
+#endif
@@ -35,8 +35,8 @@ extern "C" {
 }
 
 #include <string>
-#include <boost/regex.hpp>
-#include <boost/regex/icu.hpp>
+#include <algorithm>
+#include "gnc-imp-amount.hpp"
 #include "gnc-imp-props-price.hpp"
 
 G_GNUC_UNUSED static QofLogModule log_module = GNC_MOD_IMPORT;
@@ -60,11 +60,10 @@ std::map<GncPricePropType, const char*> gnc_price_col_type_strs = {
 GncNumeric parse_amount_price (const std::string &str, int currency_format)
 {
     /* If a cell is empty or just spaces return invalid amount */
-    if(!boost::regex_search(str, boost::regex("[0-9]")))
+    if(!has_digit (str))
         throw std::invalid_argument (_("Value doesn't appear to contain a valid number."));
 
-    auto expr = boost::make_u32regex("[[:Sc:]]");
-    std::string str_no_symbols = boost::u32regex_replace(str, expr, "");
+    auto str_no_symbols = strip_currency_symbols (str);
 
     /* Convert based on user chosen currency format */
     gnc_numeric val = gnc_numeric_zero();
@@ -284,7 +283,7 @@ std::string GncImportPrice::verify_essentials (void)
         return std::string();
 }
 
-Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
+GNCPrice* GncImportPrice::create_price (QofBook* book)
 {
     /* Gently refuse to create the price if the basics are not set correctly
      * This should have been tested before calling this function though!
@@ -293,26 +292,12 @@ Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
     if (!check.empty())
     {
         PWARN ("Refusing to create price because essentials not set properly: %s", check.c_str());
-        return FAILED;
+        return nullptr;
     }
 
     auto date = static_cast<time64>(GncDateTime(*m_date, DayPart::neutral));
 
     auto amount = *m_amount;
-    Result ret_val = ADDED;
-
-    GNCPrice *old_price = gnc_pricedb_lookup_day_t64 (pdb, *m_from_commodity,
-                                                      *m_to_currency, date);
-
-    // Should old price be over written
-    if ((old_price != nullptr) && (over == true))
-    {
-        DEBUG("Over write");
-        gnc_pricedb_remove_price (pdb, old_price);
-        gnc_price_unref (old_price);
-        old_price = nullptr;
-        ret_val = REPLACED;
-    }
 
     char date_str [MAX_DATE_LENGTH + 1];
     memset (date_str, 0, sizeof(date_str));
@@ -322,37 +307,23 @@ Result GncImportPrice::create_price (QofBook* book, GNCPriceDB *pdb, bool over)
           gnc_commodity_get_fullname (*m_from_commodity),
           gnc_commodity_get_fullname (*m_to_currency),
           amount.to_string().c_str());
-    // Create the new price
-    if (old_price == nullptr)
-    {
-        DEBUG("Create");
-        GNCPrice *price = gnc_price_create (book);
-        gnc_price_begin_edit (price);
 
-        gnc_price_set_commodity (price, *m_from_commodity);
-        gnc_price_set_currency (price, *m_to_currency);
+    // Create the new price, left open for editing until it's added
+    DEBUG("Create");
+    GNCPrice *price = gnc_price_create (book);
+    gnc_price_begin_edit (price);
 
-        auto amount_conv = amount.convert<RoundType::half_up>(CURRENCY_DENOM);
-        gnc_price_set_value (price, static_cast<gnc_numeric>(amount_conv));
+    gnc_price_set_commodity (price, *m_from_commodity);
+    gnc_price_set_currency (price, *m_to_currency);
 
-        gnc_price_set_time64 (price, date);
-        gnc_price_set_source (price, PRICE_SOURCE_USER_PRICE);
-        gnc_price_set_typestr (price, PRICE_TYPE_LAST);
-        gnc_price_commit_edit (price);
+    auto amount_conv = amount.convert<RoundType::half_up>(CURRENCY_DENOM);
+    gnc_price_set_value (price, static_cast<gnc_numeric>(amount_conv));
 
-        bool perr = gnc_pricedb_add_price (pdb, price);
+    gnc_price_set_time64 (price, date);
+    gnc_price_set_source (price, PRICE_SOURCE_USER_PRICE);
+    gnc_price_set_typestr (price, PRICE_TYPE_LAST);
 
-        gnc_price_unref (price);
-
-        if (perr == false)
-            throw std::invalid_argument (_("Failed to create price from selected columns."));
-    }
-    else
-    {
-        gnc_price_unref (old_price);
-        ret_val = DUPLICATED;
-    }
-    return ret_val;
+    return price;
 }
 
 static std::string gen_err_str (std::map<GncPricePropType, std::string>& errors)
@@ -56,8 +56,6 @@ enum class GncPricePropType {
     PRICE_PROPS = TO_CURRENCY
 };
 
-enum Result { FAILED, ADDED, DUPLICATED, REPLACED };
-
 /** Maps all column types to a string representation.
  *  The actual definition is in gnc-imp-props-price.cpp.
  *  Attention: that definition should be adjusted for any
@@ -93,7 +91,10 @@ public:
     void set_currency_format (int currency_format) { m_currency_format = currency_format ;}
     void reset (GncPricePropType prop_type);
     std::string verify_essentials (void);
-    Result create_price (QofBook* book, GNCPriceDB *pdb, bool over);
+    /** Create a price from the properties set. The price is left open
+     *  for editing, the caller should commit it once it's added to the
+     *  pricedb. Returns nullptr if the essentials aren't set. */
+    GNCPrice* create_price (QofBook* book);
 
     gnc_commodity* get_from_commodity () { if (m_from_commodity) return *m_from_commodity; else return nullptr; }
     void set_from_commodity (gnc_commodity* comm) { if (comm) m_from_commodity = comm; else m_from_commodity = boost::none; }
@@ -39,8 +39,8 @@ extern "C" {
 }
 
 #include <string>
-#include <boost/regex.hpp>
-#include <boost/regex/icu.hpp>
+#include <algorithm>
+#include "gnc-imp-amount.hpp"
 #include "gnc-imp-props-tx.hpp"
 
 G_GNUC_UNUSED static QofLogModule log_module = GNC_MOD_IMPORT;
@@ -107,11 +107,10 @@ GncNumeric parse_amount (const std::string &str, int currency_format)
         return GncNumeric{};
 
     /* Strings otherwise containing not digits will be considered invalid */
-    if(!boost::regex_search(str, boost::regex("[0-9]")))
+    if(!has_digit (str))
         throw std::invalid_argument (_("Value doesn't appear to contain a valid number."));
 
-    auto expr = boost::make_u32regex("[[:Sc:]]");
-    std::string str_no_symbols = boost::u32regex_replace(str, expr, "");
+    auto str_no_symbols = strip_currency_symbols (str);
 
     /* Convert based on user chosen currency format */
     gnc_numeric val = gnc_numeric_zero();
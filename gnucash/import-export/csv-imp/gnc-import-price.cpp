@@ -43,6 +43,7 @@ extern "C" {
 #include "gnc-tokenizer-csv.hpp"
 #include "gnc-tokenizer-fw.hpp"
 #include "gnc-imp-settings-csv-price.hpp"
+#include "gnc-imp-parallel.hpp"
 
 G_GNUC_UNUSED static QofLogModule log_module = GNC_MOD_IMPORT;
 
@@ -545,7 +546,7 @@ static void price_properties_verify_essentials (std::vector<parse_line_t>::itera
         throw std::invalid_argument(error_message);
 }
 
-void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_line)
+GNCPrice* GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_line)
 {
     StrVec line;
     std::string error_message;
@@ -554,7 +555,7 @@ void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_l
     std::tie(line, error_message, price_props, skip_line) = *parsed_line;
 
     if (skip_line)
-        return;
+        return nullptr;
 
     error_message.clear();
 
@@ -597,23 +598,15 @@ void GncPriceImport::create_price (std::vector<parse_line_t>::iterator& parsed_l
     {
         price_properties_verify_essentials (parsed_line);
 
-        QofBook* book = gnc_get_current_book();
-        GNCPriceDB *pdb = gnc_pricedb_get_db (book);
-
-        /* If all went well, add this price to the list. */
-        auto price_created = price_props->create_price (book, pdb, m_over_write);
-        if (price_created == ADDED)
-            m_prices_added++;
-        else if (price_created == DUPLICATED)
-            m_prices_duplicated++;
-        else if (price_created == REPLACED)
-            m_prices_replaced++;
+        /* If all went well, create the price to add to the pricedb. */
+        return price_props->create_price (gnc_get_current_book());
     }
     catch (const std::invalid_argument& e)
     {
         error_message = e.what();
         PINFO("User warning: %s", error_message.c_str());
     }
+    return nullptr;
 }
 
 /** Creates a list of prices from parsed data. The parsed data
@@ -630,11 +623,9 @@ void GncPriceImport::create_prices ()
     if (!verify_result.empty())
         throw std::invalid_argument (verify_result);
 
-    m_prices_added = 0;
-    m_prices_duplicated = 0;
-    m_prices_replaced = 0;
-
     /* Iterate over all parsed lines */
+    GList *prices = nullptr;
+    int n_prices = 0;
     for (auto parsed_lines_it = m_parsed_lines.begin();
             parsed_lines_it != m_parsed_lines.end();
             ++parsed_lines_it)
@@ -644,8 +635,33 @@ void GncPriceImport::create_prices ()
             continue;
 
         /* Should not throw anymore, otherwise verify needs revision */
-        create_price (parsed_lines_it);
+        auto price = create_price (parsed_lines_it);
+        if (price)
+        {
+            prices = g_list_prepend (prices, price);
+            n_prices++;
+        }
     }
+    prices = g_list_reverse (prices);
+
+    /* Merge all prices into the pricedb at once, then commit the ones
+     * that were added. The others were never committed, dropping the
+     * last reference is enough to get rid of them. */
+    guint replaced = 0;
+    auto pdb = gnc_pricedb_get_db (gnc_get_current_book());
+    auto added = gnc_pricedb_add_prices_bulk (pdb, prices,
+                                              m_over_write ? PRICE_BULK_REPLACE : PRICE_BULK_KEEP_OLD,
+                                              &replaced);
+    auto n_added = static_cast<int>(g_list_length (added));
+    for (auto node = added; node; node = g_list_next (node))
+        gnc_price_commit_edit (GNC_PRICE (node->data));
+    g_list_free (added);
+    g_list_free_full (prices, (GDestroyNotify)gnc_price_unref);
+
+    m_prices_added = n_added - static_cast<int>(replaced);
+    m_prices_duplicated = n_prices - n_added;
+    m_prices_replaced = static_cast<int>(replaced);
+
     PINFO("Number of lines is %d, added %d, duplicated %d, replaced %d",
          (int)m_parsed_lines.size(), m_prices_added, m_prices_duplicated, m_prices_replaced);
 }
@@ -707,6 +723,14 @@ void GncPriceImport::update_price_props (uint32_t row, uint32_t col, GncPricePro
     std::get<PL_PREPRICE>(m_parsed_lines[row]) = price_props;
 }
 
+static bool
+is_row_local_prop (GncPricePropType prop_type)
+{
+    return (prop_type == GncPricePropType::NONE) ||
+           (prop_type == GncPricePropType::DATE) ||
+           (prop_type == GncPricePropType::AMOUNT);
+}
+
 void
 GncPriceImport::set_column_type_price (uint32_t position, GncPricePropType type, bool force)
 {
@@ -736,24 +760,22 @@ GncPriceImport::set_column_type_price (uint32_t position, GncPricePropType type,
         to_currency (nullptr);
 
     /* Update the preparsed data */
-    for (auto parsed_lines_it = m_parsed_lines.begin();
-            parsed_lines_it != m_parsed_lines.end();
-            ++parsed_lines_it)
+    auto update_row = [this, position, type, old_type](uint32_t row)
     {
+        auto& parsed_line = m_parsed_lines[row];
+
         /* Reset date and currency formats for each price props object
          * to ensure column updates use the most recent one
          */
-        std::get<PL_PREPRICE>(*parsed_lines_it)->set_date_format (m_settings.m_date_format);
-        std::get<PL_PREPRICE>(*parsed_lines_it)->set_currency_format (m_settings.m_currency_format);
-
-        uint32_t row = parsed_lines_it - m_parsed_lines.begin();
+        std::get<PL_PREPRICE>(parsed_line)->set_date_format (m_settings.m_date_format);
+        std::get<PL_PREPRICE>(parsed_line)->set_currency_format (m_settings.m_currency_format);
 
         /* If the column type actually changed, first reset the property
          * represented by the old column type
          */
         if (old_type != type)
         {
-            auto old_col = std::get<PL_INPUT>(*parsed_lines_it).size(); // Deliberately out of bounds to trigger a reset!
+            auto old_col = std::get<PL_INPUT>(parsed_line).size(); // Deliberately out of bounds to trigger a reset!
             if ((old_type > GncPricePropType::NONE)
                     && (old_type <= GncPricePropType::PRICE_PROPS))
                 update_price_props (row, old_col, old_type);
@@ -764,10 +786,23 @@ GncPriceImport::set_column_type_price (uint32_t position, GncPricePropType type,
             update_price_props (row, position, type);
 
         /* Report errors if there are any */
-        auto price_errors = std::get<PL_PREPRICE>(*parsed_lines_it)->errors();
-        std::get<PL_ERROR>(*parsed_lines_it) =
+        auto price_errors = std::get<PL_PREPRICE>(parsed_line)->errors();
+        std::get<PL_ERROR>(parsed_line) =
                 price_errors +
                 (price_errors.empty() ? std::string() : "\n");
+    };
+
+    /* Dates and amounts only depend on the cell contents, so those rows
+     * can be parsed in parallel. The commodity properties need the engine. */
+    if (is_row_local_prop (old_type) && is_row_local_prop (type))
+    {
+        gnc_localeconv(); // Initialize the cached locale info before the threads need it
+        gnc_imp_parallel_rows (m_parsed_lines.size(), update_row);
+    }
+    else
+    {
+        for (uint32_t row = 0; row < m_parsed_lines.size(); row++)
+            update_row (row);
     }
 }
 
@@ -150,9 +150,10 @@ public:
 private:
     /** A helper function used by create_prices. It will attempt
      *  to convert a single tokenized line into a price using
-     *  the column types the user has set.
+     *  the column types the user has set. The price returned is
+     *  still open for editing.
      */
-    void create_price (std::vector<parse_line_t>::iterator& parsed_line);
+    GNCPrice* create_price (std::vector<parse_line_t>::iterator& parsed_line);
 
     void verify_column_selections (ErrorListPrice& error_msg);
 
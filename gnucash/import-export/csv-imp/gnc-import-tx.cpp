@@ -30,6 +30,8 @@ extern "C" {
 #endif
 
 #include <glib/gi18n.h>
+
+#include "gnc-ui-util.h"
 }
 
 #include <boost/regex.hpp>
@@ -40,6 +42,7 @@ extern "C" {
 #include "gnc-tokenizer-csv.hpp"
 #include "gnc-tokenizer-fw.hpp"
 #include "gnc-imp-settings-csv-tx.hpp"
+#include "gnc-imp-parallel.hpp"
 
 G_GNUC_UNUSED static QofLogModule log_module = GNC_MOD_IMPORT;
 
@@ -813,6 +816,21 @@ void GncTxImport::update_pre_split_props (uint32_t row, uint32_t col, GncTransPr
 }
 
 
+/* Split properties whose value only depends on the cell contents. Other
+ * properties need the engine (accounts) or link lines together (the
+ * transaction properties in multi-split mode), so they can't be parsed
+ * in parallel. */
+static bool
+is_row_local_prop (GncTransPropType prop_type)
+{
+    if (prop_type == GncTransPropType::NONE)
+        return true;
+    return (prop_type > GncTransPropType::TRANS_PROPS) &&
+           (prop_type <= GncTransPropType::SPLIT_PROPS) &&
+           (prop_type != GncTransPropType::ACCOUNT) &&
+           (prop_type != GncTransPropType::TACCOUNT);
+}
+
 void
 GncTxImport::set_column_type (uint32_t position, GncTransPropType type, bool force)
 {
@@ -835,6 +853,20 @@ GncTxImport::set_column_type (uint32_t position, GncTransPropType type, bool for
 
     /* Update the preparsed data */
     m_parent = nullptr;
+    if (is_row_local_prop (old_type) && is_row_local_prop (type))
+    {
+        /* The transaction properties objects can be shared between lines,
+         * so update those on this thread only. */
+        for (auto& parsed_line : m_parsed_lines)
+            std::get<PL_PRETRANS>(parsed_line)->set_date_format (m_settings.m_date_format);
+
+        gnc_localeconv(); // Initialize the cached locale info before the threads need it
+        auto update_row = [this, position, type, old_type](uint32_t row)
+            { update_split_row (row, position, type, old_type); };
+        gnc_imp_parallel_rows (m_parsed_lines.size(), update_row);
+        return;
+    }
+
     for (auto parsed_lines_it = m_parsed_lines.begin();
             parsed_lines_it != m_parsed_lines.end();
             ++parsed_lines_it)
@@ -870,17 +902,40 @@ GncTxImport::set_column_type (uint32_t position, GncTransPropType type, bool for
                 && (type <= GncTransPropType::SPLIT_PROPS))
             update_pre_split_props (row, position, type);
 
-        /* Report errors if there are any */
-        auto trans_errors = std::get<PL_PRETRANS>(*parsed_lines_it)->errors();
-        auto split_errors = std::get<PL_PRESPLIT>(*parsed_lines_it)->errors(m_req_mapped_accts);
-        std::get<PL_ERROR>(*parsed_lines_it) =
-                trans_errors +
-                (trans_errors.empty() && split_errors.empty() ? std::string() : "\n") +
-                split_errors;
-
+        update_row_errors (*parsed_lines_it);
     }
 }
 
+/* A helper function intended to be called only from set_column_type */
+void GncTxImport::update_row_errors (parse_line_t& parsed_line)
+{
+    /* Report errors if there are any */
+    auto trans_errors = std::get<PL_PRETRANS>(parsed_line)->errors();
+    auto split_errors = std::get<PL_PRESPLIT>(parsed_line)->errors(m_req_mapped_accts);
+    std::get<PL_ERROR>(parsed_line) =
+            trans_errors +
+            (trans_errors.empty() && split_errors.empty() ? std::string() : "\n") +
+            split_errors;
+}
+
+/* A helper function intended to be called only from set_column_type.
+ * It only touches the split properties of the given row, which makes it
+ * safe to run for several rows in parallel. */
+void GncTxImport::update_split_row (uint32_t row, uint32_t position,
+                                    GncTransPropType type, GncTransPropType old_type)
+{
+    auto& parsed_line = m_parsed_lines[row];
+    std::get<PL_PRESPLIT>(parsed_line)->set_date_format (m_settings.m_date_format);
+    std::get<PL_PRESPLIT>(parsed_line)->set_currency_format (m_settings.m_currency_format);
+
+    if ((old_type != type) && (old_type != GncTransPropType::NONE))
+        update_pre_split_props (row, std::get<PL_INPUT>(parsed_line).size(), old_type);
+    if (type != GncTransPropType::NONE)
+        update_pre_split_props (row, position, type);
+
+    update_row_errors (parsed_line);
+}
+
 std::vector<GncTransPropType> GncTxImport::column_types ()
 {
     return m_settings.m_column_types;
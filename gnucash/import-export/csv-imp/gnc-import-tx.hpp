@@ -188,6 +188,9 @@ private:
      */
     void update_pre_trans_props (uint32_t row, uint32_t col, GncTransPropType prop_type);
     void update_pre_split_props (uint32_t row, uint32_t col, GncTransPropType prop_type);
+    void update_split_row (uint32_t row, uint32_t position,
+                           GncTransPropType type, GncTransPropType old_type);
+    void update_row_errors (parse_line_t& parsed_line);
 
     struct CsvTranImpSettings; //FIXME do we need this line
     CsvTransImpSettings m_settings;
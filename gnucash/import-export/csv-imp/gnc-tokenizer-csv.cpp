@@ -6,12 +6,10 @@
 #include <string>
 #include <algorithm>    // copy
 #include <iterator>     // ostream_operator
-
-#include <boost/tokenizer.hpp>
-#include <boost/locale.hpp>
-#include <boost/algorithm/string.hpp>
+#include <cstring>
 
 extern "C" {
+    #include <glib.h>
     #include <glib/gi18n.h>
 }
 
@@ -22,91 +20,131 @@ GncCsvTokenizer::set_separators(const std::string& separators)
 }
 
 
-int GncCsvTokenizer::tokenize()
+/* Splits one record into fields, following what boost's
+ * escaped_list_separator did for us before: quotes toggle quoting
+ * wherever they appear, separators inside quotes are literal and \\,
+ * \" and \n are escapes. Backslashes that don't start one of those
+ * escapes are kept as is. A pair of double quotes yields a literal
+ * double quote, unless the pair makes up a complete (empty) field. */
+static void
+split_record (const char *begin, const char *end, const bool *is_sep,
+              StrVec& fields)
 {
-    using Tokenizer = boost::tokenizer< boost::escaped_list_separator<char>>;
+    fields.clear();
+    if (begin == end)
+        return;
+
+    std::string field;
+    bool in_quotes = false;
+    auto pos = begin;
+    while (pos < end)
+    {
+        /* Copy runs of ordinary characters in one go. */
+        auto run = pos;
+        while (run < end && *run != '"' && *run != '\\' &&
+               (in_quotes || !is_sep[static_cast<unsigned char>(*run)]))
+            ++run;
+        field.append (pos, run);
+        pos = run;
+        if (pos == end)
+            break;
+
+        if (*pos == '\\')
+        {
+            auto next = pos + 1;
+            if (next < end && (*next == '"' || *next == '\\' || *next == 'n'))
+            {
+                field.push_back (*next == 'n' ? '\n' : *next);
+                pos += 2;
+            }
+            else
+            {
+                field.push_back ('\\');
+                ++pos;
+            }
+        }
+        else if (*pos == '"')
+        {
+            if (pos + 1 < end && pos[1] == '"')
+            {
+                auto empty_field =
+                    (pos == begin || is_sep[static_cast<unsigned char>(pos[-1])]) &&
+                    (pos + 2 >= end || is_sep[static_cast<unsigned char>(pos[2])]);
+                if (!empty_field)
+                    field.push_back ('"');
+                pos += 2;
+            }
+            else
+            {
+                in_quotes = !in_quotes;
+                ++pos;
+            }
+        }
+        else // unquoted separator
+        {
+            fields.push_back (std::move (field));
+            field.clear();
+            ++pos;
+        }
+    }
+    fields.push_back (std::move (field));
+}
 
-    boost::escaped_list_separator<char> sep("\\", m_sep_str, "\"");
+int GncCsvTokenizer::tokenize()
+{
+    bool is_sep[256] = { false };
+    for (auto c : m_sep_str)
+        is_sep[static_cast<unsigned char>(c)] = true;
 
     StrVec vec;
-    std::string line;
-    std::string buffer;
-
+    std::string line;   // only used for records spanning several lines
     bool inside_quotes(false);
-    size_t last_quote(0);
 
     m_tokenized_contents.clear();
-    std::istringstream in_stream(m_utf8_contents);
 
-    try
+    /* Works on the contents in place; the "\r" of "\r\n" line endings
+     * goes with the trailing whitespace. */
+    auto pos = utf8_data();
+    auto end = pos + utf8_size();
+    while (pos < end)
     {
-        while (std::getline (in_stream, buffer))
+        auto eol = static_cast<const char*>(memchr (pos, '\n', end - pos));
+        if (!eol)
+            eol = end;
+
+        // Trim leading and trailing whitespace
+        auto first = pos, last = eol;
+        pos = (eol == end) ? end : eol + 1;
+        while (first < last && g_ascii_isspace (*first))
+            ++first;
+        while (last > first && g_ascii_isspace (last[-1]))
+            --last;
+
+        // --- deal with line breaks in quoted strings
+        for (auto quote = static_cast<const char*>(memchr (first, '"', last - first));
+             quote;
+             quote = static_cast<const char*>(memchr (quote + 1, '"', last - quote - 1)))
         {
-            // --- deal with line breaks in quoted strings
-            buffer = boost::trim_copy (buffer); // Removes trailing newline and spaces
-            last_quote = buffer.find_first_of('"');
-            while (last_quote != std::string::npos)
-            {
-                if (last_quote == 0) // Test separately because last_quote - 1 would be out of range
-                    inside_quotes = !inside_quotes;
-                else if (buffer[ last_quote - 1 ] != '\\')
-                    inside_quotes = !inside_quotes;
-
-                last_quote = buffer.find_first_of('"',last_quote+1);
-            }
+            if (quote == first || quote[-1] != '\\')
+                inside_quotes = !inside_quotes;
+        }
 
-            line.append(buffer);
-            if (inside_quotes)
+        if (inside_quotes || !line.empty())
+        {
+            line.append (first, last);
+            if (inside_quotes && pos < end)
             {
-                line.append(" ");
+                line.append (" ");
                 continue;
             }
-            // ---
-
-            // Deal with backslashes that are not meant to be escapes
-            // The boost::tokenizer with escaped_list_separator as we use
-            // it would choke on this.
-            auto bs_pos = line.find ('\\');
-            while (bs_pos != std::string::npos)
-            {
-                if ((bs_pos == line.size()) ||                                 // got trailing single backslash
-                    (line.find_first_of ("\"\\n", bs_pos + 1) != bs_pos + 1))  // backslash is not part of known escapes \\, \" or \n
-                    line = line.substr(0, bs_pos) + "\\\\" + line.substr(bs_pos + 1);
-                bs_pos += 2;
-                bs_pos = line.find ('\\', bs_pos);
-            }
-
-            // Deal with repeated " ("") in strings.
-            // This is commonly used as escape mechanism for double quotes in csv files.
-            // However boost just eats them.
-            bs_pos = line.find ("\"\"");
-            while (bs_pos != std::string::npos)
-            {
-                // Only make changes in case the double quotes are part of a larger field
-                // In other words a field which only contains two double quotes represent an
-                // empty field. We don't need to touch those.
-                // The way to determine whether the double quotes represent an empty string
-                // is by checking whether the character in front or after are either
-                // a field separator or the beginning or end of of the string.
-                if (!(((bs_pos == 0) ||                                          // quotes are at start of line
-                       (m_sep_str.find (line[bs_pos-1]) != std::string::npos))    // quotes preceeded by field separator
-                      &&
-                      ((bs_pos + 2 >= line.length()) ||                          // quotes are at end of line
-                       (m_sep_str.find (line[bs_pos+2]) != std::string::npos))))   // quotes followed by field separator
-                    // Only make changes in case the double quotes are not an empty field
-                    line.replace (bs_pos, 2, "\\\"");
-                bs_pos = line.find ("\"\"", bs_pos + 2);
-            }
-
-            Tokenizer tok(line, sep);
-            vec.assign(tok.begin(),tok.end());
-            m_tokenized_contents.push_back(vec);
+            split_record (line.data(), line.data() + line.size(), is_sep, vec);
             line.clear();
         }
-    }
-    catch (boost::escaped_list_error &e)
-    {
-        throw (std::range_error N_("There was an error parsing the file."));
+        else
+            split_record (first, last, is_sep, vec);
+        // ---
+
+        m_tokenized_contents.push_back (std::move (vec));
     }
 
     return 0;
@@ -55,6 +55,11 @@ public:
     ~GncCsvTokenizer() = default;                                 // destructor
 
     void set_separators(const std::string& separators);
+    /** Splits the utf-8 contents into records of fields. Every input
+     *  is accepted, so this never throws: a backslash that doesn't
+     *  start one of the escapes \\, \" or \n is kept as is, and a
+     *  quoted field still open at the end of the contents ends there,
+     *  with the lines it spans joined by spaces. */
     int  tokenize() override;
 
 private:
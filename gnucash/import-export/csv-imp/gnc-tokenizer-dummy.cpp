@@ -16,7 +16,7 @@ int GncDummyTokenizer::tokenize()
     std::string line;
 
     m_tokenized_contents.clear();
-    std::istringstream in_stream(m_utf8_contents);
+    std::istringstream in_stream(utf8_contents());
 
     while (std::getline (in_stream, line))
     {
@@ -4,6 +4,7 @@
 #include <fstream>      // fstream
 #include <vector>
 #include <string>
+#include <cstring>
 #include <algorithm>    // copy
 #include <iterator>     // ostream_operator
 
@@ -115,15 +116,20 @@ void GncFwTokenizer::load_file(const std::string& path)
 {
     GncTokenizer::load_file(path);
 
-    std::string line;
     m_longest_line = 0;
-    std::istringstream in_stream(m_utf8_contents);
-    while (std::getline (in_stream, line))
+    auto pos = utf8_data();
+    auto end = pos + utf8_size();
+    while (pos < end)
     {
-        if (line.size() > m_longest_line)
-            m_longest_line = line.size();
-
-        line.clear();
+        auto eol = static_cast<const char*>(memchr (pos, '\n', end - pos));
+        if (!eol)
+            eol = end;
+        auto length = static_cast<uint32_t>(eol - pos);
+        if (length > 0 && eol[-1] == '\r')
+            --length;
+        if (length > m_longest_line)
+            m_longest_line = length;
+        pos = eol + 1;
     }
 
     if (m_col_vec.empty())
@@ -167,8 +173,8 @@ int GncFwTokenizer::tokenize()
 
     boost::offset_separator sep(m_col_vec.begin(), m_col_vec.end(), false);
 
-    std::wstring wchar_contents = utf_to_utf<wchar_t>(m_utf8_contents.c_str(),
-        m_utf8_contents.c_str() + m_utf8_contents.size());
+    std::wstring wchar_contents = utf_to_utf<wchar_t>(utf8_data(),
+        utf8_data() + utf8_size());
 
     StrVec vec;
     std::wstring line;
@@ -178,6 +184,9 @@ int GncFwTokenizer::tokenize()
 
     while (std::getline (in_stream, line))
     {
+        // The contents may still have "\r\n" line endings
+        if (!line.empty() && line.back() == L'\r')
+            line.pop_back();
         Tokenizer tok(line, sep);
         vec.clear();
         for (auto token : tok)
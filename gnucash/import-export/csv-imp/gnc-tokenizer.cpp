@@ -10,6 +10,7 @@
 #include <algorithm>    // copy
 #include <iterator>     // ostream_operator
 #include <memory>
+#include <cstring>
 
 #include <boost/locale.hpp>
 #include <boost/algorithm/string.hpp>
@@ -46,20 +47,26 @@ GncTokenizer::load_file(const std::string& path)
         return;
 
     m_imp_file_str = path;
-    char *raw_contents;
-    size_t raw_length;
     GError *error = nullptr;
 
-    if (!g_file_get_contents(path.c_str(), &raw_contents, &raw_length, &error))
-      throw std::ifstream::failure(error->message);
+    /* Keep the file mapped; valid utf-8 is tokenized straight from it. */
+    auto mapped = g_mapped_file_new (path.c_str(), FALSE, &error);
+    if (!mapped)
+    {
+        std::string msg (error->message);
+        g_error_free (error);
+        throw std::ifstream::failure(msg);
+    }
+
+    m_mapped_file.reset (mapped, g_mapped_file_unref);
+    m_raw_size = g_mapped_file_get_length (mapped);
+    m_raw_data = m_raw_size > 0 ? g_mapped_file_get_contents (mapped) : "";
+    m_utf8_in_file = false;
+    m_utf8_contents.clear();
 
-    m_raw_contents = raw_contents;
-    g_free(raw_contents);
-    
     // Guess encoding, user can override if needed later on.
     const char *guessed_enc = NULL;
-    guessed_enc = go_guess_encoding (m_raw_contents.c_str(),
-                                     m_raw_contents.length(),
+    guessed_enc = go_guess_encoding (m_raw_data, m_raw_size,
                                      m_enc_str.empty() ? "UTF-8" : m_enc_str.c_str(),
                                      NULL);
     if (guessed_enc)
@@ -75,16 +82,92 @@ GncTokenizer::current_file()
     return m_imp_file_str;
 }
 
+/* Replace "\r\n" and lone "\r" by "\n" in a single pass over str. */
+static void
+normalize_line_endings (std::string& str)
+{
+    auto in = str.find ('\r');
+    if (in == std::string::npos)
+        return;
+
+    auto out = in;
+    for (; in < str.size(); ++in)
+    {
+        if (str[in] == '\r')
+        {
+            str[out++] = '\n';
+            if (in + 1 < str.size() && str[in + 1] == '\n')
+                ++in;
+        }
+        else
+            str[out++] = str[in];
+    }
+    str.resize (out);
+}
+
+/* Whether str has a "\r" that isn't followed by "\n". */
+static bool
+has_lone_cr (const char *str, size_t len)
+{
+    auto end = str + len;
+    for (auto cr = static_cast<const char*>(memchr (str, '\r', len)); cr;
+         cr = static_cast<const char*>(memchr (cr + 1, '\r', end - cr - 1)))
+        if (cr + 1 == end || cr[1] != '\n')
+            return true;
+    return false;
+}
+
 void
 GncTokenizer::encoding(const std::string& encoding)
 {
     m_enc_str = encoding;
-    m_utf8_contents = boost::locale::conv::to_utf<char>(m_raw_contents, m_enc_str);
+
+    // Valid utf-8 input needs no conversion and is used in place.
+    auto is_utf8 = (g_ascii_strcasecmp (m_enc_str.c_str(), "UTF-8") == 0 ||
+                    g_ascii_strcasecmp (m_enc_str.c_str(), "UTF8") == 0);
+    auto valid_utf8 = is_utf8 && m_raw_data &&
+                      g_utf8_validate (m_raw_data, m_raw_size, nullptr);
+    m_utf8_in_file = valid_utf8 && !has_lone_cr (m_raw_data, m_raw_size);
+    if (m_utf8_in_file)
+    {
+        m_utf8_contents.clear();
+        return;
+    }
+
+    if (!m_raw_data)
+        m_utf8_contents.clear();
+    else if (valid_utf8)
+        m_utf8_contents.assign (m_raw_data, m_raw_size);
+    else
+        m_utf8_contents = boost::locale::conv::to_utf<char>(m_raw_data,
+                                                            m_raw_data + m_raw_size,
+                                                            m_enc_str);
 
     // While we are converting here, let's also normalize line-endings to "\n"
     // That's what STL expects by default
-    boost::replace_all (m_utf8_contents, "\r\n", "\n");
-    boost::replace_all (m_utf8_contents, "\r", "\n");
+    normalize_line_endings (m_utf8_contents);
+}
+
+const char*
+GncTokenizer::utf8_data() const
+{
+    return m_utf8_in_file ? m_raw_data : m_utf8_contents.data();
+}
+
+size_t
+GncTokenizer::utf8_size() const
+{
+    return m_utf8_in_file ? m_raw_size : m_utf8_contents.size();
+}
+
+std::string
+GncTokenizer::utf8_contents() const
+{
+    if (!m_utf8_in_file)
+        return m_utf8_contents;
+    std::string contents (m_raw_data, m_raw_size);
+    normalize_line_endings (contents);
+    return contents;
 }
 
 const std::string&
@@ -37,6 +37,7 @@
 
 extern "C" {
 #include <config.h>
+#include <glib.h>
 }
 
 #include <iostream>
@@ -75,12 +76,24 @@ public:
     const std::vector<StrVec>& get_tokens();
 
 protected:
+    /** The utf-8 contents. Valid utf-8 files without lone "\r" line
+     *  endings are used in place, straight from the mapped file, and
+     *  may still have "\r\n" line endings. Anything else is converted
+     *  into m_utf8_contents with "\n" line endings. */
+    const char* utf8_data() const;
+    size_t utf8_size() const;
+    /** A copy of the utf-8 contents with "\n" line endings only. */
+    std::string utf8_contents() const;
+
     std::string m_utf8_contents;
     std::vector<StrVec> m_tokenized_contents;
 
 private:
     std::string m_imp_file_str;
-    std::string m_raw_contents;
+    std::shared_ptr<GMappedFile> m_mapped_file;
+    const char *m_raw_data = nullptr;
+    size_t m_raw_size = 0;
+    bool m_utf8_in_file = false;
     std::string m_enc_str;
 };
 
@@ -34,6 +34,11 @@
 
 #include <string>
 #include <stdlib.h>     /* getenv */
+#include <unistd.h>     /* write, close */
+
+extern "C" {
+#include <glib/gstdio.h>
+}
 
 
 typedef struct
@@ -63,10 +68,13 @@ public:
     std::string get_filepath(const std::string& filename);
 
 protected:
-    std::string& get_utf8_contents(std::unique_ptr<GncTokenizer> &tokenizer)
-    { return tokenizer->m_utf8_contents; }
+    std::string get_utf8_contents(std::unique_ptr<GncTokenizer> &tokenizer)
+    { return tokenizer->utf8_contents(); }
     void set_utf8_contents(std::unique_ptr<GncTokenizer> &tokenizer, const std::string& newcontents)
-    { tokenizer->m_utf8_contents = newcontents; }
+    {
+        tokenizer->m_utf8_in_file = false;
+        tokenizer->m_utf8_contents = newcontents;
+    }
     void test_gnc_tokenize_helper (const std::string& separators, tokenize_csv_test_data* test_data); // for csv tokenizer
     void test_gnc_tokenize_helper (tokenize_fw_test_data* test_data); // for csv tokenizer
 
@@ -129,6 +137,39 @@ TEST_F (GncTokenizerTest, tokenize_from_csv_file)
     EXPECT_EQ(std::string("1,100.00"), tokens.at(1).at(6));
 }
 
+/* Valid utf-8 is tokenized in place from the mapped file, "\r\n" line
+ * endings and all, and must give what the converted contents give. */
+TEST_F (GncTokenizerTest, tokenize_crlf_in_place)
+{
+    GError *error = nullptr;
+    gchar *path = nullptr;
+    auto fd = g_file_open_tmp ("test-tokenizer-XXXXXX.csv", &path, &error);
+    ASSERT_NE(-1, fd);
+    const char contents[] = "a,\"b\r\nc\",d \r\n\r\ne,\"f\"\"\"\r\n";
+    ASSERT_EQ(static_cast<ssize_t>(sizeof contents - 1),
+              write (fd, contents, sizeof contents - 1));
+    close (fd);
+
+    csv_tok->load_file (path);
+    EXPECT_EQ(std::string("a,\"b\nc\",d \n\ne,\"f\"\"\"\n"),
+              get_utf8_contents (csv_tok));
+    csv_tok->tokenize();
+    auto tokens = csv_tok->get_tokens();
+    ASSERT_EQ(3ul, tokens.size());
+    EXPECT_EQ((StrVec {"a", "b c", "d"}), tokens[0]);
+    EXPECT_TRUE(tokens[1].empty());
+    EXPECT_EQ((StrVec {"e", "f\""}), tokens[2]);
+
+    fw_tok->load_file (path);
+    fw_tok->tokenize();
+    for (auto const& line : fw_tok->get_tokens())
+        for (auto const& field : line)
+            EXPECT_EQ(std::string::npos, field.find ('\r'));
+
+    g_remove (path);
+    g_free (path);
+}
+
 /* Test parsing for several different prepared strings
  * These tests bypass file loading, rather taking a
  * prepared set of strings as input. This makes it
@@ -198,6 +239,51 @@ TEST_F (GncTokenizerTest, tokenize_semicolon_sep)
     test_gnc_tokenize_helper (";", semicolon_separated);
 }
 
+TEST_F (GncTokenizerTest, tokenize_multi_line)
+{
+    GncCsvTokenizer *csvtok = dynamic_cast<GncCsvTokenizer*>(csv_tok.get());
+    csvtok->set_separators (",");
+
+    /* A quoted field spanning lines is joined with a space, empty lines
+     * yield empty rows. */
+    set_utf8_contents (csv_tok, "a,\"b\nc\",d\n\n  e,\"f\"\"\"\n");
+    csv_tok->tokenize();
+    auto tokens = csv_tok->get_tokens();
+    ASSERT_EQ(3ul, tokens.size());
+    EXPECT_EQ(StrVec({"a", "b c", "d"}), tokens[0]);
+    EXPECT_EQ(0ul, tokens[1].size());
+    EXPECT_EQ(StrVec({"e", "f\""}), tokens[2]);
+}
+
+TEST_F (GncTokenizerTest, tokenize_unterminated_quote)
+{
+    GncCsvTokenizer *csvtok = dynamic_cast<GncCsvTokenizer*>(csv_tok.get());
+    csvtok->set_separators (",");
+
+    /* A quoted field left open at the end of the file keeps the lines
+     * it spans instead of dropping the last record. */
+    set_utf8_contents (csv_tok, "a,b\nc,\"d\ne");
+    csv_tok->tokenize();
+    auto tokens = csv_tok->get_tokens();
+    ASSERT_EQ(2ul, tokens.size());
+    EXPECT_EQ(StrVec({"a", "b"}), tokens[0]);
+    EXPECT_EQ(StrVec({"c", "d e"}), tokens[1]);
+}
+
+TEST_F (GncTokenizerTest, tokenize_never_throws)
+{
+    GncCsvTokenizer *csvtok = dynamic_cast<GncCsvTokenizer*>(csv_tok.get());
+    csvtok->set_separators (",");
+
+    /* Stray and trailing backslashes are kept as literal characters. */
+    set_utf8_contents (csv_tok, "a\\x,b\\\nc,d\\\n");
+    EXPECT_NO_THROW(csv_tok->tokenize());
+    auto tokens = csv_tok->get_tokens();
+    ASSERT_EQ(2ul, tokens.size());
+    EXPECT_EQ(StrVec({"a\\x", "b\\"}), tokens[0]);
+    EXPECT_EQ(StrVec({"c", "d\\"}), tokens[1]);
+}
+
 
 
 void
@@ -37,8 +37,8 @@
 
 #include "import-backend.h"
 #include "import-utilities.h"
+#include "import-match-index.h"
 #include "Account.h"
-#include "Query.h"
 #include "gnc-engine.h"
 #include "engine-helpers.h"
 #include "gnc-prefs.h"
@@ -809,55 +809,33 @@ void gnc_import_find_split_matches(GNCImportTransInfo *trans_info,
                                    double fuzzy_amount_difference,
                                    gint match_date_hardlimit)
 {
-    GList * list_element;
-    Query *query = qof_query_create_for(GNC_ID_SPLIT);
+    GList *list_element, *splits;
+    Account *importaccount;
+    time64 download_time;
     g_assert (trans_info);
 
-    /* Get list of splits of the originating account. */
-    {
-        /* We used to traverse *all* splits of the account by using
-           xaccAccountGetSplitList, which is a bad idea because 90% of these
-           splits are outside the date range that is interesting. We should
-           rather use a query according to the date region, which is
-           implemented here.
-        */
-        Account *importaccount =
-            xaccSplitGetAccount (gnc_import_TransInfo_get_fsplit (trans_info));
-        time64 download_time = xaccTransGetDate (gnc_import_TransInfo_get_trans (trans_info));
-
-        qof_query_set_book (query, gnc_get_current_book());
-        xaccQueryAddSingleAccountMatch (query, importaccount,
-                                        QOF_QUERY_AND);
-        xaccQueryAddDateMatchTT (query,
-                                 TRUE, download_time - match_date_hardlimit * 86400,
-                                 TRUE, download_time + match_date_hardlimit * 86400,
-                                 QOF_QUERY_AND);
-        list_element = qof_query_run (query);
-        /* Sigh. Doesn't help too much. We still create and run one query
-           for each imported transaction. Maybe it would improve
-           performance further if there is one single (master-)query at
-           the beginning, matching the full date range and all accounts in
-           question. However, this doesn't quite work because this function
-           here is called from each gnc_gen_trans_list_add_trans(), which
-           is called one at a time. Therefore the whole importer would
-           have to change its behaviour: Accept the imported txns via
-           gnc_gen_trans_list_add_trans(), and only when
-           gnc_gen_trans_list_run() is called, then calculate all the
-           different match candidates. That's too much work for now.
-        */
-    }
-
-    /* Traverse that list, calling split_find_match on each one. Note
-       that xaccAccountForEachSplit is declared in Account.h but
-       implemented nowhere :-( */
-    while (list_element != NULL)
+    /* Get list of splits of the originating account within the date
+       limit. These used to come from a query per downloaded transaction,
+       which had to look at every split of the book; the match index
+       keeps each account's splits sorted by date between imports. */
+    importaccount =
+        xaccSplitGetAccount (gnc_import_TransInfo_get_fsplit (trans_info));
+    download_time = xaccTransGetDate (gnc_import_TransInfo_get_trans (trans_info));
+    splits = gnc_import_match_index_get_splits
+             (gnc_import_match_index_get (gnc_get_current_book()),
+              importaccount,
+              download_time - match_date_hardlimit * 86400,
+              download_time + match_date_hardlimit * 86400);
+
+    /* Traverse that list, calling split_find_match on each one. */
+    for (list_element = splits; list_element != NULL;
+         list_element = g_list_next (list_element))
     {
         split_find_match (trans_info, list_element->data,
                           process_threshold, fuzzy_amount_difference);
-        list_element = g_list_next (list_element);
     }
 
-    qof_query_destroy (query);
+    g_list_free (splits);
 }
 
 
@@ -1082,49 +1060,6 @@ gnc_import_process_trans_item (GncImportMatchMap *matchmap,
     return FALSE;
 }
 
-/********************************************************************\
- * check_trans_online_id() Callback function used by
- * gnc_import_exists_online_id.  Takes pointers to transaction and split,
- * returns 0 if their online_ids  do NOT match, or if the split
- * belongs to the transaction
-\********************************************************************/
-static gint check_trans_online_id(Transaction *trans1, void *user_data)
-{
-    Account *account;
-    Split *split1;
-    Split *split2 = user_data;
-    const gchar *online_id1;
-    const gchar *online_id2;
-
-    account = xaccSplitGetAccount(split2);
-    split1 = xaccTransFindSplitByAccount(trans1, account);
-    if (split1 == split2)
-        return 0;
-
-    /* hack - we really want to iterate over the _splits_ of the account
-       instead of the transactions */
-    g_assert(split1 != NULL);
-
-    if (gnc_import_split_has_online_id(split1))
-        online_id1 = gnc_import_get_split_online_id(split1);
-    else
-        online_id1 = gnc_import_get_trans_online_id(trans1);
-
-    online_id2 = gnc_import_get_split_online_id(split2);
-
-    if ((online_id1 == NULL) ||
-            (online_id2 == NULL) ||
-            (strcmp(online_id1, online_id2) != 0))
-    {
-        return 0;
-    }
-    else
-    {
-        /*printf("test_trans_online_id(): Duplicate found\n");*/
-        return 1;
-    }
-}
-
 /** Checks whether the given transaction's online_id already exists in
   its parent account. */
 gboolean gnc_import_exists_online_id (Transaction *trans)
@@ -1132,6 +1067,7 @@ gboolean gnc_import_exists_online_id (Transaction *trans)
     gboolean online_id_exists = FALSE;
     Account *dest_acct;
     Split *source_split;
+    gchar *online_id;
 
     /* Look for an online_id in the first split */
     source_split = xaccTransGetSplit(trans, 0);
@@ -1139,9 +1075,11 @@ gboolean gnc_import_exists_online_id (Transaction *trans)
 
     /* DEBUG("%s%d%s","Checking split ",i," for duplicates"); */
     dest_acct = xaccSplitGetAccount(source_split);
-    online_id_exists = xaccAccountForEachTransaction(dest_acct,
-                       check_trans_online_id,
-                       source_split);
+    online_id = (gchar*) gnc_import_get_split_online_id(source_split);
+    online_id_exists = gnc_import_match_index_has_online_id
+                       (gnc_import_match_index_get (xaccTransGetBook (trans)),
+                        dest_acct, online_id, source_split);
+    g_free (online_id);
 
     /* If it does, abort the process for this transaction, since it is
        already in the system. */
@@ -195,6 +195,7 @@ on_matcher_ok_clicked (GtkButton *button, GNCImportMainMatcher *info)
     /* Don't run any queries and/or split sorts while processing the matcher
     results. */
     gnc_suspend_gui_refresh();
+    qof_book_begin_bulk_edit (gnc_get_current_book ());
 
     do
     {
@@ -214,6 +215,7 @@ on_matcher_ok_clicked (GtkButton *button, GNCImportMainMatcher *info)
     while (gtk_tree_model_iter_next (model, &iter));
 
     /* Allow GUI refresh again. */
+    qof_book_end_bulk_edit (gnc_get_current_book ());
     gnc_resume_gui_refresh();
 
     gnc_gen_trans_list_delete (info);
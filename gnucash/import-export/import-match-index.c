@@ -0,0 +1,402 @@
+/********************************************************************\
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+/** @addtogroup Import_Export
+    @{ */
+/** @internal
+    @file import-match-index.c
+    @brief Per book index of the splits the importers match against.
+*/
+
+#include <config.h>
+#include <glib.h>
+#include <string.h>
+
+#include "import-match-index.h"
+#include "import-utilities.h"
+#include "gnc-engine.h"
+#include "gnc-event.h"
+#include "Split.h"
+#include "Transaction.h"
+
+#define MATCH_INDEX_KEY "gnc-import-match-index"
+
+static QofLogModule log_module = GNC_MOD_IMPORT;
+
+typedef struct
+{
+    time64 date;
+    Split *split;
+} IndexEntry;
+
+typedef struct
+{
+    time64 date;              /* date the split is filed under */
+    gchar *online_id;         /* online_id it is counted under */
+} SplitInfo;
+
+typedef struct
+{
+    GArray *entries;          /* IndexEntry, sorted by date */
+    GHashTable *online_ids;   /* online_id -> number of splits carrying it */
+    GHashTable *splits;       /* Split -> SplitInfo */
+    guint generation;         /* account's splits generation it matches */
+} AccountIndex;
+
+struct _GncImportMatchIndex
+{
+    QofBook *book;
+    GHashTable *accounts;     /* Account -> AccountIndex */
+    gint handler_id;
+};
+
+/* The online_id the duplicate check compares against: the split's own
+ * one if it has any, else its transaction's. Returns a new string. */
+static gchar *
+split_online_id (Split *split)
+{
+    Transaction *trans = xaccSplitGetParent (split);
+    gchar *id = (gchar*) gnc_import_get_split_online_id (split);
+
+    if ((id == NULL || *id == '\0') && trans)
+    {
+        g_free (id);
+        id = (gchar*) gnc_import_get_trans_online_id (trans);
+    }
+    if (id && *id == '\0')
+    {
+        g_free (id);
+        id = NULL;
+    }
+    return id;
+}
+
+static time64
+split_date (Split *split)
+{
+    Transaction *trans = xaccSplitGetParent (split);
+    return trans ? xaccTransGetDate (trans) : 0;
+}
+
+/* Index of the first entry posted at or after date */
+static guint
+lower_bound (GArray *entries, time64 date)
+{
+    guint lo = 0, hi = entries->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        if (g_array_index (entries, IndexEntry, mid).date < date)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/* Index of the first entry posted after date */
+static guint
+upper_bound (GArray *entries, time64 date)
+{
+    guint lo = 0, hi = entries->len;
+
+    while (lo < hi)
+    {
+        guint mid = lo + (hi - lo) / 2;
+        if (g_array_index (entries, IndexEntry, mid).date <= date)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static gint
+compare_entries (gconstpointer a, gconstpointer b)
+{
+    const IndexEntry *ea = a, *eb = b;
+
+    if (ea->date != eb->date)
+        return (ea->date > eb->date) - (ea->date < eb->date);
+    return xaccSplitOrder (ea->split, eb->split);
+}
+
+static void
+split_info_free (gpointer data)
+{
+    SplitInfo *info = data;
+
+    g_free (info->online_id);
+    g_free (info);
+}
+
+/* Record split as filed under date and count its online_id */
+static void
+add_split_info (AccountIndex *aidx, Split *split, time64 date)
+{
+    SplitInfo *info = g_new0 (SplitInfo, 1);
+
+    info->date = date;
+    info->online_id = split_online_id (split);
+    if (info->online_id)
+    {
+        guint count = GPOINTER_TO_UINT (g_hash_table_lookup (aidx->online_ids,
+                                                             info->online_id));
+        g_hash_table_insert (aidx->online_ids, g_strdup (info->online_id),
+                             GUINT_TO_POINTER (count + 1));
+    }
+    g_hash_table_insert (aidx->splits, split, info);
+}
+
+static void index_remove_split (AccountIndex *aidx, Split *split);
+
+/* File split under its current date, moving it if it was already there */
+static void
+index_add_split (AccountIndex *aidx, Split *split)
+{
+    IndexEntry entry = { split_date (split), split };
+
+    index_remove_split (aidx, split);
+    g_array_insert_val (aidx->entries, upper_bound (aidx->entries, entry.date),
+                        entry);
+    add_split_info (aidx, split, entry.date);
+}
+
+static void
+index_remove_split (AccountIndex *aidx, Split *split)
+{
+    SplitInfo *info = g_hash_table_lookup (aidx->splits, split);
+    guint i;
+
+    if (!info) return;
+
+    /* Look for the split among those filed under the same date */
+    for (i = lower_bound (aidx->entries, info->date); i < aidx->entries->len; i++)
+    {
+        IndexEntry *entry = &g_array_index (aidx->entries, IndexEntry, i);
+        if (entry->date != info->date)
+            break;
+        if (entry->split == split)
+        {
+            g_array_remove_index (aidx->entries, i);
+            break;
+        }
+    }
+
+    if (info->online_id)
+    {
+        guint count = GPOINTER_TO_UINT (g_hash_table_lookup (aidx->online_ids,
+                                                             info->online_id));
+        if (count > 1)
+            g_hash_table_insert (aidx->online_ids, g_strdup (info->online_id),
+                                 GUINT_TO_POINTER (count - 1));
+        else
+            g_hash_table_remove (aidx->online_ids, info->online_id);
+    }
+    g_hash_table_remove (aidx->splits, split);
+}
+
+static void
+account_index_free (gpointer data)
+{
+    AccountIndex *aidx = data;
+
+    g_array_free (aidx->entries, TRUE);
+    g_hash_table_destroy (aidx->online_ids);
+    g_hash_table_destroy (aidx->splits);
+    g_free (aidx);
+}
+
+static AccountIndex *
+account_index_build (Account *account)
+{
+    AccountIndex *aidx = g_new0 (AccountIndex, 1);
+    GList *node;
+
+    aidx->entries = g_array_new (FALSE, FALSE, sizeof (IndexEntry));
+    aidx->online_ids = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                              g_free, NULL);
+    aidx->splits = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                          NULL, split_info_free);
+
+    aidx->generation = gnc_account_get_splits_generation (account);
+    for (node = xaccAccountGetSplitList (account); node; node = node->next)
+    {
+        IndexEntry entry = { split_date (node->data), node->data };
+        g_array_append_val (aidx->entries, entry);
+        add_split_info (aidx, node->data, entry.date);
+    }
+    g_array_sort (aidx->entries, compare_entries);
+    return aidx;
+}
+
+static AccountIndex *
+account_index_lookup (GncImportMatchIndex *index, Account *account)
+{
+    AccountIndex *aidx = g_hash_table_lookup (index->accounts, account);
+
+    /* Splits added or removed while events were suspended, e.g. by
+       reversing a transaction, leave the index behind the account. */
+    if (aidx &&
+        aidx->generation != gnc_account_get_splits_generation (account))
+    {
+        DEBUG ("index of %s out of date, rebuilding",
+               xaccAccountGetName (account));
+        g_hash_table_remove (index->accounts, account);
+        aidx = NULL;
+    }
+
+    if (!aidx)
+    {
+        aidx = account_index_build (account);
+        g_hash_table_insert (index->accounts, account, aidx);
+    }
+    return aidx;
+}
+
+static void
+match_index_event_handler (QofInstance *ent, QofEventId event_type,
+                           gpointer user_data, gpointer event_data)
+{
+    GncImportMatchIndex *index = user_data;
+    AccountIndex *aidx;
+    Split *split = event_data;
+
+    if (qof_instance_get_book (ent) != index->book)
+        return;
+    if (qof_book_shutting_down (index->book))
+        return;
+
+    /* Accounts nobody has looked up yet are indexed when they are. */
+    aidx = g_hash_table_lookup (index->accounts, ent);
+    if (!aidx)
+        return;
+
+    /* Each insert or remove bumps the account's generation once and
+       sends one event. An event held back by a batch may arrive after
+       the index was rebuilt and already includes its change. */
+    if ((event_type & (GNC_EVENT_ITEM_ADDED | GNC_EVENT_ITEM_REMOVED)) &&
+        aidx->generation != gnc_account_get_splits_generation (GNC_ACCOUNT (ent)))
+        aidx->generation++;
+
+    switch (event_type)
+    {
+    case GNC_EVENT_ITEM_ADDED:
+    case GNC_EVENT_ITEM_CHANGED:
+        /* ITEM_CHANGED is sent once the transaction is committed; its
+           date and online_id may both have changed since. */
+        index_add_split (aidx, split);
+        break;
+    case GNC_EVENT_ITEM_REMOVED:
+        index_remove_split (aidx, split);
+        break;
+    case QOF_EVENT_DESTROY:
+        g_hash_table_remove (index->accounts, ent);
+        break;
+    default:
+        break;
+    }
+}
+
+static void
+match_index_destroy (QofBook *book, gpointer key, gpointer data)
+{
+    GncImportMatchIndex *index = data;
+
+    qof_event_unregister_handler (index->handler_id);
+    g_hash_table_destroy (index->accounts);
+    g_free (index);
+    qof_book_set_data (book, MATCH_INDEX_KEY, NULL);
+}
+
+GncImportMatchIndex *
+gnc_import_match_index_get (QofBook *book)
+{
+    GncImportMatchIndex *index;
+
+    g_return_val_if_fail (book, NULL);
+
+    index = qof_book_get_data (book, MATCH_INDEX_KEY);
+    if (index)
+        return index;
+
+    index = g_new0 (GncImportMatchIndex, 1);
+    index->book = book;
+    index->accounts = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                             NULL, account_index_free);
+    index->handler_id =
+        qof_event_register_type_handler (GNC_ID_ACCOUNT,
+                                         GNC_EVENT_ITEM_ADDED |
+                                         GNC_EVENT_ITEM_CHANGED |
+                                         GNC_EVENT_ITEM_REMOVED |
+                                         QOF_EVENT_DESTROY,
+                                         match_index_event_handler, index);
+    qof_book_set_data_fin (book, MATCH_INDEX_KEY, index, match_index_destroy);
+    return index;
+}
+
+GList *
+gnc_import_match_index_get_splits (GncImportMatchIndex *index,
+                                   Account *account,
+                                   time64 start, time64 end)
+{
+    AccountIndex *aidx;
+    GList *splits = NULL;
+    guint first, i;
+
+    g_return_val_if_fail (index && account, NULL);
+
+    aidx = account_index_lookup (index, account);
+    first = lower_bound (aidx->entries, start);
+    for (i = upper_bound (aidx->entries, end); i > first; i--)
+        splits = g_list_prepend (splits,
+                                 g_array_index (aidx->entries, IndexEntry,
+                                                i - 1).split);
+    return splits;
+}
+
+gboolean
+gnc_import_match_index_has_online_id (GncImportMatchIndex *index,
+                                      Account *account,
+                                      const gchar *online_id,
+                                      Split *exclude)
+{
+    AccountIndex *aidx;
+    SplitInfo *info;
+    guint count;
+
+    g_return_val_if_fail (index && account, FALSE);
+    if (!online_id || *online_id == '\0')
+        return FALSE;
+
+    aidx = account_index_lookup (index, account);
+    count = GPOINTER_TO_UINT (g_hash_table_lookup (aidx->online_ids, online_id));
+    info = exclude ? g_hash_table_lookup (aidx->splits, exclude) : NULL;
+    if (count && info && g_strcmp0 (info->online_id, online_id) == 0)
+        count--;
+    return count > 0;
+}
+
+void
+gnc_import_match_index_invalidate (GncImportMatchIndex *index)
+{
+    g_return_if_fail (index);
+    g_hash_table_remove_all (index->accounts);
+}
+/** @} */
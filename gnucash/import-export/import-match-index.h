@@ -0,0 +1,65 @@
+/********************************************************************\
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+/** @addtogroup Import_Export
+    @{ */
+/** @file import-match-index.h
+    @brief Per book index of the splits the importers match against.
+
+    The index keeps, for each account it has been asked about, the
+    account's splits sorted by posted date and the online_ids found on
+    them. It is built the first time an account is looked up and then
+    kept up to date from the engine events, so repeated imports into
+    the same book don't have to query the whole book for every
+    downloaded transaction.
+*/
+
+#ifndef IMPORT_MATCH_INDEX_H
+#define IMPORT_MATCH_INDEX_H
+
+#include <glib.h>
+#include "qof.h"
+#include "Account.h"
+
+typedef struct _GncImportMatchIndex GncImportMatchIndex;
+
+/** Return the match index of book, creating it on first use. The index
+ *  belongs to the book and is destroyed with it. */
+GncImportMatchIndex *gnc_import_match_index_get (QofBook *book);
+
+/** Return a newly allocated list of the splits of account posted
+ *  between start and end inclusive, in date order. Free the list, but
+ *  not the splits, with g_list_free. */
+GList *gnc_import_match_index_get_splits (GncImportMatchIndex *index,
+                                          Account *account,
+                                          time64 start, time64 end);
+
+/** Return TRUE if a split of account other than exclude carries
+ *  online_id, either on the split itself or on its transaction. */
+gboolean gnc_import_match_index_has_online_id (GncImportMatchIndex *index,
+                                               Account *account,
+                                               const gchar *online_id,
+                                               Split *exclude);
+
+/** Forget everything indexed so far; accounts are indexed again on
+ *  their next lookup. Only needed after changes made while engine
+ *  events were suspended. */
+void gnc_import_match_index_invalidate (GncImportMatchIndex *index);
+
+#endif
+/** @} */
@@ -74,10 +74,10 @@
           (tag #f)
           (value #f)
           (abort-read #f)
-          (delimiters (string #\cr #\nl))
           (file-stats #f)
           (file-size 0)
-          (bytes-read 0))
+          (bytes-read 0)
+          (reader #f))
 
       ;; This procedure simplifies handling of warnings.
       (define (mywarn . args)
@@ -96,26 +96,6 @@
                           (string-append str "\n" (_ "Read aborted.")))
           (set! abort-read #t)))
 
-      (define (strip-bom)
-	(let ((c1 (read-char)))
-	  (if (char=? c1 (integer->char #xEF))
-	    (let ((c2 (read-char)))
-	      (if (char=? c2 (integer->char #xBB))
-		  (let ((c3 (read-char)))
-		    (if (char=? c3 (integer->char #xBF)) #t
-			(begin
-			  (unread-char c3)
-			  (unread-char c2)
-			  (unread-char c1)
-			#f)))
-		  (begin
-		    (unread-char c2)
-		    (unread-char c1)
-		    #f)))
-	    (begin
-	      (unread-char c1)
-	      #f))))
-
       (qif-file:set-path! self path)
       (if (not (access? path R_OK))
           ;; A UTF-8 encoded path won't succeed on some systems, such as
@@ -129,394 +109,381 @@
           (gnc-progress-dialog-set-sub progress-dialog
                                        (string-append (_ "Reading") " " path)))
 
-      (with-input-from-file path
-        (lambda ()
-	  (strip-bom)
-          ;; loop over lines
-          (let line-loop ()
-            (set! line (read-delimited delimiters))
-            (set! line-num (+ 1 line-num))
-            (if (and (not (eof-object? line))
-                     (not (string=? line "")))
-                (begin
-                  ;; Add to the bytes-read tally.
-                  (set! bytes-read
-                        (+ bytes-read 1 (string-length line)))
-
-                  ;; Pick the 1-char tag off from the remainder of the line.
-                  (set! tag (string-ref line 0))
-                  (set! value (substring line 1))
-
-                  ;; If the line doesn't conform to UTF-8, try a default
-                  ;; character set conversion based on the locale. If that
-                  ;; fails, remove any invalid characters.
-                  (if (not (gnc-utf8? value))
-                      (let ((converted-value (gnc-locale-to-utf8 value)))
-                        (if (or (string=? converted-value "")
-                                (not (gnc-utf8? converted-value)))
-                            (begin
-                              (set! value (gnc-utf8-strip-invalid-strdup value))
-                              (mywarn
-                               (_ "Some characters have been discarded.")
-                               " " (_"Converted to: ") value))
-                            (begin
-                              (mywarn
-                               (_ "Some characters have been converted according to your locale.")
-                               " " (_"Converted to: ") converted-value)
-                              (set! value converted-value)))))
-
-                  (if (eq? tag #\!)
-                      ;; The "!" tag has the highest precedence and is used
-                      ;; to switch between different sections of the file.
-                      (let ((old-qstate qstate-type))
-                        (set! qstate-type (qif-parse:parse-bang-field value))
-                        (case qstate-type
-                          ;; Transaction list for a particular account
-                          ((type:bank type:cash type:ccard type:invst type:port
-                            #{type:oth a}#  #{type:oth l}# #{type:oth s}#)
-                           (if ignore-accounts
-                               (set! current-account-name
-                                     last-seen-account-name))
-                           (set! ignore-accounts #f)
-                           (set! current-xtn (make-qif-xtn))
-                           (set! default-split (make-qif-split))
-                           (set! first-xtn #t))
-
-                          ;; Class list
-                          ((type:class)
-                           (set! current-xtn (make-qif-class)))
-
-                          ;; Category list
-                          ((type:cat)
-                           (set! current-xtn (make-qif-cat)))
-
-                          ;; Account list
-                          ((account)
-                           (set! current-xtn (make-qif-acct)))
-
-                          ;; Security list
-                          ((type:security)
-                           (set! current-xtn (make-qif-stock-symbol)))
-
-                          ;; Memorized transaction list
-                          ((type:memorized)
-                           ;; Not supported. We really should warn the user.
-                           #f)
-
-                          ;; Security price list
-                          ((type:prices)
-                           ;; Not supported. We really should warn the user.
-                           #f)
-
-                          ((option:autoswitch)
-                           (set! ignore-accounts #t))
-
-                          ((clear:autoswitch)
-                           (set! ignore-accounts #f))
-
-                          (else
-                           ;; Ignore any other "option:" identifiers and
-                           ;; just return to the previously known !type
-                           (if (string-match "^option:"
-                                             (symbol->string qstate-type))
-                               (begin
-                                 (mywarn (_ "Ignoring unknown option") " '"
-                                         qstate-type "'")
-                                 (set! qstate-type old-qstate))))))
-
-
-                      ;; It's not a "!" tag, so the meaning depends on what
-                      ;; type of section we are currently working on.
-                      (case qstate-type
-
-                        ;;;;;;;;;;;;;;;;;;;;;;
-                        ;; Transaction list ;;
-                        ;;;;;;;;;;;;;;;;;;;;;;
-
-                        ((type:bank type:cash type:ccard type:invst type:port
-                          #{type:oth a}#  #{type:oth l}# #{type:oth s}#)
-                         (case tag
-                           ;; D : transaction date
-                           ((#\D)
-                            (qif-xtn:set-date! current-xtn value))
-
-                           ;; T : total amount
-                           ((#\T)
-                            (if (and default-split
-                                    (not-bad-numeric-string? value))
-                                (qif-split:set-amount! default-split value)))
-
-                           ;; P : payee
-                           ((#\P)
-                            (qif-xtn:set-payee! current-xtn value))
-
-                           ;; A : address
-                           ;; multiple "A" lines are appended together with
-                           ;; newlines; some Quicken files have a lot of
-                           ;; A lines.
-                           ((#\A)
-                            (qif-xtn:set-address!
-                             current-xtn
-                             (let ((current (qif-xtn:address current-xtn)))
-                               (if (not (string? current))
-                                   (set! current ""))
-                               (string-append current "\n" value))))
-
-                           ;; N : For transactions involving a security, this
-                           ;; is the investment action. For all others,  this
-                           ;; is a check number or transaction number.
-                           ((#\N)
-                            (if (or (eq? qstate-type 'type:invst)
-                                    (eq? qstate-type 'type:port))
-                                (qif-xtn:set-action! current-xtn value)
-                                (qif-xtn:set-number! current-xtn value)))
-
-                           ;; C : cleared flag
-                           ((#\C)
-                            (qif-xtn:set-cleared! current-xtn value))
-
-                           ;; M : memo
-                           ((#\M)
-                            (if default-split
-                                (qif-split:set-memo! default-split value)))
-
-                           ;; I : share price (stock transactions)
-                           ((#\I)
-                            (qif-xtn:set-share-price! current-xtn value))
-
-                           ;; Q : number of shares (stock transactions)
-                           ((#\Q)
-                            (qif-xtn:set-num-shares! current-xtn value))
-
-                           ;; Y : name of security (stock transactions)
-                           ((#\Y)
-                            (qif-xtn:set-security-name! current-xtn value))
-
-                           ;; O : commission (stock transactions)
-                           ((#\O)
-                            (qif-xtn:set-commission! current-xtn value))
-
-                           ;; L : category
-                           ((#\L)
-                            (if default-split
-                                (qif-split:set-category! default-split value)))
-
-                           ;; S : split category
-                           ;; At this point we are ignoring the default-split
-                           ;; completely, but save it for later -- we need it
-                           ;; to determine whether to reverse the split values.
-                           ((#\S)
-                            (set! current-split (make-qif-split))
-                            (if default-split
-                                (qif-xtn:set-default-split! current-xtn
-                                                            default-split))
-                            (set! default-split #f)
-                            (qif-split:set-category! current-split value)
-                            (qif-xtn:set-splits!
-                               current-xtn
-                               (cons current-split
-                                     (qif-xtn:splits current-xtn))))
-
-                           ;; E : split memo
-                           ((#\E)
-                            (if current-split
-                                (qif-split:set-memo! current-split value)))
-
-                           ;; $ : split amount (if there are splits)
-                           ((#\$)
-                            (if (and current-split
-                                     (not-bad-numeric-string? value))
-                                (qif-split:set-amount! current-split value)))
-
-                           ;; ^ : end-of-record
-                           ((#\^)
-                            (if (null? (qif-xtn:splits current-xtn))
-                                (qif-xtn:set-splits! current-xtn
-                                                     (list default-split)))
-                            (if first-xtn
-                                (let ((opening-balance-payee
-                                       (qif-file:process-opening-balance-xtn
-                                        self current-account-name current-xtn
-                                        qstate-type)))
-                                  (if (not current-account-name)
-                                      (set! current-account-name
-                                            opening-balance-payee))
-                                  (set! first-xtn #f)))
-
-                            (if (and (or (eq? qstate-type 'type:invst)
-                                         (eq? qstate-type 'type:port))
-                                     (not (qif-xtn:security-name current-xtn)))
-                                (qif-xtn:set-security-name! current-xtn ""))
-
-                            (qif-xtn:set-from-acct! current-xtn
-                                                    current-account-name)
-
-                            (if (qif-xtn:date current-xtn)
-                                (qif-file:add-xtn! self current-xtn)
-                                ;; The date is missing! Warn the user.
-                                (mywarn (_ "Date required.") " "
-                                        (_ "Discarding this transaction.")))
-
-                            ;;(write current-xtn) (newline)
-                            (set! current-xtn (make-qif-xtn))
-                            (set! current-split #f)
-                            (set! default-split (make-qif-split)))))
-
-
-                        ;;;;;;;;;;;;;;;;
-                        ;; Class list ;;
-                        ;;;;;;;;;;;;;;;;
-
-                        ((type:class)
-                         (case tag
-                           ;; N : name
-                           ((#\N)
-                            (qif-class:set-name! current-xtn value))
-
-                           ;; D : description
-                           ((#\D)
-                            (qif-class:set-description! current-xtn value))
-
-                           ;; R : tax copy designator (ignored for now)
-                           ((#\R)
-                            #t)
-
-                           ;; end-of-record
-                           ((#\^)
-                            (qif-file:add-class! self current-xtn)
-                            (set! current-xtn (make-qif-class)))
-
-                           (else
-                            (mywarn (_ "Ignoring class line") ": " line))))
-
-
-                        ;;;;;;;;;;;;;;;;;;
-                        ;; Account List ;;
-                        ;;;;;;;;;;;;;;;;;;
-
-                        ((account)
-                         (case tag
-                           ((#\N)
-                            (qif-acct:set-name! current-xtn value)
-                            (set! last-seen-account-name value))
-                           ((#\D)
-                            (qif-acct:set-description! current-xtn value))
-                           ((#\T)
-                            (qif-acct:set-type! current-xtn value))
-                           ((#\L)
-                            (qif-acct:set-limit! current-xtn value))
-                           ((#\B)
-                            (qif-acct:set-budget! current-xtn value))
-                           ((#\^)
-                            (if (not ignore-accounts)
-                                (set! current-account-name
-                                      (qif-acct:name current-xtn)))
-                            (qif-file:add-account! self current-xtn)
-                            (set! current-xtn (make-qif-acct)))))
-
-
-                        ;;;;;;;;;;;;;;;;;;;
-                        ;; Category list ;;
-                        ;;;;;;;;;;;;;;;;;;;
-
-                        ((type:cat)
-                         (case tag
-                           ;; N : category name
-                           ((#\N)
-                            (qif-cat:set-name! current-xtn value))
-
-                           ;; D : category description
-                           ((#\D)
-                            (qif-cat:set-description! current-xtn value))
-
-                           ;; T : is this a taxable category?
-                           ((#\T)
-                            (qif-cat:set-taxable! current-xtn #t))
-
-                           ;; E : is this an expense category?
-                           ((#\E)
-                            (qif-cat:set-expense-cat! current-xtn #t))
-
-                           ;; I : is this an income category?
-                           ((#\I)
-                            (qif-cat:set-income-cat! current-xtn #t))
-
-                           ;; R : tax form/line designator
-                           ((#\R)
-                            (qif-cat:set-tax-class! current-xtn value))
-
-                           ;; B : budget amount.  not really supported.
-                           ((#\B)
-                            (qif-cat:set-budget-amt! current-xtn value))
-
-                           ;; end-of-record
-                           ((#\^)
-                            (qif-file:add-cat! self current-xtn)
-                            (set! current-xtn (make-qif-cat)))
-
-                           (else
-                            (mywarn (_ "Ignoring category line") ": " line))))
-
-
-                        ;;;;;;;;;;;;;;;;;;;
-                        ;; Security list ;;
-                        ;;;;;;;;;;;;;;;;;;;
-
-                        ((type:security)
-                         (case tag
-                           ;; N : stock name
-                           ((#\N)
-                            (qif-stock-symbol:set-name! current-xtn value))
-
-                           ;; S : ticker symbol
-                           ((#\S)
-                            (qif-stock-symbol:set-symbol! current-xtn value))
-
-                           ;; T : type
-                           ((#\T)
-                            (qif-stock-symbol:set-type! current-xtn value))
-
-                           ;; G : asset class (ignored)
-                           ((#\G)
-                            #t)
-
-                           ;; end-of-record
-                           ((#\^)
-                            (qif-ticker-map:add-ticker! ticker-map current-xtn)
-                            (set! current-xtn (make-qif-stock-symbol)))
-
-                           (else
-                            (mywarn (_ "Ignoring security line") ": " line))))
-
-
-                        ;; trying to sneak one by, eh?
-                        (else
-                          (if (and (not qstate-type)
-                                   (not (string=? (string-trim line) "")))
-                              (myfail
-                                (_ "File does not appear to be in QIF format")
-                                ": " line)))))
-
-                  ;; Report the progress.
-                  (if (and progress-dialog
-                           (zero? (remainder line-num 32)))
-                      (begin
-                        (gnc-progress-dialog-set-value progress-dialog
-                                                       (/ bytes-read file-size))
-                        (qif-import:check-pause progress-dialog)
-                        (if qif-import:canceled
-                            (begin
-                              (set! private-retval #t)
-                              (set! abort-read #t)))))
-
-                  ;; This is if we read a normal (non-null, non-eof) line...
-                  (if (not abort-read)
-                      (line-loop)))
-
-                ;; ...and this is if we read a null or eof line.
-                (if (and (not abort-read)
-                         (not (eof-object? line)))
-                    (line-loop))))) #:encoding "UTF-8")
+      ;; The reader does the line level work in C: it skips the byte
+      ;; order mark and empty lines, splits the lines at CR, LF or
+      ;; CRLF and converts values that aren't valid UTF-8. It hands
+      ;; out one field (line-num tag value conversion) at a time.
+      (set! reader (gnc-qif-reader-open path))
+      (let line-loop ((field (gnc-qif-reader-next-field reader)))
+        (if field
+            (begin
+              (set! line-num (car field))
+              (set! tag (cadr field))
+              (set! value (caddr field))
+              (set! line (string-append (string tag) value))
+
+              ;; Add to the bytes-read tally.
+              (set! bytes-read
+                    (+ bytes-read 1 (string-length line)))
+
+              ;; Values that weren't UTF-8 have been converted
+              ;; according to the locale, or stripped of the
+              ;; invalid characters if that failed.
+              (case (cadddr field)
+                ((stripped)
+                 (mywarn (_ "Some characters have been discarded.")
+                         " " (_"Converted to: ") value))
+                ((locale)
+                 (mywarn (_ "Some characters have been converted according to your locale.")
+                         " " (_"Converted to: ") value)))
+
+              (if (eq? tag #\!)
+                  ;; The "!" tag has the highest precedence and is used
+                  ;; to switch between different sections of the file.
+                  (let ((old-qstate qstate-type))
+                    (set! qstate-type (qif-parse:parse-bang-field value))
+                    (case qstate-type
+                      ;; Transaction list for a particular account
+                      ((type:bank type:cash type:ccard type:invst type:port
+                        #{type:oth a}#  #{type:oth l}# #{type:oth s}#)
+                       (if ignore-accounts
+                           (set! current-account-name
+                                 last-seen-account-name))
+                       (set! ignore-accounts #f)
+                       (set! current-xtn (make-qif-xtn))
+                       (set! default-split (make-qif-split))
+                       (set! first-xtn #t))
+
+                      ;; Class list
+                      ((type:class)
+                       (set! current-xtn (make-qif-class)))
+
+                      ;; Category list
+                      ((type:cat)
+                       (set! current-xtn (make-qif-cat)))
+
+                      ;; Account list
+                      ((account)
+                       (set! current-xtn (make-qif-acct)))
+
+                      ;; Security list
+                      ((type:security)
+                       (set! current-xtn (make-qif-stock-symbol)))
+
+                      ;; Memorized transaction list
+                      ((type:memorized)
+                       ;; Not supported. We really should warn the user.
+                       #f)
+
+                      ;; Security price list
+                      ((type:prices)
+                       ;; Not supported. We really should warn the user.
+                       #f)
+
+                      ((option:autoswitch)
+                       (set! ignore-accounts #t))
+
+                      ((clear:autoswitch)
+                       (set! ignore-accounts #f))
+
+                      (else
+                       ;; Ignore any other "option:" identifiers and
+                       ;; just return to the previously known !type
+                       (if (string-match "^option:"
+                                         (symbol->string qstate-type))
+                           (begin
+                             (mywarn (_ "Ignoring unknown option") " '"
+                                     qstate-type "'")
+                             (set! qstate-type old-qstate))))))
+
+
+                  ;; It's not a "!" tag, so the meaning depends on what
+                  ;; type of section we are currently working on.
+                  (case qstate-type
+
+                    ;;;;;;;;;;;;;;;;;;;;;;
+                    ;; Transaction list ;;
+                    ;;;;;;;;;;;;;;;;;;;;;;
+
+                    ((type:bank type:cash type:ccard type:invst type:port
+                      #{type:oth a}#  #{type:oth l}# #{type:oth s}#)
+                     (case tag
+                       ;; D : transaction date
+                       ((#\D)
+                        (qif-xtn:set-date! current-xtn value))
+
+                       ;; T : total amount
+                       ((#\T)
+                        (if (and default-split
+                                (not-bad-numeric-string? value))
+                            (qif-split:set-amount! default-split value)))
+
+                       ;; P : payee
+                       ((#\P)
+                        (qif-xtn:set-payee! current-xtn value))
+
+                       ;; A : address
+                       ;; multiple "A" lines are appended together with
+                       ;; newlines; some Quicken files have a lot of
+                       ;; A lines.
+                       ((#\A)
+                        (qif-xtn:set-address!
+                         current-xtn
+                         (let ((current (qif-xtn:address current-xtn)))
+                           (if (not (string? current))
+                               (set! current ""))
+                           (string-append current "\n" value))))
+
+                       ;; N : For transactions involving a security, this
+                       ;; is the investment action. For all others,  this
+                       ;; is a check number or transaction number.
+                       ((#\N)
+                        (if (or (eq? qstate-type 'type:invst)
+                                (eq? qstate-type 'type:port))
+                            (qif-xtn:set-action! current-xtn value)
+                            (qif-xtn:set-number! current-xtn value)))
+
+                       ;; C : cleared flag
+                       ((#\C)
+                        (qif-xtn:set-cleared! current-xtn value))
+
+                       ;; M : memo
+                       ((#\M)
+                        (if default-split
+                            (qif-split:set-memo! default-split value)))
+
+                       ;; I : share price (stock transactions)
+                       ((#\I)
+                        (qif-xtn:set-share-price! current-xtn value))
+
+                       ;; Q : number of shares (stock transactions)
+                       ((#\Q)
+                        (qif-xtn:set-num-shares! current-xtn value))
+
+                       ;; Y : name of security (stock transactions)
+                       ((#\Y)
+                        (qif-xtn:set-security-name! current-xtn value))
+
+                       ;; O : commission (stock transactions)
+                       ((#\O)
+                        (qif-xtn:set-commission! current-xtn value))
+
+                       ;; L : category
+                       ((#\L)
+                        (if default-split
+                            (qif-split:set-category! default-split value)))
+
+                       ;; S : split category
+                       ;; At this point we are ignoring the default-split
+                       ;; completely, but save it for later -- we need it
+                       ;; to determine whether to reverse the split values.
+                       ((#\S)
+                        (set! current-split (make-qif-split))
+                        (if default-split
+                            (qif-xtn:set-default-split! current-xtn
+                                                        default-split))
+                        (set! default-split #f)
+                        (qif-split:set-category! current-split value)
+                        (qif-xtn:set-splits!
+                           current-xtn
+                           (cons current-split
+                                 (qif-xtn:splits current-xtn))))
+
+                       ;; E : split memo
+                       ((#\E)
+                        (if current-split
+                            (qif-split:set-memo! current-split value)))
+
+                       ;; $ : split amount (if there are splits)
+                       ((#\$)
+                        (if (and current-split
+                                 (not-bad-numeric-string? value))
+                            (qif-split:set-amount! current-split value)))
+
+                       ;; ^ : end-of-record
+                       ((#\^)
+                        (if (null? (qif-xtn:splits current-xtn))
+                            (qif-xtn:set-splits! current-xtn
+                                                 (list default-split)))
+                        (if first-xtn
+                            (let ((opening-balance-payee
+                                   (qif-file:process-opening-balance-xtn
+                                    self current-account-name current-xtn
+                                    qstate-type)))
+                              (if (not current-account-name)
+                                  (set! current-account-name
+                                        opening-balance-payee))
+                              (set! first-xtn #f)))
+
+                        (if (and (or (eq? qstate-type 'type:invst)
+                                     (eq? qstate-type 'type:port))
+                                 (not (qif-xtn:security-name current-xtn)))
+                            (qif-xtn:set-security-name! current-xtn ""))
+
+                        (qif-xtn:set-from-acct! current-xtn
+                                                current-account-name)
+
+                        (if (qif-xtn:date current-xtn)
+                            (qif-file:add-xtn! self current-xtn)
+                            ;; The date is missing! Warn the user.
+                            (mywarn (_ "Date required.") " "
+                                    (_ "Discarding this transaction.")))
+
+                        ;;(write current-xtn) (newline)
+                        (set! current-xtn (make-qif-xtn))
+                        (set! current-split #f)
+                        (set! default-split (make-qif-split)))))
+
+
+                    ;;;;;;;;;;;;;;;;
+                    ;; Class list ;;
+                    ;;;;;;;;;;;;;;;;
+
+                    ((type:class)
+                     (case tag
+                       ;; N : name
+                       ((#\N)
+                        (qif-class:set-name! current-xtn value))
+
+                       ;; D : description
+                       ((#\D)
+                        (qif-class:set-description! current-xtn value))
+
+                       ;; R : tax copy designator (ignored for now)
+                       ((#\R)
+                        #t)
+
+                       ;; end-of-record
+                       ((#\^)
+                        (qif-file:add-class! self current-xtn)
+                        (set! current-xtn (make-qif-class)))
+
+                       (else
+                        (mywarn (_ "Ignoring class line") ": " line))))
+
+
+                    ;;;;;;;;;;;;;;;;;;
+                    ;; Account List ;;
+                    ;;;;;;;;;;;;;;;;;;
+
+                    ((account)
+                     (case tag
+                       ((#\N)
+                        (qif-acct:set-name! current-xtn value)
+                        (set! last-seen-account-name value))
+                       ((#\D)
+                        (qif-acct:set-description! current-xtn value))
+                       ((#\T)
+                        (qif-acct:set-type! current-xtn value))
+                       ((#\L)
+                        (qif-acct:set-limit! current-xtn value))
+                       ((#\B)
+                        (qif-acct:set-budget! current-xtn value))
+                       ((#\^)
+                        (if (not ignore-accounts)
+                            (set! current-account-name
+                                  (qif-acct:name current-xtn)))
+                        (qif-file:add-account! self current-xtn)
+                        (set! current-xtn (make-qif-acct)))))
+
+
+                    ;;;;;;;;;;;;;;;;;;;
+                    ;; Category list ;;
+                    ;;;;;;;;;;;;;;;;;;;
+
+                    ((type:cat)
+                     (case tag
+                       ;; N : category name
+                       ((#\N)
+                        (qif-cat:set-name! current-xtn value))
+
+                       ;; D : category description
+                       ((#\D)
+                        (qif-cat:set-description! current-xtn value))
+
+                       ;; T : is this a taxable category?
+                       ((#\T)
+                        (qif-cat:set-taxable! current-xtn #t))
+
+                       ;; E : is this an expense category?
+                       ((#\E)
+                        (qif-cat:set-expense-cat! current-xtn #t))
+
+                       ;; I : is this an income category?
+                       ((#\I)
+                        (qif-cat:set-income-cat! current-xtn #t))
+
+                       ;; R : tax form/line designator
+                       ((#\R)
+                        (qif-cat:set-tax-class! current-xtn value))
+
+                       ;; B : budget amount.  not really supported.
+                       ((#\B)
+                        (qif-cat:set-budget-amt! current-xtn value))
+
+                       ;; end-of-record
+                       ((#\^)
+                        (qif-file:add-cat! self current-xtn)
+                        (set! current-xtn (make-qif-cat)))
+
+                       (else
+                        (mywarn (_ "Ignoring category line") ": " line))))
+
+
+                    ;;;;;;;;;;;;;;;;;;;
+                    ;; Security list ;;
+                    ;;;;;;;;;;;;;;;;;;;
+
+                    ((type:security)
+                     (case tag
+                       ;; N : stock name
+                       ((#\N)
+                        (qif-stock-symbol:set-name! current-xtn value))
+
+                       ;; S : ticker symbol
+                       ((#\S)
+                        (qif-stock-symbol:set-symbol! current-xtn value))
+
+                       ;; T : type
+                       ((#\T)
+                        (qif-stock-symbol:set-type! current-xtn value))
+
+                       ;; G : asset class (ignored)
+                       ((#\G)
+                        #t)
+
+                       ;; end-of-record
+                       ((#\^)
+                        (qif-ticker-map:add-ticker! ticker-map current-xtn)
+                        (set! current-xtn (make-qif-stock-symbol)))
+
+                       (else
+                        (mywarn (_ "Ignoring security line") ": " line))))
+
+
+                    ;; trying to sneak one by, eh?
+                    (else
+                      (if (and (not qstate-type)
+                               (not (string=? (string-trim line) "")))
+                          (myfail
+                            (_ "File does not appear to be in QIF format")
+                            ": " line)))))
+
+              ;; Report the progress.
+              (if (and progress-dialog
+                       (zero? (remainder line-num 32)))
+                  (begin
+                    (gnc-progress-dialog-set-value progress-dialog
+                                                   (/ bytes-read file-size))
+                    (qif-import:check-pause progress-dialog)
+                    (if qif-import:canceled
+                        (begin
+                          (set! private-retval #t)
+                          (set! abort-read #t)))))
+
+              (if (not abort-read)
+                  (line-loop (gnc-qif-reader-next-field reader))))))
+      (gnc-qif-reader-close reader)
 
       ;; Reverse the transaction list so xtns are in the same order that
       ;; they appeared in the file.  This is important in a few cases.
@@ -225,46 +225,11 @@
            (errorproc errortype msg))))))
 
 
-;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
-;;  parse-check-date-format
-;;  given a match-triple (matches in spaces 1, 2, 3) and a
-;;  list of possible date formats, return the list of formats
-;;  that this date string could actually be.
-;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
-(define (parse-check-date-format match possible-formats)
-  (define (date? d m y ys)
-    (and (number? d) (<= 1 d 31)
-         (number? m) (<= 1 m 12)
-         (number? y) (or (not (= 4 (string-length ys)))
-                         (> y 1930))))
-  (let* ((date-parts (list (match:substring match 1)
-                           (match:substring match 2)
-                           (match:substring match 3)))
-         (numeric-date-parts (map (lambda (elt) (with-input-from-string elt read))
-                                  date-parts))
-         (n1 (car numeric-date-parts))
-         (n2 (cadr numeric-date-parts))
-         (n3 (caddr numeric-date-parts))
-         (s1 (car date-parts))
-         (s3 (caddr date-parts))
-         (format-alist (list (list 'd-m-y n1 n2 n3 s3)
-                             (list 'm-d-y n2 n1 n3 s3)
-                             (list 'y-m-d n3 n2 n1 s1)
-                             (list 'y-d-m n2 n3 n1 s1))))
-
-    (let lp ((possible-formats possible-formats)
-             (res '()))
-      (cond
-       ((null? possible-formats) (reverse res))
-       (else
-        (lp (cdr possible-formats)
-            (let ((args (assq (car possible-formats) format-alist)))
-              (if (apply date? (cdr args)) (cons (car args) res) res))))))))
-
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;;  qif-parse:check-date-format
 ;;  given a list of possible date formats, return a pruned list
-;;  of possibilities.
+;;  of possibilities. The matching is done in C by
+;;  gnc-qif-check-date-format.
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 (define qif-date-compiled-rexp
   (make-regexp "^ *([0-9]+) *[-/.'] *([0-9]+) *[-/.'] *([0-9]+).*$|^ *([0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9]).*$"))
@@ -278,23 +243,7 @@
 (define (qif-parse:check-date-format date-string possible-formats)
   (and (string? date-string)
        (not (string-null? date-string))
-       (let ((rmatch (regexp-exec qif-date-compiled-rexp date-string)))
-         (if rmatch
-             (if (match:substring rmatch 1)
-                 (parse-check-date-format rmatch possible-formats)
-                 ;; Uh oh -- this is a string XXXXXXXX; we don't know which
-                 ;; way to test..  So test both YYYYxxxx and xxxxYYYY,
-                 ;; and let the parser verify the year is valid.
-                 (let* ((newstr (match:substring rmatch 4))
-                        (date-ymd (regexp-exec qif-date-ymd-compiled-rexp newstr))
-                        (date-mdy (regexp-exec qif-date-mdy-compiled-rexp newstr)))
-                   (append
-                    (if (or (memq 'y-d-m possible-formats)
-                            (memq 'y-m-d possible-formats))
-                        (parse-check-date-format date-ymd possible-formats))
-                    (if (or (memq 'd-m-y possible-formats)
-                            (memq 'm-d-y possible-formats))
-                        (parse-check-date-format date-mdy possible-formats)))))))))
+       (gnc-qif-check-date-format date-string possible-formats)))
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;;  qif-parse:parse-date/format
@@ -351,36 +300,16 @@
      ((eq? dateformat 'y-m-d) (refs->list 2 1 0))
      ((eq? dateformat 'y-d-m) (refs->list 2 0 1)))))
 
-;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
-;;  number format predicates
-;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
-
-
-;; eg 1000.00 or 1,500.00 or 2'000.00
-(define decimal-radix-regexp
-  (make-regexp "^ *[$]?[+-]?[$]?[0-9]+[+-]?$|^ *[$]?[+-]?[$]?[0-9]?[0-9]?[0-9]?([,'][0-9][0-9][0-9])*(\\.[0-9]*)?[+-]? *$|^ *[$]?[+-]?[$]?[0-9]+\\.[0-9]*[+-]? *$"))
-
-;; eg 5.000,00 or 4'500,00
-(define comma-radix-regexp
-  (make-regexp "^ *[$]?[+-]?[$]?[0-9]+[+-]?$|^ *[$]?[+-]?[$]?[0-9]?[0-9]?[0-9]?([\\.'][0-9][0-9][0-9])*(,[0-9]*)?[+-]? *$|^ *[$]?[+-]?[$]?[0-9]+,[0-9]*[+-]? *$"))
-
-;; eg 456 or 123
-(define integer-regexp
-  (make-regexp "^[$]?[+-]?[$]?[0-9]+[+-]? *$"))
-
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;;  qif-parse:check-number-format
 ;;  given a list of possible number formats, return a pruned list
-;;  of possibilities.
+;;  of possibilities. The accepted forms are 1000.00, 1,500.00 or
+;;  2'000.00 for decimal, 5.000,00 or 4'500,00 for comma and 456 for
+;;  integer; see gnc-qif-check-number-format.
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 
 (define (qif-parse:check-number-format value-string possible-formats)
-  (define numtypes-alist
-    (list (cons 'decimal decimal-radix-regexp)
-          (cons 'comma comma-radix-regexp)
-          (cons 'integer integer-regexp)))
-  (filter (lambda (fmt) (regexp-exec (assq-ref numtypes-alist fmt) value-string))
-          possible-formats))
+  (gnc-qif-check-number-format value-string possible-formats))
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;;  qif-parse:parse-number/format
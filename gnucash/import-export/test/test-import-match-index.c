@@ -0,0 +1,209 @@
+/********************************************************************\
+ * test-import-match-index.c -- Test the importer's match index.    *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include <unittest-support.h>
+
+#include <glib.h>
+#include "import-match-index.h"
+#include "import-utilities.h"
+#include "Account.h"
+#include "Transaction.h"
+#include "Split.h"
+#include "gnc-commodity.h"
+#include "cashobjects.h"
+
+static const gchar *suitename = "/import-export/import-match-index";
+
+#define DAY 86400
+
+typedef struct
+{
+    QofBook *book;
+    gnc_commodity *currency;
+    Account *account;
+    GncImportMatchIndex *index;
+} Fixture;
+
+static Split *
+add_trans (Fixture *fixture, time64 date, const gchar *online_id)
+{
+    Transaction *trans = xaccMallocTransaction (fixture->book);
+    Split *split = xaccMallocSplit (fixture->book);
+
+    xaccTransBeginEdit (trans);
+    xaccTransSetCurrency (trans, fixture->currency);
+    xaccTransSetDatePostedSecs (trans, date);
+    xaccSplitSetParent (split, trans);
+    xaccSplitSetAccount (split, fixture->account);
+    if (online_id)
+        gnc_import_set_split_online_id (split, online_id);
+    xaccTransCommitEdit (trans);
+    return split;
+}
+
+static void
+setup (Fixture *fixture, gconstpointer pData)
+{
+    fixture->book = qof_book_new ();
+    fixture->currency = gnc_commodity_new (fixture->book, "US Dollar",
+                                           "CURRENCY", "USD", "0", 100);
+    fixture->account = xaccMallocAccount (fixture->book);
+    xaccAccountBeginEdit (fixture->account);
+    xaccAccountSetCommodity (fixture->account, fixture->currency);
+    xaccAccountCommitEdit (fixture->account);
+    fixture->index = gnc_import_match_index_get (fixture->book);
+}
+
+static void
+teardown (Fixture *fixture, gconstpointer pData)
+{
+    qof_book_destroy (fixture->book);
+}
+
+static void
+test_match_index_date_range (Fixture *fixture, gconstpointer pData)
+{
+    Split *s1 = add_trans (fixture, 10 * DAY, NULL);
+    Split *s2 = add_trans (fixture, 20 * DAY, NULL);
+    Split *s3 = add_trans (fixture, 30 * DAY, NULL);
+    GList *splits;
+
+    g_assert (gnc_import_match_index_get (fixture->book) == fixture->index);
+
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                15 * DAY, 30 * DAY);
+    g_assert_cmpint (g_list_length (splits), ==, 2);
+    g_assert (splits->data == s2);
+    g_assert (splits->next->data == s3);
+    g_list_free (splits);
+
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                0, 5 * DAY);
+    g_assert (splits == NULL);
+
+    /* Once the account is indexed, changes come in through events */
+    xaccTransBeginEdit (xaccSplitGetParent (s1));
+    xaccTransSetDatePostedSecs (xaccSplitGetParent (s1), 2 * DAY);
+    xaccTransCommitEdit (xaccSplitGetParent (s1));
+    add_trans (fixture, 4 * DAY, NULL);
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                0, 5 * DAY);
+    g_assert_cmpint (g_list_length (splits), ==, 2);
+    g_assert (splits->data == s1);
+    g_list_free (splits);
+
+    xaccTransBeginEdit (xaccSplitGetParent (s2));
+    xaccTransDestroy (xaccSplitGetParent (s2));
+    xaccTransCommitEdit (xaccSplitGetParent (s2));
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                15 * DAY, 30 * DAY);
+    g_assert_cmpint (g_list_length (splits), ==, 1);
+    g_assert (splits->data == s3);
+    g_list_free (splits);
+}
+
+static void
+test_match_index_online_id (Fixture *fixture, gconstpointer pData)
+{
+    Split *s1 = add_trans (fixture, 10 * DAY, "id-1");
+    Split *s2;
+
+    g_assert (gnc_import_match_index_has_online_id (fixture->index,
+                                                    fixture->account,
+                                                    "id-1", NULL));
+    g_assert (!gnc_import_match_index_has_online_id (fixture->index,
+                                                     fixture->account,
+                                                     "id-1", s1));
+    g_assert (!gnc_import_match_index_has_online_id (fixture->index,
+                                                     fixture->account,
+                                                     "id-2", NULL));
+
+    s2 = add_trans (fixture, 11 * DAY, "id-1");
+    g_assert (gnc_import_match_index_has_online_id (fixture->index,
+                                                    fixture->account,
+                                                    "id-1", s2));
+
+    xaccTransBeginEdit (xaccSplitGetParent (s1));
+    xaccTransDestroy (xaccSplitGetParent (s1));
+    xaccTransCommitEdit (xaccSplitGetParent (s1));
+    g_assert (!gnc_import_match_index_has_online_id (fixture->index,
+                                                     fixture->account,
+                                                     "id-1", s2));
+}
+
+static void
+test_match_index_suspended_events (Fixture *fixture, gconstpointer pData)
+{
+    GList *splits;
+    Split *s2, *s3;
+    Transaction *trans;
+
+    add_trans (fixture, 10 * DAY, NULL);
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                0, 20 * DAY);
+    g_assert_cmpint (g_list_length (splits), ==, 1);
+    g_list_free (splits);
+
+    qof_event_suspend ();
+    s2 = add_trans (fixture, 12 * DAY, NULL);
+    qof_event_resume ();
+
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                0, 20 * DAY);
+    g_assert_cmpint (g_list_length (splits), ==, 2);
+    g_list_free (splits);
+
+    /* One split gone and another one added leave the count unchanged. */
+    qof_event_suspend ();
+    trans = xaccSplitGetParent (s2);
+    xaccTransBeginEdit (trans);
+    xaccTransDestroy (trans);
+    xaccTransCommitEdit (trans);
+    s3 = add_trans (fixture, 14 * DAY, NULL);
+    qof_event_resume ();
+
+    splits = gnc_import_match_index_get_splits (fixture->index, fixture->account,
+                                                11 * DAY, 20 * DAY);
+    g_assert_cmpint (g_list_length (splits), ==, 1);
+    g_assert (splits->data == s3);
+    g_list_free (splits);
+}
+
+int
+main (int argc, char *argv[])
+{
+    int result;
+    qof_init ();
+    cashobjects_register ();
+    g_test_init (&argc, &argv, NULL);
+
+    GNC_TEST_ADD (suitename, "date range", Fixture, NULL, setup,
+                  test_match_index_date_range, teardown);
+    GNC_TEST_ADD (suitename, "online id", Fixture, NULL, setup,
+                  test_match_index_online_id, teardown);
+    GNC_TEST_ADD (suitename, "suspended events", Fixture, NULL, setup,
+                  test_match_index_suspended_events, teardown);
+    result = g_test_run ();
+
+    qof_close ();
+    return result;
+}
@@ -446,10 +446,22 @@ flawed. see report-utilities.scm. please update reports.")
 ;; keyword which can be reproduced via #:split->amount (lambda (s)
 ;; (and (not (xaccTransGetIsClosingTxn (xaccSplitGetParent s)))
 ;; (xaccSplitGetAmount s)))
+;;
+;; with the default split->amount the balances are computed natively
+;; in one pass by gnc-account-get-balances-at-dates.
 (define* (gnc:account-get-balances-at-dates
           account dates-list #:key (split->amount xaccSplitGetAmount))
   (define (amount->monetary bal)
     (gnc:make-gnc-monetary (xaccAccountGetCommodity account) bal))
+  (if (eq? split->amount xaccSplitGetAmount)
+      (map (lambda (bal) (amount->monetary (car bal)))
+           (gnc-account-get-balances-at-dates
+            account (stable-sort! dates-list <)))
+      (account-get-balances-at-dates-scm
+       account dates-list split->amount amount->monetary)))
+
+(define (account-get-balances-at-dates-scm
+         account dates-list split->amount amount->monetary)
   (let loop ((splits (xaccAccountGetSplitList account))
              (dates-list (stable-sort! dates-list <))
              (currentbal 0)
@@ -49,8 +49,46 @@ typedef struct ParserNum
 } ParserNum;
 
 
+/* Nodes of a compiled expression. Compilation runs the ordinary
+ * parser with callbacks which build these instead of computing values,
+ * so the grammar (and its quirks) are exactly those of
+ * gnc_exp_parser_parse_separate_vars. */
+typedef enum
+{
+    EXP_NODE_CONST,
+    EXP_NODE_VAR,
+    EXP_NODE_OP,
+    EXP_NODE_FUNC,
+    EXP_NODE_STRING
+} ExpNodeType;
+
+typedef struct ExpNode
+{
+    ExpNodeType type;
+    gboolean negate;   /* negated in place by negate_numeric */
+    gboolean shared;   /* already used as an operand */
+    gnc_numeric value; /* EXP_NODE_CONST */
+    char op;           /* EXP_NODE_OP */
+    gchar *name;       /* EXP_NODE_VAR, EXP_NODE_FUNC, EXP_NODE_STRING */
+    struct ExpNode *left, *right; /* EXP_NODE_OP */
+    int argc;          /* EXP_NODE_FUNC */
+    struct ExpNode **argv;
+} ExpNode;
+
+struct GncExpCompiled
+{
+    GHashTable *nodes;    /* owns every node of the expression */
+    GPtrArray *var_nodes; /* EXP_NODE_VARs, one per name, in parser order */
+    ExpNode *root;
+};
+
+/* Compilation state; like the parser itself this isn't reentrant. */
+static GncExpCompiled *compiling           = NULL;
+static gboolean        compile_unsupported = FALSE;
+
 /** Static Globals *************************************************/
 static GHashTable   *variable_bindings = NULL;
+static GHashTable   *compiled_cache    = NULL;
 static ParseError    last_error        = PARSER_NO_ERROR;
 static GNCParseError last_gncp_error   = NO_ERR;
 static gboolean      parser_inited     = FALSE;
@@ -136,6 +174,12 @@ gnc_exp_parser_shutdown (void)
     GKeyFile* key_file;
     gchar *filename;
 
+    if (compiled_cache)
+    {
+        g_hash_table_destroy (compiled_cache);
+        compiled_cache = NULL;
+    }
+
     if (!parser_inited)
         return;
 
@@ -596,6 +640,367 @@ gnc_exp_parser_parse_separate_vars (const char * expression,
     return last_error == PARSER_NO_ERROR;
 }
 
+/* Compiled expressions ******************************************/
+
+static ExpNode *
+exp_node_new (ExpNodeType type)
+{
+    ExpNode *node = g_new0 (ExpNode, 1);
+    node->type = type;
+    g_hash_table_add (compiling->nodes, node);
+    return node;
+}
+
+static void
+exp_node_free (gpointer data)
+{
+    ExpNode *node = data;
+    g_free (node->name);
+    g_free (node->argv);
+    g_free (node);
+}
+
+static void *
+compile_trans_numeric (const char *digit_str,
+                       gchar      *radix_point,
+                       gchar      *group_char,
+                       char      **rstr)
+{
+    ExpNode *node;
+    gnc_numeric value;
+
+    if (digit_str == NULL)
+        return NULL;
+
+    /* The parser initializes a newly seen variable by translating "0"
+     * without asking for the end of the string; that's the only call
+     * with rstr == NULL. The variable's name is filled in once parsing
+     * is complete. */
+    if (rstr == NULL)
+    {
+        node = exp_node_new (EXP_NODE_VAR);
+        g_ptr_array_add (compiling->var_nodes, node);
+        return node;
+    }
+
+    if (!xaccParseAmount (digit_str, TRUE, &value, rstr))
+        return NULL;
+
+    node = exp_node_new (EXP_NODE_CONST);
+    node->value = value;
+    return node;
+}
+
+static void *
+compile_numeric_ops (char op_sym, void *left_value, void *right_value)
+{
+    ExpNode *left = left_value;
+    ExpNode *right = right_value;
+    ExpNode *node;
+
+    if ((left == NULL) || (right == NULL))
+        return NULL;
+
+    /* Assignments mutate variables while parsing; leave those to the
+     * interpreter. */
+    if (op_sym == ASN_OP)
+    {
+        compile_unsupported = TRUE;
+        return left;
+    }
+
+    node = exp_node_new (EXP_NODE_OP);
+    node->op = op_sym;
+    node->left = left;
+    node->right = right;
+    left->shared = right->shared = TRUE;
+    return node;
+}
+
+static void *
+compile_negate_numeric (void *value)
+{
+    ExpNode *node = value;
+
+    if (node == NULL)
+        return NULL;
+
+    /* The interpreter negates in place. That's only equivalent here if
+     * no other operation has already consumed the value. */
+    if (node->shared)
+        compile_unsupported = TRUE;
+    node->negate = !node->negate;
+    return node;
+}
+
+static void
+compile_free_numeric (void *value)
+{
+    /* Nodes belong to the compiled expression; anything else is a
+     * string argument the parser handed over to us. */
+    if (!g_hash_table_contains (compiling->nodes, value))
+        g_free (value);
+}
+
+static void *
+compile_func_op (const char *fname, int argc, void **argv)
+{
+    ExpNode *node = exp_node_new (EXP_NODE_FUNC);
+    int i;
+
+    node->name = g_strdup (fname);
+    node->argc = argc;
+    node->argv = g_new0 (ExpNode*, argc);
+    for (i = 0; i < argc; i++)
+    {
+        var_store *vs = argv[i];
+        if (vs->type == VST_STRING)
+        {
+            node->argv[i] = exp_node_new (EXP_NODE_STRING);
+            node->argv[i]->name = g_strdup (vs->value);
+        }
+        else
+        {
+            node->argv[i] = vs->value;
+            node->argv[i]->shared = TRUE;
+        }
+    }
+    return node;
+}
+
+static void
+gnc_exp_compiled_free (gpointer data)
+{
+    GncExpCompiled *exp = data;
+
+    if (exp == NULL)
+        return;
+    g_hash_table_destroy (exp->nodes);
+    g_ptr_array_free (exp->var_nodes, TRUE);
+    g_free (exp);
+}
+
+static GncExpCompiled *
+compile_expression (const char *expression)
+{
+    GncExpCompiled *exp = g_new0 (GncExpCompiled, 1);
+    parser_env_ptr pe;
+    var_store_ptr named;
+    struct lconv *lc;
+    var_store result = { NULL };
+    char *error_loc;
+    guint i = 0;
+
+    exp->nodes = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                        exp_node_free, NULL);
+    exp->var_nodes = g_ptr_array_new ();
+    compiling = exp;
+    compile_unsupported = FALSE;
+
+    lc = gnc_localeconv ();
+    pe = init_parser (NULL, lc->mon_decimal_point, lc->mon_thousands_sep,
+                      compile_trans_numeric, compile_numeric_ops,
+                      compile_negate_numeric, compile_free_numeric,
+                      compile_func_op);
+
+    error_loc = parse_string (&result, expression, pe);
+    exp->root = result.value;
+    if (error_loc != NULL || exp->root == NULL ||
+        exp->root->type == EXP_NODE_STRING)
+        compile_unsupported = TRUE;
+
+    /* Name the variables, and make sure none was assigned to. */
+    for (named = parser_get_vars (pe); named; named = named->next_var, ++i)
+    {
+        ExpNode *node;
+        if (i >= exp->var_nodes->len)
+        {
+            compile_unsupported = TRUE;
+            break;
+        }
+        node = g_ptr_array_index (exp->var_nodes, i);
+        if (named->value != node)
+            compile_unsupported = TRUE;
+        node->name = g_strdup (named->variable_name);
+    }
+    if (i != exp->var_nodes->len)
+        compile_unsupported = TRUE;
+
+    exit_parser (pe);
+    compiling = NULL;
+
+    if (compile_unsupported)
+    {
+        gnc_exp_compiled_free (exp);
+        return NULL;
+    }
+    return exp;
+}
+
+const GncExpCompiled *
+gnc_exp_parser_compile (const char *expression)
+{
+    gpointer exp;
+
+    if (expression == NULL)
+        return NULL;
+
+    if (compiled_cache == NULL)
+        compiled_cache = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                g_free, gnc_exp_compiled_free);
+
+    if (!g_hash_table_lookup_extended (compiled_cache, expression, NULL, &exp))
+    {
+        exp = compile_expression (expression);
+        /* Remember failures too, so they aren't retried each time. */
+        g_hash_table_insert (compiled_cache, g_strdup (expression), exp);
+    }
+
+    return exp;
+}
+
+static gboolean
+lookup_variable (const char *name, GHashTable *varHash, gnc_numeric *value)
+{
+    gpointer key, val;
+
+    if (varHash && g_hash_table_lookup_extended (varHash, name, &key, &val))
+    {
+        /* Same as make_predefined_vars_from_external_helper */
+        *value = val ? *(gnc_numeric*)val : (gnc_numeric){ 0, 0 };
+        return TRUE;
+    }
+    if (variable_bindings &&
+        (val = g_hash_table_lookup (variable_bindings, name)))
+    {
+        *value = ((ParserNum*)val)->value;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static gboolean
+eval_node (const ExpNode *node, GHashTable *varHash, gnc_numeric *value)
+{
+    gnc_numeric left, right;
+
+    switch (node->type)
+    {
+    case EXP_NODE_CONST:
+        *value = node->value;
+        break;
+    case EXP_NODE_VAR:
+        if (!lookup_variable (node->name, varHash, value))
+            *value = gnc_numeric_zero ();
+        break;
+    case EXP_NODE_OP:
+        if (!eval_node (node->left, varHash, &left) ||
+            !eval_node (node->right, varHash, &right))
+            return FALSE;
+        {
+            ParserNum l = { left }, r = { right };
+            ParserNum *res = numeric_ops (node->op, &l, &r);
+            *value = res->value;
+            g_free (res);
+        }
+        break;
+    case EXP_NODE_FUNC:
+    {
+        var_store *args = g_new0 (var_store, node->argc);
+        ParserNum *nums = g_new0 (ParserNum, node->argc);
+        void **argv = g_new0 (void*, node->argc);
+        gnc_numeric *res = NULL;
+        gboolean ok = TRUE;
+        int i;
+
+        for (i = 0; ok && i < node->argc; i++)
+        {
+            argv[i] = &args[i];
+            if (node->argv[i]->type == EXP_NODE_STRING)
+            {
+                args[i].type = VST_STRING;
+                args[i].value = node->argv[i]->name;
+            }
+            else
+            {
+                args[i].type = VST_NUMERIC;
+                args[i].value = &nums[i];
+                ok = eval_node (node->argv[i], varHash, &nums[i].value);
+            }
+        }
+        if (ok)
+        {
+            res = func_op (node->name, node->argc, argv);
+            if (res)
+                *value = *res;
+            else
+            {
+                last_error = NOT_A_FUNC;
+                ok = FALSE;
+            }
+        }
+        g_free (res);
+        g_free (argv);
+        g_free (nums);
+        g_free (args);
+        if (!ok)
+            return FALSE;
+        break;
+    }
+    case EXP_NODE_STRING:
+        return FALSE;
+    }
+
+    if (node->negate)
+        *value = gnc_numeric_neg (*value);
+    return TRUE;
+}
+
+gboolean
+gnc_exp_parser_eval_compiled (const GncExpCompiled *exp,
+                              gnc_numeric *value_p,
+                              GHashTable *varHash)
+{
+    gnc_numeric value;
+    guint i;
+
+    g_return_val_if_fail (exp != NULL, FALSE);
+
+    if (!parser_inited)
+        gnc_exp_parser_real_init ( (varHash == NULL) );
+
+    if (!eval_node (exp->root, varHash, &value))
+        return FALSE;
+
+    if (gnc_numeric_check (value))
+    {
+        last_error = NUMERIC_ERROR;
+        return FALSE;
+    }
+
+    if (value_p)
+        *value_p = gnc_numeric_reduce (value);
+    last_error = PARSER_NO_ERROR;
+
+    /* Like the interpreter, report variables that weren't defined. */
+    if (varHash != NULL)
+    {
+        for (i = 0; i < exp->var_nodes->len; i++)
+        {
+            ExpNode *node = g_ptr_array_index (exp->var_nodes, i);
+            gnc_numeric *numericValue;
+
+            if (lookup_variable (node->name, varHash, &value))
+                continue;
+            numericValue = g_new0 (gnc_numeric, 1);
+            eval_node (node, varHash, numericValue);
+            g_hash_table_insert (varHash, g_strdup (node->name), numericValue);
+        }
+    }
+
+    return TRUE;
+}
+
 const char *
 gnc_exp_parser_error_string (void)
 {
@@ -85,6 +85,34 @@ gboolean gnc_exp_parser_parse_separate_vars (const char * expression,
         char **error_loc_p,
         GHashTable *varHash );
 
+/** An expression parsed once for repeated evaluation. */
+typedef struct GncExpCompiled GncExpCompiled;
+
+/**
+ * Compile the given expression for repeated evaluation with
+ * gnc_exp_parser_eval_compiled(). Compiled expressions are cached by
+ * expression text until gnc_exp_parser_shutdown(), so this is cheap to
+ * call again for the same expression.
+ *
+ * Expressions which contain syntax errors or assign to variables are
+ * not compiled; use gnc_exp_parser_parse_separate_vars() for those, which
+ * also provides the error location.
+ *
+ * @return The compiled expression, owned by the parser, or NULL.
+ **/
+const GncExpCompiled * gnc_exp_parser_compile (const char *expression);
+
+/**
+ * Evaluate a compiled expression with the given variable bindings.
+ * The result and the contents of varHash afterwards are the same as
+ * gnc_exp_parser_parse_separate_vars() would give for the expression.
+ * On failure gnc_exp_parser_error_string() describes the problem, but
+ * no error location is available.
+ **/
+gboolean gnc_exp_parser_eval_compiled (const GncExpCompiled *exp,
+                                       gnc_numeric *value_p,
+                                       GHashTable *varHash);
+
 /* If the last parse returned FALSE, return an error string describing
  * the problem. Otherwise, return NULL. */
 const char * gnc_exp_parser_error_string (void);
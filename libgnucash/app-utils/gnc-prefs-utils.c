@@ -27,6 +27,7 @@
 #include "gnc-prefs-utils.h"
 #include "gnc-prefs.h"
 #include "xml/gnc-backend-xml.h"
+#include "TransLog.h"
 
 static QofLogModule log_module = G_LOG_DOMAIN;
 
@@ -36,6 +37,11 @@ static QofLogModule log_module = G_LOG_DOMAIN;
 #define GNC_PREF_RETAIN_TYPE_DAYS    "retain-type-days"
 #define GNC_PREF_RETAIN_TYPE_FOREVER "retain-type-forever"
 #define GNC_PREF_RETAIN_DAYS         "retain-days"
+#define GNC_PREF_BINARY_JOURNAL      "binary-journal"
+#define GNC_PREF_JOURNAL_FLUSH       "journal-flush-interval"
+#define GNC_PREF_JOURNAL_ASYNC       "journal-async"
+#define GNC_PREF_JOURNAL_PERIOD      "journal-flush-period"
+#define GNC_PREF_JOURNAL_FSYNC       "journal-fsync-on-save"
 
 /***************************************************************
  * Initialization                                              *
@@ -78,6 +84,22 @@ file_compression_changed_cb(gpointer gsettings, gchar *key, gpointer user_data)
     }
 }
 
+static void
+journal_changed_cb(gpointer gsettings, gchar *key, gpointer user_data)
+{
+    if (gnc_prefs_is_set_up())
+    {
+        gboolean binary = gnc_prefs_get_bool(GNC_PREFS_GROUP_GENERAL, GNC_PREF_BINARY_JOURNAL);
+        gint interval = gnc_prefs_get_int(GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_FLUSH);
+        gint period = gnc_prefs_get_int(GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_PERIOD);
+        xaccLogSetFormat (binary ? XACC_LOG_BINARY : XACC_LOG_TEXT);
+        xaccLogSetFlushInterval (MAX (interval, 1));
+        xaccLogSetFlushPeriod (MAX (period, 0));
+        xaccLogSetFsyncOnClose (gnc_prefs_get_bool(GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_FSYNC));
+        xaccLogSetAsync (gnc_prefs_get_bool(GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_ASYNC));
+    }
+}
+
 
 void gnc_prefs_init (void)
 {
@@ -89,6 +111,7 @@ void gnc_prefs_init (void)
     file_retain_changed_cb (NULL, NULL, NULL);
     file_retain_type_changed_cb (NULL, NULL, NULL);
     file_compression_changed_cb (NULL, NULL, NULL);
+    journal_changed_cb (NULL, NULL, NULL);
 
     /* Check for invalid retain_type (days)/retain_days (0) combo.
      * This can happen either because a user changed the preferences
@@ -122,5 +145,15 @@ void gnc_prefs_init (void)
                            file_retain_type_changed_cb, NULL);
     gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_FILE_COMPRESSION,
                            file_compression_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_BINARY_JOURNAL,
+                           journal_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_FLUSH,
+                           journal_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_ASYNC,
+                           journal_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_PERIOD,
+                           journal_changed_cb, NULL);
+    gnc_prefs_register_cb (GNC_PREFS_GROUP_GENERAL, GNC_PREF_JOURNAL_FSYNC,
+                           journal_changed_cb, NULL);
 
 }
@@ -70,6 +70,7 @@ static void gnc_sx_instance_model_init(GTypeInstance *instance, gpointer klass);
 static GncSxInstanceModel* gnc_sx_instance_model_new(void);
 
 static GncSxInstance* gnc_sx_instance_new(GncSxInstances *parent, GncSxInstanceState state, GDate *date, void *temporal_state, gint sequence_num);
+static void gnc_sx_instance_free(GncSxInstance *instance);
 
 static gint _get_vars_helper(Transaction *txn, void *var_hash_data);
 
@@ -169,6 +170,27 @@ gnc_sx_instance_get_variables_for_parser(GHashTable *instance_var_hash)
     return parser_vars;
 }
 
+/* Evaluate a formula, using the parser's cached compiled form when
+ * there is one. Template formulas don't change between instances, only
+ * the variable bindings do, so this saves re-parsing them for every
+ * instance. Falls back to the interpreter for formulas that can't be
+ * compiled, and to report errors with their location. */
+static gboolean
+_gnc_sx_eval_formula(const char *formula, gnc_numeric *result,
+                     char **error_loc, GHashTable *parser_vars)
+{
+    const GncExpCompiled *compiled = gnc_exp_parser_compile(formula);
+    if (compiled != NULL &&
+        gnc_exp_parser_eval_compiled(compiled, result, parser_vars))
+    {
+        if (error_loc != NULL)
+            *error_loc = NULL;
+        return TRUE;
+    }
+    return gnc_exp_parser_parse_separate_vars(formula, result, error_loc,
+                                              parser_vars);
+}
+
 int
 gnc_sx_parse_vars_from_formula(const char *formula,
                                GHashTable *var_hash,
@@ -183,7 +205,7 @@ gnc_sx_parse_vars_from_formula(const char *formula,
     parser_vars = gnc_sx_instance_get_variables_for_parser(var_hash);
 
     num = gnc_numeric_zero();
-    if (!gnc_exp_parser_parse_separate_vars(formula, &num, &errLoc, parser_vars))
+    if (!_gnc_sx_eval_formula(formula, &num, &errLoc, parser_vars))
     {
         toRet = -1;
     }
@@ -411,18 +433,54 @@ gnc_sx_instance_get_variables(GncSxInstance *inst)
     return vars;
 }
 
-static GncSxInstances*
-_gnc_sx_gen_instances(gpointer *data, gpointer user_data)
+/* Adds the instance for the next date in the schedule to the (reversed)
+ * instance list. While the dates in @a reuse agree with the schedule
+ * its instances are taken over instead of being regenerated; from the
+ * first disagreement on the rest of @a reuse is freed. */
+static void
+_gnc_sx_instances_add(GncSxInstances *instances, GList **reuse, guint *reused,
+                      GncSxInstanceState state, GDate *date,
+                      void *temporal_state, gint sequence_num)
 {
-    GncSxInstances *instances = g_new0(GncSxInstances, 1);
-    SchedXaction *sx = (SchedXaction*)data;
-    const GDate *range_end = (const GDate*)user_data;
+    GncSxInstance *inst = NULL;
+
+    if (*reuse != NULL)
+    {
+        GncSxInstance *existing = (GncSxInstance*)(*reuse)->data;
+        if (g_date_compare(&existing->date, date) == 0)
+        {
+            inst = existing;
+            *reuse = g_list_delete_link(*reuse, *reuse);
+            (*reused)++;
+        }
+        else
+        {
+            g_list_free_full(*reuse, (GDestroyNotify)gnc_sx_instance_free);
+            *reuse = NULL;
+        }
+    }
+
+    if (inst == NULL)
+        inst = gnc_sx_instance_new(instances, state, date, temporal_state,
+                                   sequence_num);
+    instances->instance_list = g_list_prepend(instances->instance_list, inst);
+}
+
+/* Fills instances->instance_list with the instances of instances->sx up
+ * to range_end, taking over the leading instances in @a reuse which are
+ * still valid. @a reuse is consumed.
+ * @return the number of instances taken over from @a reuse; they are at
+ * the head of the instance list. */
+static guint
+_gnc_sx_instances_fill(GncSxInstances *instances, const GDate *range_end,
+                       GList *reuse)
+{
+    SchedXaction *sx = instances->sx;
+    guint reused = 0;
     GDate creation_end, remind_end;
     GDate cur_date;
     SXTmpStateData *temporal_state = gnc_sx_create_temporal_state(sx);
 
-    instances->sx = sx;
-
     creation_end = *range_end;
     g_date_add_days(&creation_end, xaccSchedXactionGetAdvanceCreation(sx));
     remind_end = creation_end;
@@ -435,15 +493,13 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
         {
             GDate inst_date;
             int seq_num;
-            GncSxInstance *inst;
 
             g_date_clear(&inst_date, 1);
             inst_date = xaccSchedXactionGetNextInstance(sx, postponed->data);
             seq_num = gnc_sx_get_instance_count(sx, postponed->data);
-            inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_POSTPONED,
-                                       &inst_date, postponed->data, seq_num);
-            instances->instance_list =
-                g_list_append(instances->instance_list, inst);
+            _gnc_sx_instances_add(instances, &reuse, &reused,
+                                  SX_INSTANCE_STATE_POSTPONED,
+                                  &inst_date, postponed->data, seq_num);
             gnc_sx_destroy_temporal_state(temporal_state);
             temporal_state = gnc_sx_clone_temporal_state(postponed->data);
             gnc_sx_incr_temporal_state(sx, temporal_state);
@@ -456,12 +512,10 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
     instances->next_instance_date = cur_date;
     while (g_date_valid(&cur_date) && g_date_compare(&cur_date, &creation_end) <= 0)
     {
-        GncSxInstance *inst;
         int seq_num;
         seq_num = gnc_sx_get_instance_count(sx, temporal_state);
-        inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_TO_CREATE,
-                                   &cur_date, temporal_state, seq_num);
-        instances->instance_list = g_list_append(instances->instance_list, inst);
+        _gnc_sx_instances_add(instances, &reuse, &reused, SX_INSTANCE_STATE_TO_CREATE,
+                              &cur_date, temporal_state, seq_num);
         gnc_sx_incr_temporal_state(sx, temporal_state);
         cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
     }
@@ -470,20 +524,78 @@ _gnc_sx_gen_instances(gpointer *data, gpointer user_data)
     while (g_date_valid(&cur_date) &&
            g_date_compare(&cur_date, &remind_end) <= 0)
     {
-        GncSxInstance *inst;
         int seq_num;
         seq_num = gnc_sx_get_instance_count(sx, temporal_state);
-        inst = gnc_sx_instance_new(instances, SX_INSTANCE_STATE_REMINDER,
-                                   &cur_date, temporal_state, seq_num);
-        instances->instance_list = g_list_append(instances->instance_list,
-                                                 inst);
+        _gnc_sx_instances_add(instances, &reuse, &reused, SX_INSTANCE_STATE_REMINDER,
+                              &cur_date, temporal_state, seq_num);
         gnc_sx_incr_temporal_state(sx, temporal_state);
         cur_date = xaccSchedXactionGetNextInstance(sx, temporal_state);
     }
 
+    instances->instance_list = g_list_reverse(instances->instance_list);
+    g_list_free_full(reuse, (GDestroyNotify)gnc_sx_instance_free);
+    gnc_sx_destroy_temporal_state(temporal_state);
+    return reused;
+}
+
+static GncSxInstances*
+_gnc_sx_gen_instances(gpointer *data, gpointer user_data)
+{
+    GncSxInstances *instances = g_new0(GncSxInstances, 1);
+    const GDate *range_end = (const GDate*)user_data;
+
+    instances->sx = (SchedXaction*)data;
+    _gnc_sx_instances_fill(instances, range_end, NULL);
     return instances;
 }
 
+static void
+_gnc_sx_instance_model_append(GncSxInstanceModel *model, GncSxInstances *instances)
+{
+    GList *link = g_list_alloc();
+
+    link->data = instances;
+    link->prev = model->sx_instance_list_tail;
+    if (model->sx_instance_list_tail != NULL)
+        model->sx_instance_list_tail->next = link;
+    else
+        model->sx_instance_list = link;
+    model->sx_instance_list_tail = link;
+
+    g_hash_table_insert(model->sx_instance_index,
+                        guid_copy(xaccSchedXactionGetGUID(instances->sx)),
+                        link);
+}
+
+static GList*
+_gnc_sx_instance_model_find_link(GncSxInstanceModel *model, const SchedXaction *sx)
+{
+    GList *link = g_hash_table_lookup(model->sx_instance_index,
+                                      xaccSchedXactionGetGUID(sx));
+    if (link != NULL && ((GncSxInstances*)link->data)->sx != sx)
+        return NULL;
+    return link;
+}
+
+static void
+_gnc_sx_instance_model_remove_link(GncSxInstanceModel *model, GList *link)
+{
+    GncSxInstances *instances = (GncSxInstances*)link->data;
+
+    g_hash_table_remove(model->sx_instance_index,
+                        xaccSchedXactionGetGUID(instances->sx));
+    if (link == model->sx_instance_list_tail)
+        model->sx_instance_list_tail = link->prev;
+    model->sx_instance_list = g_list_remove_link(model->sx_instance_list, link);
+}
+
+GncSxInstances*
+gnc_sx_instance_model_lookup_sx_instances(GncSxInstanceModel *model, const SchedXaction *sx)
+{
+    GList *link = _gnc_sx_instance_model_find_link(model, sx);
+    return link ? (GncSxInstances*)link->data : NULL;
+}
+
 GncSxInstanceModel*
 gnc_sx_get_current_instances(void)
 {
@@ -506,25 +618,18 @@ gnc_sx_get_instances(const GDate *range_end, gboolean include_disabled)
     instances->include_disabled = include_disabled;
     instances->range_end = *range_end;
 
-    if (include_disabled)
-    {
-        instances->sx_instance_list = gnc_g_list_map(all_sxes, (GncGMapFunc)_gnc_sx_gen_instances, (gpointer)range_end);
-    }
-    else
     {
         GList *sx_iter = g_list_first(all_sxes);
-        GList *enabled_sxes = NULL;
 
         for (; sx_iter != NULL; sx_iter = sx_iter->next)
         {
             SchedXaction *sx = (SchedXaction*)sx_iter->data;
-            if (xaccSchedXactionGetEnabled(sx))
+            if (include_disabled || xaccSchedXactionGetEnabled(sx))
             {
-                enabled_sxes = g_list_append(enabled_sxes, sx);
+                _gnc_sx_instance_model_append(instances,
+                                              _gnc_sx_gen_instances((gpointer)sx, (gpointer)range_end));
             }
         }
-        instances->sx_instance_list = gnc_g_list_map(enabled_sxes, (GncGMapFunc)_gnc_sx_gen_instances, (gpointer)range_end);
-        g_list_free(enabled_sxes);
     }
 
     return instances;
@@ -629,6 +734,9 @@ gnc_sx_instance_model_finalize (GObject *object)
     }
     g_list_free(model->sx_instance_list);
     model->sx_instance_list = NULL;
+    model->sx_instance_list_tail = NULL;
+    g_hash_table_destroy(model->sx_instance_index);
+    model->sx_instance_index = NULL;
 
     G_OBJECT_CLASS(parent_class)->finalize(object);
 }
@@ -687,17 +795,13 @@ gnc_sx_instance_model_init(GTypeInstance *instance, gpointer klass)
 
     g_date_clear(&inst->range_end, 1);
     inst->sx_instance_list = NULL;
+    inst->sx_instance_list_tail = NULL;
+    inst->sx_instance_index = g_hash_table_new_full(guid_hash_to_guint,
+                                                    guid_g_hash_table_equal,
+                                                    guid_free, NULL);
     inst->qof_event_handler_id = qof_event_register_handler(_gnc_sx_instance_event_handler, inst);
 }
 
-static gint
-_gnc_sx_instance_find_by_sx(GncSxInstances *in_list_instances, SchedXaction *sx_to_find)
-{
-    if (in_list_instances->sx == sx_to_find)
-        return 0;
-    return -1;
-}
-
 static void
 _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer user_data, gpointer evt_data)
 {
@@ -718,7 +822,7 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
 
         sx = GNC_SX(ent);
         // only send `updated` if it's actually in the model
-        sx_is_in_model = (g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx) != NULL);
+        sx_is_in_model = (_gnc_sx_instance_model_find_link(instances, sx) != NULL);
         if (event_type & QOF_EVENT_MODIFY)
         {
             if (sx_is_in_model)
@@ -740,9 +844,8 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
                 if (g_list_find(all_sxes, sx) && (!instances->include_disabled && xaccSchedXactionGetEnabled(sx)))
                 {
                     /* it's moved from disabled to enabled, add the instances */
-                    instances->sx_instance_list
-                        = g_list_append(instances->sx_instance_list,
-                                        _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+                    _gnc_sx_instance_model_append(instances,
+                                                  _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
                     g_signal_emit_by_name(instances, "added", (gpointer)sx);
                 }
             }
@@ -756,7 +859,7 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
         if (event_type & GNC_EVENT_ITEM_REMOVED)
         {
             GList *instances_link;
-            instances_link = g_list_find_custom(instances->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
+            instances_link = _gnc_sx_instance_model_find_link(instances, sx);
             if (instances_link != NULL)
             {
                 g_signal_emit_by_name(instances, "removing", (gpointer)sx);
@@ -771,9 +874,8 @@ _gnc_sx_instance_event_handler(QofInstance *ent, QofEventId event_type, gpointer
             if (instances->include_disabled || xaccSchedXactionGetEnabled(sx))
             {
                 /* generate instances, add to instance list, emit update. */
-                instances->sx_instance_list
-                    = g_list_append(instances->sx_instance_list,
-                                    _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
+                _gnc_sx_instance_model_append(instances,
+                                              _gnc_sx_gen_instances((gpointer)sx, (gpointer) & instances->range_end));
                 g_signal_emit_by_name(instances, "added", (gpointer)sx);
             }
         }
@@ -803,101 +905,62 @@ _find_unreferenced_vars(gchar *key,
 void
 gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXaction *sx)
 {
-    GncSxInstances *existing, *new_instances;
-    GList *link;
+    GncSxInstances *existing;
+    GHashTable *old_names, *new_names;
+    GList *link, *reuse;
+    GList *removed_var_names = NULL, *added_var_names = NULL;
+    guint reused;
 
-    link = g_list_find_custom(model->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
+    link = _gnc_sx_instance_model_find_link(model, sx);
     if (link == NULL)
     {
         g_critical("couldn't find sx [%p]\n", sx);
         return;
     }
-
-    // merge the new instance data into the existing structure, mutating as little as possible.
     existing = (GncSxInstances*)link->data;
-    new_instances = _gnc_sx_gen_instances((gpointer)sx, &model->range_end);
-    existing->sx = new_instances->sx;
-    existing->next_instance_date = new_instances->next_instance_date;
-    {
-        GList *existing_iter, *new_iter;
-        gboolean existing_remain, new_remain;
-
-        // step through the lists pairwise, and retain the existing
-        // instance if the dates align, as soon as they don't stop and
-        // cleanup.
-        existing_iter = existing->instance_list;
-        new_iter = new_instances->instance_list;
-        for (; existing_iter != NULL && new_iter != NULL; existing_iter = existing_iter->next, new_iter = new_iter->next)
-        {
-            GncSxInstance *existing_inst, *new_inst;
-            gboolean same_instance_date;
-            existing_inst = (GncSxInstance*)existing_iter->data;
-            new_inst = (GncSxInstance*)new_iter->data;
-
-            same_instance_date = g_date_compare(&existing_inst->date, &new_inst->date) == 0;
-            if (!same_instance_date)
-                break;
-        }
-
-        existing_remain = (existing_iter != NULL);
-        new_remain = (new_iter != NULL);
-
-        if (existing_remain)
-        {
-            // delete excess
-            gnc_g_list_cut(&existing->instance_list, existing_iter);
-            g_list_foreach(existing_iter, (GFunc)gnc_sx_instance_free, NULL);
-        }
 
-        if (new_remain)
-        {
-            // append new
-            GList *new_iter_iter;
-            gnc_g_list_cut(&new_instances->instance_list, new_iter);
+    // parse the new variable names up front, so that only the instances
+    // generated past the first changed date need to be built from them.
+    new_names = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)gnc_sx_variable_free);
+    gnc_sx_get_variables(sx, new_names);
+    g_hash_table_foreach(new_names, (GHFunc)_wipe_parsed_sx_var, NULL);
 
-            for (new_iter_iter = new_iter; new_iter_iter != NULL; new_iter_iter = new_iter_iter->next)
-            {
-                GncSxInstance *inst = (GncSxInstance*)new_iter_iter->data;
-                inst->parent = existing;
-                existing->instance_list = g_list_append(existing->instance_list, new_iter_iter->data);
-            }
-            g_list_free(new_iter);
-        }
+    old_names = existing->variable_names;
+    if (old_names != NULL)
+    {
+        HashListPair removed_cb_data;
+        removed_cb_data.hash = new_names;
+        removed_cb_data.list = NULL;
+        g_hash_table_foreach(old_names, (GHFunc)_find_unreferenced_vars, &removed_cb_data);
+        removed_var_names = removed_cb_data.list;
     }
+    g_debug("%d removed variables", g_list_length(removed_var_names));
 
-    // handle variables
     {
-        GList *removed_var_names = NULL, *added_var_names = NULL;
-        GList *inst_iter = NULL;
+        HashListPair added_cb_data;
+        added_cb_data.hash = old_names;
+        added_cb_data.list = NULL;
+        g_hash_table_foreach(new_names, (GHFunc)_find_unreferenced_vars, &added_cb_data);
+        added_var_names = added_cb_data.list;
+    }
+    g_debug("%d added variables", g_list_length(added_var_names));
 
-        if (existing->variable_names != NULL)
-        {
-            HashListPair removed_cb_data;
-            removed_cb_data.hash = new_instances->variable_names;
-            removed_cb_data.list = NULL;
-            g_hash_table_foreach(existing->variable_names, (GHFunc)_find_unreferenced_vars, &removed_cb_data);
-            removed_var_names = removed_cb_data.list;
-        }
-        g_debug("%d removed variables", g_list_length(removed_var_names));
+    existing->variable_names = new_names;
+    existing->variable_names_parsed = TRUE;
 
-        if (new_instances->variable_names != NULL)
-        {
-            HashListPair added_cb_data;
-            added_cb_data.hash = existing->variable_names;
-            added_cb_data.list = NULL;
-            g_hash_table_foreach(new_instances->variable_names, (GHFunc)_find_unreferenced_vars, &added_cb_data);
-            added_var_names = added_cb_data.list;
-        }
-        g_debug("%d added variables", g_list_length(added_var_names));
+    // regenerate in place: the existing instances are retained while
+    // their dates align with the schedule, the rest are replaced.
+    reuse = existing->instance_list;
+    existing->instance_list = NULL;
+    reused = _gnc_sx_instances_fill(existing, &model->range_end, reuse);
 
-        if (existing->variable_names != NULL)
-        {
-            g_hash_table_destroy(existing->variable_names);
-        }
-        existing->variable_names = new_instances->variable_names;
-        new_instances->variable_names = NULL;
+    // handle variables of the retained instances
+    if (removed_var_names != NULL || added_var_names != NULL)
+    {
+        GList *inst_iter = existing->instance_list;
+        guint i;
 
-        for (inst_iter = existing->instance_list; inst_iter != NULL; inst_iter = inst_iter->next)
+        for (i = 0; i < reused; i++, inst_iter = inst_iter->next)
         {
             GList *var_iter;
             GncSxInstance *inst = (GncSxInstance*)inst_iter->data;
@@ -925,7 +988,11 @@ gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXactio
             }
         }
     }
-    gnc_sx_instances_free(new_instances);
+
+    g_list_free(removed_var_names);
+    g_list_free(added_var_names);
+    if (old_names != NULL)
+        g_hash_table_destroy(old_names);
 }
 
 void
@@ -933,15 +1000,16 @@ gnc_sx_instance_model_remove_sx_instances(GncSxInstanceModel *model, SchedXactio
 {
     GList *instance_link = NULL;
 
-    instance_link = g_list_find_custom(model->sx_instance_list, sx, (GCompareFunc)_gnc_sx_instance_find_by_sx);
+    instance_link = _gnc_sx_instance_model_find_link(model, sx);
     if (instance_link == NULL)
     {
         g_warning("instance not found!\n");
         return;
     }
 
-    model->sx_instance_list = g_list_remove_link(model->sx_instance_list, instance_link);
+    _gnc_sx_instance_model_remove_link(model, instance_link);
     gnc_sx_instances_free((GncSxInstances*)instance_link->data);
+    g_list_free_1(instance_link);
 }
 
 static void
@@ -1034,10 +1102,10 @@ _get_sx_formula_value(const SchedXaction* sx,
         {
             parser_vars = gnc_sx_instance_get_variables_for_parser(variable_bindings);
         }
-        if (!gnc_exp_parser_parse_separate_vars(formula_str,
-                                                numeric,
-                                                &parseErrorLoc,
-                                                parser_vars))
+        if (!_gnc_sx_eval_formula(formula_str,
+                                  numeric,
+                                  &parseErrorLoc,
+                                  parser_vars))
         {
             gchar *err = N_("Error parsing SX [%s] key [%s]=formula [%s] at [%s]: %s.");
             REPORT_ERROR(creation_errors, err,
@@ -1349,13 +1417,16 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
                                     GList **creation_errors)
 {
     GList *iter;
+    QofBook *book = gnc_get_current_book();
 
-    if (qof_book_is_readonly(gnc_get_current_book()))
+    if (qof_book_is_readonly(book))
     {
         /* Is the book read-only? Then don't change anything here. */
         return;
     }
 
+    /* Sort and rebalance the accounts once all the transactions are in */
+    qof_book_begin_bulk_edit(book);
     for (iter = model->sx_instance_list; iter != NULL; iter = iter->next)
     {
         GList *instance_iter;
@@ -1445,6 +1516,7 @@ gnc_sx_instance_model_effect_change(GncSxInstanceModel *model,
         gnc_sx_set_instance_count(instances->sx, instance_count);
         xaccSchedXactionSetRemOccur(instances->sx, remain_occur_count);
     }
+    qof_book_end_bulk_edit(book);
 }
 
 void
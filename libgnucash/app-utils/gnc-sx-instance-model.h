@@ -48,6 +48,8 @@ typedef struct _GncSxInstanceModel
 
     /* private */
     gint qof_event_handler_id;
+    GHashTable *sx_instance_index; /* <GncGUID*,GList*>: SX guid -> link in sx_instance_list */
+    GList *sx_instance_list_tail;
 
     /* signals */
     /* void (*added)(SchedXaction *sx); // gpointer user_data */
@@ -136,6 +138,10 @@ GncSxInstanceModel* gnc_sx_get_instances(const GDate *range_end, gboolean includ
 void gnc_sx_instance_model_update_sx_instances(GncSxInstanceModel *model, SchedXaction *sx);
 void gnc_sx_instance_model_remove_sx_instances(GncSxInstanceModel *model, SchedXaction *sx);
 
+/** @return the GncSxInstances for the given SX, or NULL if the SX isn't
+ * in the model. */
+GncSxInstances* gnc_sx_instance_model_lookup_sx_instances(GncSxInstanceModel *model, const SchedXaction *sx);
+
 /** Fix up numerics where they've gotten out-of-sync with the formulas.
  *
  * Ideally this would be done at load time, but it requires gnc_exp_parser to
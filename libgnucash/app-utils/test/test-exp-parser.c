@@ -116,11 +116,31 @@ run_parser_test (TestNode *node)
 
     if (succeeded)
     {
+        const GncExpCompiled *compiled;
+
         if (!gnc_numeric_equal (result, node->expected_result))
         {
             failure_args (node->test_name, node->file, node->line, "wrong result");
             return;
         }
+
+        /* The compiled form, if there is one, must agree. */
+        compiled = gnc_exp_parser_compile (node->exp);
+        if (compiled)
+        {
+            GHashTable *vars = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                      g_free, g_free);
+            result = gnc_numeric_error (-1);
+            if (!gnc_exp_parser_eval_compiled (compiled, &result, vars) ||
+                !gnc_numeric_equal (result, node->expected_result))
+            {
+                failure_args (node->test_name, node->file, node->line,
+                              "wrong compiled result");
+                g_hash_table_destroy (vars);
+                return;
+            }
+            g_hash_table_destroy (vars);
+        }
     }
     else if (node->expected_error_offset != -1)
     {
@@ -246,12 +266,51 @@ test_variable_expressions()
     success("variable found");
 }
 
+static void
+test_compiled_expressions()
+{
+    gnc_numeric num, *a_value, *b_value;
+    const GncExpCompiled *compiled, *again;
+    GHashTable *vars = g_hash_table_new_full(g_str_hash, g_str_equal,
+                                             g_free, g_free);
+
+    compiled = gnc_exp_parser_compile("123 + a * -b");
+    do_test(compiled != NULL, "compiling");
+    again = gnc_exp_parser_compile("123 + a * -b");
+    do_test(compiled == again, "compiled expressions are cached");
+
+    do_test(gnc_exp_parser_eval_compiled(compiled, &num, vars), "evaluating");
+    do_test(g_hash_table_size(vars) == 2, "'a' and 'b' are the variables");
+    do_test(gnc_numeric_equal(num, gnc_numeric_create(123, 1)),
+            "undefined variables are zero");
+
+    a_value = g_new(gnc_numeric, 1);
+    *a_value = gnc_numeric_create(7, 1);
+    b_value = g_new(gnc_numeric, 1);
+    *b_value = gnc_numeric_create(7, 1);
+    g_hash_table_replace(vars, g_strdup("a"), a_value);
+    g_hash_table_replace(vars, g_strdup("b"), b_value);
+    do_test(gnc_exp_parser_eval_compiled(compiled, &num, vars),
+            "evaluating with bindings");
+    do_test(gnc_numeric_equal(num, gnc_numeric_create(74, 1)),
+            "bindings are used");
+    g_hash_table_destroy(vars);
+
+    do_test(gnc_exp_parser_compile("a = 2") == NULL,
+            "assignments are not compiled");
+    do_test(gnc_exp_parser_compile("1 +") == NULL,
+            "syntax errors are not compiled");
+    gnc_exp_parser_shutdown ();
+    success("compiled expressions");
+}
+
 static void
 real_main (void *closure, int argc, char **argv)
 {
     /* set_should_print_success (TRUE); */
     test_parser();
     test_variable_expressions();
+    test_compiled_expressions();
     print_test_results();
     exit(get_rv());
 }
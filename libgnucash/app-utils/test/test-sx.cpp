@@ -213,6 +213,55 @@ test_state_changes()
     remove_sx(foo);
 }
 
+static void
+test_update_keeps_aligned_instances()
+{
+    SchedXaction *foo;
+    GDate *start, *end;
+    GncSxInstanceModel *model;
+    GncSxInstances *insts;
+    GncSxInstance *first, *second;
+
+    start = g_date_new();
+    gnc_gdate_set_today (start);
+
+    end = g_date_new();
+    gnc_gdate_set_today (end);
+    g_date_add_days(end, 3);
+
+    foo = add_daily_sx("foo", start, NULL, NULL);
+    model = gnc_sx_get_instances(end, TRUE);
+
+    insts = gnc_sx_instance_model_lookup_sx_instances(model, foo);
+    do_test(insts != NULL, "sx found by lookup");
+    do_test(insts == (GncSxInstances*)model->sx_instance_list->data, "lookup agrees with list");
+    do_test(g_list_length(insts->instance_list) == 4, "4 instances");
+    first = _nth_instance(insts, 0);
+    second = _nth_instance(insts, 1);
+
+    // ending the sx after the second instance keeps the first two.
+    {
+        GDate *sx_end = g_date_new();
+        gnc_gdate_set_today (sx_end);
+        g_date_add_days(sx_end, 1);
+        xaccSchedXactionSetEndDate(foo, sx_end);
+        g_date_free(sx_end);
+    }
+    gnc_sx_instance_model_update_sx_instances(model, foo);
+    do_test(g_list_length(insts->instance_list) == 2, "2 instances after update");
+    do_test(_nth_instance(insts, 0) == first, "first instance retained");
+    do_test(_nth_instance(insts, 1) == second, "second instance retained");
+
+    gnc_sx_instance_model_remove_sx_instances(model, foo);
+    do_test(gnc_sx_instance_model_lookup_sx_instances(model, foo) == NULL, "sx no longer found");
+    do_test(model->sx_instance_list == NULL, "instance list is empty");
+
+    g_object_unref(model);
+    remove_sx(foo);
+    g_date_free(start);
+    g_date_free(end);
+}
+
 int
 main(int argc, char **argv)
 {
@@ -228,6 +277,7 @@ main(int argc, char **argv)
     }
     test_basic();
     test_state_changes();
+    test_update_keeps_aligned_instances();
 
     print_test_results();
     exit(get_rv());
@@ -652,11 +652,11 @@ gnc_sql_slots_save (GncSqlBackend* sql_be, const GncGUID* guid, gboolean is_infa
 {
     slot_info_t slot_info = { NULL, NULL, TRUE, NULL, KvpValue::Type::INVALID,
                               NULL, FRAME, NULL, "" };
-    KvpFrame* pFrame = qof_instance_get_slots (inst);
+    KvpFrame* pFrame;
 
     g_return_val_if_fail (sql_be != NULL, FALSE);
     g_return_val_if_fail (guid != NULL, FALSE);
-    g_return_val_if_fail (pFrame != NULL, FALSE);
+    g_return_val_if_fail (inst != NULL, FALSE);
 
     // If this is not saving into a new db, clear out the old saved slots first
     if (!sql_be->pristine() && !is_infant)
@@ -664,6 +664,11 @@ gnc_sql_slots_save (GncSqlBackend* sql_be, const GncGUID* guid, gboolean is_infa
         (void)gnc_sql_slots_delete (sql_be, guid);
     }
 
+    // Don't make a frame for an instance that never had any slots
+    if (!qof_instance_has_kvp (inst))
+        return TRUE;
+    pFrame = qof_instance_get_slots (inst);
+
     slot_info.be = sql_be;
     slot_info.guid = guid;
     pFrame->for_each_slot_temp (save_slot, slot_info);
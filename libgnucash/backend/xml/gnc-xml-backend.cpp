@@ -801,7 +801,8 @@ GncXmlBackend::remove_old_files ()
         if (! (g_str_has_suffix (dent, ".LNK") ||
                g_str_has_suffix (dent, ".xac") /* old data file extension */ ||
                g_str_has_suffix (dent, GNC_DATAFILE_EXT) ||
-               g_str_has_suffix (dent, GNC_LOGFILE_EXT)))
+               g_str_has_suffix (dent, GNC_LOGFILE_EXT) ||
+               g_str_has_suffix (dent, GNC_JOURNALFILE_EXT)))
             continue;
 
         name = g_build_filename (m_dirname.c_str(), dent, (gchar*)NULL);
@@ -841,6 +842,7 @@ GncXmlBackend::remove_old_files ()
          * <fullpath/to/datafile><anything>.gnucash
          * <fullpath/to/datafile><anything>.xac
          * <fullpath/to/datafile><anything>.log
+         * <fullpath/to/datafile><anything>.jnl
          *
          * To be a file generated by GnuCash, the <anything> part should consist
          * of 1 dot followed by 14 digits (0 to 9). Let's test this with a
@@ -852,8 +854,9 @@ GncXmlBackend::remove_old_files ()
              * be safe */
             regex_t pattern;
             gchar* stamp_start = name + strlen (m_fullpath.c_str());
-            gchar* expression = g_strdup_printf ("^\\.[[:digit:]]{14}(\\%s|\\%s|\\.xac)$",
-                                                 GNC_DATAFILE_EXT, GNC_LOGFILE_EXT);
+            gchar* expression = g_strdup_printf ("^\\.[[:digit:]]{14}(\\%s|\\%s|\\%s|\\.xac)$",
+                                                 GNC_DATAFILE_EXT, GNC_LOGFILE_EXT,
+                                                 GNC_JOURNALFILE_EXT);
             gboolean got_date_stamp = FALSE;
 
             if (regcomp (&pattern, expression, REG_EXTENDED | REG_ICASE) != 0)
@@ -328,9 +328,10 @@ qof_instance_slots_to_dom_tree (const char* tag, const QofInstance* inst)
     xmlNodePtr ret;
     const char** keys;
     unsigned int i;
-    KvpFrame* frame = qof_instance_get_slots (inst);
-    if (!frame || frame->empty())
+    /* Don't make a frame for an instance that never had any slots */
+    if (!qof_instance_has_kvp (const_cast<QofInstance*> (inst)))
         return nullptr;
+    KvpFrame* frame = qof_instance_get_slots (inst);
 
     ret = xmlNewNode (nullptr, BAD_CAST tag);
     frame->for_each_slot_temp (&add_kvp_slot, ret);
@@ -0,0 +1,952 @@
+/********************************************************************\
+ * gnc-bench.cpp -- Engine and backend benchmarks on synthetic books *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/* gnc-bench times the operations that dominate work on a large book:
+ * adding splits, computing balances, running queries, looking up
+ * prices, loading and saving, Bayesian import matching and reading QIF
+ * files.
+ *
+ * Every book is generated from a seed, so two runs with the same
+ * --seed and --size work on identical data and their results can be
+ * compared. Build it with "make gnc-bench"; it isn't part of the
+ * default build. Run "gnc-bench --help" for the options.
+ */
+
+extern "C"
+{
+#include <config.h>
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "qof.h"
+#include "Account.h"
+#include "Query.h"
+#include "Split.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "cashobjects.h"
+#include "gnc-commodity.h"
+#include "gnc-pricedb.h"
+}
+
+#include <libguile.h>
+
+#include "gnc-backend-xml.h"
+#include "gnc-qif-reader.hpp"
+#ifdef HAVE_DBI_BACKEND
+#include "gnc-backend-dbi.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const time64 day_secs = 24 * 60 * 60;
+/* Transactions and prices are spread over ten years. */
+const unsigned span_days = 3650;
+const unsigned n_banks = 10;
+const unsigned n_incomes = 10;
+const unsigned n_expenses = 60;
+const unsigned n_payees = 200;
+const unsigned n_places = 20;
+/* Each stock has at most one price a day. */
+const size_t min_stocks = 20;
+const size_t lookups = 10000;
+const size_t max_bayes_training = 10000;
+
+/* The books are not made with test-engine-stuff, whose random books
+ * come from rand() and so differ between C libraries. std::mt19937_64's
+ * output is fixed by the standard, unlike that of the standard
+ * distributions, so a seed gives the same book everywhere. */
+class BenchRandom
+{
+public:
+    explicit BenchRandom (uint64_t seed) : m_engine (seed) {}
+    uint64_t below (uint64_t n) { return m_engine () % n; }
+private:
+    std::mt19937_64 m_engine;
+};
+
+struct BenchBook
+{
+    QofSession *session = nullptr;
+    QofBook *book = nullptr;
+    gnc_commodity *currency = nullptr;
+    std::vector<Account*> banks;
+    /* Indexed by payee; incomes first, then expenses. */
+    std::vector<Account*> payees;
+    std::vector<gnc_commodity*> stocks;
+    time64 start = 0;
+};
+
+struct Fixture
+{
+    Fixture (size_t splits, uint64_t s, const gchar *d) :
+        n_splits (splits), seed (s), dir (d) {}
+    size_t n_splits;
+    uint64_t seed;
+    const gchar *dir;
+    BenchBook data;
+    /* The book a benchmark builds or loads for itself. */
+    BenchBook scratch;
+    QofSession *loaded = nullptr;
+    std::string xml_uri;
+    std::string sqlite_uri;
+    std::string qif_file;
+    bool xml_saved = false;
+    bool sqlite_saved = false;
+    bool qif_written = false;
+    bool bayes_trained = false;
+    /* Token lists of the descriptions bayes-match looks up. */
+    std::vector<GList*> bayes_queries;
+};
+
+struct Benchmark
+{
+    const char *name;
+    /* Untimed, before each repetition. */
+    std::function<void(Fixture&)> setup;
+    /* The timed part; returns the number of items it handled. */
+    std::function<size_t(Fixture&)> run;
+    /* Untimed, after each repetition. */
+    std::function<void(Fixture&)> teardown;
+};
+
+struct Result
+{
+    std::string name;
+    size_t n_splits;
+    size_t items;
+    std::vector<double> seconds;
+};
+
+Account *
+make_account (BenchBook& bb, Account *parent, const char *name,
+              GNCAccountType type)
+{
+    auto acc = xaccMallocAccount (bb.book);
+    xaccAccountBeginEdit (acc);
+    xaccAccountSetName (acc, name);
+    xaccAccountSetType (acc, type);
+    xaccAccountSetCommodity (acc, bb.currency);
+    gnc_account_append_child (parent, acc);
+    xaccAccountCommitEdit (acc);
+    return acc;
+}
+
+void
+make_accounts (BenchBook& bb, Account *parent, const char *prefix,
+               unsigned n, GNCAccountType type, std::vector<Account*>& accounts)
+{
+    for (unsigned i = 0; i < n; i++)
+    {
+        auto name = g_strdup_printf ("%s %02u", prefix, i);
+        accounts.push_back (make_account (bb, parent, name, type));
+        g_free (name);
+    }
+}
+
+void
+new_book (BenchBook& bb)
+{
+    bb.session = qof_session_new ();
+    bb.book = qof_session_get_book (bb.session);
+    bb.currency = gnc_commodity_table_lookup (gnc_commodity_table_get_table (bb.book),
+                                              GNC_COMMODITY_NS_CURRENCY, "USD");
+    bb.start = gnc_dmy2time64_neutral (1, 1, 2010);
+
+    auto root = gnc_book_get_root_account (bb.book);
+    auto assets = make_account (bb, root, "Assets", ACCT_TYPE_ASSET);
+    auto income = make_account (bb, root, "Income", ACCT_TYPE_INCOME);
+    auto expenses = make_account (bb, root, "Expenses", ACCT_TYPE_EXPENSE);
+    make_accounts (bb, assets, "Bank", n_banks, ACCT_TYPE_BANK, bb.banks);
+    make_accounts (bb, income, "Income", n_incomes, ACCT_TYPE_INCOME, bb.payees);
+    make_accounts (bb, expenses, "Expense", n_expenses, ACCT_TYPE_EXPENSE,
+                   bb.payees);
+}
+
+void
+free_book (BenchBook& bb)
+{
+    if (bb.session)
+    {
+        qof_session_end (bb.session);
+        qof_session_destroy (bb.session);
+    }
+    bb = BenchBook ();
+}
+
+/* The payee decides the other account, which is what Bayesian matching
+ * has to learn from the descriptions. */
+void
+add_transaction (BenchBook& bb, BenchRandom& rng)
+{
+    auto payee = rng.below (n_payees);
+    auto other = bb.payees[payee % bb.payees.size ()];
+    auto bank = bb.banks[rng.below (n_banks)];
+    auto amount = gnc_numeric_create (rng.below (100000) + 1, 100);
+    if (xaccAccountGetType (other) == ACCT_TYPE_INCOME)
+        amount = gnc_numeric_neg (amount);
+    auto description = g_strdup_printf ("payee%03u place%02u",
+                                        static_cast<unsigned>(payee),
+                                        static_cast<unsigned>(rng.below (n_places)));
+    auto posted = bb.start + static_cast<time64>(rng.below (span_days)) * day_secs;
+
+    auto trans = xaccMallocTransaction (bb.book);
+    xaccTransBeginEdit (trans);
+    xaccTransSetCurrency (trans, bb.currency);
+    xaccTransSetDatePostedSecsNormalized (trans, posted);
+    xaccTransSetDateEnteredSecs (trans, posted);
+    xaccTransSetDescription (trans, description);
+
+    auto split = xaccMallocSplit (bb.book);
+    xaccSplitSetParent (split, trans);
+    xaccSplitSetAccount (split, other);
+    xaccSplitSetAmount (split, amount);
+    xaccSplitSetValue (split, amount);
+
+    split = xaccMallocSplit (bb.book);
+    xaccSplitSetParent (split, trans);
+    xaccSplitSetAccount (split, bank);
+    xaccSplitSetAmount (split, gnc_numeric_neg (amount));
+    xaccSplitSetValue (split, gnc_numeric_neg (amount));
+    xaccTransCommitEdit (trans);
+
+    g_free (description);
+}
+
+/* With bulk, the accounts are sorted and their balances computed once
+ * at the end instead of after every transaction. */
+void
+add_transactions (BenchBook& bb, BenchRandom& rng, size_t n_splits, bool bulk)
+{
+    if (bulk)
+        qof_book_begin_bulk_edit (bb.book);
+    for (size_t i = 0; i < n_splits / 2; i++)
+        add_transaction (bb, rng);
+    if (bulk)
+        qof_book_end_bulk_edit (bb.book);
+}
+
+/* One price in ten splits, at most one a day for each stock. */
+void
+add_prices (BenchBook& bb, BenchRandom& rng, size_t n_splits)
+{
+    auto n_prices = std::max<size_t> (n_splits / 10, 1);
+    auto n_stocks = std::max (min_stocks, (n_prices + span_days - 1) / span_days);
+    auto table = gnc_commodity_table_get_table (bb.book);
+    for (size_t i = 0; i < n_stocks; i++)
+    {
+        auto mnemonic = g_strdup_printf ("STK%04u", static_cast<unsigned>(i));
+        auto stock = gnc_commodity_new (bb.book, mnemonic, "BENCH", mnemonic,
+                                        "", 10000);
+        bb.stocks.push_back (gnc_commodity_table_insert (table, stock));
+        g_free (mnemonic);
+    }
+
+    auto per_stock = std::max<size_t> (n_prices / n_stocks, 1);
+    auto step = std::max<size_t> (span_days / per_stock, 1);
+    GList *prices = nullptr;
+    for (size_t i = 0; i < n_prices; i++)
+    {
+        auto price = gnc_price_create (bb.book);
+        gnc_price_begin_edit (price);
+        gnc_price_set_commodity (price, bb.stocks[i % n_stocks]);
+        gnc_price_set_currency (price, bb.currency);
+        gnc_price_set_time64 (price, bb.start + static_cast<time64>
+                              ((i / n_stocks) * step % span_days) * day_secs);
+        gnc_price_set_source (price, PRICE_SOURCE_FQ);
+        gnc_price_set_typestr (price, PRICE_TYPE_LAST);
+        gnc_price_set_value (price, gnc_numeric_create (rng.below (1000000) + 1,
+                                                        100));
+        prices = g_list_prepend (prices, price);
+    }
+
+    auto pdb = gnc_pricedb_get_db (bb.book);
+    auto added = gnc_pricedb_add_prices_bulk (pdb, prices, PRICE_BULK_REPLACE,
+                                              nullptr);
+    for (auto node = added; node; node = g_list_next (node))
+        gnc_price_commit_edit (GNC_PRICE (node->data));
+    g_list_free (added);
+    g_list_free_full (prices, (GDestroyNotify)gnc_price_unref);
+}
+
+void
+build_book (Fixture& fixture, BenchBook& bb)
+{
+    BenchRandom rng (fixture.seed);
+    new_book (bb);
+    add_transactions (bb, rng, fixture.n_splits, true);
+    add_prices (bb, rng, fixture.n_splits);
+}
+
+/* The descriptions of the first transactions are the import history the
+ * matcher learns from, the way the importer feeds it. */
+GList *
+description_tokens (Transaction *trans)
+{
+    GList *tokens = nullptr;
+    auto words = g_strsplit (xaccTransGetDescription (trans), " ", -1);
+    for (auto word = words; *word; ++word)
+        tokens = g_list_prepend (tokens, g_strdup (*word));
+    g_strfreev (words);
+    return tokens;
+}
+
+size_t
+train_bayes (Fixture& fixture)
+{
+    auto bank = fixture.data.banks[0];
+    auto imap = gnc_account_imap_create_imap (bank);
+    size_t trained = 0;
+    for (auto node = xaccAccountGetSplitList (bank);
+         node && trained < max_bayes_training; node = g_list_next (node))
+    {
+        auto split = GNC_SPLIT (node->data);
+        auto tokens = description_tokens (xaccSplitGetParent (split));
+        gnc_account_imap_add_account_bayes (imap, tokens,
+                                            xaccSplitGetAccount (xaccSplitGetOtherSplit (split)));
+        g_list_free_full (tokens, g_free);
+        trained++;
+    }
+    g_free (imap);
+    fixture.bayes_trained = true;
+    return trained;
+}
+
+/* Match the descriptions of another bank account's transactions, which
+ * come from the same payees. */
+void
+prepare_bayes_match (Fixture& fixture)
+{
+    if (!fixture.bayes_trained)
+        train_bayes (fixture);
+
+    std::vector<Split*> splits;
+    for (auto node = xaccAccountGetSplitList (fixture.data.banks[1]); node;
+         node = g_list_next (node))
+        splits.push_back (GNC_SPLIT (node->data));
+    if (splits.empty ())
+        return;
+
+    BenchRandom rng (fixture.seed);
+    for (size_t i = 0; i < lookups; i++)
+    {
+        auto split = splits[rng.below (splits.size ())];
+        fixture.bayes_queries.push_back (description_tokens (xaccSplitGetParent (split)));
+    }
+}
+
+void
+save_book (QofSession *from, const std::string& uri)
+{
+    auto session = qof_session_new ();
+    qof_session_begin (session, uri.c_str (), TRUE, TRUE, TRUE);
+    if (qof_session_get_error (session) == ERR_BACKEND_NO_ERR)
+    {
+        qof_session_swap_data (from, session);
+        qof_session_save (session, nullptr);
+        qof_session_swap_data (from, session);
+    }
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        g_printerr ("Saving to %s failed: %s\n", uri.c_str (),
+                    qof_session_get_error_message (session));
+    qof_session_end (session);
+    qof_session_destroy (session);
+}
+
+QofSession *
+load_book (const std::string& uri)
+{
+    auto session = qof_session_new ();
+    qof_session_begin (session, uri.c_str (), TRUE, FALSE, FALSE);
+    if (qof_session_get_error (session) == ERR_BACKEND_NO_ERR)
+        qof_session_load (session, nullptr);
+    if (qof_session_get_error (session) != ERR_BACKEND_NO_ERR)
+        g_printerr ("Loading %s failed: %s\n", uri.c_str (),
+                    qof_session_get_error_message (session));
+    return session;
+}
+
+void
+close_loaded (Fixture& fixture)
+{
+    if (!fixture.loaded)
+        return;
+    qof_session_end (fixture.loaded);
+    qof_session_destroy (fixture.loaded);
+    fixture.loaded = nullptr;
+}
+
+/* The bank accounts as a bank's web site exports them, one after the
+ * other in the same file. */
+void
+write_qif (Fixture& fixture)
+{
+    auto file = g_fopen (fixture.qif_file.c_str (), "w");
+    if (!file)
+    {
+        g_printerr ("Can't write %s\n", fixture.qif_file.c_str ());
+        return;
+    }
+    for (auto bank : fixture.data.banks)
+    {
+        fprintf (file, "!Account\nN%s\nTBank\n^\n!Type:Bank\n",
+                 xaccAccountGetName (bank));
+        for (auto node = xaccAccountGetSplitList (bank); node;
+             node = g_list_next (node))
+        {
+            auto split = GNC_SPLIT (node->data);
+            auto trans = xaccSplitGetParent (split);
+            auto posted = xaccTransGetDate (trans);
+            struct tm tm;
+            gnc_localtime_r (&posted, &tm);
+            fprintf (file, "D%02d/%02d/%04d\nT%.2f\nP%s\nL%s\n^\n",
+                     tm.tm_mon + 1, tm.tm_mday, tm.tm_year + 1900,
+                     gnc_numeric_to_double (xaccSplitGetAmount (split)),
+                     xaccTransGetDescription (trans),
+                     xaccAccountGetName (xaccSplitGetAccount (xaccSplitGetOtherSplit (split))));
+        }
+    }
+    fclose (file);
+    fixture.qif_written = true;
+}
+
+/* Read the records and guess the date and number formats, the part of
+ * the QIF import that grows with the size of the file. */
+size_t
+read_qif (Fixture& fixture)
+{
+    try
+    {
+        GncQifReader reader {fixture.qif_file};
+        GncQifRecord record;
+        std::vector<std::string> dates, amounts;
+        size_t records = 0;
+        while (reader.next_record (record))
+        {
+            for (auto const& field : record.fields)
+            {
+                if (field.tag == 'D')
+                    dates.push_back (field.value);
+                else if (field.tag == 'T')
+                    amounts.push_back (field.value);
+            }
+            records++;
+        }
+        gnc_qif_guess_date_formats (dates);
+        gnc_qif_guess_number_formats (amounts);
+        return records;
+    }
+    catch (const std::ifstream::failure& err)
+    {
+        g_printerr ("Reading %s failed: %s\n", fixture.qif_file.c_str (),
+                    err.what ());
+        return 0;
+    }
+}
+
+void
+prepare_qif (Fixture& fixture)
+{
+    if (!fixture.qif_written)
+        write_qif (fixture);
+}
+
+/* The Scheme QIF benchmarks are in qif-read.scm, loaded when one of
+ * them first runs. It loads the reader's bindings from libgnc-qif,
+ * which the dynamic linker must find, e.g. on LD_LIBRARY_PATH. */
+enum class SchemeState { NOT_LOADED, LOADED, FAILED };
+SchemeState scheme_state = SchemeState::NOT_LOADED;
+
+struct SchemeCall
+{
+    const char *proc;
+    const char *path;
+};
+
+SCM
+scheme_load (void *data)
+{
+    return scm_c_primitive_load (static_cast<const char*>(data));
+}
+
+SCM
+scheme_call (void *data)
+{
+    auto call = static_cast<SchemeCall*>(data);
+    return scm_call_1 (scm_variable_ref (scm_c_lookup (call->proc)),
+                       scm_from_locale_string (call->path));
+}
+
+SCM
+scheme_error (void *data, SCM key, SCM args)
+{
+    auto port = scm_current_error_port ();
+    scm_puts (static_cast<const char*>(data), port);
+    scm_puts (": ", port);
+    scm_display (scm_cons (key, args), port);
+    scm_newline (port);
+    return SCM_BOOL_F;
+}
+
+void
+load_scheme ()
+{
+    if (scheme_state != SchemeState::NOT_LOADED)
+        return;
+    scm_init_guile ();
+    auto file = const_cast<char*>(GNC_BENCH_SCM_DIR "/qif-read.scm");
+    auto result = scm_internal_catch (SCM_BOOL_T, scheme_load, file,
+                                      scheme_error, file);
+    scheme_state = scm_is_false (result) ? SchemeState::FAILED :
+        SchemeState::LOADED;
+}
+
+/* Read the file with the Scheme procedure proc of qif-read.scm. */
+size_t
+read_qif_scheme (Fixture& fixture, const char *proc)
+{
+    if (scheme_state != SchemeState::LOADED)
+        return 0;
+    SchemeCall call {proc, fixture.qif_file.c_str ()};
+    auto result = scm_internal_catch (SCM_BOOL_T, scheme_call, &call,
+                                      scheme_error, const_cast<char*>(proc));
+    return scm_is_integer (result) ? scm_to_size_t (result) : 0;
+}
+
+size_t
+run_query (Fixture& fixture, Account *account, time64 from, time64 to)
+{
+    auto query = qof_query_create_for (GNC_ID_SPLIT);
+    qof_query_set_book (query, fixture.data.book);
+    if (account)
+        xaccQueryAddSingleAccountMatch (query, account, QOF_QUERY_AND);
+    if (from || to)
+        xaccQueryAddDateMatchTT (query, TRUE, from, TRUE, to, QOF_QUERY_AND);
+    qof_query_run (query);
+    qof_query_destroy (query);
+    return fixture.n_splits;
+}
+
+std::vector<Benchmark>
+benchmarks ()
+{
+    auto nothing = [](Fixture&) {};
+    return {
+        {"split-insert",
+         [](Fixture& f) { new_book (f.scratch); },
+         [](Fixture& f) {
+             BenchRandom rng (f.seed);
+             add_transactions (f.scratch, rng, f.n_splits, false);
+             return f.n_splits;
+         },
+         [](Fixture& f) { free_book (f.scratch); }},
+        {"split-insert-bulk",
+         [](Fixture& f) { new_book (f.scratch); },
+         [](Fixture& f) {
+             BenchRandom rng (f.seed);
+             add_transactions (f.scratch, rng, f.n_splits, true);
+             return f.n_splits;
+         },
+         [](Fixture& f) { free_book (f.scratch); }},
+        {"balance-recompute",
+         [](Fixture& f) {
+             for (auto acc : f.data.banks)
+                 gnc_account_set_balance_dirty (acc);
+             for (auto acc : f.data.payees)
+                 gnc_account_set_balance_dirty (acc);
+         },
+         [](Fixture& f) {
+             for (auto acc : f.data.banks)
+                 xaccAccountRecomputeBalance (acc);
+             for (auto acc : f.data.payees)
+                 xaccAccountRecomputeBalance (acc);
+             return f.n_splits;
+         },
+         nothing},
+        {"balance-as-of-date", nothing,
+         [](Fixture& f) {
+             BenchRandom rng (f.seed);
+             for (size_t i = 0; i < lookups; i++)
+                 xaccAccountGetBalanceAsOfDate (f.data.banks[rng.below (n_banks)],
+                                                f.data.start + static_cast<time64>
+                                                (rng.below (span_days)) * day_secs);
+             return lookups;
+         },
+         nothing},
+        {"query-date-range", nothing,
+         [](Fixture& f) {
+             return run_query (f, nullptr, f.data.start + 365 * day_secs,
+                               f.data.start + 2 * 365 * day_secs);
+         },
+         nothing},
+        {"query-account", nothing,
+         [](Fixture& f) { return run_query (f, f.data.banks[0], 0, 0); },
+         nothing},
+        {"price-lookup", nothing,
+         [](Fixture& f) {
+             BenchRandom rng (f.seed);
+             auto pdb = gnc_pricedb_get_db (f.data.book);
+             for (size_t i = 0; i < lookups; i++)
+             {
+                 auto stock = f.data.stocks[rng.below (f.data.stocks.size ())];
+                 auto when = f.data.start + static_cast<time64>
+                     (rng.below (span_days)) * day_secs;
+                 auto price = gnc_pricedb_lookup_nearest_in_time64 (pdb, stock,
+                                                                    f.data.currency,
+                                                                    when);
+                 gnc_price_unref (price);
+             }
+             return lookups;
+         },
+         nothing},
+        {"xml-save", nothing,
+         [](Fixture& f) {
+             save_book (f.data.session, f.xml_uri);
+             f.xml_saved = true;
+             return f.n_splits;
+         },
+         nothing},
+        {"xml-load",
+         [](Fixture& f) {
+             if (!f.xml_saved)
+                 save_book (f.data.session, f.xml_uri);
+             f.xml_saved = true;
+         },
+         [](Fixture& f) {
+             f.loaded = load_book (f.xml_uri);
+             return f.n_splits;
+         },
+         close_loaded},
+#ifdef HAVE_DBI_BACKEND
+        {"sqlite-save", nothing,
+         [](Fixture& f) {
+             save_book (f.data.session, f.sqlite_uri);
+             f.sqlite_saved = true;
+             return f.n_splits;
+         },
+         nothing},
+        {"sqlite-load",
+         [](Fixture& f) {
+             if (!f.sqlite_saved)
+                 save_book (f.data.session, f.sqlite_uri);
+             f.sqlite_saved = true;
+         },
+         [](Fixture& f) {
+             f.loaded = load_book (f.sqlite_uri);
+             return f.n_splits;
+         },
+         close_loaded},
+#endif
+        {"qif-read", prepare_qif, read_qif, nothing},
+        {"qif-read-scheme",
+         [](Fixture& f) { prepare_qif (f); load_scheme (); },
+         [](Fixture& f) { return read_qif_scheme (f, "bench:qif-read"); },
+         nothing},
+        /* The same with the regular expressions the Scheme code used
+         * before the C++ reader, for comparison. */
+        {"qif-read-scheme-regex",
+         [](Fixture& f) { prepare_qif (f); load_scheme (); },
+         [](Fixture& f) { return read_qif_scheme (f, "bench:qif-read-regex"); },
+         nothing},
+        {"bayes-train",
+         [](Fixture& f) {
+             /* Train from scratch, not on top of the last repetition. */
+             gnc_account_delete_all_bayes_maps (f.data.banks[0]);
+         },
+         train_bayes, nothing},
+        {"bayes-match", prepare_bayes_match,
+         [](Fixture& f) {
+             auto imap = gnc_account_imap_create_imap (f.data.banks[0]);
+             for (auto tokens : f.bayes_queries)
+                 gnc_account_imap_find_account_bayes (imap, tokens);
+             g_free (imap);
+             return f.bayes_queries.size ();
+         },
+         [](Fixture& f) {
+             for (auto tokens : f.bayes_queries)
+                 g_list_free_full (tokens, g_free);
+             f.bayes_queries.clear ();
+         }},
+    };
+}
+
+bool
+parse_size (const char *str, size_t *size)
+{
+    gchar *end;
+    auto value = g_ascii_strtoull (str, &end, 10);
+    if (end == str)
+        return false;
+    if (*end == 'k' || *end == 'K')
+    {
+        value *= 1000;
+        end++;
+    }
+    else if (*end == 'm' || *end == 'M')
+    {
+        value *= 1000000;
+        end++;
+    }
+    if (*end || value < 2)
+        return false;
+    *size = value;
+    return true;
+}
+
+bool
+selected (const char *name, gchar **filters)
+{
+    if (!filters)
+        return true;
+    for (auto filter = filters; *filter; ++filter)
+        if (strstr (name, *filter))
+            return true;
+    return false;
+}
+
+double
+median (std::vector<double> values)
+{
+    std::sort (values.begin (), values.end ());
+    auto mid = values.size () / 2;
+    return values.size () % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+void
+print_result (const Result& result)
+{
+    auto best = *std::min_element (result.seconds.begin (), result.seconds.end ());
+    printf ("%-20s %10" G_GSIZE_FORMAT " %12.3f %12.3f %12.1f\n",
+            result.name.c_str (), result.n_splits, best * 1e3,
+            median (result.seconds) * 1e3,
+            result.items ? best * 1e9 / result.items : 0.0);
+    fflush (stdout);
+}
+
+bool
+write_json (const char *filename, const std::vector<Result>& results,
+            uint64_t seed)
+{
+    auto file = g_fopen (filename, "w");
+    if (!file)
+        return false;
+    fprintf (file, "{\n\"seed\": %" G_GUINT64_FORMAT ",\n\"results\": [",
+             static_cast<guint64>(seed));
+    auto sep = "";
+    for (auto const& result : results)
+    {
+        auto best = *std::min_element (result.seconds.begin (),
+                                       result.seconds.end ());
+        fprintf (file, "%s\n  {\"name\": \"%s\", \"splits\": %" G_GSIZE_FORMAT
+                 ", \"items\": %" G_GSIZE_FORMAT ", \"seconds\": [",
+                 sep, result.name.c_str (), result.n_splits, result.items);
+        auto sec_sep = "";
+        for (auto seconds : result.seconds)
+        {
+            fprintf (file, "%s%.6f", sec_sep, seconds);
+            sec_sep = ", ";
+        }
+        fprintf (file, "], \"min\": %.6f, \"median\": %.6f}", best,
+                 median (result.seconds));
+        sep = ",";
+    }
+    fprintf (file, "\n]\n}\n");
+    return fclose (file) == 0;
+}
+
+void
+remove_dir (const gchar *path)
+{
+    auto dir = g_dir_open (path, 0, nullptr);
+    if (dir)
+    {
+        const gchar *name;
+        while ((name = g_dir_read_name (dir)))
+        {
+            auto file = g_build_filename (path, name, nullptr);
+            g_unlink (file);
+            g_free (file);
+        }
+        g_dir_close (dir);
+    }
+    g_rmdir (path);
+}
+
+void
+run_size (Fixture& fixture, const std::vector<Benchmark>& benches,
+          gchar **filters, int repeat, std::vector<Result>& results)
+{
+    auto xml_file = g_build_filename (fixture.dir, "bench.gnucash", nullptr);
+    auto sqlite_file = g_build_filename (fixture.dir, "bench.sqlite.gnucash",
+                                         nullptr);
+    auto qif_file = g_build_filename (fixture.dir, "bench.qif", nullptr);
+    fixture.xml_uri = std::string ("xml://") + xml_file;
+    fixture.sqlite_uri = std::string ("sqlite3://") + sqlite_file;
+    fixture.qif_file = qif_file;
+    g_free (xml_file);
+    g_free (sqlite_file);
+    g_free (qif_file);
+
+    for (auto const& bench : benches)
+    {
+        if (!selected (bench.name, filters))
+            continue;
+        /* The split-insert benchmarks build their own book and need no
+         * other. */
+        if (!fixture.data.session && !g_str_has_prefix (bench.name, "split-insert"))
+            build_book (fixture, fixture.data);
+
+        Result result {bench.name, fixture.n_splits, 0, {}};
+        for (int i = 0; i < repeat; i++)
+        {
+            bench.setup (fixture);
+            auto start = std::chrono::steady_clock::now ();
+            result.items = bench.run (fixture);
+            std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now () - start;
+            bench.teardown (fixture);
+            result.seconds.push_back (elapsed.count ());
+        }
+        print_result (result);
+        results.push_back (result);
+    }
+    free_book (fixture.data);
+    fixture.xml_saved = fixture.sqlite_saved = fixture.bayes_trained = false;
+    fixture.qif_written = false;
+}
+
+}
+
+int
+main (int argc, char **argv)
+{
+    gchar *sizes_arg = nullptr;
+    gchar *filter_arg = nullptr;
+    gchar *json_file = nullptr;
+    gint64 seed = 1;
+    gint repeat = 3;
+    gboolean list = FALSE;
+    GError *error = nullptr;
+    GOptionEntry options[] =
+    {
+        {"size", 's', 0, G_OPTION_ARG_STRING, &sizes_arg,
+         "Comma separated book sizes in splits, e.g. 10k,100k,1M,10M (default 10k)",
+         "SIZES"},
+        {"filter", 'f', 0, G_OPTION_ARG_STRING, &filter_arg,
+         "Only run the benchmarks whose name contains one of the comma separated NAMES",
+         "NAMES"},
+        {"repeat", 'r', 0, G_OPTION_ARG_INT, &repeat,
+         "Run each benchmark N times (default 3)", "N"},
+        {"seed", 0, 0, G_OPTION_ARG_INT64, &seed,
+         "Generate the books from SEED (default 1)", "SEED"},
+        {"json", 'j', 0, G_OPTION_ARG_FILENAME, &json_file,
+         "Also write the results to FILE as JSON", "FILE"},
+        {"list", 'l', 0, G_OPTION_ARG_NONE, &list,
+         "List the benchmarks and exit", nullptr},
+        {nullptr}
+    };
+
+    auto context = g_option_context_new ("- benchmark the GnuCash engine");
+    g_option_context_add_main_entries (context, options, nullptr);
+    if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        return 1;
+    }
+    g_option_context_free (context);
+
+    auto benches = benchmarks ();
+    if (list)
+    {
+        for (auto const& bench : benches)
+            printf ("%s\n", bench.name);
+        return 0;
+    }
+
+    std::vector<size_t> sizes;
+    auto size_strs = g_strsplit (sizes_arg ? sizes_arg : "10k", ",", -1);
+    for (auto str = size_strs; *str; ++str)
+    {
+        size_t size;
+        if (!parse_size (*str, &size))
+        {
+            g_printerr ("Invalid book size %s\n", *str);
+            return 1;
+        }
+        sizes.push_back (size);
+    }
+    g_strfreev (size_strs);
+    auto filters = filter_arg ? g_strsplit (filter_arg, ",", -1) : nullptr;
+    repeat = std::max (repeat, 1);
+
+    qof_init ();
+    cashobjects_register ();
+    gnc_module_init_backend_xml ();
+#ifdef HAVE_DBI_BACKEND
+    gnc_module_init_backend_dbi ();
+#endif
+    /* The transaction log would write every generated transaction. */
+    xaccLogDisable ();
+
+    auto dir = g_dir_make_tmp ("gnc-bench-XXXXXX", &error);
+    if (!dir)
+    {
+        g_printerr ("%s\n", error->message);
+        g_error_free (error);
+        return 1;
+    }
+
+    printf ("%-20s %10s %12s %12s %12s\n", "benchmark", "splits", "min ms",
+            "median ms", "ns/item");
+    std::vector<Result> results;
+    for (auto size : sizes)
+    {
+        Fixture fixture (size, static_cast<uint64_t>(seed), dir);
+        run_size (fixture, benches, filters, repeat, results);
+    }
+
+    remove_dir (dir);
+    g_free (dir);
+    g_strfreev (filters);
+
+    auto ret = 0;
+    if (json_file && !write_json (json_file, results, seed))
+    {
+        g_printerr ("Can't write %s\n", json_file);
+        ret = 1;
+    }
+    qof_close ();
+    return ret;
+}
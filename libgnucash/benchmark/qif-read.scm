@@ -0,0 +1,178 @@
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+;;; qif-read.scm - the Scheme side of gnc-bench's QIF benchmarks
+;;;
+;;; This program is free software; you can redistribute it and/or
+;;; modify it under the terms of the GNU General Public License as
+;;; published by the Free Software Foundation; either version 2 of
+;;; the License, or (at your option) any later version.
+;;;
+;;; This program is distributed in the hope that it will be useful,
+;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;; GNU General Public License for more details.
+;;;
+;;; You should have received a copy of the GNU General Public License
+;;; along with this program; if not, contact:
+;;;
+;;; Free Software Foundation           Voice:  +1-617-542-5942
+;;; 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652
+;;; Boston, MA  02110-1301,  USA       gnu@gnu.org
+;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
+
+;; The QIF import reads a file in qif-file:read-file and guesses its
+;; formats with qif-parse:check-date-format and
+;; qif-parse:check-number-format. gnc-bench times that work twice:
+;; bench:qif-read the way those procedures do it now, through the C++
+;; reader, and bench:qif-read-regex the way they did it before, with
+;; read-delimited and regular expressions. Both return the number of
+;; records, '!' lines included, like the C++ qif-read benchmark.
+;;
+;; bench:qif-read-regex leaves out the UTF-8 check of every value that
+;; qif-file:read-file did, which needs the core-utils bindings; the old
+;; code was slower than it measures.
+
+(use-modules (ice-9 rdelim))
+(use-modules (ice-9 regex))
+(use-modules (srfi srfi-1))
+
+(load-extension "libgnc-qif" "gnc_qif_reader_guile_init")
+
+(define bench:date-formats '(m-d-y d-m-y y-m-d y-d-m))
+(define bench:number-formats '(decimal comma integer))
+
+;; Narrow formats down to those all of strings could be in, like
+;; qif-parse:check-number-formats.
+(define (bench:check-formats check strings formats)
+  (let lp ((strings strings)
+           (formats formats))
+    (if (or (null? strings) (null? formats))
+        formats
+        (lp (cdr strings) (check (car strings) formats)))))
+
+(define (bench:record-end? tag)
+  (or (eqv? tag #\^) (eqv? tag #\!)))
+
+(define (bench:qif-read path)
+  (let ((reader (gnc-qif-reader-open path)))
+    (let lp ((field (gnc-qif-reader-next-field reader))
+             (records 0)
+             (dates '())
+             (amounts '()))
+      (if field
+          (let ((tag (cadr field))
+                (value (caddr field)))
+            (lp (gnc-qif-reader-next-field reader)
+                (if (bench:record-end? tag) (1+ records) records)
+                (if (eqv? tag #\D) (cons value dates) dates)
+                (if (eqv? tag #\T) (cons value amounts) amounts)))
+          (begin
+            (gnc-qif-reader-close reader)
+            (bench:check-formats gnc-qif-check-date-format
+                                 (reverse dates) bench:date-formats)
+            (bench:check-formats gnc-qif-check-number-format
+                                 (reverse amounts) bench:number-formats)
+            records)))))
+
+
+;; The format checks of qif-parse.scm before they went to C++.
+
+(define (regex:parse-check-date-format match possible-formats)
+  (define (date? d m y ys)
+    (and (number? d) (<= 1 d 31)
+         (number? m) (<= 1 m 12)
+         (number? y) (or (not (= 4 (string-length ys)))
+                         (> y 1930))))
+  (let* ((date-parts (list (match:substring match 1)
+                           (match:substring match 2)
+                           (match:substring match 3)))
+         (numeric-date-parts (map (lambda (elt) (with-input-from-string elt read))
+                                  date-parts))
+         (n1 (car numeric-date-parts))
+         (n2 (cadr numeric-date-parts))
+         (n3 (caddr numeric-date-parts))
+         (s1 (car date-parts))
+         (s3 (caddr date-parts))
+         (format-alist (list (list 'd-m-y n1 n2 n3 s3)
+                             (list 'm-d-y n2 n1 n3 s3)
+                             (list 'y-m-d n3 n2 n1 s1)
+                             (list 'y-d-m n2 n3 n1 s1))))
+
+    (let lp ((possible-formats possible-formats)
+             (res '()))
+      (cond
+       ((null? possible-formats) (reverse res))
+       (else
+        (lp (cdr possible-formats)
+            (let ((args (assq (car possible-formats) format-alist)))
+              (if (apply date? (cdr args)) (cons (car args) res) res))))))))
+
+(define regex:date-rexp
+  (make-regexp "^ *([0-9]+) *[-/.'] *([0-9]+) *[-/.'] *([0-9]+).*$|^ *([0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9]).*$"))
+
+(define regex:date-mdy-rexp
+  (make-regexp "([0-9][0-9])([0-9][0-9])([0-9][0-9][0-9][0-9])"))
+
+(define regex:date-ymd-rexp
+  (make-regexp "([0-9][0-9][0-9][0-9])([0-9][0-9])([0-9][0-9])"))
+
+(define (regex:check-date-format date-string possible-formats)
+  (and (string? date-string)
+       (not (string-null? date-string))
+       (let ((rmatch (regexp-exec regex:date-rexp date-string)))
+         (if rmatch
+             (if (match:substring rmatch 1)
+                 (regex:parse-check-date-format rmatch possible-formats)
+                 (let* ((newstr (match:substring rmatch 4))
+                        (date-ymd (regexp-exec regex:date-ymd-rexp newstr))
+                        (date-mdy (regexp-exec regex:date-mdy-rexp newstr)))
+                   (append
+                    (if (or (memq 'y-d-m possible-formats)
+                            (memq 'y-m-d possible-formats))
+                        (regex:parse-check-date-format date-ymd possible-formats)
+                        '())
+                    (if (or (memq 'd-m-y possible-formats)
+                            (memq 'm-d-y possible-formats))
+                        (regex:parse-check-date-format date-mdy possible-formats)
+                        '()))))
+             '()))))
+
+(define regex:decimal-radix-rexp
+  (make-regexp "^ *[$]?[+-]?[$]?[0-9]+[+-]?$|^ *[$]?[+-]?[$]?[0-9]?[0-9]?[0-9]?([,'][0-9][0-9][0-9])*(\\.[0-9]*)?[+-]? *$|^ *[$]?[+-]?[$]?[0-9]+\\.[0-9]*[+-]? *$"))
+
+(define regex:comma-radix-rexp
+  (make-regexp "^ *[$]?[+-]?[$]?[0-9]+[+-]?$|^ *[$]?[+-]?[$]?[0-9]?[0-9]?[0-9]?([\\.'][0-9][0-9][0-9])*(,[0-9]*)?[+-]? *$|^ *[$]?[+-]?[$]?[0-9]+,[0-9]*[+-]? *$"))
+
+(define regex:integer-rexp
+  (make-regexp "^[$]?[+-]?[$]?[0-9]+[+-]? *$"))
+
+(define (regex:check-number-format value-string possible-formats)
+  (define numtypes-alist
+    (list (cons 'decimal regex:decimal-radix-rexp)
+          (cons 'comma regex:comma-radix-rexp)
+          (cons 'integer regex:integer-rexp)))
+  (filter (lambda (fmt) (regexp-exec (assq-ref numtypes-alist fmt) value-string))
+          possible-formats))
+
+(define (bench:qif-read-regex path)
+  (with-input-from-file path
+    (lambda ()
+      (let lp ((line (read-delimited (string #\cr #\nl)))
+               (records 0)
+               (dates '())
+               (amounts '()))
+        (cond
+         ((eof-object? line)
+          (bench:check-formats regex:check-date-format
+                               (reverse dates) bench:date-formats)
+          (bench:check-formats regex:check-number-format
+                               (reverse amounts) bench:number-formats)
+          records)
+         ((string-null? line)
+          (lp (read-delimited (string #\cr #\nl)) records dates amounts))
+         (else
+          (let ((tag (string-ref line 0))
+                (value (substring line 1)))
+            (lp (read-delimited (string #\cr #\nl))
+                (if (bench:record-end? tag) (1+ records) records)
+                (if (eqv? tag #\D) (cons value dates) dates)
+                (if (eqv? tag #\T) (cons value amounts) amounts)))))))))
@@ -44,12 +44,34 @@
 #include "guid.hpp"
 
 #include <numeric>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 static QofLogModule log_module = GNC_MOD_ACCOUNT;
 
 /* The Canonical Account Separator.  Pre-Initialized. */
 static gchar account_separator[8] = ".";
 static gunichar account_uc_separator = ':';
+
+/* Cached full names and the lookup indexes of root accounts are stamped
+ * with the generation of their account tree, which is kept on the top
+ * account of the tree and renewed whenever a name, a code or the
+ * parentage in that tree changes. Generations come from one counter, so
+ * a stamp never matches the generation of another tree. A change of
+ * separator affects every tree: trees whose generation is older than
+ * account_separator_generation get a new one when next used.
+ *
+ * The caches are filled lazily by functions taking a const Account,
+ * which may run on several threads at once, for instance from
+ * xaccAccountTreeForEachTransactionParallel, so they and the
+ * generations are only touched with account_cache_mutex held. */
+static std::mutex account_cache_mutex;
+static guint account_generation = 0;
+static guint account_separator_generation = 0;
 /* Predefined KVP paths */
 static const std::string KEY_ASSOC_INCOME_ACCOUNT("ofx/associated-income-account");
 static const std::string KEY_RECONCILE_INFO("reconcile-info");
@@ -64,7 +86,6 @@ static const std::string AB_BANK_CODE("bank-code");
 static const std::string AB_TRANS_RETRIEVAL("trans-retrieval");
 
 using FinalProbabilityVec=std::vector<std::pair<std::string, int32_t>>;
-using ProbabilityVec=std::vector<std::pair<std::string, struct AccountProbability>>;
 using FlatKvpEntry=std::pair<std::string, KvpValue*>;
 
 enum
@@ -123,6 +144,30 @@ enum
 #define GET_PRIVATE(o)  \
    (G_TYPE_INSTANCE_GET_PRIVATE ((o), GNC_TYPE_ACCOUNT, AccountPrivate))
 
+/* The running balances of an account's splits, as parallel arrays
+ * indexed by Split::balance_index. Only the accounts somebody asks a
+ * split balance of, usually for a register, ever fill them. They are
+ * filled through a const Account but, unlike the name caches above,
+ * without a lock: they sit on the path of every split insert and
+ * balance lookup, and the engine is single threaded. Split balances
+ * thus must not be asked for from the callbacks of
+ * xaccAccountTreeForEachTransactionParallel. */
+struct SplitBalances
+{
+    std::vector<const Split*> splits;
+    std::vector<gnc_numeric> balance;
+    std::vector<gnc_numeric> cleared_balance;
+    std::vector<gnc_numeric> reconciled_balance;
+    bool stale = true;
+};
+
+static inline void
+mark_split_balances_stale (AccountPrivate *priv)
+{
+    if (priv->split_balances)
+        priv->split_balances->stale = true;
+}
+
 /********************************************************************\
  * Because I can't use C++ for this project, doesn't mean that I    *
  * can't pretend to!  These functions perform actions on the        *
@@ -152,6 +197,42 @@ gnc_get_account_separator (void)
     return account_uc_separator;
 }
 
+static AccountPrivate *
+account_top_private (const Account *acc)
+{
+    AccountPrivate *priv = GET_PRIVATE(acc);
+    while (priv->parent)
+        priv = GET_PRIVATE(priv->parent);
+    return priv;
+}
+
+/* Returns the generation of the tree holding acc. Call with
+ * account_cache_mutex held. */
+static guint
+account_tree_generation (const Account *acc)
+{
+    AccountPrivate *tpriv = account_top_private (acc);
+    if (tpriv->tree_gen <= account_separator_generation)
+        tpriv->tree_gen = ++account_generation;
+    return tpriv->tree_gen;
+}
+
+/* Makes the cached full names and indexes of the tree holding acc
+ * stale. */
+static void
+account_tree_changed (const Account *acc)
+{
+    std::lock_guard<std::mutex> lock (account_cache_mutex);
+    account_top_private (acc)->tree_gen = ++account_generation;
+}
+
+static void
+account_separator_changed (void)
+{
+    std::lock_guard<std::mutex> lock (account_cache_mutex);
+    account_separator_generation = ++account_generation;
+}
+
 void
 gnc_set_account_separator (const gchar *separator)
 {
@@ -163,12 +244,14 @@ gnc_set_account_separator (const gchar *separator)
     {
         account_uc_separator = ':';
         strcpy(account_separator, ":");
+        account_separator_changed ();
         return;
     }
 
     account_uc_separator = uc;
     count = g_unichar_to_utf8(uc, account_separator);
     account_separator[count] = '\0';
+    account_separator_changed ();
 }
 
 gchar *gnc_account_name_violations_errmsg (const gchar *separator, GList* invalid_account_names)
@@ -288,6 +371,15 @@ gnc_account_init(Account* acc)
 
     priv->splits = NULL;
     priv->sort_dirty = FALSE;
+    priv->splits_gen = 0;
+
+    priv->full_name = NULL;
+    priv->full_name_gen = 0;
+    priv->name_index = NULL;
+    priv->code_index = NULL;
+    priv->index_gen = 0;
+    priv->tree_gen = 0;
+    priv->split_balances = NULL;
 }
 
 static void
@@ -567,15 +659,35 @@ gnc_account_set_property (GObject         *object,
     }
 }
 
+static void
+gnc_account_get_memory_usage (const QofInstance *inst, QofMemoryUsage *usage)
+{
+    AccountPrivate *priv = GET_PRIVATE(inst);
+    auto nodes = g_list_length (priv->children) + g_list_length (priv->splits) +
+        g_list_length (priv->lots);
+
+    usage->list_nodes += nodes;
+    usage->bytes += nodes * sizeof (GList);
+    if (priv->full_name)
+        usage->bytes += strlen (priv->full_name) + 1;
+    if (auto sb = priv->split_balances)
+        usage->bytes += sizeof (*sb) +
+            sb->splits.capacity () * sizeof (const Split*) +
+            (sb->balance.capacity () + sb->cleared_balance.capacity () +
+             sb->reconciled_balance.capacity ()) * sizeof (gnc_numeric);
+}
+
 static void
 gnc_account_class_init (AccountClass *klass)
 {
     GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+    QofInstanceClass *qof_class = QOF_INSTANCE_CLASS (klass);
 
     gobject_class->dispose = gnc_account_dispose;
     gobject_class->finalize = gnc_account_finalize;
     gobject_class->set_property = gnc_account_set_property;
     gobject_class->get_property = gnc_account_get_property;
+    qof_class->get_memory_usage = gnc_account_get_memory_usage;
 
     g_object_class_install_property
     (gobject_class,
@@ -1262,6 +1374,17 @@ xaccFreeAccount (Account *acc)
     qof_string_cache_remove(priv->description);
     priv->accountName = priv->accountCode = priv->description = nullptr;
 
+    g_free(priv->full_name);
+    priv->full_name = nullptr;
+    if (priv->name_index)
+    {
+        g_hash_table_destroy(priv->name_index);
+        g_hash_table_destroy(priv->code_index);
+        priv->name_index = priv->code_index = nullptr;
+    }
+    delete priv->split_balances;
+    priv->split_balances = nullptr;
+
     /* zero out values, just in case stray
      * pointers are pointing here. */
 
@@ -1413,6 +1536,9 @@ xaccAccountDestroy (Account *acc)
     g_return_if_fail(GNC_IS_ACCOUNT(acc));
 
     qof_instance_set_destroying(acc, TRUE);
+    /* A bulk edit holding the account open would otherwise put off its
+     * destruction until the edit ends. */
+    qof_book_bulk_edit_release (qof_instance_get_book (acc), QOF_INSTANCE (acc));
 
     xaccAccountCommitEdit (acc);
 }
@@ -1727,6 +1853,24 @@ gnc_account_set_balance_dirty (Account *acc)
 /********************************************************************\
 \********************************************************************/
 
+static void
+bulk_edit_commit (QofInstance *inst)
+{
+    xaccAccountCommitEdit (GNC_ACCOUNT (inst));
+}
+
+/* While the book is in a bulk edit, keep the account open for editing
+ * so that its splits are sorted and its balances recomputed once when
+ * the edit ends instead of after every change. */
+static void
+account_hold_for_bulk_edit (Account *acc)
+{
+    QofBook *book = qof_instance_get_book (acc);
+
+    if (qof_book_in_bulk_edit (book) && !qof_instance_get_destroying (acc))
+        qof_book_bulk_edit_hold (book, QOF_INSTANCE (acc), bulk_edit_commit);
+}
+
 gboolean
 gnc_account_insert_split (Account *acc, Split *s)
 {
@@ -1741,6 +1885,7 @@ gnc_account_insert_split (Account *acc, Split *s)
     if (node)
         return FALSE;
 
+    account_hold_for_bulk_edit (acc);
     if (qof_instance_get_editlevel(acc) == 0)
     {
         priv->splits = g_list_insert_sorted(priv->splits, s,
@@ -1751,13 +1896,15 @@ gnc_account_insert_split (Account *acc, Split *s)
         priv->splits = g_list_prepend(priv->splits, s);
         priv->sort_dirty = TRUE;
     }
+    priv->splits_gen++;
 
     //FIXME: find better event
     qof_event_gen (&acc->inst, QOF_EVENT_MODIFY, NULL);
     /* Also send an event based on the account */
-    qof_event_gen(&acc->inst, GNC_EVENT_ITEM_ADDED, s);
+    qof_event_gen_item(&acc->inst, GNC_EVENT_ITEM_ADDED, &s->inst);
 
     priv->balance_dirty = TRUE;
+    mark_split_balances_stale (priv);
 //  DRH: Should the below be added? It is present in the delete path.
 //  xaccAccountRecomputeBalance(acc);
     return TRUE;
@@ -1778,12 +1925,14 @@ gnc_account_remove_split (Account *acc, Split *s)
         return FALSE;
 
     priv->splits = g_list_delete_link(priv->splits, node);
+    priv->splits_gen++;
     //FIXME: find better event type
     qof_event_gen(&acc->inst, QOF_EVENT_MODIFY, NULL);
     // And send the account-based event, too
-    qof_event_gen(&acc->inst, GNC_EVENT_ITEM_REMOVED, s);
+    qof_event_gen_item(&acc->inst, GNC_EVENT_ITEM_REMOVED, &s->inst);
 
     priv->balance_dirty = TRUE;
+    mark_split_balances_stale (priv);
     xaccAccountRecomputeBalance(acc);
     return TRUE;
 }
@@ -1798,9 +1947,11 @@ xaccAccountSortSplits (Account *acc, gboolean force)
     priv = GET_PRIVATE(acc);
     if (!priv->sort_dirty || (!force && qof_instance_get_editlevel(acc) > 0))
         return;
+    QOF_PERF_COUNT ("account.sort-splits", 1);
     priv->splits = g_list_sort(priv->splits, (GCompareFunc)xaccSplitOrder);
     priv->sort_dirty = FALSE;
     priv->balance_dirty = TRUE;
+    mark_split_balances_stale (priv);
 }
 
 static void
@@ -2077,11 +2228,14 @@ xaccAccountRecomputeBalance (Account * acc)
     if (NULL == acc) return;
 
     priv = GET_PRIVATE(acc);
+    if (priv->balance_dirty)
+        account_hold_for_bulk_edit (acc);
     if (qof_instance_get_editlevel(acc) > 0) return;
     if (!priv->balance_dirty) return;
     if (qof_instance_get_destroying(acc)) return;
     if (qof_book_shutting_down(qof_instance_get_book(acc))) return;
 
+    QOF_PERF_COUNT ("account.recompute-balance", 1);
     balance            = priv->starting_balance;
     cleared_balance    = priv->starting_cleared_balance;
     reconciled_balance = priv->starting_reconciled_balance;
@@ -2106,17 +2260,85 @@ xaccAccountRecomputeBalance (Account * acc)
             reconciled_balance =
                 gnc_numeric_add_fixed(reconciled_balance, amt);
         }
-
-        split->balance = balance;
-        split->cleared_balance = cleared_balance;
-        split->reconciled_balance = reconciled_balance;
-
     }
 
+    QOF_PERF_COUNT ("account.recompute-balance.splits",
+                    g_list_length (priv->splits));
     priv->balance = balance;
     priv->cleared_balance = cleared_balance;
     priv->reconciled_balance = reconciled_balance;
     priv->balance_dirty = FALSE;
+    mark_split_balances_stale (priv);
+}
+
+/* Recompute the running balances of all of acc's splits, the same way
+ * xaccAccountRecomputeBalance() computes the account's. */
+static void
+fill_split_balances (Account *acc, SplitBalances *sb)
+{
+    AccountPrivate *priv = GET_PRIVATE(acc);
+    gnc_numeric balance = priv->starting_balance;
+    gnc_numeric cleared_balance = priv->starting_cleared_balance;
+    gnc_numeric reconciled_balance = priv->starting_reconciled_balance;
+    auto count = g_list_length (priv->splits);
+
+    sb->splits.clear();
+    sb->balance.clear();
+    sb->cleared_balance.clear();
+    sb->reconciled_balance.clear();
+    sb->splits.reserve(count);
+    sb->balance.reserve(count);
+    sb->cleared_balance.reserve(count);
+    sb->reconciled_balance.reserve(count);
+
+    for (auto lp = priv->splits; lp; lp = lp->next)
+    {
+        auto split = static_cast<Split*>(lp->data);
+        gnc_numeric amt = xaccSplitGetAmount (split);
+
+        balance = gnc_numeric_add_fixed(balance, amt);
+        if (NREC != split->reconciled)
+            cleared_balance = gnc_numeric_add_fixed(cleared_balance, amt);
+        if (YREC == split->reconciled || FREC == split->reconciled)
+            reconciled_balance = gnc_numeric_add_fixed(reconciled_balance, amt);
+
+        split->balance_index = sb->splits.size();
+        sb->splits.push_back(split);
+        sb->balance.push_back(balance);
+        sb->cleared_balance.push_back(cleared_balance);
+        sb->reconciled_balance.push_back(reconciled_balance);
+    }
+    sb->stale = false;
+}
+
+gboolean
+gnc_account_get_split_balances (const Account *acc, const Split *split,
+                                gnc_numeric *balance,
+                                gnc_numeric *cleared_balance,
+                                gnc_numeric *reconciled_balance)
+{
+    g_return_val_if_fail (GNC_IS_ACCOUNT (acc) && split, FALSE);
+
+    auto account = const_cast<Account*>(acc);
+    auto priv = GET_PRIVATE(account);
+    if (!priv->split_balances)
+        priv->split_balances = new SplitBalances;
+
+    auto sb = priv->split_balances;
+    if (sb->stale)
+        fill_split_balances (account, sb);
+
+    auto idx = split->balance_index;
+    if (idx >= sb->splits.size() || sb->splits[idx] != split)
+        return FALSE;
+
+    if (balance)
+        *balance = sb->balance[idx];
+    if (cleared_balance)
+        *cleared_balance = sb->cleared_balance[idx];
+    if (reconciled_balance)
+        *reconciled_balance = sb->reconciled_balance[idx];
+    return TRUE;
 }
 
 /********************************************************************\
@@ -2252,6 +2474,7 @@ xaccAccountSetName (Account *acc, const char *str)
 
     xaccAccountBeginEdit(acc);
     priv->accountName = qof_string_cache_replace(priv->accountName, str);
+    account_tree_changed (acc);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2271,6 +2494,7 @@ xaccAccountSetCode (Account *acc, const char *str)
 
     xaccAccountBeginEdit(acc);
     priv->accountCode = qof_string_cache_replace(priv->accountCode, str ? str : "");
+    account_tree_changed (acc);
     mark_account (acc);
     xaccAccountCommitEdit(acc);
 }
@@ -2566,6 +2790,7 @@ gnc_account_append_child (Account *new_parent, Account *child)
     }
     cpriv->parent = new_parent;
     ppriv->children = g_list_append(ppriv->children, child);
+    account_tree_changed (new_parent);
     qof_instance_set_dirty(&new_parent->inst);
     qof_instance_set_dirty(&child->inst);
 
@@ -2606,12 +2831,15 @@ gnc_account_remove_child (Account *parent, Account *child)
     ed.idx = g_list_index(ppriv->children, child);
 
     ppriv->children = g_list_remove(ppriv->children, child);
+    account_tree_changed (parent);
 
     /* Now send the event. */
     qof_event_gen(&child->inst, QOF_EVENT_REMOVE, &ed);
 
     /* clear the account's parent pointer after REMOVE event generation. */
     cpriv->parent = NULL;
+    /* The child now tops a tree of its own. */
+    account_tree_changed (child);
 
     qof_event_gen (&parent->inst, QOF_EVENT_MODIFY, NULL);
 }
@@ -2829,6 +3057,81 @@ gnc_account_lookup_by_name (const Account *parent, const char * name)
     return NULL;
 }
 
+/* Fills the name index with the descendants of acc, setting their
+ * cached full names on the way. The first account in tree order wins
+ * for duplicate full names, as in gnc_account_lookup_by_full_name_helper.
+ * Accounts below a name containing the separator can't be found by
+ * splitting a full name and are left out. */
+static void
+account_index_full_names (GHashTable *index, const Account *acc,
+                          const gchar *prefix, gboolean reachable, guint gen)
+{
+    for (GList *node = GET_PRIVATE(acc)->children; node; node = node->next)
+    {
+        Account *child = static_cast<Account*>(node->data);
+        AccountPrivate *cpriv = GET_PRIVATE(child);
+        gboolean child_reachable;
+
+        g_free(cpriv->full_name);
+        cpriv->full_name = prefix ?
+            g_strconcat(prefix, account_separator, cpriv->accountName, nullptr) :
+            g_strdup(cpriv->accountName);
+        cpriv->full_name_gen = gen;
+
+        child_reachable = reachable &&
+            strstr(cpriv->accountName, account_separator) == NULL;
+        if (child_reachable && !g_hash_table_contains(index, cpriv->full_name))
+            g_hash_table_insert(index, cpriv->full_name, child);
+        account_index_full_names(index, child, cpriv->full_name,
+                                 child_reachable, gen);
+    }
+}
+
+/* Same search order as the recursion in gnc_account_lookup_by_code:
+ * a node's children before any of their descendants. */
+static void
+account_index_codes (GHashTable *index, const Account *acc)
+{
+    const AccountPrivate *ppriv = GET_PRIVATE(acc);
+    GList *node;
+
+    for (node = ppriv->children; node; node = node->next)
+    {
+        Account *child = static_cast<Account*>(node->data);
+        const char *code = GET_PRIVATE(child)->accountCode;
+        if (code && !g_hash_table_contains(index, code))
+            g_hash_table_insert(index, (gpointer)code, child);
+    }
+    for (node = ppriv->children; node; node = node->next)
+        account_index_codes(index, static_cast<Account*>(node->data));
+}
+
+/* Returns the private data of root with current lookup indexes. The
+ * index keys belong to the accounts: cached full names and the
+ * accountCode strings. Call with account_cache_mutex held and keep it
+ * while using the indexes. */
+static AccountPrivate *
+account_get_lookup_index (const Account *root)
+{
+    AccountPrivate *rpriv = GET_PRIVATE(root);
+    guint gen = account_tree_generation (root);
+
+    if (rpriv->name_index && rpriv->index_gen == gen)
+        return rpriv;
+
+    if (rpriv->name_index)
+    {
+        g_hash_table_destroy(rpriv->name_index);
+        g_hash_table_destroy(rpriv->code_index);
+    }
+    rpriv->name_index = g_hash_table_new(g_str_hash, g_str_equal);
+    rpriv->code_index = g_hash_table_new(g_str_hash, g_str_equal);
+    account_index_full_names(rpriv->name_index, root, nullptr, TRUE, gen);
+    account_index_codes(rpriv->code_index, root);
+    rpriv->index_gen = gen;
+    return rpriv;
+}
+
 Account *
 gnc_account_lookup_by_code (const Account *parent, const char * code)
 {
@@ -2839,6 +3142,14 @@ gnc_account_lookup_by_code (const Account *parent, const char * code)
     g_return_val_if_fail(GNC_IS_ACCOUNT(parent), NULL);
     g_return_val_if_fail(code, NULL);
 
+    /* Searches of a whole tree go through the root's index. */
+    if (!GET_PRIVATE(parent)->parent)
+    {
+        std::lock_guard<std::mutex> lock (account_cache_mutex);
+        return static_cast<Account*>(g_hash_table_lookup(
+            account_get_lookup_index(parent)->code_index, code));
+    }
+
     /* first, look for accounts hanging off the current node */
     ppriv = GET_PRIVATE(parent);
     for (node = ppriv->children; node; node = node->next)
@@ -2914,12 +3225,14 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
 {
     const AccountPrivate *rpriv;
     const Account *root;
-    Account *found;
-    gchar **names;
 
     g_return_val_if_fail(GNC_IS_ACCOUNT(any_acc), NULL);
     g_return_val_if_fail(name, NULL);
 
+    /* An empty name splits into no names at all, which never matches. */
+    if (*name == '\0')
+        return NULL;
+
     root = any_acc;
     rpriv = GET_PRIVATE(root);
     while (rpriv->parent)
@@ -2927,10 +3240,9 @@ gnc_account_lookup_by_full_name (const Account *any_acc,
         root = rpriv->parent;
         rpriv = GET_PRIVATE(root);
     }
-    names = g_strsplit(name, gnc_get_account_separator_string(), -1);
-    found = gnc_account_lookup_by_full_name_helper(root, names);
-    g_strfreev(names);
-    return found;
+    std::lock_guard<std::mutex> lock (account_cache_mutex);
+    rpriv = account_get_lookup_index(root);
+    return static_cast<Account*>(g_hash_table_lookup(rpriv->name_index, name));
 }
 
 void
@@ -3034,11 +3346,12 @@ xaccAccountGetName (const Account *acc)
 gchar *
 gnc_account_get_full_name(const Account *account)
 {
-    AccountPrivate *priv;
+    AccountPrivate *priv, *apriv;
     const Account *a;
     char *fullname;
     gchar **names;
     int level;
+    guint gen;
 
     /* So much for hardening the API. Too many callers to this function don't
      * bother to check if they have a non-NULL pointer before calling. */
@@ -3049,10 +3362,15 @@ gnc_account_get_full_name(const Account *account)
     g_return_val_if_fail(GNC_IS_ACCOUNT(account), g_strdup(""));
 
     /* optimizations */
-    priv = GET_PRIVATE(account);
+    priv = apriv = GET_PRIVATE(account);
     if (!priv->parent)
         return g_strdup("");
 
+    std::lock_guard<std::mutex> lock (account_cache_mutex);
+    gen = account_tree_generation (account);
+    if (apriv->full_name && apriv->full_name_gen == gen)
+        return g_strdup(apriv->full_name);
+
     /* Figure out how much space is needed by counting the nodes up to
      * the root. */
     level = 0;
@@ -3076,6 +3394,10 @@ gnc_account_get_full_name(const Account *account)
     fullname =  g_strjoinv(account_separator, names);
     g_free(names);
 
+    g_free(apriv->full_name);
+    apriv->full_name = g_strdup(fullname);
+    apriv->full_name_gen = gen;
+
     return fullname;
 }
 
@@ -3200,6 +3522,7 @@ gnc_account_set_start_balance (Account *acc, const gnc_numeric start_baln)
     priv = GET_PRIVATE(acc);
     priv->starting_balance = start_baln;
     priv->balance_dirty = TRUE;
+    mark_split_balances_stale (priv);
 }
 
 void
@@ -3213,6 +3536,7 @@ gnc_account_set_start_cleared_balance (Account *acc,
     priv = GET_PRIVATE(acc);
     priv->starting_cleared_balance = start_baln;
     priv->balance_dirty = TRUE;
+    mark_split_balances_stale (priv);
 }
 
 void
@@ -3226,6 +3550,7 @@ gnc_account_set_start_reconciled_balance (Account *acc,
     priv = GET_PRIVATE(acc);
     priv->starting_reconciled_balance = start_baln;
     priv->balance_dirty = TRUE;
+    mark_split_balances_stale (priv);
 }
 
 gnc_numeric
@@ -3342,6 +3667,44 @@ xaccAccountGetBalanceAsOfDate (Account *acc, time64 date)
     return( balance );
 }
 
+void
+xaccAccountGetBalancesAtDates (const Account *acc, const time64 *dates,
+                               gsize n_dates, gnc_numeric *amounts,
+                               gnc_numeric *values)
+{
+    g_return_if_fail (GNC_IS_ACCOUNT(acc));
+    g_return_if_fail (dates || !n_dates);
+
+    /* Visit the dates in ascending order while walking the (date
+     * sorted) split list once, filling in the results in the caller's
+     * order. */
+    std::vector<gsize> order (n_dates);
+    std::iota (order.begin(), order.end(), 0);
+    std::stable_sort (order.begin(), order.end(),
+                      [dates](gsize a, gsize b) { return dates[a] < dates[b]; });
+
+    xaccAccountSortSplits (const_cast<Account*>(acc), TRUE); /* normally a noop */
+
+    auto amount = gnc_numeric_zero ();
+    auto value = gnc_numeric_zero ();
+    auto lp = GET_PRIVATE(acc)->splits;
+    for (auto index : order)
+    {
+        for (; lp; lp = g_list_next (lp))
+        {
+            auto split = static_cast<Split*>(lp->data);
+            if (xaccTransGetDate (xaccSplitGetParent (split)) > dates[index])
+                break;
+            amount = gnc_numeric_add_fixed (amount, xaccSplitGetAmount (split));
+            value = gnc_numeric_add_fixed (value, xaccSplitGetValue (split));
+        }
+        if (amounts)
+            amounts[index] = amount;
+        if (values)
+            values[index] = value;
+    }
+}
+
 /*
  * Originally gsr_account_present_balance in gnc-split-reg.c
  *
@@ -3703,6 +4066,13 @@ xaccAccountGetSplitList (const Account *acc)
     return GET_PRIVATE(acc)->splits;
 }
 
+guint
+gnc_account_get_splits_generation (const Account *acc)
+{
+    g_return_val_if_fail(GNC_IS_ACCOUNT(acc), 0);
+    return GET_PRIVATE(acc)->splits_gen;
+}
+
 gint64
 xaccAccountCountSplits (const Account *acc, gboolean include_children)
 {
@@ -5041,6 +5411,100 @@ xaccAccountForEachTransaction(const Account *acc, TransactionCallback proc,
     return xaccAccountStagedTransactionTraversal(acc, 42, proc, data);
 }
 
+/* Parallel, read-only traversal. Instead of stamping Transaction::marker
+ * the unique transactions are gathered into a vector (sorted and
+ * deduplicated by address) and the vector is handed out to the worker
+ * threads in chunks, so nothing in the book is written to and several
+ * traversals may run at once. */
+
+#define PARALLEL_TRAVERSAL_CHUNK 256
+
+struct ParallelTraversal
+{
+    std::vector<Transaction*> txns;
+    std::atomic<size_t> next;
+    std::atomic<int> retval;
+    TransactionCallback proc;
+    void *data;
+};
+
+static void
+collect_account_transactions (Account *acc, gpointer data)
+{
+    auto txns = static_cast<std::vector<Transaction*>*>(data);
+    for (auto node = GET_PRIVATE(acc)->splits; node; node = g_list_next(node))
+    {
+        auto trans = static_cast<Split*>(node->data)->parent;
+        if (trans)
+            txns->push_back (trans);
+    }
+}
+
+static gpointer
+parallel_traversal_worker (gpointer data)
+{
+    auto pt = static_cast<ParallelTraversal*>(data);
+    auto n_txns = pt->txns.size();
+
+    while (pt->retval.load (std::memory_order_relaxed) == 0)
+    {
+        auto begin = pt->next.fetch_add (PARALLEL_TRAVERSAL_CHUNK);
+        if (begin >= n_txns)
+            break;
+        auto end = std::min (begin + PARALLEL_TRAVERSAL_CHUNK, n_txns);
+        for (auto i = begin; i < end; ++i)
+        {
+            auto result = pt->proc (pt->txns[i], pt->data);
+            if (result)
+            {
+                int expected = 0;
+                pt->retval.compare_exchange_strong (expected, result);
+                return nullptr;
+            }
+        }
+    }
+    return nullptr;
+}
+
+int
+xaccAccountTreeForEachTransactionParallel (const Account *acc,
+                                           TransactionCallback proc,
+                                           void *data, guint n_threads)
+{
+    ParallelTraversal pt;
+
+    if (!acc || !proc) return 0;
+
+    collect_account_transactions (const_cast<Account*>(acc), &pt.txns);
+    gnc_account_foreach_descendant (acc, collect_account_transactions,
+                                    &pt.txns);
+    std::sort (pt.txns.begin(), pt.txns.end());
+    pt.txns.erase (std::unique (pt.txns.begin(), pt.txns.end()),
+                   pt.txns.end());
+
+    pt.next = 0;
+    pt.retval = 0;
+    pt.proc = proc;
+    pt.data = data;
+
+    if (n_threads == 0)
+        n_threads = g_get_num_processors ();
+    n_threads = std::min<size_t> (n_threads,
+                                  (pt.txns.size() + PARALLEL_TRAVERSAL_CHUNK - 1)
+                                  / PARALLEL_TRAVERSAL_CHUNK);
+
+    /* The calling thread is one of the workers. */
+    std::vector<GThread*> threads;
+    for (guint i = 1; i < n_threads; ++i)
+        threads.push_back (g_thread_new ("gnc-txn-traversal",
+                                         parallel_traversal_worker, &pt));
+    parallel_traversal_worker (&pt);
+    for (auto thread : threads)
+        g_thread_join (thread);
+
+    return pt.retval;
+}
+
 /* ================================================================ */
 /* The following functions are used by
  * src/import-export/import-backend.c to manipulate the contra-account
@@ -5143,14 +5607,36 @@ gnc_account_imap_delete_account (GncImportMatchMap *imap,
  */
 struct AccountProbability
 {
-    double product; /* product of probabilities */
-    double product_difference; /* product of (1-probabilities) */
+    double product = 1.0; /* product of probabilities */
+    double product_difference = 1.0; /* product of (1-probabilities) */
+};
+
+/** The candidate accounts of one lookup. Each account GUID found in the
+  map gets a dense id the first time it turns up, so that scoring the
+  tokens indexes a flat array instead of comparing GUID strings.
+ */
+struct BayesCandidates
+{
+    std::unordered_map<std::string, size_t> ids;
+    std::vector<std::string> account_guids;
+    std::vector<AccountProbability> probabilities;
+
+    size_t id_for (std::string && account_guid)
+    {
+        auto res = ids.emplace (std::move (account_guid), account_guids.size ());
+        if (res.second)
+        {
+            account_guids.push_back (res.first->first);
+            probabilities.emplace_back ();
+        }
+        return res.first->second;
+    }
 };
 
 struct AccountTokenCount
 {
-    std::string account_guid;
-    int64_t token_count; /** occurrences of a given token for this account_guid */
+    size_t account_id;
+    int64_t token_count; /** occurrences of a given token for this account */
 };
 
 /** total_count and the token_count for a given account let us calculate the
@@ -5158,6 +5644,7 @@ struct AccountTokenCount
  */
 struct TokenAccountsInfo
 {
+    BayesCandidates & candidates;
     std::vector<AccountTokenCount> accounts;
     int64_t total_count;
 };
@@ -5174,13 +5661,15 @@ struct AccountInfo
 static void
 build_token_info(char const * key, KvpValue * value, TokenAccountsInfo & tokenInfo)
 {
-    tokenInfo.total_count += value->get<int64_t>();
-    AccountTokenCount this_account;
-    std::string account_guid {key};
+    auto token_count = value->get<int64_t>();
+    auto key_len = strlen (key);
+    tokenInfo.total_count += token_count;
     /*By convention, the key ends with the account GUID.*/
-    this_account.account_guid = account_guid.substr(account_guid.size() - GUID_ENCODING_LENGTH);
-    this_account.token_count = value->get<int64_t>();
-    tokenInfo.accounts.push_back(this_account);
+    if (key_len < GUID_ENCODING_LENGTH)
+        return;
+    std::string account_guid {key + key_len - GUID_ENCODING_LENGTH};
+    tokenInfo.accounts.push_back ({tokenInfo.candidates.id_for (std::move (account_guid)),
+                                   token_count});
 }
 
 /** We scale the probability values by probability_factor.
@@ -5189,19 +5678,20 @@ build_token_info(char const * key, KvpValue * value, TokenAccountsInfo & tokenIn
 static constexpr int probability_factor = 100000;
 
 static FinalProbabilityVec
-build_probabilities(ProbabilityVec const & first_pass)
+build_probabilities(BayesCandidates const & candidates)
 {
     FinalProbabilityVec ret;
-    for (auto const & first_pass_prob : first_pass)
+    ret.reserve (candidates.account_guids.size ());
+    for (size_t id = 0; id < candidates.account_guids.size (); ++id)
     {
-        auto const & account_probability = first_pass_prob.second;
+        auto const & account_probability = candidates.probabilities[id];
         /* P(AB) = A*B / [A*B + (1-A)*(1-B)]
          * NOTE: so we only keep track of a running product(A*B*C...)
          * and product difference ((1-A)(1-B)...)
          */
         int32_t probability = (account_probability.product /
                 (account_probability.product + account_probability.product_difference)) * probability_factor;
-        ret.push_back({first_pass_prob.first, probability});
+        ret.push_back({candidates.account_guids[id], probability});
     }
     return ret;
 }
@@ -5216,38 +5706,34 @@ highest_probability(FinalProbabilityVec const & probabilities)
     return ret;
 }
 
-static ProbabilityVec
+/* Only the ratio of product and product_difference matters, so when both
+ * get small enough to lose precision they are scaled up together. A power
+ * of two keeps the scaling exact. */
+static const double rescale_below = std::ldexp (1.0, -512);
+static const double rescale_by = std::ldexp (1.0, 512);
+
+static BayesCandidates
 get_first_pass_probabilities(GncImportMatchMap * imap, GList * tokens)
 {
-    ProbabilityVec ret;
+    BayesCandidates ret;
     /* find the probability for each account that contains any of the tokens
      * in the input tokens list. */
     for (auto current_token = tokens; current_token; current_token = current_token->next)
     {
-        TokenAccountsInfo tokenInfo{};
+        TokenAccountsInfo tokenInfo{ret, {}, 0};
         auto path = std::string{IMAP_FRAME_BAYES "/"} + static_cast <char const *> (current_token->data);
         qof_instance_foreach_slot_prefix (QOF_INSTANCE (imap->acc), path, &build_token_info, tokenInfo);
         for (auto const & current_account_token : tokenInfo.accounts)
         {
-            auto item = std::find_if(ret.begin(), ret.end(), [&current_account_token]
-                (std::pair<std::string, AccountProbability> const & a) {
-                    return current_account_token.account_guid == a.first;
-                });
-            if (item != ret.end())
-            {/* This account is already in the map */
-                item->second.product = ((double)current_account_token.token_count /
-                                      (double)tokenInfo.total_count) * item->second.product;
-                item->second.product_difference = ((double)1 - ((double)current_account_token.token_count /
-                                              (double)tokenInfo.total_count)) * item->second.product_difference;
-            }
-            else
+            auto & item = ret.probabilities[current_account_token.account_id];
+            auto probability = (double)current_account_token.token_count /
+                               (double)tokenInfo.total_count;
+            item.product *= probability;
+            item.product_difference *= 1 - probability;
+            if (item.product < rescale_below && item.product_difference < rescale_below)
             {
-                /* add a new entry */
-                AccountProbability new_probability;
-                new_probability.product = ((double)current_account_token.token_count /
-                                      (double)tokenInfo.total_count);
-                new_probability.product_difference = 1 - (new_probability.product);
-                ret.push_back({current_account_token.account_guid, std::move(new_probability)});
+                item.product *= rescale_by;
+                item.product_difference *= rescale_by;
             }
         } /* for all accounts in tokenInfo */
     }
@@ -5418,7 +5904,7 @@ gnc_account_imap_find_account_bayes (GncImportMatchMap *imap, GList *tokens)
         return nullptr;
     check_import_map_data (imap->book);
     auto first_pass = get_first_pass_probabilities(imap, tokens);
-    if (!first_pass.size())
+    if (first_pass.account_guids.empty())
         return nullptr;
     auto final_probabilities = build_probabilities(first_pass);
     if (!final_probabilities.size())
@@ -557,6 +557,24 @@ gnc_numeric xaccAccountGetProjectedMinimumBalance (const Account *account);
 /** Get the balance of the account as of the date specified */
 gnc_numeric xaccAccountGetBalanceAsOfDate (Account *account,
         time64 date);
+/** Get the balance of the account as of each of several dates in a
+ *  single pass over its splits. A split counts towards the balance at
+ *  a date if its transaction was posted on or before that date.
+ *
+ *  @param account The account.
+ *  @param dates The dates, in any order.
+ *  @param n_dates The number of entries in @a dates.
+ *  @param amounts If not NULL, receives the balance in the account's
+ *  commodity as of dates[i] in amounts[i].
+ *  @param values If not NULL, receives the sum of the split values,
+ *  i.e. the balance in the transaction currencies, as of dates[i] in
+ *  values[i]. This is only meaningful if all of the account's
+ *  transactions are in the same currency.
+ */
+void xaccAccountGetBalancesAtDates (const Account *account,
+                                    const time64 *dates, gsize n_dates,
+                                    gnc_numeric *amounts,
+                                    gnc_numeric *values);
 
 /* These two functions convert a given balance from one commodity to
    another.  The account argument is only used to get the Book, and
@@ -1012,6 +1030,14 @@ SplitList* xaccAccountGetSplitList (const Account *account);
  */
 gint64 xaccAccountCountSplits (const Account *acc, gboolean include_children);
 
+/** Return a counter bumped every time a split is inserted into or
+ *  removed from the account, whether events are suspended or not.
+ *  Lets a cache of the split list tell in constant time whether the
+ *  list changed since it was filled.
+ * @param acc the account whose split list is watched
+ */
+guint gnc_account_get_splits_generation (const Account *acc);
+
 /** The xaccAccountMoveAllSplits() routine reassigns each of the splits
  *  in accfrom to accto. */
 void xaccAccountMoveAllSplits (Account *accfrom, Account *accto);
@@ -1390,6 +1416,37 @@ int gnc_account_tree_staged_transaction_traversal(const Account *account,
 int xaccAccountTreeForEachTransaction(Account *acc,
                                       TransactionCallback proc, void *data);
 
+/** Traverse all of the transactions in the account tree topped by @a acc
+ * on @a n_threads threads, calling @a proc exactly once for each
+ * transaction that has a split in any account of the tree.
+ *
+ * Unlike xaccAccountTreeForEachTransaction() this does not use the
+ * transaction traversal markers: the unique transactions are collected
+ * up front and partitioned among the worker threads, so nothing is
+ * written to the book and any number of these traversals may run
+ * concurrently with each other and with staged traversals.
+ *
+ * If @a proc returns a non-zero value the traversal is stopped as soon
+ * as every worker notices; transactions already handed to other workers
+ * may still be visited. The first non-zero value returned by @a proc is
+ * the return value, otherwise 0.
+ *
+ * \warning @a proc is called from several threads at once and must
+ * therefore be thread safe. It must treat the transaction and the rest
+ * of the book as read-only: no edits, no commits and no events. The
+ * running split balances, xaccSplitGetBalance() and its siblings, are
+ * computed on demand and must not be asked for either.
+ *
+ * @param acc The root of the account tree to traverse.
+ * @param proc The callback, called from several threads at once.
+ * @param data User data passed to @a proc.
+ * @param n_threads The number of threads to use, including the calling
+ * thread. 0 means one per processor.
+ */
+int xaccAccountTreeForEachTransactionParallel(const Account *acc,
+                                              TransactionCallback proc,
+                                              void *data, guint n_threads);
+
 /** Obtain an ImportMatchMap object from an Account or a Book
  */
 GncImportMatchMap *gnc_account_imap_create_imap (Account *acc);
@@ -112,10 +112,16 @@ typedef struct AccountPrivate
     gnc_numeric cleared_balance;
     gnc_numeric reconciled_balance;
 
-    gboolean balance_dirty;     /* balances in splits incorrect */
+    gboolean balance_dirty;     /* cached balances incorrect */
 
     GList *splits;              /* list of split pointers */
     gboolean sort_dirty;        /* sort order of splits is bad */
+    guint splits_gen;           /* bumped when a split is inserted or removed */
+
+    /* Running balances of the splits, in split order, kept out of the
+     * splits themselves. Filled in by gnc_account_get_split_balances()
+     * the first time one is asked for after the splits change. */
+    struct SplitBalances *split_balances;
 
     LotList   *lots;		/* list of lot pointers */
     GNCPolicy *policy;		/* Cached pointer to policy method */
@@ -124,6 +130,22 @@ typedef struct AccountPrivate
      * in any way desired.  Handy for specialty traversals of the
      * account tree. */
     short mark;
+
+    /* Cached full name, valid while full_name_gen matches the
+     * generation of the account's tree. */
+    char *full_name;
+    guint full_name_gen;
+
+    /* Root accounts only: full name -> Account and code -> Account
+     * indexes used by gnc_account_lookup_by_full_name and
+     * gnc_account_lookup_by_code, rebuilt when index_gen is stale. */
+    GHashTable *name_index;
+    GHashTable *code_index;
+    guint index_gen;
+
+    /* Top accounts only: the generation of the tree below, see
+     * account_cache_mutex in Account.cpp. */
+    guint tree_gen;
 } AccountPrivate;
 
 struct account_s
@@ -139,6 +161,17 @@ void xaccAccountSetGUID (Account *account, const GncGUID *guid);
 /* Register Accounts with the engine */
 gboolean xaccAccountRegister (void);
 
+/* Look up the balance, cleared balance and reconciled balance of acc
+ * up to and including split, in the order of the account's split
+ * list. The running balances of all of acc's splits are computed
+ * together when they are out of date. Any of the results may be NULL.
+ * Returns FALSE, leaving the results alone, if split isn't in acc. */
+gboolean gnc_account_get_split_balances (const Account *acc,
+                                         const Split *split,
+                                         gnc_numeric *balance,
+                                         gnc_numeric *cleared_balance,
+                                         gnc_numeric *reconciled_balance);
+
 /* Structure for accessing static functions for testing */
 typedef struct
 {
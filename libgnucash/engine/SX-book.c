@@ -214,7 +214,7 @@ gnc_sxes_add_sx(SchedXactions *sxes, SchedXaction *sx)
     if (g_list_find(sxes->sx_list, sx) != NULL)
         return;
     sxes->sx_list = g_list_append(sxes->sx_list, sx);
-    qof_event_gen(&sxes->inst, GNC_EVENT_ITEM_ADDED, (gpointer)sx);
+    qof_event_gen_item(&sxes->inst, GNC_EVENT_ITEM_ADDED, &sx->inst);
 }
 
 void
@@ -225,7 +225,7 @@ gnc_sxes_del_sx(SchedXactions *sxes, SchedXaction *sx)
     if (to_remove == NULL)
         return;
     sxes->sx_list = g_list_delete_link(sxes->sx_list, to_remove);
-    qof_event_gen(&sxes->inst, GNC_EVENT_ITEM_REMOVED, (gpointer)sx);
+    qof_event_gen_item(&sxes->inst, GNC_EVENT_ITEM_REMOVED, &sx->inst);
 }
 
 /* ====================================================================== */
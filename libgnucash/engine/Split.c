@@ -97,6 +97,86 @@ enum
 
 };
 
+/* The account and transaction a split was last committed to. They are
+ * only needed while the split is being moved, so instead of keeping
+ * them in every split they are saved here when a committed split's
+ * account or transaction first changes, and dropped when it is
+ * committed or rolled back. */
+typedef struct
+{
+    Account *acc;
+    Transaction *parent;
+} SplitOrig;
+
+/* Like the rest of the engine this is not thread safe. The parallel
+ * transaction traversal may only read it, it never edits a split. */
+static GHashTable *split_origs = NULL;
+
+static void
+split_orig_free (gpointer data)
+{
+    g_slice_free (SplitOrig, data);
+}
+
+static SplitOrig *
+split_lookup_orig (const Split *s)
+{
+    return split_origs ? g_hash_table_lookup (split_origs, s) : NULL;
+}
+
+static void
+split_set_orig (Split *s, Account *acc, Transaction *parent)
+{
+    SplitOrig *orig = split_lookup_orig (s);
+
+    if (!orig)
+    {
+        if (!split_origs)
+            split_origs = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                                 NULL, split_orig_free);
+        orig = g_slice_new (SplitOrig);
+        g_hash_table_insert (split_origs, s, orig);
+    }
+    orig->acc = acc;
+    orig->parent = parent;
+}
+
+static Account *
+split_orig_acc (const Split *s)
+{
+    SplitOrig *orig = split_lookup_orig (s);
+
+    if (orig)
+        return orig->acc;
+    return s->committed ? s->acc : NULL;
+}
+
+static Transaction *
+split_orig_parent (const Split *s)
+{
+    SplitOrig *orig = split_lookup_orig (s);
+
+    if (orig)
+        return orig->parent;
+    return s->committed ? s->parent : NULL;
+}
+
+/* Call before changing the account or transaction of s. A split that
+ * was never committed has nothing to remember. */
+static void
+split_save_orig (Split *s)
+{
+    if (s->committed && !split_lookup_orig (s))
+        split_set_orig (s, s->acc, s->parent);
+}
+
+static void
+split_clear_orig (Split *s)
+{
+    if (split_origs)
+        g_hash_table_remove (split_origs, s);
+}
+
 /* GObject Initialization */
 G_DEFINE_TYPE(Split, gnc_split, QOF_TYPE_INSTANCE)
 
@@ -105,9 +185,9 @@ gnc_split_init(Split* split)
 {
     /* fill in some sane defaults */
     split->acc         = NULL;
-    split->orig_acc    = NULL;
     split->parent      = NULL;
     split->lot         = NULL;
+    split->committed   = FALSE;
 
     split->action      = CACHE_INSERT("");
     split->memo        = CACHE_INSERT("");
@@ -117,10 +197,6 @@ gnc_split_init(Split* split)
 
     split->date_reconciled  = 0;
 
-    split->balance             = gnc_numeric_zero();
-    split->cleared_balance     = gnc_numeric_zero();
-    split->reconciled_balance  = gnc_numeric_zero();
-
     split->gains = GAINS_STATUS_UNKNOWN;
     split->gains_split = NULL;
 }
@@ -134,6 +210,7 @@ gnc_split_dispose(GObject *splitp)
 static void
 gnc_split_finalize(GObject* splitp)
 {
+    split_clear_orig (GNC_SPLIT (splitp));
     G_OBJECT_CLASS(gnc_split_parent_class)->finalize(splitp);
 }
 /* Note that g_value_set_object() refs the object, as does
@@ -496,9 +573,10 @@ xaccInitSplit(Split * split, QofBook *book)
 void
 xaccSplitReinit(Split * split)
 {
-    /* fill in some sane defaults */
+    /* fill in some sane defaults; the split forgets its account but
+     * not the transaction it was committed to. */
+    split_set_orig (split, NULL, split_orig_parent (split));
     split->acc         = NULL;
-    split->orig_acc    = NULL;
     split->parent      = NULL;
     split->lot         = NULL;
 
@@ -510,10 +588,6 @@ xaccSplitReinit(Split * split)
 
     split->date_reconciled  = 0;
 
-    split->balance             = gnc_numeric_zero();
-    split->cleared_balance     = gnc_numeric_zero();
-    split->reconciled_balance  = gnc_numeric_zero();
-
     qof_instance_set_idata(split, 0);
 
     split->gains = GAINS_STATUS_UNKNOWN;
@@ -559,7 +633,6 @@ xaccDupeSplit (const Split *s)
 
     split->parent = s->parent;
     split->acc = s->acc;
-    split->orig_acc = s->orig_acc;
     split->lot = s->lot;
 
     split->memo = CACHE_INSERT(s->memo);
@@ -573,11 +646,7 @@ xaccDupeSplit (const Split *s)
     split->value = s->value;
     split->amount = s->amount;
 
-    /* no need to futz with the balances;  these get wiped each time ...
-     * split->balance             = s->balance;
-     * split->cleared_balance     = s->cleared_balance;
-     * split->reconciled_balance  = s->reconciled_balance;
-     */
+    /* no need to futz with the balances; they belong to the account */
 
     return split;
 }
@@ -594,9 +663,6 @@ xaccSplitCloneNoKvp (const Split *s)
     split->date_reconciled     = s->date_reconciled;
     split->value               = s->value;
     split->amount              = s->amount;
-    split->balance             = s->balance;
-    split->cleared_balance     = s->cleared_balance;
-    split->reconciled_balance  = s->reconciled_balance;
 
     split->gains = GAINS_STATUS_UNKNOWN;
     split->gains_split = NULL;
@@ -675,10 +741,12 @@ xaccSplitDump (const Split *split, const char *tag)
 
     printf("    Value:    %s\n", gnc_numeric_to_string(split->value));
     printf("    Amount:   %s\n", gnc_numeric_to_string(split->amount));
-    printf("    Balance:  %s\n", gnc_numeric_to_string(split->balance));
-    printf("    CBalance: %s\n", gnc_numeric_to_string(split->cleared_balance));
+    printf("    Balance:  %s\n",
+           gnc_numeric_to_string(xaccSplitGetBalance(split)));
+    printf("    CBalance: %s\n",
+           gnc_numeric_to_string(xaccSplitGetClearedBalance(split)));
     printf("    RBalance: %s\n",
-           gnc_numeric_to_string(split->reconciled_balance));
+           gnc_numeric_to_string(xaccSplitGetReconciledBalance(split)));
     printf("    idata:    %x\n", qof_instance_get_idata(split));
 }
 #endif
@@ -709,7 +777,7 @@ xaccFreeSplit (Split *split)
     split->parent      = NULL;
     split->lot         = NULL;
     split->acc         = NULL;
-    split->orig_acc    = NULL;
+    split_clear_orig (split);
 
     split->date_reconciled = 0;
     G_OBJECT_CLASS (QOF_INSTANCE_GET_CLASS (&split->inst))->dispose(G_OBJECT (split));
@@ -860,13 +928,16 @@ xaccSplitEqual(const Split *sa, const Split *sb,
 
     if (check_balances)
     {
-        if (!xaccSplitEqualCheckBal ("", sa->balance, sb->balance))
+        if (!xaccSplitEqualCheckBal ("", xaccSplitGetBalance (sa),
+                                     xaccSplitGetBalance (sb)))
             return FALSE;
-        if (!xaccSplitEqualCheckBal ("cleared ", sa->cleared_balance,
-                                     sb->cleared_balance))
+        if (!xaccSplitEqualCheckBal ("cleared ",
+                                     xaccSplitGetClearedBalance (sa),
+                                     xaccSplitGetClearedBalance (sb)))
             return FALSE;
-        if (!xaccSplitEqualCheckBal ("reconciled ", sa->reconciled_balance,
-                                     sb->reconciled_balance))
+        if (!xaccSplitEqualCheckBal ("reconciled ",
+                                     xaccSplitGetReconciledBalance (sa),
+                                     xaccSplitGetReconciledBalance (sb)))
             return FALSE;
     }
 
@@ -926,6 +997,7 @@ xaccSplitSetAccount (Split *s, Account *acc)
     if (trans)
         xaccTransBeginEdit(trans);
 
+    split_save_orig(s);
     s->acc = acc;
     qof_instance_set_dirty(QOF_INSTANCE(s));
 
@@ -945,12 +1017,14 @@ xaccSplitCommitEdit(Split *s)
 {
     Account *acc = NULL;
     Account *orig_acc = NULL;
+    Transaction *orig_parent = NULL;
 
     g_return_if_fail(s);
     if (!qof_instance_is_dirty(QOF_INSTANCE(s)))
         return;
 
-    orig_acc = s->orig_acc;
+    orig_acc = split_orig_acc(s);
+    orig_parent = split_orig_parent(s);
 
     if (GNC_IS_ACCOUNT(s->acc))
         acc = s->acc;
@@ -986,11 +1060,11 @@ xaccSplitCommitEdit(Split *s)
         xaccSplitSetAmount(s, xaccSplitGetAmount(s));
     }
 
-    if (s->parent != s->orig_parent)
+    if (s->parent != orig_parent)
     {
         //FIXME: find better event
-        if (s->orig_parent)
-            qof_event_gen(&s->orig_parent->inst, QOF_EVENT_MODIFY,
+        if (orig_parent)
+            qof_event_gen(&orig_parent->inst, QOF_EVENT_MODIFY,
                           NULL);
     }
     if (s->lot)
@@ -1002,8 +1076,8 @@ xaccSplitCommitEdit(Split *s)
     /* Important: we save off the original parent transaction and account
        so that when we commit, we can generate signals for both the
        original and new transactions, for the _next_ begin/commit cycle. */
-    s->orig_acc = s->acc;
-    s->orig_parent = s->parent;
+    split_clear_orig(s);
+    s->committed = TRUE;
     if (!qof_commit_edit_part2(QOF_INSTANCE(s), commit_err, NULL,
                                (void (*) (QofInstance *)) xaccFreeSplit))
         return;
@@ -1019,12 +1093,12 @@ xaccSplitCommitEdit(Split *s)
 void
 xaccSplitRollbackEdit(Split *s)
 {
+    Transaction *orig_parent = split_orig_parent(s);
 
     /* Don't use setters because we want to allow NULL.  This is legit
        only because we don't emit events for changing accounts until
        the final commit. */
-    if (s->acc != s->orig_acc)
-        s->acc = s->orig_acc;
+    s->acc = split_orig_acc(s);
 
     /* Undestroy if needed */
     if (qof_instance_get_destroying(s) && s->parent)
@@ -1038,7 +1112,8 @@ xaccSplitRollbackEdit(Split *s)
 
     /* But for the parent trans, we want the intermediate events, so
        we use the setter. */
-    xaccSplitSetParent(s, s->orig_parent);
+    xaccSplitSetParent(s, orig_parent);
+    split_clear_orig(s);
 }
 
 /********************************************************************\
@@ -1269,19 +1344,28 @@ xaccSplitSetValue (Split *s, gnc_numeric amt)
 gnc_numeric
 xaccSplitGetBalance (const Split *s)
 {
-    return s ? s->balance : gnc_numeric_zero();
+    gnc_numeric balance = gnc_numeric_zero();
+    if (s && s->acc)
+        gnc_account_get_split_balances (s->acc, s, &balance, NULL, NULL);
+    return balance;
 }
 
 gnc_numeric
 xaccSplitGetClearedBalance (const Split *s)
 {
-    return s ? s->cleared_balance : gnc_numeric_zero();
+    gnc_numeric balance = gnc_numeric_zero();
+    if (s && s->acc)
+        gnc_account_get_split_balances (s->acc, s, NULL, &balance, NULL);
+    return balance;
 }
 
 gnc_numeric
 xaccSplitGetReconciledBalance (const Split *s)
 {
-    return s ? s->reconciled_balance : gnc_numeric_zero();
+    gnc_numeric balance = gnc_numeric_zero();
+    if (s && s->acc)
+        gnc_account_get_split_balances (s->acc, s, NULL, NULL, &balance);
+    return balance;
 }
 
 void
@@ -1812,7 +1896,8 @@ xaccSplitSetParent(Split *s, Transaction *t)
     g_return_if_fail(s);
     if (s->parent == t) return;
 
-    if (s->parent != s->orig_parent && s->orig_parent != t)
+    split_save_orig(s);
+    if (s->parent != split_orig_parent(s) && split_orig_parent(s) != t)
         PERR("You may not add the split to more than one transaction"
              " during the BeginEdit/CommitEdit block.");
     xaccTransBeginEdit(t);
@@ -2333,6 +2418,9 @@ _utest_split_fill_functions (void)
     func->get_currency_denom = get_currency_denom;
     func->get_commodity_denom = get_commodity_denom;
     func->get_corr_account_split = get_corr_account_split;
+    func->split_orig_acc = split_orig_acc;
+    func->split_orig_parent = split_orig_parent;
+    func->split_set_orig = split_set_orig;
     return func;
 }
 
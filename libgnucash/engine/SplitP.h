@@ -73,11 +73,9 @@ struct split_s
     QofInstance inst;
 
     Account *acc;              /* back-pointer to debited/credited account  */
-    Account *orig_acc;
     GNCLot *lot;               /* back-pointer to debited/credited lot */
 
     Transaction *parent;       /* parent of split                           */
-    Transaction *orig_parent;
 
     /* The memo field is an arbitrary user-assiged value.
      * It is intended to hold a short (zero to forty character) string
@@ -103,6 +101,15 @@ struct split_s
      */
     unsigned char  gains;
 
+    /* Set once the split has been through xaccSplitCommitEdit. The
+     * account and transaction it was committed to are only kept aside
+     * while it is being moved; see split_orig_acc() in Split.c. */
+    unsigned char  committed;
+
+    /* Position of the split in its account's running balances, valid
+     * while those are; see gnc_account_get_split_balances(). */
+    unsigned int   balance_index;
+
     /* 'gains_split' is a convenience pointer used to track down the
      * other end of a cap-gains transaction pair.  NULL if this split
      * doesn't involve cap gains.
@@ -114,17 +121,6 @@ struct split_s
      * commodity involved. */
     gnc_numeric  value;
     gnc_numeric  amount;
-
-    /* -------------------------------------------------------------- */
-    /* Below follow some 'temporary' fields */
-
-    /* The various "balances" are the sum of all of the values of
-     * all the splits in the account, up to and including this split.
-     * These balances apply to a sorting order by date posted
-     * (not by date entered). */
-    gnc_numeric  balance;
-    gnc_numeric  cleared_balance;
-    gnc_numeric  reconciled_balance;
 };
 
 struct _SplitClass
@@ -225,6 +221,9 @@ typedef struct
     int (*get_currency_denom) (const Split *s);
     int (*get_commodity_denom) (const Split *s);
     gboolean (*get_corr_account_split) (const Split *sa, const Split **retval);
+    Account* (*split_orig_acc) (const Split *s);
+    Transaction* (*split_orig_parent) (const Split *s);
+    void (*split_set_orig) (Split *s, Account *acc, Transaction *parent);
 } SplitTestFunctions;
 
 SplitTestFunctions* _utest_split_fill_functions (void);
@@ -26,9 +26,15 @@
 #define __USE_MINGW_ANSI_STDIO 1
 #endif
 #include <errno.h>
+#include <fcntl.h>
 #include <glib.h>
 #include <glib/gstdio.h>
 #include <string.h>
+#ifdef G_OS_WIN32
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
 
 #include "Account.h"
 #include "Transaction.h"
@@ -38,6 +44,9 @@
 #ifdef _MSC_VER
 # define g_fopen fopen
 #endif
+#ifndef O_BINARY
+# define O_BINARY 0
+#endif
 
 static QofLogModule log_module = "gnc.translog";
 
@@ -80,6 +89,15 @@ static QofLogModule log_module = "gnc.translog";
  *     occurred at a certain time, it can be located.
  * (-) hack alert -- something better than just the account name
  *     is needed for identifying the account.
+ *
+ * The binary journal trades (2) for speed: each transaction is one
+ * length-prefixed record, written with a single fwrite, holding the
+ * GUIDs, times and numerics in their raw form (little endian). The
+ * length prefix lets the reader stop cleanly at a record that was cut
+ * short by a crash. Flag bytes keep track of the dates and numerics
+ * a text log left empty, so converting one doesn't invent them.
+ * xaccLogConvertFile turns it back into text for anyone who wants to
+ * look at it.
  */
 /* ------------------------------------------------------------------ */
 
@@ -88,6 +106,66 @@ static int gen_logs = 1;
 static FILE * trans_log = NULL; /**< current log file handle */
 static char * trans_log_name = NULL; /**< current log file name */
 static char * log_base_name = NULL;
+static XaccLogFormat log_format = XACC_LOG_TEXT;
+static guint flush_interval = 1;
+static guint unflushed_trans = 0;
+static guint flush_period = 0; /**< msec, background writer only */
+static gint64 last_flush_time = 0;
+static gboolean fsync_on_close = FALSE;
+static GArray * log_entries = NULL; /**< entries of the trans being logged */
+static GString * log_record = NULL; /**< binary record being built */
+
+/* The background writer. Records are queued as binary records and
+ * written in order by the one writer thread. log_mutex protects
+ * trans_log, the flush state and the format while it runs. */
+static GThread * log_writer = NULL;
+static GAsyncQueue * log_queue = NULL;
+static GAsyncQueue * log_spare_items = NULL;
+static GMutex log_mutex;
+static GMutex sync_mutex;
+static GCond sync_cond;
+
+typedef enum
+{
+    LOG_ITEM_RECORD,
+    LOG_ITEM_SYNC,
+    LOG_ITEM_STOP,
+} LogItemType;
+
+typedef struct
+{
+    LogItemType type;
+    GString *record;
+    gboolean to_disk;
+    gboolean done;
+} LogQueueItem;
+
+static void log_writer_request (LogItemType type, gboolean to_disk);
+
+#define TEXT_LOG_START "===== START"
+#define TEXT_LOG_END "===== END"
+#define BINARY_LOG_MAGIC "GNCJNL02"
+#define BINARY_LOG_MAGIC_LEN 8
+
+/* The bits of the flag bytes of a binary record that say which fields
+ * were logged; the first two are in the transaction's, the others in
+ * each split's. */
+enum
+{
+    LOG_HAS_DATE_ENTERED = 1 << 0,
+    LOG_HAS_DATE_POSTED = 1 << 1,
+    LOG_HAS_ACCOUNT = 1 << 2,
+    LOG_HAS_AMOUNT = 1 << 3,
+    LOG_HAS_VALUE = 1 << 4,
+    LOG_HAS_DATE_RECONCILED = 1 << 5,
+};
+
+static const char text_log_header[] =
+    "mod\ttrans_guid\tsplit_guid\ttime_now\t"
+    "date_entered\tdate_posted\t"
+    "acc_guid\tacc_name\tnum\tdescription\t"
+    "notes\tmemo\taction\treconciled\t"
+    "amount\tvalue\tdate_reconciled\n";
 
 /********************************************************************\
 \********************************************************************/
@@ -131,6 +209,51 @@ xaccLogSetBaseName (const char *basepath)
 }
 
 
+void
+xaccLogSetFormat (XaccLogFormat format)
+{
+    if (format == log_format) return;
+
+    /* Records still queued are written in the old format */
+    if (trans_log)
+    {
+        xaccCloseLog();
+        log_format = format;
+        xaccOpenLog();
+    }
+    else
+        log_format = format;
+}
+
+XaccLogFormat
+xaccLogGetFormat (void)
+{
+    return log_format;
+}
+
+void
+xaccLogSetFlushInterval (guint n_trans)
+{
+    g_mutex_lock (&log_mutex);
+    flush_interval = MAX (n_trans, 1);
+    g_mutex_unlock (&log_mutex);
+}
+
+void
+xaccLogSetFlushPeriod (guint msec)
+{
+    g_mutex_lock (&log_mutex);
+    flush_period = msec;
+    g_mutex_unlock (&log_mutex);
+}
+
+void
+xaccLogSetFsyncOnClose (gboolean fsync)
+{
+    fsync_on_close = fsync;
+}
+
+
 /*
  * See if the provided file name is that of the current log file.
  * Since the filename is generated with a time-stamp we can ignore the
@@ -155,11 +278,25 @@ xaccFileIsCurrentLog (const gchar *name)
 /********************************************************************\
 \********************************************************************/
 
+static void
+log_write_header (FILE *log, XaccLogFormat format)
+{
+    if (format == XACC_LOG_BINARY)
+    {
+        fwrite (BINARY_LOG_MAGIC, BINARY_LOG_MAGIC_LEN, 1, log);
+        return;
+    }
+
+    fputs (text_log_header, log);
+    fprintf (log, "-----------------\n");
+}
+
 void
 xaccOpenLog (void)
 {
     char * filename;
     char * timestamp;
+    gboolean binary = (log_format == XACC_LOG_BINARY);
 
     if (!gen_logs)
     {
@@ -173,12 +310,15 @@ xaccOpenLog (void)
     /* tag each filename with a timestamp */
     timestamp = gnc_date_timestamp ();
 
-    filename = g_strconcat (log_base_name, ".", timestamp, ".log", NULL);
+    filename = g_strconcat (log_base_name, ".", timestamp,
+                            binary ? ".jnl" : ".log", NULL);
 
-    trans_log = g_fopen (filename, "a");
+    g_mutex_lock (&log_mutex);
+    trans_log = g_fopen (filename, binary ? "ab" : "a");
     if (!trans_log)
     {
         int norr = errno;
+        g_mutex_unlock (&log_mutex);
         printf ("Error: xaccOpenLog(): cannot open journal \n"
                 "\t %d %s\n", norr, g_strerror (norr) ? g_strerror (norr) : "");
 
@@ -195,38 +335,524 @@ xaccOpenLog (void)
     g_free (filename);
     g_free (timestamp);
 
-    /*  Note: this must match src/import-export/log-replay/gnc-log-replay.c */
-    fprintf (trans_log, "mod\ttrans_guid\tsplit_guid\ttime_now\t"
-             "date_entered\tdate_posted\t"
-             "acc_guid\tacc_name\tnum\tdescription\t"
-             "notes\tmemo\taction\treconciled\t"
-             "amount\tvalue\tdate_reconciled\n");
-    fprintf (trans_log, "-----------------\n");
+    /* A journal only starts with its magic; appending a second one
+     * would corrupt the records already in the file. */
+    fseek (trans_log, 0, SEEK_END);
+    if (!binary || ftell (trans_log) == 0)
+        log_write_header (trans_log, log_format);
+    g_mutex_unlock (&log_mutex);
 }
 
 /********************************************************************\
 \********************************************************************/
 
+/* Call with log_mutex held. */
+static void
+log_flush (gboolean to_disk)
+{
+    unflushed_trans = 0;
+    last_flush_time = g_get_monotonic_time ();
+    if (!trans_log) return;
+
+    fflush (trans_log);
+    if (to_disk)
+#ifdef G_OS_WIN32
+        _commit (_fileno (trans_log));
+#else
+        fsync (fileno (trans_log));
+#endif
+}
+
+void
+xaccLogSync (gboolean to_disk)
+{
+    if (log_writer)
+    {
+        log_writer_request (LOG_ITEM_SYNC, to_disk);
+        return;
+    }
+    g_mutex_lock (&log_mutex);
+    log_flush (to_disk);
+    g_mutex_unlock (&log_mutex);
+}
+
 void
 xaccCloseLog (void)
 {
     if (!trans_log) return;
-    fflush (trans_log);
+    xaccLogSync (fsync_on_close);
+
+    g_mutex_lock (&log_mutex);
     fclose (trans_log);
     trans_log = NULL;
+    unflushed_trans = 0;
+    g_mutex_unlock (&log_mutex);
 }
 
 /********************************************************************\
 \********************************************************************/
 
+/* Fields that weren't logged are written empty. */
+static void
+text_time (gboolean present, time64 t, char *buff)
+{
+    if (present)
+        gnc_time64_to_iso8601_buff (t, buff);
+    else
+        buff[0] = '\0';
+}
+
+static void
+text_numeric (gboolean present, gnc_numeric n, char *buff, gsize len)
+{
+    if (present)
+        g_snprintf (buff, len, "%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT,
+                    gnc_numeric_num (n), gnc_numeric_denom (n));
+    else
+        buff[0] = '\0';
+}
+
+static void
+log_write_text (FILE *log, const TransLogEntry *entries, guint n_entries)
+{
+    char trans_guid_str[GUID_ENCODING_LENGTH + 1];
+    char split_guid_str[GUID_ENCODING_LENGTH + 1];
+    char acc_guid_str[GUID_ENCODING_LENGTH + 1];
+    char dnow[100], dent[100], dpost[100], drecn[100];
+    char amount[50], value[50];
+    guint i;
+
+    if (n_entries)
+    {
+        gnc_time64_to_iso8601_buff (entries->log_date, dnow);
+        text_time (entries->date_entered_present, entries->date_entered, dent);
+        text_time (entries->date_posted_present, entries->date_posted, dpost);
+        guid_to_string_buff (&entries->trans_guid, trans_guid_str);
+    }
+    fprintf (log, TEXT_LOG_START "\n");
+
+    for (i = 0; i < n_entries; i++)
+    {
+        const TransLogEntry *entry = &entries[i];
+
+        if (entry->acc_guid_present)
+            guid_to_string_buff (&entry->acc_guid, acc_guid_str);
+        else
+            acc_guid_str[0] = '\0';
+
+        text_time (entry->date_reconciled_present, entry->date_reconciled,
+                   drecn);
+        text_numeric (entry->amount_present, entry->amount, amount,
+                      sizeof (amount));
+        text_numeric (entry->value_present, entry->value, value,
+                      sizeof (value));
+        guid_to_string_buff (&entry->split_guid, split_guid_str);
+
+        /* use tab-separated fields */
+        fprintf (log,
+                 "%c\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t"
+                 "%s\t%s\t%s\t%s\t%c\t%s\t%s\t%s\n",
+                 entry->flag,
+                 trans_guid_str, split_guid_str,  /* trans+split make up unique id */
+                 dnow,
+                 dent,
+                 dpost,
+                 acc_guid_str,
+                 entry->acc_name,
+                 entry->num,
+                 entry->description,
+                 entry->notes,
+                 entry->memo,
+                 entry->action,
+                 entry->reconciled,
+                 amount,
+                 value,
+                 drecn);
+    }
+
+    fprintf (log, TEXT_LOG_END "\n");
+}
+
+static void
+record_append_u32 (GString *record, guint32 val)
+{
+    val = GUINT32_TO_LE (val);
+    g_string_append_len (record, (const gchar*)&val, sizeof (val));
+}
+
+static void
+record_append_i64 (GString *record, gint64 val)
+{
+    val = GINT64_TO_LE (val);
+    g_string_append_len (record, (const gchar*)&val, sizeof (val));
+}
+
+static void
+record_append_guid (GString *record, const GncGUID *guid)
+{
+    g_string_append_len (record, (const gchar*)guid->reserved, GUID_DATA_SIZE);
+}
+
+static void
+record_append_str (GString *record, const char *str)
+{
+    guint32 len = str ? strlen (str) : 0;
+
+    record_append_u32 (record, len);
+    g_string_append_len (record, str, len);
+}
+
+/* A binary record is the length of the rest of the record, the
+ * transaction fields once and then the fields of each split. */
+static void
+log_build_binary (GString *log_record, const TransLogEntry *entries,
+                  guint n_entries)
+{
+    static const TransLogEntry no_entry;
+    const TransLogEntry *trans_entry = n_entries ? entries : &no_entry;
+    guint32 len;
+    guint i;
+
+    g_string_truncate (log_record, 0);
+
+    record_append_u32 (log_record, 0);
+    g_string_append_c (log_record, trans_entry->flag);
+    record_append_u32 (log_record, n_entries);
+    record_append_guid (log_record, &trans_entry->trans_guid);
+    record_append_i64 (log_record, trans_entry->log_date);
+    record_append_i64 (log_record, trans_entry->date_entered);
+    record_append_i64 (log_record, trans_entry->date_posted);
+    g_string_append_c (log_record,
+                       (trans_entry->date_entered_present ? LOG_HAS_DATE_ENTERED : 0) |
+                       (trans_entry->date_posted_present ? LOG_HAS_DATE_POSTED : 0));
+    record_append_str (log_record, trans_entry->num);
+    record_append_str (log_record, trans_entry->description);
+    record_append_str (log_record, trans_entry->notes);
+
+    for (i = 0; i < n_entries; i++)
+    {
+        const TransLogEntry *entry = &entries[i];
+
+        record_append_guid (log_record, &entry->split_guid);
+        g_string_append_c (log_record,
+                           (entry->acc_guid_present ? LOG_HAS_ACCOUNT : 0) |
+                           (entry->amount_present ? LOG_HAS_AMOUNT : 0) |
+                           (entry->value_present ? LOG_HAS_VALUE : 0) |
+                           (entry->date_reconciled_present ?
+                            LOG_HAS_DATE_RECONCILED : 0));
+        record_append_guid (log_record, &entry->acc_guid);
+        record_append_str (log_record, entry->acc_name);
+        record_append_str (log_record, entry->memo);
+        record_append_str (log_record, entry->action);
+        g_string_append_c (log_record, entry->reconciled);
+        record_append_i64 (log_record, gnc_numeric_num (entry->amount));
+        record_append_i64 (log_record, gnc_numeric_denom (entry->amount));
+        record_append_i64 (log_record, gnc_numeric_num (entry->value));
+        record_append_i64 (log_record, gnc_numeric_denom (entry->value));
+        record_append_i64 (log_record, entry->date_reconciled);
+    }
+
+    len = GUINT32_TO_LE (log_record->len - sizeof (len));
+    memcpy (log_record->str, &len, sizeof (len));
+}
+
+static void
+log_write_binary (FILE *log, const TransLogEntry *entries, guint n_entries)
+{
+    if (!log_record)
+        log_record = g_string_sized_new (1024);
+    log_build_binary (log_record, entries, n_entries);
+    fwrite (log_record->str, log_record->len, 1, log);
+}
+
+static void
+log_write_trans (FILE *log, XaccLogFormat format,
+                 const TransLogEntry *entries, guint n_entries)
+{
+    if (format == XACC_LOG_BINARY)
+        log_write_binary (log, entries, n_entries);
+    else
+        log_write_text (log, entries, n_entries);
+}
+
+typedef struct
+{
+    const guchar *pos;
+    const guchar *end;
+    gboolean ok;
+} RecordCursor;
+
+static void
+cursor_take (RecordCursor *cur, gpointer dest, gsize len)
+{
+    if (!cur->ok || (gsize)(cur->end - cur->pos) < len)
+    {
+        cur->ok = FALSE;
+        memset (dest, 0, len);
+        return;
+    }
+    memcpy (dest, cur->pos, len);
+    cur->pos += len;
+}
+
+static char
+cursor_char (RecordCursor *cur)
+{
+    char c;
+    cursor_take (cur, &c, 1);
+    return c;
+}
+
+static guint32
+cursor_u32 (RecordCursor *cur)
+{
+    guint32 val;
+    cursor_take (cur, &val, sizeof (val));
+    return GUINT32_FROM_LE (val);
+}
+
+static gint64
+cursor_i64 (RecordCursor *cur)
+{
+    gint64 val;
+    cursor_take (cur, &val, sizeof (val));
+    return GINT64_FROM_LE (val);
+}
+
+static gnc_numeric
+cursor_numeric (RecordCursor *cur)
+{
+    gint64 num = cursor_i64 (cur);
+    gint64 denom = cursor_i64 (cur);
+    return gnc_numeric_create (num, denom);
+}
+
+static void
+cursor_guid (RecordCursor *cur, GncGUID *guid)
+{
+    cursor_take (cur, guid->reserved, GUID_DATA_SIZE);
+}
+
+static const char *
+cursor_str (RecordCursor *cur, GStringChunk *chunk)
+{
+    const char *str;
+    guint32 len = cursor_u32 (cur);
+
+    if (!cur->ok || (gsize)(cur->end - cur->pos) < len)
+    {
+        cur->ok = FALSE;
+        return "";
+    }
+    str = g_string_chunk_insert_len (chunk, (const gchar*)cur->pos, len);
+    cur->pos += len;
+    return str;
+}
+
+static gboolean
+read_binary_record (RecordCursor *cur, GArray *entries, GStringChunk *chunk)
+{
+    TransLogEntry trans_entry;
+    guint32 n_splits, i;
+    guchar flags;
+
+    memset (&trans_entry, 0, sizeof (trans_entry));
+    trans_entry.flag = cursor_char (cur);
+    n_splits = cursor_u32 (cur);
+    cursor_guid (cur, &trans_entry.trans_guid);
+    trans_entry.log_date = cursor_i64 (cur);
+    trans_entry.date_entered = cursor_i64 (cur);
+    trans_entry.date_posted = cursor_i64 (cur);
+    flags = cursor_char (cur);
+    trans_entry.date_entered_present = (flags & LOG_HAS_DATE_ENTERED) != 0;
+    trans_entry.date_posted_present = (flags & LOG_HAS_DATE_POSTED) != 0;
+    trans_entry.num = cursor_str (cur, chunk);
+    trans_entry.description = cursor_str (cur, chunk);
+    trans_entry.notes = cursor_str (cur, chunk);
+
+    for (i = 0; i < n_splits && cur->ok; i++)
+    {
+        TransLogEntry entry = trans_entry;
+
+        cursor_guid (cur, &entry.split_guid);
+        flags = cursor_char (cur);
+        entry.acc_guid_present = (flags & LOG_HAS_ACCOUNT) != 0;
+        entry.amount_present = (flags & LOG_HAS_AMOUNT) != 0;
+        entry.value_present = (flags & LOG_HAS_VALUE) != 0;
+        entry.date_reconciled_present = (flags & LOG_HAS_DATE_RECONCILED) != 0;
+        cursor_guid (cur, &entry.acc_guid);
+        entry.acc_name = cursor_str (cur, chunk);
+        entry.memo = cursor_str (cur, chunk);
+        entry.action = cursor_str (cur, chunk);
+        entry.reconciled = cursor_char (cur);
+        entry.amount = cursor_numeric (cur);
+        entry.value = cursor_numeric (cur);
+        entry.date_reconciled = cursor_i64 (cur);
+        g_array_append_val (entries, entry);
+    }
+
+    return cur->ok && cur->pos == cur->end;
+}
+
+/********************************************************************\
+ * The background writer
+\********************************************************************/
+
+/* Write a record queued by xaccTransWriteLog in the current format.
+ * Call with log_mutex held. */
+static void
+log_write_record (GString *record, GArray *entries, GStringChunk *chunk)
+{
+    RecordCursor cur;
+
+    if (!trans_log) return;
+    if (log_format == XACC_LOG_BINARY)
+    {
+        fwrite (record->str, record->len, 1, trans_log);
+        return;
+    }
+
+    cur.pos = (const guchar*)record->str + sizeof (guint32);
+    cur.end = (const guchar*)record->str + record->len;
+    cur.ok = TRUE;
+    if (read_binary_record (&cur, entries, chunk))
+        log_write_text (trans_log, (TransLogEntry*)entries->data, entries->len);
+    g_array_set_size (entries, 0);
+    g_string_chunk_clear (chunk);
+}
+
+static gpointer
+log_writer_thread (gpointer user_data)
+{
+    GArray *entries = g_array_new (FALSE, FALSE, sizeof (TransLogEntry));
+    GStringChunk *chunk = g_string_chunk_new (4096);
+    gboolean running = TRUE;
+
+    while (running)
+    {
+        LogQueueItem *item;
+        gint64 period;
+
+        /* Wait no longer than the flush deadline of pending records */
+        g_mutex_lock (&log_mutex);
+        period = (gint64)flush_period * 1000;
+        if (period && unflushed_trans)
+            period += last_flush_time - g_get_monotonic_time ();
+        else
+            period = -1;
+        g_mutex_unlock (&log_mutex);
+
+        if (period < 0)
+            item = g_async_queue_pop (log_queue);
+        else if (period > 0)
+            item = g_async_queue_timeout_pop (log_queue, period);
+        else
+            item = NULL;
+
+        g_mutex_lock (&log_mutex);
+        if (!item)
+            log_flush (FALSE);
+        else if (item->type == LOG_ITEM_RECORD)
+        {
+            log_write_record (item->record, entries, chunk);
+            if (++unflushed_trans >= flush_interval ||
+                (flush_period && g_get_monotonic_time () - last_flush_time >=
+                 (gint64)flush_period * 1000))
+                log_flush (FALSE);
+        }
+        else
+        {
+            log_flush (item->to_disk);
+            running = (item->type != LOG_ITEM_STOP);
+        }
+        g_mutex_unlock (&log_mutex);
+
+        if (!item)
+            continue;
+        if (item->type == LOG_ITEM_RECORD)
+        {
+            if (g_async_queue_length (log_spare_items) < 256)
+                g_async_queue_push (log_spare_items, item);
+            else
+            {
+                g_string_free (item->record, TRUE);
+                g_free (item);
+            }
+            continue;
+        }
+
+        g_mutex_lock (&sync_mutex);
+        item->done = TRUE;
+        g_cond_broadcast (&sync_cond);
+        g_mutex_unlock (&sync_mutex);
+    }
+
+    g_array_free (entries, TRUE);
+    g_string_chunk_free (chunk);
+    return NULL;
+}
+
+/* Queue a control item and wait for the writer to handle it, which
+ * it does after writing everything queued before it. */
+static void
+log_writer_request (LogItemType type, gboolean to_disk)
+{
+    LogQueueItem item;
+
+    item.type = type;
+    item.record = NULL;
+    item.to_disk = to_disk;
+    item.done = FALSE;
+    g_async_queue_push (log_queue, &item);
+
+    g_mutex_lock (&sync_mutex);
+    while (!item.done)
+        g_cond_wait (&sync_cond, &sync_mutex);
+    g_mutex_unlock (&sync_mutex);
+}
+
+static void
+log_writer_queue (const TransLogEntry *entries, guint n_entries)
+{
+    LogQueueItem *item = g_async_queue_try_pop (log_spare_items);
+
+    if (!item)
+    {
+        item = g_new0 (LogQueueItem, 1);
+        item->type = LOG_ITEM_RECORD;
+        item->record = g_string_sized_new (1024);
+    }
+    log_build_binary (item->record, entries, n_entries);
+    g_async_queue_push (log_queue, item);
+}
+
+void
+xaccLogSetAsync (gboolean async)
+{
+    if (async == (log_writer != NULL)) return;
+
+    if (!async)
+    {
+        log_writer_request (LOG_ITEM_STOP, FALSE);
+        g_thread_join (log_writer);
+        log_writer = NULL;
+        return;
+    }
+
+    if (!log_queue)
+    {
+        log_queue = g_async_queue_new ();
+        log_spare_items = g_async_queue_new ();
+    }
+    log_writer = g_thread_new ("gnc-translog", log_writer_thread, NULL);
+}
+
 void
 xaccTransWriteLog (Transaction *trans, char flag)
 {
     GList *node;
-    char trans_guid_str[GUID_ENCODING_LENGTH + 1];
-    char split_guid_str[GUID_ENCODING_LENGTH + 1];
+    TransLogEntry trans_entry;
     const char *trans_notes;
-    char dnow[100], dent[100], dpost[100], drecn[100];
 
     if (!gen_logs)
     {
@@ -235,69 +861,324 @@ xaccTransWriteLog (Transaction *trans, char flag)
     }
     if (!trans_log) return;
 
-    gnc_time64_to_iso8601_buff (gnc_time(NULL), dnow);
-    gnc_time64_to_iso8601_buff (trans->date_entered, dent);
-    gnc_time64_to_iso8601_buff (trans->date_posted, dpost);
-    guid_to_string_buff (xaccTransGetGUID(trans), trans_guid_str);
+    if (!log_entries)
+        log_entries = g_array_new (FALSE, FALSE, sizeof (TransLogEntry));
+    g_array_set_size (log_entries, 0);
+
+    memset (&trans_entry, 0, sizeof (trans_entry));
     trans_notes = xaccTransGetNotes(trans);
-    fprintf (trans_log, "===== START\n");
+    trans_entry.flag = flag;
+    trans_entry.trans_guid = *xaccTransGetGUID(trans);
+    trans_entry.log_date = gnc_time(NULL);
+    trans_entry.date_entered_present = TRUE;
+    trans_entry.date_entered = trans->date_entered;
+    trans_entry.date_posted_present = TRUE;
+    trans_entry.date_posted = trans->date_posted;
+    trans_entry.num = trans->num ? trans->num : "";
+    trans_entry.description = trans->description ? trans->description : "";
+    trans_entry.notes = trans_notes ? trans_notes : "";
 
     for (node = trans->splits; node; node = node->next)
     {
-        time64 time;
         Split *split = node->data;
-        const char * accname = "";
-        char acc_guid_str[GUID_ENCODING_LENGTH + 1];
-        gnc_numeric amt, val;
+        Account *acc = xaccSplitGetAccount(split);
+        TransLogEntry entry = trans_entry;
 
-        if (xaccSplitGetAccount(split))
+        if (acc)
         {
-            accname = xaccAccountGetName (xaccSplitGetAccount(split));
-            guid_to_string_buff(xaccAccountGetGUID(xaccSplitGetAccount(split)),
-                                acc_guid_str);
+            const char *accname = xaccAccountGetName (acc);
+            entry.acc_guid_present = TRUE;
+            entry.acc_guid = *xaccAccountGetGUID(acc);
+            entry.acc_name = accname ? accname : "";
         }
         else
         {
-            acc_guid_str[0] = '\0';
+            entry.acc_guid = *guid_null();
+            entry.acc_name = "";
         }
 
-        gnc_time64_to_iso8601_buff (split->date_reconciled, drecn);
+        entry.split_guid = *xaccSplitGetGUID(split);
+        entry.memo = split->memo ? split->memo : "";
+        entry.action = split->action ? split->action : "";
+        entry.reconciled = split->reconciled;
+        entry.amount_present = entry.value_present = TRUE;
+        entry.amount = xaccSplitGetAmount (split);
+        entry.value = xaccSplitGetValue (split);
+        entry.date_reconciled_present = TRUE;
+        entry.date_reconciled = split->date_reconciled;
+        g_array_append_val (log_entries, entry);
+    }
 
-        guid_to_string_buff (xaccSplitGetGUID(split), split_guid_str);
-        amt = xaccSplitGetAmount (split);
-        val = xaccSplitGetValue (split);
+    if (log_writer)
+    {
+        log_writer_queue ((TransLogEntry*)log_entries->data, log_entries->len);
+        return;
+    }
 
-        /* use tab-separated fields */
-        fprintf (trans_log,
-                 "%c\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t%s\t"
-                 "%s\t%s\t%s\t%s\t%c\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%" G_GINT64_FORMAT "/%" G_GINT64_FORMAT "\t%s\n",
-                 flag,
-                 trans_guid_str, split_guid_str,  /* trans+split make up unique id */
-                 /* Note that the next three strings always exist,
-                 		* so we don't need to test them. */
-                 dnow,
-                 dent,
-                 dpost,
-                 acc_guid_str,
-                 accname ? accname : "",
-                 trans->num ? trans->num : "",
-                 trans->description ? trans->description : "",
-                 trans_notes ? trans_notes : "",
-                 split->memo ? split->memo : "",
-                 split->action ? split->action : "",
-                 split->reconciled,
-                 gnc_numeric_num(amt),
-                 gnc_numeric_denom(amt),
-                 gnc_numeric_num(val),
-                 gnc_numeric_denom(val),
-                 /* The next string always exists. No need to test it. */
-                 drecn);
+    log_write_trans (trans_log, log_format,
+                     (TransLogEntry*)log_entries->data, log_entries->len);
+
+    /* get data out to the disk, once per flush_interval transactions
+     * so that bulk posting can share the cost of a flush */
+    if (++unflushed_trans >= flush_interval)
+    {
+        fflush (trans_log);
+        unflushed_trans = 0;
     }
+}
 
-    fprintf (trans_log, "===== END\n");
+/********************************************************************\
+ * Reading logs back
+\********************************************************************/
 
-    /* get data out to the disk */
-    fflush (trans_log);
+/* Split off the next tab-separated field of a text log line. Like
+ * the old replay code this gives an empty field between consecutive
+ * tabs and at the end of the line. */
+static char *
+next_text_field (char **pos)
+{
+    char *field = *pos;
+    char *tab = strchr (field, '\t');
+
+    if (tab)
+    {
+        *tab = '\0';
+        *pos = tab + 1;
+    }
+    else
+        *pos = field + strlen (field);
+    return field;
+}
+
+static time64
+text_field_time (const char *field, gboolean *present)
+{
+    *present = *field != '\0';
+    return *field ? gnc_iso8601_to_time64_gmt (field) : 0;
+}
+
+static gnc_numeric
+text_field_numeric (const char *field, gboolean *present)
+{
+    gnc_numeric n = gnc_numeric_zero ();
+
+    *present = *field && string_to_gnc_numeric (field, &n);
+    return *present ? n : gnc_numeric_zero ();
+}
+
+static void
+parse_text_entry (char *line, TransLogEntry *entry)
+{
+    char *pos = line;
+    char *field;
+    gboolean log_date_present;
+
+    memset (entry, 0, sizeof (*entry));
+
+    entry->flag = *next_text_field (&pos);
+    field = next_text_field (&pos);
+    if (*field)
+        string_to_guid (field, &entry->trans_guid);
+    field = next_text_field (&pos);
+    if (*field)
+        string_to_guid (field, &entry->split_guid);
+    entry->log_date = text_field_time (next_text_field (&pos), &log_date_present);
+    entry->date_entered = text_field_time (next_text_field (&pos),
+                                           &entry->date_entered_present);
+    entry->date_posted = text_field_time (next_text_field (&pos),
+                                          &entry->date_posted_present);
+    field = next_text_field (&pos);
+    if (*field)
+        entry->acc_guid_present = string_to_guid (field, &entry->acc_guid);
+    entry->acc_name = next_text_field (&pos);
+    entry->num = next_text_field (&pos);
+    entry->description = next_text_field (&pos);
+    entry->notes = next_text_field (&pos);
+    entry->memo = next_text_field (&pos);
+    entry->action = next_text_field (&pos);
+    entry->reconciled = *next_text_field (&pos);
+    entry->amount = text_field_numeric (next_text_field (&pos),
+                                        &entry->amount_present);
+    entry->value = text_field_numeric (next_text_field (&pos),
+                                       &entry->value_present);
+    entry->date_reconciled = text_field_time (next_text_field (&pos),
+                                              &entry->date_reconciled_present);
+
+    if (*pos)
+        PERR ("Expected number of fields exceeded!");
+}
+
+static gboolean
+line_has_prefix (const char *line, gsize len, const char *prefix)
+{
+    gsize prefix_len = strlen (prefix);
+    return len >= prefix_len && strncmp (line, prefix, prefix_len) == 0;
+}
+
+static XaccLogReadStatus
+read_text_log (const char *pos, const char *end,
+               TransLogReadFunc func, gpointer user_data)
+{
+    GStringChunk *chunk;
+    GArray *entries;
+    gboolean in_record = FALSE;
+    const char *eol = memchr (pos, '\n', end - pos);
+    gsize header_len = sizeof (text_log_header) - 2; /* sans newline */
+
+    if ((gsize)((eol ? eol : end) - pos) < header_len ||
+        strncmp (pos, text_log_header, header_len) != 0)
+        return XACC_LOG_READ_BAD_HEADER;
+
+    chunk = g_string_chunk_new (4096);
+    entries = g_array_new (FALSE, FALSE, sizeof (TransLogEntry));
+    pos = eol ? eol + 1 : end;
+    while (pos < end)
+    {
+        gsize len;
+
+        eol = memchr (pos, '\n', end - pos);
+        len = (eol ? eol : end) - pos;
+        if (!in_record)
+            in_record = line_has_prefix (pos, len, TEXT_LOG_START);
+        else if (line_has_prefix (pos, len, TEXT_LOG_END))
+        {
+            func ((TransLogEntry*)entries->data, entries->len, user_data);
+            g_array_set_size (entries, 0);
+            g_string_chunk_clear (chunk);
+            in_record = FALSE;
+        }
+        else
+        {
+            TransLogEntry entry;
+            char *line = g_string_chunk_insert_len (chunk, pos, len);
+
+            parse_text_entry (g_strchomp (line), &entry);
+            g_array_append_val (entries, entry);
+        }
+        pos = eol ? eol + 1 : end;
+    }
+
+    /* A record cut short by the end of the file is still replayed. */
+    if (in_record)
+        func ((TransLogEntry*)entries->data, entries->len, user_data);
+
+    g_array_free (entries, TRUE);
+    g_string_chunk_free (chunk);
+    return XACC_LOG_READ_OK;
+}
+
+static XaccLogReadStatus
+read_binary_log (const char *pos, const char *end,
+                 TransLogReadFunc func, gpointer user_data)
+{
+    GStringChunk *chunk = g_string_chunk_new (4096);
+    GArray *entries = g_array_new (FALSE, FALSE, sizeof (TransLogEntry));
+
+    while (pos < end)
+    {
+        RecordCursor cur;
+        guint32 len;
+
+        cur.pos = (const guchar*)pos;
+        cur.end = (const guchar*)end;
+        cur.ok = TRUE;
+        len = cursor_u32 (&cur);
+        if (!cur.ok || (gsize)(cur.end - cur.pos) < len)
+        {
+            PWARN ("Ignoring a truncated record at the end of the journal");
+            break;
+        }
+
+        pos = (const char*)cur.pos + len;
+        cur.end = cur.pos + len;
+        if (read_binary_record (&cur, entries, chunk))
+            func ((TransLogEntry*)entries->data, entries->len, user_data);
+        else
+            PERR ("Corrupted record");
+
+        g_array_set_size (entries, 0);
+        g_string_chunk_clear (chunk);
+    }
+
+    g_array_free (entries, TRUE);
+    g_string_chunk_free (chunk);
+    return XACC_LOG_READ_OK;
+}
+
+XaccLogReadStatus
+xaccLogReadFile (const char *filename, TransLogReadFunc func, gpointer user_data)
+{
+    GMappedFile *mapped;
+    const char *contents;
+    gsize length;
+    XaccLogReadStatus status;
+    int fd;
+
+    g_return_val_if_fail (filename && func, XACC_LOG_READ_OPEN_ERROR);
+
+    fd = g_open (filename, O_RDONLY | O_BINARY, 0);
+    if (fd < 0)
+        return XACC_LOG_READ_OPEN_ERROR;
+    mapped = g_mapped_file_new_from_fd (fd, FALSE, NULL);
+    g_close (fd, NULL);
+    if (!mapped)
+        return XACC_LOG_READ_OPEN_ERROR;
+
+    contents = g_mapped_file_get_contents (mapped);
+    length = g_mapped_file_get_length (mapped);
+    if (length == 0)
+        status = XACC_LOG_READ_EMPTY;
+    else if (length >= BINARY_LOG_MAGIC_LEN &&
+             memcmp (contents, BINARY_LOG_MAGIC, BINARY_LOG_MAGIC_LEN) == 0)
+        status = read_binary_log (contents + BINARY_LOG_MAGIC_LEN,
+                                  contents + length, func, user_data);
+    else
+        status = read_text_log (contents, contents + length, func, user_data);
+
+    g_mapped_file_unref (mapped);
+    return status;
+}
+
+typedef struct
+{
+    FILE *out;
+    XaccLogFormat format;
+} LogConvertData;
+
+static void
+log_convert_trans (const TransLogEntry *entries, guint n_entries,
+                   gpointer user_data)
+{
+    LogConvertData *data = user_data;
+    log_write_trans (data->out, data->format, entries, n_entries);
+}
+
+gboolean
+xaccLogConvertFile (const char *in_filename, const char *out_filename,
+                    XaccLogFormat format)
+{
+    LogConvertData data;
+    XaccLogReadStatus status;
+
+    g_return_val_if_fail (in_filename && out_filename, FALSE);
+
+    data.format = format;
+    data.out = g_fopen (out_filename, format == XACC_LOG_BINARY ? "wb" : "w");
+    if (!data.out)
+    {
+        PERR ("Cannot open %s: %s", out_filename, g_strerror (errno));
+        return FALSE;
+    }
+
+    log_write_header (data.out, format);
+    status = xaccLogReadFile (in_filename, log_convert_trans, &data);
+    if (fclose (data.out) != 0 || status != XACC_LOG_READ_OK)
+    {
+        PERR ("Cannot convert %s to %s", in_filename, out_filename);
+        g_unlink (out_filename);
+        return FALSE;
+    }
+    return TRUE;
 }
 
 /************************ END OF ************************************\
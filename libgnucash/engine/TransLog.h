@@ -81,6 +81,116 @@ void    xaccLogSetBaseName (const char *);
 /** Test a filename to see if it is the name of the current logfile */
 gboolean xaccFileIsCurrentLog (const gchar *name);
 
+/** The on-disk formats of the transaction log. XACC_LOG_TEXT is the
+ *  tab-separated .log file; XACC_LOG_BINARY is a compact journal of
+ *  length-prefixed records holding raw GUIDs, times and numerics,
+ *  written to a .jnl file.
+ */
+typedef enum
+{
+    XACC_LOG_TEXT,
+    XACC_LOG_BINARY,
+} XaccLogFormat;
+
+/** Select the format of the log files opened from now on. If the log
+ *  is already open it is closed and reopened in the new format.
+ */
+void    xaccLogSetFormat (XaccLogFormat format);
+XaccLogFormat xaccLogGetFormat (void);
+
+/** Flush the log to disk only after every n_trans logged
+ *  transactions instead of after each one. The log is always flushed
+ *  when it is closed. A value of 1, the default, flushes every
+ *  transaction.
+ */
+void    xaccLogSetFlushInterval (guint n_trans);
+
+/** Write the log on a background thread. xaccTransWriteLog then only
+ *  queues a copy of the transaction; the writer thread writes the
+ *  queued transactions in order and flushes as xaccLogSetFlushInterval
+ *  and xaccLogSetFlushPeriod say. Turning it off waits for everything
+ *  queued to be written.
+ */
+void    xaccLogSetAsync (gboolean async);
+
+/** With the background writer, also flush the log once pending
+ *  transactions are msec milliseconds old, whichever of this and the
+ *  flush interval comes first. 0, the default, turns this off.
+ */
+void    xaccLogSetFlushPeriod (guint msec);
+
+/** Also fsync the log when it is closed. The log is closed and
+ *  reopened after each save, so this makes every save a point at
+ *  which the log is safely on disk.
+ */
+void    xaccLogSetFsyncOnClose (gboolean fsync);
+
+/** Wait until everything logged so far is written and flushed, and
+ *  with to_disk also fsync'ed.
+ */
+void    xaccLogSync (gboolean to_disk);
+
+/** One split of a logged transaction, as found in a log file. The
+ *  strings are never NULL; an empty string means the field was empty
+ *  when it was logged. The dates and numerics can be left empty in a
+ *  text log too, e.g. by hand; their _present flags are FALSE then
+ *  and the field is 0, and log replay leaves them alone.
+ */
+typedef struct
+{
+    char flag;
+    GncGUID trans_guid;
+    GncGUID split_guid;
+    time64 log_date;
+    gboolean date_entered_present;
+    time64 date_entered;
+    gboolean date_posted_present;
+    time64 date_posted;
+    gboolean acc_guid_present;
+    GncGUID acc_guid;
+    const char *acc_name;
+    const char *num;
+    const char *description;
+    const char *notes;
+    const char *memo;
+    const char *action;
+    char reconciled;
+    gboolean amount_present;
+    gnc_numeric amount;
+    gboolean value_present;
+    gnc_numeric value;
+    gboolean date_reconciled_present;
+    time64 date_reconciled;
+} TransLogEntry;
+
+typedef enum
+{
+    XACC_LOG_READ_OK,
+    XACC_LOG_READ_OPEN_ERROR, /**< errno tells why */
+    XACC_LOG_READ_EMPTY,
+    XACC_LOG_READ_BAD_HEADER,
+} XaccLogReadStatus;
+
+/** Called once for each transaction read from a log, with the entries
+ *  of all of its splits. The entries are only valid during the call.
+ */
+typedef void (*TransLogReadFunc) (const TransLogEntry *entries,
+                                  guint n_entries, gpointer user_data);
+
+/** Read the log file filename, which can be in either format, and
+ *  call func for each transaction in it. A truncated last record of a
+ *  binary journal, as left by a crash, is ignored.
+ */
+XaccLogReadStatus xaccLogReadFile (const char *filename,
+                                   TransLogReadFunc func, gpointer user_data);
+
+/** Rewrite the log file in_filename, which can be in either format,
+ *  to out_filename in format. Returns FALSE if either file can't be
+ *  opened or the input isn't a log file.
+ */
+gboolean xaccLogConvertFile (const char *in_filename, const char *out_filename,
+                             XaccLogFormat format);
+
 #endif /* XACC_TRANS_LOG_H */
 /** @} */
 /** @} */
@@ -245,7 +245,7 @@ void gen_event_trans (Transaction *trans)
         Account *account = s->acc;
         GNCLot *lot = s->lot;
         if (account)
-            qof_event_gen (&account->inst, GNC_EVENT_ITEM_CHANGED, s);
+            qof_event_gen_item (&account->inst, GNC_EVENT_ITEM_CHANGED, &s->inst);
 
         if (lot)
         {
@@ -391,15 +391,29 @@ gnc_transaction_set_property(GObject* object,
     }
 }
 
+static void
+gnc_transaction_get_memory_usage(const QofInstance* inst, QofMemoryUsage* usage)
+{
+    const Transaction* trans = GNC_TRANSACTION(inst);
+    guint nodes = g_list_length(trans->splits);
+
+    usage->list_nodes += nodes;
+    usage->bytes += nodes * sizeof(GList);
+    if (trans->readonly_reason)
+        usage->bytes += strlen(trans->readonly_reason) + 1;
+}
+
 static void
 gnc_transaction_class_init(TransactionClass* klass)
 {
     GObjectClass* gobject_class = G_OBJECT_CLASS(klass);
+    QofInstanceClass* qof_class = QOF_INSTANCE_CLASS(klass);
 
     gobject_class->dispose = gnc_transaction_dispose;
     gobject_class->finalize = gnc_transaction_finalize;
     gobject_class->set_property = gnc_transaction_set_property;
     gobject_class->get_property = gnc_transaction_get_property;
+    qof_class->get_memory_usage = gnc_transaction_get_memory_usage;
 
     g_object_class_install_property
     (gobject_class,
@@ -105,6 +105,36 @@ static const GncGUID * gncBudgetGetGUID(GncBudget *x)
 { return qof_instance_get_guid(QOF_INSTANCE(x)); }
 %}
 
+/* Scheme wrapper for xaccAccountGetBalancesAtDates: takes a list of
+ * time64 and returns a list of (amount . value) pairs in the same
+ * order. */
+%inline %{
+static SCM
+gnc_account_get_balances_at_dates (Account *acc, SCM dates_scm)
+{
+    SCM result = SCM_EOL;
+    gsize n_dates = scm_to_size_t (scm_length (dates_scm));
+    time64 *dates = g_new (time64, n_dates);
+    gnc_numeric *amounts = g_new (gnc_numeric, n_dates);
+    gnc_numeric *values = g_new (gnc_numeric, n_dates);
+    gsize i;
+
+    for (i = 0; i < n_dates; ++i, dates_scm = SCM_CDR (dates_scm))
+        dates[i] = scm_to_int64 (SCM_CAR (dates_scm));
+
+    xaccAccountGetBalancesAtDates (acc, dates, n_dates, amounts, values);
+
+    for (i = n_dates; i > 0; --i)
+        result = scm_cons (scm_cons (gnc_numeric_to_scm (amounts[i - 1]),
+                                     gnc_numeric_to_scm (values[i - 1])),
+                           result);
+    g_free (dates);
+    g_free (amounts);
+    g_free (values);
+    return result;
+}
+%}
+
 /* NB: The object ownership annotations should already cover all the
 functions currently used in guile, but not all the functions that are
 wrapped.  So, we should contract the interface to wrap only the used
@@ -217,6 +247,7 @@ SplitList * qof_query_run_subquery (QofQuery *q, const QofQuery *q);
 %include <qofquery.h>
 %include <qofquerycore.h>
 %include <qofbookslots.h>
+%newobject qof_book_get_memory_report;
 %include <qofbook.h>
 
 %ignore GNC_DENOM_AUTO;
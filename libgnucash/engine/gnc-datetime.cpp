@@ -553,7 +553,18 @@ GncDateImpl::GncDateImpl(const std::string str, const std::string fmt) :
     if (iter == GncDate::c_formats.cend())
         throw std::invalid_argument(N_("Unknown date format specifier passed as argument."));
 
-    boost::regex r(iter->m_re);
+    /* Compiling a regex is far more expensive than matching a short date
+     * string with it, and importers construct dates by the thousands, so
+     * compile each format's regex only once. */
+    static const std::vector<boost::regex> format_regexes = []()
+    {
+        std::vector<boost::regex> regexes;
+        for (const auto& format : GncDate::c_formats)
+            regexes.emplace_back(format.m_re);
+        return regexes;
+    }();
+
+    const auto& r = format_regexes[iter - GncDate::c_formats.cbegin()];
     boost::smatch what;
     if(!boost::regex_search(str, what, r))  // regex didn't find a match
         throw std::invalid_argument (N_("Value can't be parsed into a date using the selected date format."));
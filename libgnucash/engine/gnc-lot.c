@@ -202,15 +202,26 @@ gnc_lot_set_property (GObject* object,
      }
 }
 
+static void
+gnc_lot_get_memory_usage(const QofInstance* inst, QofMemoryUsage* usage)
+{
+    guint nodes = g_list_length(GET_PRIVATE(inst)->splits);
+
+    usage->list_nodes += nodes;
+    usage->bytes += nodes * sizeof(GList);
+}
+
 static void
 gnc_lot_class_init(GNCLotClass* klass)
 {
     GObjectClass* gobject_class = G_OBJECT_CLASS(klass);
+    QofInstanceClass* qof_class = QOF_INSTANCE_CLASS(klass);
 
     gobject_class->dispose = gnc_lot_dispose;
     gobject_class->finalize = gnc_lot_finalize;
     gobject_class->get_property = gnc_lot_get_property;
     gobject_class->set_property = gnc_lot_set_property;
+    qof_class->get_memory_usage = gnc_lot_get_memory_usage;
 
     g_object_class_install_property(
         gobject_class,
@@ -834,7 +834,52 @@ gnc_price_list_equal(PriceList *prices1, PriceList *prices2)
  */
 
 /* GObject Initialization */
-QOF_GOBJECT_IMPL(gnc_pricedb, GNCPriceDB, QOF_TYPE_INSTANCE);
+QOF_GOBJECT_GET_TYPE(GNCPriceDB, gnc_pricedb, QOF_TYPE_INSTANCE, {});
+QOF_GOBJECT_DISPOSE(gnc_pricedb);
+QOF_GOBJECT_FINALIZE(gnc_pricedb);
+
+/* A GHashTable slot holds the key, the value and the hash. */
+#define HASH_SLOT_SIZE (2 * sizeof(gpointer) + sizeof(guint))
+
+static void
+price_list_memory_usage(gpointer key, gpointer value, gpointer data)
+{
+    QofMemoryUsage *usage = data;
+    guint nodes = g_list_length(value);
+
+    usage->list_nodes += nodes;
+    usage->bytes += HASH_SLOT_SIZE + nodes * sizeof(GList);
+}
+
+static void
+currency_hash_memory_usage(gpointer key, gpointer value, gpointer data)
+{
+    QofMemoryUsage *usage = data;
+
+    usage->bytes += HASH_SLOT_SIZE;
+    g_hash_table_foreach(value, price_list_memory_usage, usage);
+}
+
+static void
+gnc_pricedb_get_memory_usage(const QofInstance *inst, QofMemoryUsage *usage)
+{
+    const GNCPriceDB *db = GNC_PRICEDB(inst);
+
+    if (db->commodity_hash)
+        g_hash_table_foreach(db->commodity_hash, currency_hash_memory_usage,
+                             usage);
+}
+
+static void
+gnc_pricedb_class_init(GNCPriceDBClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS(klass);
+    QofInstanceClass *qof_class = QOF_INSTANCE_CLASS(klass);
+
+    object_class->dispose = gnc_pricedb_dispose;
+    object_class->finalize = gnc_pricedb_finalize;
+    qof_class->get_memory_usage = gnc_pricedb_get_memory_usage;
+}
 
 static void
 gnc_pricedb_init(GNCPriceDB* pdb)
@@ -1188,6 +1233,272 @@ gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p)
     return TRUE;
 }
 
+/* Sort order of gnc_pricedb_add_prices_bulk(): grouped by commodity and
+ * currency, newest first. g_ptr_array_sort is stable so prices with
+ * equal times keep their order in the array. */
+static gint
+compare_prices_for_bulk (gconstpointer a, gconstpointer b)
+{
+    const GNCPrice *pa = *(GNCPrice * const *) a;
+    const GNCPrice *pb = *(GNCPrice * const *) b;
+
+    if (pa->commodity != pb->commodity)
+        return pa->commodity < pb->commodity ? -1 : 1;
+    if (pa->currency != pb->currency)
+        return pa->currency < pb->currency ? -1 : 1;
+    return time64_cmp (pb->tmspec, pa->tmspec);
+}
+
+static gboolean
+bulk_keeps_new_price (PriceBulkMode mode, const GNCPrice *p, GList *same_day)
+{
+    GList *node;
+
+    switch (mode)
+    {
+    case PRICE_BULK_REPLACE:
+        return TRUE;
+    case PRICE_BULK_BY_SOURCE:
+        for (node = same_day; node; node = node->next)
+            if (p->source > ((GNCPrice *) node->data)->source)
+                return FALSE;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+static time64
+price_node_day (GList *node)
+{
+    return time64CanonicalDayTime (((GNCPrice *) node->data)->tmspec);
+}
+
+/* Merge batch[start, end), sharing commodity and currency and sorted
+ * newest first, into the existing price list in one pass over it. days
+ * holds the canonical day of each batch entry.
+ *
+ * The list is changed in place one price at a time, and every change
+ * is announced like remove_price() and add_price() do: a replaced price
+ * gets its QOF_EVENT_REMOVE while it is still listed, a new price its
+ * QOF_EVENT_ADD once it is. Event handlers such as the price tree model
+ * thus always find the list matching the events they were sent. The
+ * replaced prices are moved to *removed, the new ones added are
+ * prepended to *added and to the batch_added set.
+ *
+ * Like gnc_pricedb_lookup_day_t64(), which the importers used before,
+ * prices quoted the other way round on the same day count as
+ * duplicates too. Their list is walked alongside the series. A reverse
+ * price added earlier in this batch always wins, like the first price
+ * of a day within the series does.
+ */
+static void
+pricedb_merge_bulk_series (GNCPriceDB *db, GNCPrice **batch,
+                           const time64 *days, guint start, guint end,
+                           PriceBulkMode mode, GHashTable *batch_added,
+                           GList **added, GList **removed, guint *n_replaced)
+{
+    gnc_commodity *commodity = batch[start]->commodity;
+    gnc_commodity *currency = batch[start]->currency;
+    GHashTable *currency_hash, *rev_hash = NULL;
+    GList *list, *old, *prev = NULL, *rev_list = NULL, *rev_old;
+    guint k = start;
+
+    currency_hash = g_hash_table_lookup (db->commodity_hash, commodity);
+    if (!currency_hash)
+    {
+        currency_hash = g_hash_table_new (NULL, NULL);
+        g_hash_table_insert (db->commodity_hash, commodity, currency_hash);
+    }
+    list = g_hash_table_lookup (currency_hash, currency);
+    if (commodity != currency)
+        rev_hash = g_hash_table_lookup (db->commodity_hash, currency);
+    if (rev_hash)
+        rev_list = g_hash_table_lookup (rev_hash, commodity);
+
+    /* All lists are sorted newest first, so are their days. prev is
+     * the last existing price newer than the current day. */
+    old = list;
+    rev_old = rev_list;
+    while (k < end)
+    {
+        time64 new_day = days[k];
+        GList *same_day = NULL, *node;
+        GNCPrice *p = batch[k];
+        gboolean batch_dup = FALSE;
+
+        /* The first price of the day in the batch wins, skip the others. */
+        while (k < end && days[k] == new_day)
+            k++;
+
+        while (old && price_node_day (old) > new_day)
+        {
+            prev = old;
+            old = old->next;
+        }
+        for (node = old; node && price_node_day (node) == new_day;
+             node = node->next)
+            same_day = g_list_prepend (same_day, node->data);
+
+        while (rev_old && price_node_day (rev_old) > new_day)
+            rev_old = rev_old->next;
+        for (node = rev_old; node && price_node_day (node) == new_day;
+             node = node->next)
+        {
+            if (g_hash_table_contains (batch_added, node->data))
+                batch_dup = TRUE;
+            same_day = g_list_prepend (same_day, node->data);
+        }
+
+        if (batch_dup ||
+            (same_day && !bulk_keeps_new_price (mode, p, same_day)))
+        {
+            g_list_free (same_day);
+            continue;
+        }
+
+        if (same_day)
+        {
+            while (old && price_node_day (old) == new_day)
+            {
+                GList *next = old->next;
+
+                qof_event_gen (&((GNCPrice *) old->data)->inst,
+                               QOF_EVENT_REMOVE, NULL);
+                list = g_list_delete_link (list, old);
+                if (list)
+                    g_hash_table_insert (currency_hash, currency, list);
+                else
+                    g_hash_table_remove (currency_hash, currency);
+                gnc_pricedb_nth_price_reset_cache (db);
+                old = next;
+            }
+            while (rev_old && price_node_day (rev_old) == new_day)
+            {
+                GList *next = rev_old->next;
+
+                qof_event_gen (&((GNCPrice *) rev_old->data)->inst,
+                               QOF_EVENT_REMOVE, NULL);
+                rev_list = g_list_delete_link (rev_list, rev_old);
+                if (rev_list)
+                    g_hash_table_insert (rev_hash, commodity, rev_list);
+                else
+                    g_hash_table_remove (rev_hash, commodity);
+                gnc_pricedb_nth_price_reset_cache (db);
+                rev_old = next;
+            }
+            *removed = g_list_concat (same_day, *removed);
+            (*n_replaced)++;
+        }
+
+        /* Insert p between prev and old. */
+        gnc_price_ref (p);
+        p->db = db;
+        if (old)
+        {
+            list = g_list_insert_before (list, old, p);
+            prev = old->prev;
+        }
+        else if (prev)
+        {
+            g_list_append (prev, p);
+            prev = prev->next;
+        }
+        else
+        {
+            list = g_list_prepend (list, p);
+            prev = list;
+        }
+        g_hash_table_insert (currency_hash, currency, list);
+        gnc_pricedb_nth_price_reset_cache (db);
+        qof_event_gen (&p->inst, QOF_EVENT_ADD, NULL);
+        g_hash_table_add (batch_added, p);
+        *added = g_list_prepend (*added, p);
+    }
+}
+
+GList *
+gnc_pricedb_add_prices_bulk (GNCPriceDB *db, GList *prices,
+                             PriceBulkMode mode, guint *n_replaced)
+{
+    GPtrArray *batch;
+    GHashTable *batch_added;
+    GList *node, *added = NULL, *removed = NULL;
+    time64 *days;
+    guint i, start, end, replaced = 0;
+
+    if (n_replaced) *n_replaced = 0;
+    if (!db || !prices || !db->commodity_hash) return NULL;
+    ENTER ("db=%p, mode=%d", db, mode);
+
+    /* Fill the array back to front so that the stable sort puts the
+     * last of several prices with the same time first. */
+    batch = g_ptr_array_new ();
+    for (node = g_list_last (prices); node; node = node->prev)
+    {
+        GNCPrice *p = node->data;
+
+        if (!p || !p->commodity || !p->currency || p->db)
+            continue;
+        if (!qof_instance_books_equal (db, p))
+        {
+            PERR ("attempted to mix up prices across different books");
+            continue;
+        }
+        g_ptr_array_add (batch, p);
+    }
+    g_ptr_array_sort (batch, compare_prices_for_bulk);
+
+    days = g_new (time64, batch->len);
+    for (i = 0; i < batch->len; i++)
+        days[i] = time64CanonicalDayTime (
+            ((GNCPrice *) g_ptr_array_index (batch, i))->tmspec);
+
+    batch_added = g_hash_table_new (NULL, NULL);
+    for (start = 0; start < batch->len; start = end)
+    {
+        GNCPrice *first = g_ptr_array_index (batch, start);
+
+        for (end = start + 1; end < batch->len; end++)
+        {
+            GNCPrice *p = g_ptr_array_index (batch, end);
+            if (p->commodity != first->commodity ||
+                p->currency != first->currency)
+                break;
+        }
+        pricedb_merge_bulk_series (db, (GNCPrice **) batch->pdata, days,
+                                   start, end, mode, batch_added, &added,
+                                   &removed, &replaced);
+    }
+    g_hash_table_destroy (batch_added);
+    g_free (days);
+    g_ptr_array_free (batch, TRUE);
+
+    /* Destroy the replaced prices the way gnc_pricedb_remove_price does. */
+    for (node = removed; node; node = node->next)
+    {
+        GNCPrice *p = node->data;
+
+        gnc_price_begin_edit (p);
+        qof_instance_set_destroying (p, TRUE);
+        gnc_price_commit_edit (p);
+        p->db = NULL;
+        gnc_price_unref (p);
+    }
+    g_list_free (removed);
+
+    if (added)
+    {
+        gnc_pricedb_begin_edit (db);
+        qof_instance_set_dirty (&db->inst);
+        gnc_pricedb_commit_edit (db);
+    }
+
+    if (n_replaced) *n_replaced = replaced;
+    LEAVE ("db=%p, added %u, replaced %u", db, g_list_length (added), replaced);
+    return added;
+}
+
 /* remove_price() is a utility; its only function is to remove the price
  * from the double-hash tables.
  */
@@ -1747,6 +2058,7 @@ pricedb_get_prices_internal(GNCPriceDB *db, const gnc_commodity *commodity,
     PriceList *forward_list = NULL, *reverse_list = NULL;
     g_return_val_if_fail (db != NULL, NULL);
     g_return_val_if_fail (commodity != NULL, NULL);
+    QOF_PERF_COUNT ("pricedb.lookups", 1);
     forward_hash = g_hash_table_lookup(db->commodity_hash, commodity);
     if (currency && bidi)
         reverse_hash = g_hash_table_lookup(db->commodity_hash, currency);
@@ -370,6 +370,49 @@ void gnc_pricedb_set_bulk_update(GNCPriceDB *db, gboolean bulk_update);
  */
 gboolean     gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p);
 
+/** How gnc_pricedb_add_prices_bulk() resolves a new price falling on
+ *  the same day as prices already in the database. */
+typedef enum
+{
+    PRICE_BULK_KEEP_OLD,   // keep the existing prices, skip the new one
+    PRICE_BULK_REPLACE,    // replace the existing prices by the new one
+    PRICE_BULK_BY_SOURCE,  // as gnc_pricedb_add_price, decide by PriceSource
+} PriceBulkMode;
+
+/** @brief Add a batch of prices to the pricedb.
+ *
+ * The prices are sorted by commodity, currency and time and each
+ * commodity/currency series is merged with the existing prices in a
+ * single pass. Only one price per day is added for each series; if the
+ * batch holds several, the latest one is used, or the one coming last
+ * in the list if their times are equal. As in
+ * gnc_pricedb_lookup_day_t64(), prices quoted in the reverse direction
+ * on the same day count as duplicates too, and are replaced along with
+ * the others. Of two reverse prices in the batch the first series
+ * merged wins.
+ *
+ * As with gnc_pricedb_add_price() and gnc_pricedb_remove_price(), each
+ * price added gets a QOF_EVENT_ADD and each price replaced a
+ * QOF_EVENT_REMOVE. Wrap the call in qof_event_suspend() and
+ * qof_event_resume() if nobody needs to follow the changes.
+ *
+ * The pricedb takes its own reference on the prices it adds, so the
+ * caller remains responsible for the references it holds. The prices
+ * are not committed, which lets the caller keep them open for editing
+ * and commit only those that were added.
+ * @param db The pricedb
+ * @param prices A list of GNCPrice to add.
+ * @param mode How to resolve prices already present on the same day.
+ * @param n_replaced If not NULL, set to the number of added prices that
+ * replaced existing ones.
+ * @return The list of prices that were added, including replacements.
+ * The list must be freed with g_list_free, the prices belong to the
+ * pricedb.
+ */
+GList       *gnc_pricedb_add_prices_bulk(GNCPriceDB *db, GList *prices,
+                                         PriceBulkMode mode,
+                                         guint *n_replaced);
+
 /** @brief Remove a price from the pricedb and unref the price.
  * @param db The Pricedb
  * @param p The price to remove.
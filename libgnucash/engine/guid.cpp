@@ -56,8 +56,11 @@ extern "C"
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <chrono>
+#include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = QOF_MOD_ENGINE;
@@ -233,15 +236,7 @@ guid_hash_to_guint (gconstpointer ptr)
         return 0;
     }
     GncGUID const & guid = * reinterpret_cast <GncGUID const *> (ptr);
-    gnc::GUID const & temp {guid};
-
-    guint hash {0};
-    unsigned retspot {0};
-    std::for_each (temp.begin (), temp.end (), [&hash] (unsigned char a) {
-        hash <<=4;
-        hash |= a;
-    });
-    return hash;
+    return static_cast<guint> (gnc::hash_guid (guid));
 }
 
 gint
@@ -315,11 +310,86 @@ gnc_guid_get_type (void)
 namespace gnc
 {
 
+namespace
+{
+/* A xoshiro256** stream seeded from the system's entropy source once per
+ * thread. GUIDs only have to be unique, and neither going to the entropy
+ * source for every one of them, as newer boost random_generators do, nor
+ * sharing one generator between threads is cheap enough for code that
+ * creates objects by the million. */
+class GUIDGenerator
+{
+public:
+    GUIDGenerator () noexcept
+    {
+        uint64_t seed = seed_entropy ();
+        for (auto & word : m_state)
+            word = splitmix64 (seed);
+    }
+
+    uint64_t next () noexcept
+    {
+        auto result = rotl (m_state[1] * 5, 7) * 9;
+        auto t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl (m_state[3], 45);
+        return result;
+    }
+
+private:
+    static uint64_t rotl (uint64_t x, int k) noexcept
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t splitmix64 (uint64_t & x) noexcept
+    {
+        auto z = (x += UINT64_C (0x9e3779b97f4a7c15));
+        z = (z ^ (z >> 30)) * UINT64_C (0xbf58476d1ce4e5b9);
+        z = (z ^ (z >> 27)) * UINT64_C (0x94d049bb133111eb);
+        return z ^ (z >> 31);
+    }
+
+    static uint64_t seed_entropy () noexcept
+    {
+        /* Should the entropy source be unavailable, the time and thread
+         * still keep the streams of different threads and runs apart. */
+        uint64_t seed = std::chrono::high_resolution_clock::now ()
+            .time_since_epoch ().count ();
+        seed ^= std::hash<std::thread::id> () (std::this_thread::get_id ())
+            * UINT64_C (0x9e3779b97f4a7c15);
+        try
+        {
+            std::random_device rd;
+            seed ^= (static_cast<uint64_t> (rd ()) << 32) | rd ();
+        }
+        catch (...)
+        {
+            PWARN ("No entropy source, seeding GUIDs from the clock");
+        }
+        return seed;
+    }
+
+    uint64_t m_state[4];
+};
+}
+
 GUID
 GUID::create_random () noexcept
 {
-    static boost::uuids::random_generator gen;
-    return {gen ()};
+    static thread_local GUIDGenerator gen;
+    uint64_t words[2] {gen.next (), gen.next ()};
+    boost::uuids::uuid uuid;
+    static_assert (sizeof uuid.data == sizeof words, "GUID size");
+    std::memcpy (uuid.data, words, sizeof words);
+    /* Mark it as an RFC 4122 version 4 (random) UUID. */
+    uuid.data[6] = (uuid.data[6] & 0x0f) | 0x40;
+    uuid.data[8] = (uuid.data[8] & 0x3f) | 0x80;
+    return {uuid};
 }
 
 GUID::GUID (boost::uuids::uuid const & other) noexcept
@@ -23,6 +23,8 @@
 #define GUID_HPP_HEADER
 
 #include <boost/uuid/uuid.hpp>
+#include <cstdint>
+#include <cstring>
 #include <stdexcept>
 extern "C" {
 #include "guid.h"
@@ -62,6 +64,23 @@ struct GUID
 bool operator != (GUID const &, GUID const &) noexcept;
 bool operator == (GUID const &, GncGUID const &) noexcept;
 
+/** Hash all 128 bits of a GUID into 64. GUIDs are random, but tables
+ * indexed by the low bits of the hash still want every bit of the GUID to
+ * reach them, so the halves are folded and run through a 64 bit mixer. */
+inline uint64_t
+hash_guid (GncGUID const & guid) noexcept
+{
+    uint64_t lo, hi;
+    std::memcpy (&lo, guid.reserved, sizeof lo);
+    std::memcpy (&hi, guid.reserved + sizeof lo, sizeof hi);
+    uint64_t h = lo ^ (hi * UINT64_C (0x9e3779b97f4a7c15));
+    h ^= h >> 33;
+    h *= UINT64_C (0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= UINT64_C (0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}
 
 }
 #endif
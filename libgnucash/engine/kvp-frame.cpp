@@ -199,6 +199,22 @@ KvpFrameImpl::get_keys() const noexcept
     return ret;
 }
 
+size_t
+KvpFrameImpl::get_memory_usage(size_t & slots) const noexcept
+{
+    /* A std::map node holds the value, three pointers and the color. */
+    constexpr size_t node_size = sizeof(map_type::value_type) + 4 * sizeof(void*);
+    size_t ret {0};
+    for (auto const & a : m_valuemap)
+    {
+        ++slots;
+        ret += node_size;
+        if (a.second)
+            ret += sizeof(KvpValue) + a.second->get_memory_usage(slots);
+    }
+    return ret;
+}
+
 int compare(const KvpFrameImpl * one, const KvpFrameImpl * two) noexcept
 {
     if (one && !two) return 1;
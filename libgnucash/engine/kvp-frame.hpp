@@ -187,6 +187,15 @@ struct KvpFrameImpl
      */
     std::vector<std::string> get_keys() const noexcept;
 
+    /**
+     * Approximate the bytes allocated for the frame's slots and their
+     * values, nested frames included, but not for the frame itself.
+     * Keys are in the string cache and aren't counted.
+     * @param slots: Incremented by the number of slots.
+     * @return The number of bytes.
+     */
+    size_t get_memory_usage (size_t & slots) const noexcept;
+
     /** Get the value for the tail of the path or nullptr if it doesn't exist.
      * @param path: Path of keys leading to the desired value.
      * @return The value at the key or nullptr.
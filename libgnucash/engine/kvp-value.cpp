@@ -270,6 +270,55 @@ kvp_glist_copy(const GList * list)
     return retval;
 }
 
+struct memory_usage_visitor : boost::static_visitor<size_t>
+{
+    size_t & slots;
+
+    memory_usage_visitor(size_t & s) : slots(s){}
+
+    template <typename T> size_t
+    operator()(T const &) const { return 0; }
+};
+
+template <> size_t
+memory_usage_visitor::operator()(const char * const & val) const
+{
+    return val ? strlen(val) + 1 : 0;
+}
+
+template <> size_t
+memory_usage_visitor::operator()(GncGUID * const & val) const
+{
+    return val ? sizeof(GncGUID) : 0;
+}
+
+template <> size_t
+memory_usage_visitor::operator()(GList * const & val) const
+{
+    size_t ret {0};
+    for (auto node = val; node; node = node->next)
+    {
+        ret += sizeof(GList);
+        if (node->data)
+            ret += sizeof(KvpValue) +
+                static_cast<KvpValue*>(node->data)->get_memory_usage(slots);
+    }
+    return ret;
+}
+
+template <> size_t
+memory_usage_visitor::operator()(KvpFrame * const & val) const
+{
+    return val ? sizeof(KvpFrame) + val->get_memory_usage(slots) : 0;
+}
+
+size_t
+KvpValueImpl::get_memory_usage(size_t & slots) const noexcept
+{
+    memory_usage_visitor visitor {slots};
+    return boost::apply_visitor(visitor, datastore);
+}
+
 struct compare_visitor : boost::static_visitor<int>
 {
     template <typename T, typename U>
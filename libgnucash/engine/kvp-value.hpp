@@ -140,6 +140,15 @@ struct KvpValueImpl
     std::string to_string() const noexcept;
     std::string to_string(std::string const & prefix) const noexcept;
 
+    /**
+     * Approximate the bytes allocated for the contents of this
+     * KvpValueImpl: strings, GUIDs and the values of lists and frames,
+     * but not the KvpValueImpl itself.
+     * @param slots: Incremented by the slots of any frames contained.
+     * @return The number of bytes.
+     */
+    size_t get_memory_usage (size_t & slots) const noexcept;
+
     template <typename T>
     T get() const noexcept;
 
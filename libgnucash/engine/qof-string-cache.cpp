@@ -37,46 +37,117 @@ extern "C"
 #include "qof.h"
 }
 
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
 /* Uncomment if you need to log anything.
 static QofLogModule log_module = QOF_MOD_UTIL;
 */
 /* =================================================================== */
 /* The QOF string cache                                                */
 /*                                                                     */
-/* The cache is a GHashTable where a copy of the string is the key,    */
-/* and a ref count is the value                                        */
+/* The cache is split into shards picked by the string's hash, each   */
+/* with its own lock, so threads working on different strings rarely  */
+/* wait for each other. A cached string and its refcount share one    */
+/* allocation; the shard's map is keyed by the string's bytes.        */
 /* =================================================================== */
 
-static GHashTable* qof_string_cache = NULL;
+namespace
+{
+
+struct CacheEntry
+{
+    guint refcount;
+    char str[1];
+};
 
-static GHashTable*
-qof_get_string_cache(void)
+struct CacheKey
 {
-    if (!qof_string_cache)
+    const char* data;
+    size_t len;
+    bool operator==(const CacheKey& other) const noexcept
     {
-        qof_string_cache = g_hash_table_new_full(
-                               g_str_hash,               /* hash_func          */
-                               g_str_equal,              /* key_equal_func     */
-                               g_free,                   /* key_destroy_func   */
-                               g_free);                  /* value_destroy_func */
+        return len == other.len && memcmp(data, other.data, len) == 0;
     }
-    return qof_string_cache;
+};
+
+/* FNV-1a, folded so that every bit of the result is mixed: the shard
+ * and the shard's bucket are both picked from it. */
+inline size_t
+cache_hash(const char* data, size_t len) noexcept
+{
+    guint64 hash = G_GUINT64_CONSTANT(14695981039346656037);
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= G_GUINT64_CONSTANT(1099511628211);
+    }
+    return static_cast<size_t>(hash ^ (hash >> 32));
 }
 
+struct CacheKeyHash
+{
+    size_t operator()(const CacheKey& key) const noexcept
+    {
+        return cache_hash(key.data, key.len);
+    }
+};
+
+struct CacheShard
+{
+    std::mutex mutex;
+    std::unordered_map<CacheKey, CacheEntry*, CacheKeyHash> entries;
+};
+
+constexpr size_t num_shards = 32;
+
+/* Never freed, so that strings released by other static destructors
+ * at exit still find it. */
+CacheShard*
+cache_shards()
+{
+    static CacheShard* shards = new CacheShard[num_shards];
+    return shards;
+}
+
+inline CacheShard&
+cache_shard(const CacheKey& key)
+{
+    return cache_shards()[(CacheKeyHash{}(key) >> 8) % num_shards];
+}
+
+CacheEntry*
+cache_entry_new(const char* data, size_t len)
+{
+    auto entry = static_cast<CacheEntry*>(g_malloc(offsetof(CacheEntry, str) +
+                                                   len + 1));
+    entry->refcount = 1;
+    memcpy(entry->str, data, len);
+    entry->str[len] = '\0';
+    return entry;
+}
+
+} // anonymous namespace
+
 void
 qof_string_cache_init(void)
 {
-    (void)qof_get_string_cache();
+    (void)cache_shards();
 }
 
 void
 qof_string_cache_destroy (void)
 {
-    if (qof_string_cache)
+    auto shards = cache_shards();
+    for (size_t i = 0; i < num_shards; ++i)
     {
-        g_hash_table_destroy(qof_string_cache);
+        auto& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (auto& entry : shard.entries)
+            g_free(entry.second);
+        shard.entries.clear();
     }
-    qof_string_cache = NULL;
 }
 
 /* If the key exists in the cache, check the refcount.  If 1, just
@@ -86,52 +157,63 @@ qof_string_cache_remove(const char * key)
 {
     if (key)
     {
-        GHashTable* cache = qof_get_string_cache();
-        gpointer value;
-        gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
+        CacheKey ckey {key, strlen(key)};
+        auto& shard = cache_shard(ckey);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto iter = shard.entries.find(ckey);
+        if (iter == shard.entries.end())
+            return;
+        auto entry = iter->second;
+        if (--entry->refcount == 0)
         {
-            guint* refcount = (guint*)value;
-            if (*refcount == 1)
-            {
-                g_hash_table_remove(cache, key);
-            }
-            else
-            {
-                --(*refcount);
-            }
+            shard.entries.erase(iter);
+            g_free(entry);
         }
     }
 }
 
-/* If the key exists in the cache, increment the refcount.  Otherwise,
- * add it with a refcount of 1. */
 char *
-qof_string_cache_insert(const char * key)
+qof_string_cache_insert_len(const char * key, size_t len)
 {
     if (key)
     {
-        GHashTable* cache = qof_get_string_cache();
-        gpointer value;
-        gpointer cache_key;
-        if (g_hash_table_lookup_extended(cache, key, &cache_key, &value))
+        CacheKey ckey {key, len};
+        auto& shard = cache_shard(ckey);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto iter = shard.entries.find(ckey);
+        if (iter != shard.entries.end())
         {
-            guint* refcount = (guint*)value;
-            ++(*refcount);
-            return static_cast <char *> (cache_key);
-        }
-        else
-        {
-            gpointer new_key = g_strdup(static_cast<const char*>(key));
-            guint* refcount = static_cast<unsigned int*>(g_malloc(sizeof(guint)));
-            *refcount = 1;
-            g_hash_table_insert(cache, new_key, refcount);
-            return static_cast <char *> (new_key);
+            ++iter->second->refcount;
+            return iter->second->str;
         }
+        auto entry = cache_entry_new(key, len);
+        shard.entries.emplace(CacheKey{entry->str, len}, entry);
+        return entry->str;
     }
     return NULL;
 }
 
+/* If the key exists in the cache, increment the refcount.  Otherwise,
+ * add it with a refcount of 1. */
+char *
+qof_string_cache_insert(const char * key)
+{
+    return key ? qof_string_cache_insert_len(key, strlen(key)) : NULL;
+}
+
+const char *
+qof_string_cache_lookup(const char * key, size_t len)
+{
+    if (!key)
+        return NULL;
+
+    CacheKey ckey {key, len};
+    auto& shard = cache_shard(ckey);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto iter = shard.entries.find(ckey);
+    return iter == shard.entries.end() ? NULL : iter->second->str;
+}
+
 char *
 qof_string_cache_replace(char const * dst, char const * src)
 {
@@ -139,4 +221,34 @@ qof_string_cache_replace(char const * dst, char const * src)
     qof_string_cache_remove (dst);
     return tmp;
 }
+
+void
+qof_string_cache_get_usage(size_t * n_strings, size_t * n_refs, size_t * bytes)
+{
+    using Map = std::unordered_map<CacheKey, CacheEntry*, CacheKeyHash>;
+    /* A map node holds the value, the next pointer and the cached hash. */
+    constexpr size_t node_size = sizeof(Map::value_type) + sizeof(void*) +
+        sizeof(size_t);
+    size_t strings = 0, refs = 0, total = sizeof(CacheShard) * num_shards;
+
+    auto shards = cache_shards();
+    for (size_t i = 0; i < num_shards; ++i)
+    {
+        auto& shard = shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        strings += shard.entries.size();
+        total += shard.entries.bucket_count() * sizeof(void*);
+        for (auto& entry : shard.entries)
+        {
+            refs += entry.second->refcount;
+            total += node_size + offsetof(CacheEntry, str) + entry.first.len + 1;
+        }
+    }
+    if (n_strings)
+        *n_strings = strings;
+    if (n_refs)
+        *n_refs = refs;
+    if (bytes)
+        *bytes = total;
+}
 /* ************************ END OF FILE ***************************** */
@@ -33,6 +33,8 @@
 #ifndef QOF_STRING_UTIL_H
 #define QOF_STRING_UTIL_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -66,7 +68,8 @@ extern "C"
  * Note that all the work is done when inserting or removing.  Once
  * cached the strings are just plain C strings.
  *
- * The string cache is demand-created on first use.
+ * The string cache is demand-created on first use. It may be used
+ * from several threads at once.
  *
  **/
 
@@ -86,10 +89,31 @@ void qof_string_cache_remove(const char * key);
 */
 char * qof_string_cache_insert(const char * key);
 
+/** Insert the len bytes at key, which need not be NUL-terminated, as
+ *  qof_string_cache_insert() does; the cached copy is terminated.
+ *  Lets parsers cache a piece of their buffer without copying it out
+ *  first.
+ */
+char * qof_string_cache_insert_len(const char * key, size_t len);
+
+/** Return the cached copy of the len bytes at key without adding a
+ *  reference to it, or NULL if it isn't cached. Nothing is allocated.
+ *  The result is only good for as long as some reference to the
+ *  string is known to be held.
+ */
+const char * qof_string_cache_lookup(const char * key, size_t len);
+
 /** Same as CACHE_REPLACE below, but safe to call from C++.
  */
 char * qof_string_cache_replace(const char * dst, const char * src);
 
+/** Report the number of distinct strings in the cache, the number of
+ *  references held to them and the approximate bytes the cache uses,
+ *  its tables included. Any of the pointers may be NULL.
+ */
+void qof_string_cache_get_usage(size_t * n_strings, size_t * n_refs,
+                                size_t * bytes);
+
 #define CACHE_INSERT(str) qof_string_cache_insert((str))
 #define CACHE_REMOVE(str) qof_string_cache_remove((str))
 
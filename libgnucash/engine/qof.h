@@ -86,5 +86,6 @@
 #include "qofsession.h"
 #include "qofchoice.h"
 #include "qof-string-cache.h"
+#include "qofperf.h"
 
 #endif /* QOF_H_ */
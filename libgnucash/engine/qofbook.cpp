@@ -143,6 +143,8 @@ qof_book_init (QofBook *book)
     book->version = 0;
     book->cached_num_field_source_isvalid = FALSE;
     book->cached_num_days_autoreadonly_isvalid = FALSE;
+    book->bulk_edit_level = 0;
+    book->bulk_edit_held = NULL;
 
     // Register a callback on this NUM_FIELD_SOURCE property of that object
     // because it gets called quite a lot, so that its value must be stored in
@@ -423,6 +425,13 @@ qof_book_destroy (QofBook *book)
     if (!book) return;
     ENTER ("book=%p", book);
 
+    if (book->bulk_edit_level)
+    {
+        PWARN ("book=%p destroyed during a bulk edit", book);
+        while (book->bulk_edit_level)
+            qof_book_end_bulk_edit (book);
+    }
+
     book->shutting_down = TRUE;
     qof_event_force (&book->inst, QOF_EVENT_DESTROY, NULL);
 
@@ -533,6 +542,13 @@ qof_book_shutting_down (const QofBook *book)
     return book->shutting_down;
 }
 
+gboolean
+qof_book_in_bulk_edit (const QofBook *book)
+{
+    if (!book) return FALSE;
+    return book->bulk_edit_level > 0;
+}
+
 /* ====================================================================== */
 /* setters */
 
@@ -599,6 +615,81 @@ qof_book_empty(const QofBook *book)
 
 /* ====================================================================== */
 
+void
+qof_book_begin_bulk_edit (QofBook *book)
+{
+    g_return_if_fail (book != NULL);
+    if (book->bulk_edit_level++ == 0)
+        book->bulk_edit_held = g_hash_table_new (g_direct_hash, g_direct_equal);
+    qof_event_begin_batch ();
+}
+
+void
+qof_book_end_bulk_edit (QofBook *book)
+{
+    g_return_if_fail (book != NULL);
+    if (book->bulk_edit_level == 0)
+    {
+        PERR ("bulk edit level underflow");
+        return;
+    }
+
+    if (--book->bulk_edit_level == 0)
+    {
+        /* The edit is over, so committing doesn't put anything on hold
+         * again. */
+        auto held = book->bulk_edit_held;
+        book->bulk_edit_held = NULL;
+
+        ENTER ("book=%p, %u instances held", book, g_hash_table_size (held));
+        GHashTableIter iter;
+        gpointer inst, commit;
+        g_hash_table_iter_init (&iter, held);
+        while (g_hash_table_iter_next (&iter, &inst, &commit))
+        {
+            auto cb = reinterpret_cast<QofBookBulkCommitCB>(commit);
+            (*cb) (QOF_INSTANCE (inst));
+            g_object_unref (inst);
+        }
+        g_hash_table_destroy (held);
+        LEAVE ("book=%p", book);
+    }
+
+    /* Deliver the events of the commits with the rest of the batch. */
+    qof_event_end_batch ();
+}
+
+gboolean
+qof_book_bulk_edit_hold (QofBook *book, QofInstance *inst,
+                         QofBookBulkCommitCB commit)
+{
+    g_return_val_if_fail (book && inst && commit, FALSE);
+    if (!book->bulk_edit_level ||
+        g_hash_table_contains (book->bulk_edit_held, inst))
+        return FALSE;
+
+    qof_begin_edit (inst);
+    g_object_ref (inst);
+    g_hash_table_insert (book->bulk_edit_held, inst,
+                         reinterpret_cast<gpointer>(commit));
+    return TRUE;
+}
+
+gboolean
+qof_book_bulk_edit_release (QofBook *book, QofInstance *inst)
+{
+    g_return_val_if_fail (book && inst, FALSE);
+    if (!book->bulk_edit_held ||
+        !g_hash_table_remove (book->bulk_edit_held, inst))
+        return FALSE;
+
+    qof_instance_decrease_editlevel (inst);
+    g_object_unref (inst);
+    return TRUE;
+}
+
+/* ====================================================================== */
+
 QofCollection *
 qof_book_get_collection (const QofBook *book, QofIdType entity_type)
 {
@@ -649,6 +740,88 @@ qof_book_foreach_collection (const QofBook *book,
 
 /* ====================================================================== */
 
+static void
+collection_memory_usage_cb (QofCollection *col, gpointer data)
+{
+    auto list = static_cast<GList**>(data);
+    auto usage = g_new (QofMemoryUsage, 1);
+
+    qof_collection_get_memory_usage (col, usage);
+    if (usage->count)
+        *list = g_list_prepend (*list, usage);
+    else
+        g_free (usage);
+}
+
+static gint
+memory_usage_compare (gconstpointer a, gconstpointer b)
+{
+    return g_strcmp0 (static_cast<const QofMemoryUsage*>(a)->type,
+                      static_cast<const QofMemoryUsage*>(b)->type);
+}
+
+GList *
+qof_book_get_memory_usage (const QofBook *book)
+{
+    GList *list = NULL;
+
+    g_return_val_if_fail (book, NULL);
+
+    qof_book_foreach_collection (book, collection_memory_usage_cb, &list);
+    return g_list_sort (list, memory_usage_compare);
+}
+
+static void
+append_memory_usage (GString *str, const QofMemoryUsage *usage)
+{
+    g_string_append_printf (str, "{\"count\": %" G_GUINT64_FORMAT
+                            ", \"bytes\": %" G_GUINT64_FORMAT
+                            ", \"kvp_slots\": %" G_GUINT64_FORMAT
+                            ", \"kvp_bytes\": %" G_GUINT64_FORMAT
+                            ", \"list_nodes\": %" G_GUINT64_FORMAT "}",
+                            usage->count, usage->bytes, usage->kvp_slots,
+                            usage->kvp_bytes, usage->list_nodes);
+}
+
+gchar *
+qof_book_get_memory_report (const QofBook *book)
+{
+    QofMemoryUsage total {};
+    size_t n_strings, n_refs, cache_bytes;
+
+    g_return_val_if_fail (book, NULL);
+
+    auto list = qof_book_get_memory_usage (book);
+    auto str = g_string_new ("{\n\"types\": {");
+    auto sep = "";
+    for (auto node = list; node; node = g_list_next (node))
+    {
+        auto usage = static_cast<QofMemoryUsage*>(node->data);
+        /* QOF type names need no escaping. */
+        g_string_append_printf (str, "%s\n  \"%s\": ", sep, usage->type);
+        append_memory_usage (str, usage);
+        total.count += usage->count;
+        total.bytes += usage->bytes;
+        total.kvp_slots += usage->kvp_slots;
+        total.kvp_bytes += usage->kvp_bytes;
+        total.list_nodes += usage->list_nodes;
+        sep = ",";
+    }
+    g_list_free_full (list, g_free);
+
+    g_string_append (str, "\n},\n\"total\": ");
+    append_memory_usage (str, &total);
+
+    qof_string_cache_get_usage (&n_strings, &n_refs, &cache_bytes);
+    g_string_append_printf (str, ",\n\"string_cache\": {\"strings\": %" G_GSIZE_FORMAT
+                            ", \"references\": %" G_GSIZE_FORMAT
+                            ", \"bytes\": %" G_GSIZE_FORMAT "}\n}\n",
+                            n_strings, n_refs, cache_bytes);
+    return g_string_free (str, FALSE);
+}
+
+/* ====================================================================== */
+
 void qof_book_mark_closed (QofBook *book)
 {
     if (!book)
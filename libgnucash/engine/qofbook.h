@@ -161,6 +161,13 @@ struct _QofBook
     gint cached_num_days_autoreadonly;
     /* Whether the above cached value is valid. */
     gboolean cached_num_days_autoreadonly_isvalid;
+
+    /* Nesting depth of qof_book_begin_bulk_edit() calls. */
+    gint bulk_edit_level;
+
+    /* The instances held open for editing until the bulk edit ends,
+     * mapped to the function committing them. */
+    GHashTable *bulk_edit_held;
 };
 
 struct _QofBookClass
@@ -313,6 +320,55 @@ gboolean qof_book_use_split_action_for_num_field (const QofBook *book);
 /** Is the book shutting down? */
 gboolean qof_book_shutting_down (const QofBook *book);
 
+/** Start a bulk edit of the book, e.g. for an import of many
+ *  transactions. Until the matching qof_book_end_bulk_edit(), objects
+ *  that would otherwise redo expensive bookkeeping after every single
+ *  change (accounts re-sorting their splits and recomputing their
+ *  balances) put themselves on hold and do it once at the end, and
+ *  engine events are batched (see qof_event_begin_batch()).
+ *
+ *  Bulk edits nest; each call must be matched by a call to
+ *  qof_book_end_bulk_edit().
+ */
+void qof_book_begin_bulk_edit (QofBook *book);
+
+/** End a bulk edit of the book. If it is the outermost one, the
+ *  instances put on hold are committed and the batched events are
+ *  delivered. */
+void qof_book_end_bulk_edit (QofBook *book);
+
+/** Is a bulk edit of the book in progress? */
+gboolean qof_book_in_bulk_edit (const QofBook *book);
+
+#ifndef SWIG
+/** Commit function passed to qof_book_bulk_edit_hold(). */
+typedef void (*QofBookBulkCommitCB) (QofInstance *inst);
+
+/** Keep inst open for editing until the bulk edit of book ends, at
+ *  which time commit is called for it. The first call for an instance
+ *  begins an edit of it and returns TRUE; later calls, or calls outside
+ *  of a bulk edit, do nothing and return FALSE. */
+gboolean qof_book_bulk_edit_hold (QofBook *book, QofInstance *inst,
+                                  QofBookBulkCommitCB commit);
+
+/** Take inst off hold without committing it, ending the edit begun by
+ *  qof_book_bulk_edit_hold(), e.g. because inst is being destroyed and
+ *  must not wait for the bulk edit to end. Returns FALSE if inst wasn't
+ *  held. */
+gboolean qof_book_bulk_edit_release (QofBook *book, QofInstance *inst);
+
+/** Return the approximate memory used by the objects in the book as a
+ *  list of QofMemoryUsage, one for each type of object present, sorted
+ *  by type. Free it with g_list_free_full (list, g_free). */
+GList *qof_book_get_memory_usage (const QofBook *book);
+#endif
+
+/** Return a report of the approximate memory used by the book as JSON:
+ *  an object "types" holding the counts and sizes from
+ *  qof_book_get_memory_usage() for each type, their "total" and the
+ *  "string_cache", which all books share. Free it with g_free. */
+gchar *qof_book_get_memory_report (const QofBook *book);
+
 /** qof_book_not_saved() returns the value of the session_dirty flag,
  * set when changes to any object in the book are committed
  * (qof_backend->commit_edit has been called) and the backend hasn't
@@ -32,6 +32,8 @@ typedef struct
 {
     QofEventHandler handler;
     gpointer user_data;
+    QofIdTypeConst entity_type;   /* NULL for all types */
+    QofEventId event_mask;        /* 0 for all events */
 
     gint handler_id;
 } HandlerInfo;
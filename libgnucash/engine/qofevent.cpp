@@ -28,15 +28,61 @@ extern "C"
 #include <glib.h>
 }
 
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "qof.h"
 #include "qofevent-p.h"
 
+/* An event held back by a batch. The entity, and the item of an item
+ * event, are referenced until the event is delivered or superseded;
+ * a superseded event's entity is set to NULL. */
+struct BatchedEvent
+{
+    QofInstance *entity;
+    QofEventId event_id;
+    QofInstance *item;
+};
+
+struct BatchedEventHash
+{
+    size_t operator()(const BatchedEvent& ev) const noexcept
+    {
+        return std::hash<const void*>()(ev.entity) ^
+            std::hash<const void*>()(ev.item) ^
+            (static_cast<size_t>(ev.event_id) * 0x9e3779b9u);
+    }
+};
+
+struct BatchedEventEqual
+{
+    bool operator()(const BatchedEvent& a, const BatchedEvent& b) const noexcept
+    {
+        return a.entity == b.entity && a.event_id == b.event_id &&
+            a.item == b.item;
+    }
+};
+
 /* Static Variables ************************************************/
 static guint   suspend_counter   = 0;
 static gint    next_handler_id   = 1;
 static guint   handler_run_level = 0;
 static guint   pending_deletes   = 0;
 static GList   *handlers  =   NULL;
+/* The handlers of the list above registered for all types, and those
+ * registered for one type, keyed by that type. */
+static GList   *any_type_handlers = NULL;
+static GHashTable *type_handlers  = NULL;
+
+static guint   batch_level       = 0;
+static std::vector<BatchedEvent> batched_events;
+/* Where each held event is in batched_events */
+static std::unordered_map<BatchedEvent, size_t, BatchedEventHash,
+                          BatchedEventEqual> batched_index;
+/* Where the events held for each entity are in batched_events */
+static std::unordered_map<QofInstance*, std::vector<size_t>> batched_entities;
 
 /* This static indicates the debugging module that this .o belongs to.  */
 static QofLogModule log_module = QOF_MOD_ENGINE;
@@ -74,11 +120,20 @@ find_next_handler_id(void)
 
 gint
 qof_event_register_handler (QofEventHandler handler, gpointer user_data)
+{
+    return qof_event_register_type_handler (NULL, 0, handler, user_data);
+}
+
+gint
+qof_event_register_type_handler (QofIdTypeConst entity_type,
+                                 QofEventId event_mask,
+                                 QofEventHandler handler, gpointer user_data)
 {
     HandlerInfo *hi;
     gint handler_id;
 
-    ENTER ("(handler=%p, data=%p)", handler, user_data);
+    ENTER ("(type=%s, mask=%x, handler=%p, data=%p)",
+           entity_type ? entity_type : "(all)", event_mask, handler, user_data);
 
     /* sanity check */
     if (!handler)
@@ -95,13 +150,50 @@ qof_event_register_handler (QofEventHandler handler, gpointer user_data)
 
     hi->handler = handler;
     hi->user_data = user_data;
+    hi->entity_type = entity_type;
+    hi->event_mask = event_mask;
     hi->handler_id = handler_id;
 
     handlers = g_list_prepend (handlers, hi);
+    if (entity_type)
+    {
+        GList *list;
+
+        if (!type_handlers)
+            type_handlers = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                   g_free, NULL);
+        list = static_cast<GList*>(g_hash_table_lookup (type_handlers,
+                                                        entity_type));
+        g_hash_table_insert (type_handlers, g_strdup (entity_type),
+                             g_list_prepend (list, hi));
+    }
+    else
+        any_type_handlers = g_list_prepend (any_type_handlers, hi);
     LEAVE ("(handler=%p, data=%p) handler_id=%d", handler, user_data, handler_id);
     return handler_id;
 }
 
+/* Take hi out of the handler lists and free it. */
+static void
+free_handler_info (HandlerInfo *hi)
+{
+    handlers = g_list_remove (handlers, hi);
+    if (hi->entity_type)
+    {
+        auto list = static_cast<GList*>(g_hash_table_lookup (type_handlers,
+                                                             hi->entity_type));
+        list = g_list_remove (list, hi);
+        if (list)
+            g_hash_table_insert (type_handlers, g_strdup (hi->entity_type),
+                                 list);
+        else
+            g_hash_table_remove (type_handlers, hi->entity_type);
+    }
+    else
+        any_type_handlers = g_list_remove (any_type_handlers, hi);
+    g_free (hi);
+}
+
 void
 qof_event_unregister_handler (gint handler_id)
 {
@@ -128,11 +220,7 @@ qof_event_unregister_handler (gint handler_id)
         hi->handler = NULL;
 
         if (handler_run_level == 0)
-        {
-            handlers = g_list_remove_link (handlers, node);
-            g_list_free_1 (node);
-            g_free (hi);
-        }
+            free_handler_info (hi);
         else
         {
             pending_deletes++;
@@ -167,13 +255,31 @@ qof_event_resume (void)
     suspend_counter--;
 }
 
+static void
+run_handlers (GList *list, QofInstance *entity, QofEventId event_id,
+              gpointer event_data)
+{
+    GList *node, *next_node;
+
+    for (node = list; node; node = next_node)
+    {
+        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
+
+        next_node = node->next;
+        if (hi->handler && (!hi->event_mask || (hi->event_mask & event_id)))
+        {
+            PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
+                  hi->handler, event_data);
+            QOF_PERF_COUNT ("qof.event.handler-calls", 1);
+            hi->handler (entity, event_id, hi->user_data, event_data);
+        }
+    }
+}
+
 static void
 qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
                              gpointer event_data)
 {
-    GList *node;
-    GList *next_node = NULL;
-
     g_return_if_fail(entity);
 
     switch (event_id)
@@ -185,19 +291,15 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
     }
     }
 
+    QOF_PERF_COUNT ("qof.event.dispatch", 1);
     handler_run_level++;
-    for (node = handlers; node; node = next_node)
-    {
-        HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
-
-        next_node = node->next;
-        if (hi->handler)
-        {
-            PINFO("id=%d hi=%p han=%p data=%p", hi->handler_id, hi,
-                  hi->handler, event_data);
-            hi->handler (entity, event_id, hi->user_data, event_data);
-        }
-    }
+    /* Only the handlers of the entity's type are looked at, then those
+     * of all types. */
+    if (type_handlers && entity->e_type)
+        run_handlers (static_cast<GList*>(g_hash_table_lookup (type_handlers,
+                                                               entity->e_type)),
+                      entity, event_id, event_data);
+    run_handlers (any_type_handlers, entity, event_id, event_data);
     handler_run_level--;
 
     /* If we're the outermost event runner and we have pending deletes
@@ -205,17 +307,14 @@ qof_event_generate_internal (QofInstance *entity, QofEventId event_id,
      */
     if (handler_run_level == 0 && pending_deletes)
     {
+        GList *node, *next_node;
+
         for (node = handlers; node; node = next_node)
         {
             HandlerInfo *hi = static_cast<HandlerInfo*>(node->data);
             next_node = node->next;
             if (hi->handler == NULL)
-            {
-                /* remove this node from the list, then free this node */
-                handlers = g_list_remove_link (handlers, node);
-                g_list_free_1 (node);
-                g_free (hi);
-            }
+                free_handler_info (hi);
         }
         pending_deletes = 0;
     }
@@ -230,8 +329,80 @@ qof_event_force (QofInstance *entity, QofEventId event_id, gpointer event_data)
     qof_event_generate_internal (entity, event_id, event_data);
 }
 
-void
-qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
+static void
+release_batched_event (BatchedEvent& ev)
+{
+    g_object_unref (ev.entity);
+    if (ev.item)
+        g_object_unref (ev.item);
+    ev.entity = nullptr;
+}
+
+/* Hold an event back until the batch ends. Returns FALSE if it has to
+ * be delivered right away. */
+static gboolean
+batch_event (QofInstance *entity, QofEventId event_id, QofInstance *item,
+             gpointer event_data)
+{
+    /* The data of an event, e.g. the GncEventData of a transaction's
+     * ITEM_ADDED, often lives on the generator's stack. */
+    if (event_data || event_id == QOF_EVENT_NONE)
+        return FALSE;
+    if (event_id == QOF_EVENT_DESTROY)
+        return FALSE;
+
+    BatchedEvent ev {entity, event_id, item};
+    auto slot = batched_index.find (ev);
+    if (slot != batched_index.end ())
+    {
+        /* Without an item only the first one counts. An item event is
+         * moved to the end so that, e.g., a split added, removed and
+         * added again ends up added. */
+        if (!item)
+            return TRUE;
+        release_batched_event (batched_events[slot->second]);
+        batched_index.erase (slot);
+    }
+
+    g_object_ref (entity);
+    if (item)
+        g_object_ref (item);
+    batched_index.emplace (ev, batched_events.size ());
+    batched_entities[entity].push_back (batched_events.size ());
+    batched_events.push_back (ev);
+    return TRUE;
+}
+
+/* Deliver the events held for entity, before an event of it that
+ * can't be held, so that its handlers see them in order. */
+static void
+deliver_batched_events_of (QofInstance *entity)
+{
+    auto held = batched_entities.find (entity);
+    if (held == batched_entities.end ())
+        return;
+
+    std::vector<size_t> slots;
+    slots.swap (held->second);
+    batched_entities.erase (held);
+    for (auto i : slots)
+    {
+        /* Handlers may hold more events, growing the vector. */
+        auto ev = batched_events[i];
+        if (!ev.entity)
+            continue;
+        batched_index.erase (ev);
+        batched_events[i].entity = nullptr;
+        qof_event_generate_internal (ev.entity, ev.event_id, ev.item);
+        g_object_unref (ev.entity);
+        if (ev.item)
+            g_object_unref (ev.item);
+    }
+}
+
+static void
+gen_event (QofInstance *entity, QofEventId event_id, QofInstance *item,
+           gpointer event_data)
 {
     if (!entity)
         return;
@@ -239,7 +410,70 @@ qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
     if (suspend_counter)
         return;
 
-    qof_event_generate_internal (entity, event_id, event_data);
+    if (batch_level)
+    {
+        if (batch_event (entity, event_id, item, event_data))
+            return;
+        if (event_id != QOF_EVENT_DESTROY)
+            deliver_batched_events_of (entity);
+    }
+
+    qof_event_generate_internal (entity, event_id,
+                                 item ? item : event_data);
+}
+
+void
+qof_event_gen (QofInstance *entity, QofEventId event_id, gpointer event_data)
+{
+    gen_event (entity, event_id, NULL, event_data);
+}
+
+void
+qof_event_gen_item (QofInstance *entity, QofEventId event_id,
+                    QofInstance *item)
+{
+    gen_event (entity, event_id, item, NULL);
+}
+
+void
+qof_event_begin_batch (void)
+{
+    batch_level++;
+}
+
+void
+qof_event_end_batch (void)
+{
+    if (batch_level == 0)
+    {
+        PERR ("batch level underflow");
+        return;
+    }
+
+    if (--batch_level)
+        return;
+
+    /* Handlers may generate more events, or start another batch. */
+    std::vector<BatchedEvent> events;
+    events.swap (batched_events);
+    batched_index.clear ();
+    batched_entities.clear ();
+
+    ENTER ("delivering %zu events", events.size ());
+    QofPerfSpan span {"qof.event.batch-delivery"};
+    for (auto& ev : events)
+    {
+        if (!ev.entity)
+            continue;
+        /* Whatever happened to an entity before it was destroyed is of
+         * no interest to anyone any more. */
+        if (!qof_instance_get_destroying (ev.entity))
+            qof_event_generate_internal (ev.entity, ev.event_id, ev.item);
+        g_object_unref (ev.entity);
+        if (ev.item)
+            g_object_unref (ev.item);
+    }
+    LEAVE (" ");
 }
 
 /* =========================== END OF FILE ======================= */
@@ -98,6 +98,28 @@ typedef void (*QofEventHandler) (QofInstance *ent,  QofEventId event_type,
  */
 gint qof_event_register_handler (QofEventHandler handler, gpointer handler_data);
 
+/** \brief Register a handler for some events of one type of entity.
+ *
+ * The handler is only invoked for entities whose e_type is entity_type
+ * and for events matching event_mask, so it doesn't have to be called
+ * for, and filter out, the many events it has no interest in. Handlers
+ * are kept by type: an event only visits those of its entity's type,
+ * before those registered for all types.
+ *
+ * @param entity_type: the QofIdType to receive events of, or NULL for
+ * all types
+ * @param event_mask: the events to receive, or 0 for all events
+ * @param handler:   handler to register
+ * @param handler_data: data provided when handler is invoked
+ *
+ * @return id identifying handler, to be passed to
+ * qof_event_unregister_handler()
+ */
+gint qof_event_register_type_handler (QofIdTypeConst entity_type,
+                                      QofEventId event_mask,
+                                      QofEventHandler handler,
+                                      gpointer handler_data);
+
 /** \brief Unregister an event handler.
  *
  * @param handler_id: the id of the handler to unregister
@@ -128,6 +150,16 @@ void qof_event_unregister_handler (gint handler_id);
 void qof_event_gen (QofInstance *entity, QofEventId event_type,
                     gpointer event_data);
 
+/** \brief Invoke all registered event handlers for an event about
+ *  item, an instance entity holds, e.g. a split added to an account.
+ *
+ *  The handlers get item as their event_data, as from qof_event_gen().
+ *  But unlike other event data item can be referenced, so a batch
+ *  holds such events back as well.
+ */
+void qof_event_gen_item (QofInstance *entity, QofEventId event_type,
+                         QofInstance *item);
+
 /** \brief  Suspend all engine events.
  *
  *    This function may be called multiple times. To resume event generation,
@@ -139,8 +171,44 @@ void qof_event_suspend (void);
 /** Resume engine event generation. */
 void qof_event_resume (void);
 
+/** \brief Start a batch of engine events.
+ *
+ *    Until the matching qof_event_end_batch(), events generated without
+ *   event_data or by qof_event_gen_item() are held back, so a bulk
+ *   change to many objects doesn't call every handler for every step of
+ *   it. An event repeated for the same entity, and item, is only
+ *   delivered once: in the place it was first generated, or for item
+ *   events the place it was last generated, so that an item added,
+ *   removed and added again is reported as added. The held events are
+ *   delivered when the outermost batch ends.
+ *
+ *    Events carrying other event_data, often on the generator's stack,
+ *   and QOF_EVENT_DESTROY events are still delivered immediately. The
+ *   former first release the events held for their entity, so each
+ *   entity's events arrive in order; the held events of a destroyed
+ *   entity are dropped.
+ *
+ *    Batches nest; each call must be matched by a call to
+ *   qof_event_end_batch().
+ */
+void qof_event_begin_batch (void);
+
+/** End a batch of engine events, delivering the held events if it is
+ *  the outermost one. */
+void qof_event_end_batch (void);
+
 #ifdef __cplusplus
 }
+
+/** Batches the engine events for as long as it is in scope. */
+class QofEventBatch
+{
+public:
+    QofEventBatch() { qof_event_begin_batch (); }
+    ~QofEventBatch() { qof_event_end_batch (); }
+    QofEventBatch(const QofEventBatch&) = delete;
+    QofEventBatch& operator=(const QofEventBatch&) = delete;
+};
 #endif
 
 #endif
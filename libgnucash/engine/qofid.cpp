@@ -32,15 +32,124 @@ extern "C"
 #include "qof.h"
 #include "qofid-p.h"
 #include "qofinstance-p.h"
+#include "guid.hpp"
+
+#include <vector>
 
 static QofLogModule log_module = QOF_MOD_ENGINE;
 
+/** Map from GUID to instance with open addressing and linear probing.
+ *
+ * Every lookup of a book object by GUID ends up here, and a GHashTable
+ * costs a node allocation per entity and a pointer chase per probe. The
+ * slots here hold a copy of the GUID next to the instance, so a lookup
+ * usually touches a single cache line. Removal shifts the following
+ * slots back instead of leaving tombstones.
+ */
+class GuidInstanceMap
+{
+    struct Slot
+    {
+        GncGUID guid;
+        QofInstance *ent;  /* nullptr marks an empty slot */
+    };
+
+    std::vector<Slot> m_slots;
+    size_t m_count = 0;
+
+    size_t mask () const noexcept { return m_slots.size () - 1; }
+
+    /* The slot holding guid, or the empty slot where it would go. */
+    size_t find_slot (GncGUID const & guid) const noexcept
+    {
+        auto i = gnc::hash_guid (guid) & mask ();
+        while (m_slots[i].ent &&
+               memcmp (&m_slots[i].guid, &guid, sizeof guid) != 0)
+            i = (i + 1) & mask ();
+        return i;
+    }
+
+    void grow ()
+    {
+        std::vector<Slot> old (m_slots.empty () ? 16 : m_slots.size () * 2,
+                               Slot {{{0}}, nullptr});
+        old.swap (m_slots);
+        for (auto const & slot : old)
+            if (slot.ent)
+                m_slots[find_slot (slot.guid)] = slot;
+    }
+
+public:
+    QofInstance * lookup (GncGUID const & guid) const noexcept
+    {
+        if (!m_count) return nullptr;
+        return m_slots[find_slot (guid)].ent;
+    }
+
+    /* Insert or replace, like g_hash_table_insert */
+    void insert (GncGUID const & guid, QofInstance *ent)
+    {
+        /* Keep the load at most 3/4 so probe runs stay short */
+        if ((m_count + 1) * 4 > m_slots.size () * 3)
+            grow ();
+        auto & slot = m_slots[find_slot (guid)];
+        if (!slot.ent)
+            ++m_count;
+        slot = Slot {guid, ent};
+    }
+
+    void remove (GncGUID const & guid) noexcept
+    {
+        if (!m_count) return;
+        auto hole = find_slot (guid);
+        if (!m_slots[hole].ent) return;
+        --m_count;
+
+        /* Move back any entry of the following run that would no longer
+         * be reachable from its home slot across the hole. */
+        for (auto i = (hole + 1) & mask (); m_slots[i].ent; i = (i + 1) & mask ())
+        {
+            auto home = gnc::hash_guid (m_slots[i].guid) & mask ();
+            if (((i - home) & mask ()) >= ((i - hole) & mask ()))
+            {
+                m_slots[hole] = m_slots[i];
+                hole = i;
+            }
+        }
+        m_slots[hole].ent = nullptr;
+    }
+
+    size_t size () const noexcept { return m_count; }
+
+    size_t memory_usage () const noexcept
+    {
+        return sizeof (*this) + m_slots.capacity () * sizeof (Slot);
+    }
+
+    template <typename F> void for_each (F func) const
+    {
+        for (auto const & slot : m_slots)
+            if (slot.ent)
+                func (slot.ent);
+    }
+
+    std::vector<QofInstance*> values () const
+    {
+        std::vector<QofInstance*> ret;
+        ret.reserve (m_count);
+        for (auto const & slot : m_slots)
+            if (slot.ent)
+                ret.push_back (slot.ent);
+        return ret;
+    }
+};
+
 struct QofCollection_s
 {
     QofIdType    e_type;
     gboolean     is_dirty;
 
-    GHashTable * hash_of_entities;
+    GuidInstanceMap * hash_of_entities;
     gpointer     data;       /* place where object class can hang arbitrary data */
 };
 
@@ -52,7 +161,7 @@ qof_collection_new (QofIdType type)
     QofCollection *col;
     col = g_new0(QofCollection, 1);
     col->e_type = static_cast<QofIdType>(CACHE_INSERT (type));
-    col->hash_of_entities = guid_hash_table_new();
+    col->hash_of_entities = new GuidInstanceMap;
     col->data = NULL;
     return col;
 }
@@ -61,7 +170,7 @@ void
 qof_collection_destroy (QofCollection *col)
 {
     CACHE_REMOVE (col->e_type);
-    g_hash_table_destroy(col->hash_of_entities);
+    delete col->hash_of_entities;
     col->e_type = NULL;
     col->hash_of_entities = NULL;
     col->data = NULL;   /** XXX there should be a destroy notifier for this */
@@ -89,7 +198,7 @@ qof_collection_remove_entity (QofInstance *ent)
     col = qof_instance_get_collection(ent);
     if (!col) return;
     guid = qof_instance_get_guid(ent);
-    g_hash_table_remove (col->hash_of_entities, guid);
+    col->hash_of_entities->remove (*guid);
     qof_instance_set_collection(ent, NULL);
 }
 
@@ -103,7 +212,7 @@ qof_collection_insert_entity (QofCollection *col, QofInstance *ent)
     if (guid_equal(guid, guid_null())) return;
     g_return_if_fail (col->e_type == ent->e_type);
     qof_collection_remove_entity (ent);
-    g_hash_table_insert (col->hash_of_entities, (gpointer)guid, ent);
+    col->hash_of_entities->insert (*guid, ent);
     qof_instance_set_collection(ent, col);
 }
 
@@ -129,7 +238,7 @@ qof_collection_add_entity (QofCollection *coll, QofInstance *ent)
     {
         return FALSE;
     }
-    g_hash_table_insert (coll->hash_of_entities, (gpointer)guid, ent);
+    coll->hash_of_entities->insert (*guid, ent);
     return TRUE;
 }
 
@@ -216,8 +325,7 @@ qof_collection_lookup_entity (const QofCollection *col, const GncGUID * guid)
     QofInstance *ent;
     g_return_val_if_fail (col, NULL);
     if (guid == NULL) return NULL;
-    ent = static_cast<QofInstance*>(g_hash_table_lookup (col->hash_of_entities,
-							 guid));
+    ent = col->hash_of_entities->lookup (*guid);
     return ent;
 }
 
@@ -246,7 +354,7 @@ qof_collection_count (const QofCollection *col)
 {
     guint c;
 
-    c = g_hash_table_size(col->hash_of_entities);
+    c = col->hash_of_entities->size ();
     return c;
 }
 
@@ -303,40 +411,37 @@ qof_collection_set_data (QofCollection *col, gpointer user_data)
 
 /* =============================================================== */
 
-struct _iterate
-{
-    QofInstanceForeachCB      fcn;
-    gpointer                data;
-};
-
-static void
-foreach_cb (gpointer item, gpointer arg)
+void
+qof_collection_get_memory_usage (const QofCollection *col,
+                                 QofMemoryUsage *usage)
 {
-    struct _iterate *iter = static_cast<_iterate*>(arg);
-    QofInstance *ent = static_cast<QofInstance*>(item);
-
-    iter->fcn (ent, iter->data);
+    g_return_if_fail (col);
+    g_return_if_fail (usage);
+
+    memset (usage, 0, sizeof (*usage));
+    usage->type = col->e_type;
+    usage->bytes = sizeof (*col) + col->hash_of_entities->memory_usage ();
+    col->hash_of_entities->for_each ([usage](QofInstance *ent)
+                                     {
+                                         qof_instance_get_memory_usage (ent, usage);
+                                     });
 }
 
+/* =============================================================== */
+
 void
 qof_collection_foreach (const QofCollection *col, QofInstanceForeachCB cb_func,
                         gpointer user_data)
 {
-    struct _iterate iter;
-    GList *entries;
-
     g_return_if_fail (col);
     g_return_if_fail (cb_func);
 
-    iter.fcn = cb_func;
-    iter.data = user_data;
-
-    PINFO("Hash Table size of %s before is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s before is %" G_GSIZE_FORMAT, col->e_type, col->hash_of_entities->size ());
 
-    entries = g_hash_table_get_values (col->hash_of_entities);
-    g_list_foreach (entries, foreach_cb, &iter);
-    g_list_free (entries);
+    /* Work on a copy, the callback may add or remove entities */
+    for (auto ent : col->hash_of_entities->values ())
+        cb_func (ent, user_data);
 
-    PINFO("Hash Table size of %s after is %d", col->e_type, g_hash_table_size(col->hash_of_entities));
+    PINFO("Hash Table size of %s after is %" G_GSIZE_FORMAT, col->e_type, col->hash_of_entities->size ());
 }
 /* =============================================================== */
@@ -90,6 +90,20 @@ typedef const gchar* QofLogModule;
 
 typedef struct QofCollection_s QofCollection;
 
+/** Approximate memory used by the instances of one type. The sizes are
+ *  worked out from the data structures; allocator overhead isn't
+ *  included, and strings in the string cache are only counted by
+ *  qof_string_cache_get_usage(), since they are shared. */
+typedef struct
+{
+    QofIdTypeConst type;   /**< The type of the instances */
+    guint64 count;         /**< Number of instances */
+    guint64 bytes;         /**< All the bytes, those below included */
+    guint64 kvp_slots;     /**< KVP slots, those of nested frames included */
+    guint64 kvp_bytes;     /**< Bytes of the KVP frames */
+    guint64 list_nodes;    /**< GList nodes held by the instances */
+} QofMemoryUsage;
+
 #include "qofinstance.h"
 
 #define QOF_ID_NONE           NULL
@@ -140,7 +154,7 @@ print error message if its bad  */
 
 @param e_type QofIdType
 @param is_dirty gboolean
-@param hash_of_entities GHashTable
+@param hash_of_entities map from GncGUID to QofInstance
 @param data gpointer, place where object class can hang arbitrary data
 
 */
@@ -183,6 +197,11 @@ void qof_collection_set_data (QofCollection *col, gpointer user_data);
 /** Return value of 'dirty' flag on collection */
 gboolean qof_collection_is_dirty (const QofCollection *col);
 
+/** Fill usage with the approximate memory used by the collection and
+ *  its instances. */
+void qof_collection_get_memory_usage (const QofCollection *col,
+                                      QofMemoryUsage *usage);
+
 /** @name QOF_TYPE_COLLECT: Linking one entity to many of one type
 
 \note These are \b NOT the same as the main collections in the book.
@@ -183,7 +183,8 @@ template<typename func_type, typename data_type>
 void qof_instance_foreach_slot_prefix(QofInstance const * inst, std::string const & path_prefix,
         func_type const & func, data_type & data)
 {
-    inst->kvp_data->for_each_slot_prefix(path_prefix, func, data);
+    if (inst->kvp_data)
+        inst->kvp_data->for_each_slot_prefix(path_prefix, func, data);
 }
 
 #endif
@@ -261,7 +261,7 @@ qof_instance_init (QofInstance *inst)
 
     priv = GET_PRIVATE(inst);
     priv->book = NULL;
-    inst->kvp_data = new KvpFrame;
+    inst->kvp_data = nullptr; /* created by instance_slots () */
     priv->last_update = 0;
     priv->editlevel = 0;
     priv->do_free = FALSE;
@@ -569,12 +569,30 @@ qof_instance_books_equal (gconstpointer ptr1, gconstpointer ptr2)
     return (priv1->book == priv2->book);
 }
 
+/* Most instances, splits and prices above all, never get any slots, so
+ * their KvpFrame is only allocated when something is stored in it. Readers
+ * treat a missing frame as an empty one. */
+static KvpFrame *
+instance_slots (const QofInstance *inst)
+{
+    auto mutable_inst = const_cast<QofInstance*>(inst);
+    if (!mutable_inst->kvp_data)
+        mutable_inst->kvp_data = new KvpFrame;
+    return mutable_inst->kvp_data;
+}
+
+static KvpValue *
+instance_get_slot (const QofInstance *inst, std::vector<std::string> const & path)
+{
+    return inst->kvp_data ? inst->kvp_data->get_slot (path) : nullptr;
+}
+
 /* Watch out: This function is still used (as a "friend") in src/import-export/aqb/gnc-ab-kvp.c */
 KvpFrame*
 qof_instance_get_slots (const QofInstance *inst)
 {
     if (!inst) return NULL;
-    return inst->kvp_data;
+    return instance_slots (inst);
 }
 
 void
@@ -919,6 +937,39 @@ gboolean qof_instance_refers_to_object(const QofInstance* inst, const QofInstanc
     }
 }
 
+void
+qof_instance_get_memory_usage (const QofInstance* inst, QofMemoryUsage* usage)
+{
+    GTypeQuery query;
+    QofInstanceClass* klass;
+    gint private_offset;
+
+    g_return_if_fail (QOF_IS_INSTANCE (inst));
+    g_return_if_fail (usage);
+
+    klass = QOF_INSTANCE_GET_CLASS (inst);
+    g_type_query (G_TYPE_FROM_INSTANCE (inst), &query);
+    usage->count++;
+    usage->bytes += query.instance_size;
+    /* GLib puts the private data of the whole class hierarchy in front
+     * of the instance; the offset is minus its size. */
+    private_offset = g_type_class_get_instance_private_offset (klass);
+    if (private_offset < 0)
+        usage->bytes += -private_offset;
+
+    if (inst->kvp_data)
+    {
+        size_t slots = 0;
+        auto bytes = sizeof (KvpFrame) + inst->kvp_data->get_memory_usage (slots);
+        usage->kvp_slots += slots;
+        usage->kvp_bytes += bytes;
+        usage->bytes += bytes;
+    }
+
+    if (klass->get_memory_usage)
+        klass->get_memory_usage (inst, usage);
+}
+
 /* g_object_set/get wrappers */
 void
 qof_instance_get (const QofInstance *inst, const gchar *first_prop, ...)
@@ -1055,7 +1106,7 @@ qof_instance_has_kvp (QofInstance *inst)
 
 void qof_instance_set_path_kvp (QofInstance * inst, GValue const * value, std::vector<std::string> const & path)
 {
-    delete inst->kvp_data->set_path (path, kvp_value_from_gvalue (value));
+    delete instance_slots (inst)->set_path (path, kvp_value_from_gvalue (value));
 }
 
 void
@@ -1067,12 +1118,12 @@ qof_instance_set_kvp (QofInstance * inst, GValue const * value, unsigned count,
     for (unsigned i{0}; i < count; ++i)
         path.push_back (va_arg (args, char const *));
     va_end (args);
-    delete inst->kvp_data->set_path (path, kvp_value_from_gvalue (value));
+    delete instance_slots (inst)->set_path (path, kvp_value_from_gvalue (value));
 }
 
 void qof_instance_get_path_kvp (QofInstance * inst, GValue * value, std::vector<std::string> const & path)
 {
-    auto temp = gvalue_from_kvp_value (inst->kvp_data->get_slot (path));
+    auto temp = gvalue_from_kvp_value (instance_get_slot (inst, path));
     if (G_IS_VALUE (temp))
     {
         if (G_IS_VALUE (value))
@@ -1092,7 +1143,7 @@ qof_instance_get_kvp (QofInstance * inst, GValue * value, unsigned count, ...)
     for (unsigned i{0}; i < count; ++i)
         path.push_back (va_arg (args, char const *));
     va_end (args);
-    auto temp = gvalue_from_kvp_value (inst->kvp_data->get_slot (path));
+    auto temp = gvalue_from_kvp_value (instance_get_slot (inst, path));
     if (G_IS_VALUE (temp))
     {
         if (G_IS_VALUE (value))
@@ -1107,7 +1158,7 @@ void
 qof_instance_copy_kvp (QofInstance *to, const QofInstance *from)
 {
     delete to->kvp_data;
-    to->kvp_data = new KvpFrame(*from->kvp_data);
+    to->kvp_data = from->kvp_data ? new KvpFrame(*from->kvp_data) : nullptr;
 }
 
 void
@@ -1119,13 +1170,17 @@ qof_instance_swap_kvp (QofInstance *a, QofInstance *b)
 int
 qof_instance_compare_kvp (const QofInstance *a, const QofInstance *b)
 {
-    return compare(a->kvp_data, b->kvp_data);
+    static const KvpFrame empty_frame {};
+    return compare(a->kvp_data ? *a->kvp_data : empty_frame,
+                   b->kvp_data ? *b->kvp_data : empty_frame);
 }
 
 char*
 qof_instance_kvp_as_string (const QofInstance *inst)
 {
     //The std::string is a local temporary and doesn't survive this function.
+    if (!inst->kvp_data)
+        return g_strdup("");
     return g_strdup(inst->kvp_data->to_string().c_str());
 }
 
@@ -1134,13 +1189,11 @@ qof_instance_kvp_add_guid (const QofInstance *inst, const char* path,
                            time64 time, const char *key,
                            const GncGUID *guid)
 {
-    g_return_if_fail (inst->kvp_data != NULL);
-
     auto container = new KvpFrame;
     Time64 t{time};
     container->set({key}, new KvpValue(const_cast<GncGUID*>(guid)));
     container->set({"date"}, new KvpValue(t));
-    delete inst->kvp_data->set_path({path}, new KvpValue(container));
+    delete instance_slots (inst)->set_path({path}, new KvpValue(container));
 }
 
 inline static gboolean
@@ -1161,10 +1214,9 @@ gboolean
 qof_instance_kvp_has_guid (const QofInstance *inst, const char *path,
                            const char* key, const GncGUID *guid)
 {
-    g_return_val_if_fail (inst->kvp_data != NULL, FALSE);
     g_return_val_if_fail (guid != NULL, FALSE);
 
-    auto v = inst->kvp_data->get_slot({path});
+    auto v = instance_get_slot (inst, {path});
     if (v == nullptr) return FALSE;
 
     switch (v->get_type())
@@ -1196,10 +1248,9 @@ void
 qof_instance_kvp_remove_guid (const QofInstance *inst, const char *path,
                           const char *key, const GncGUID *guid)
 {
-    g_return_if_fail (inst->kvp_data != NULL);
     g_return_if_fail (guid != NULL);
 
-    auto v = inst->kvp_data->get_slot({path});
+    auto v = instance_get_slot (inst, {path});
     if (v == NULL) return;
 
     switch (v->get_type())
@@ -1245,14 +1296,14 @@ qof_instance_kvp_merge_guids (const QofInstance *target,
     auto v = donor->kvp_data->get_slot({path});
     if (v == NULL) return;
 
-    auto target_val = target->kvp_data->get_slot({path});
+    auto target_val = instance_get_slot (target, {path});
     switch (v->get_type())
     {
     case KvpValue::Type::FRAME:
         if (target_val)
             target_val->add(v);
         else
-            target->kvp_data->set_path({path}, v);
+            instance_slots (target)->set_path({path}, v);
         donor->kvp_data->set({path}, nullptr); //Contents moved, Don't delete!
         break;
     case KvpValue::Type::GLIST:
@@ -1263,7 +1314,7 @@ qof_instance_kvp_merge_guids (const QofInstance *target,
             target_val->set(list);
         }
         else
-            target->kvp_data->set({path}, v);
+            instance_slots (target)->set({path}, v);
         donor->kvp_data->set({path}, nullptr); //Contents moved, Don't delete!
         break;
     default:
@@ -1274,29 +1325,31 @@ qof_instance_kvp_merge_guids (const QofInstance *target,
 
 bool qof_instance_has_path_slot (QofInstance const * inst, std::vector<std::string> const & path)
 {
-    return inst->kvp_data->get_slot (path) != nullptr;
+    return instance_get_slot (inst, path) != nullptr;
 }
 
 gboolean
 qof_instance_has_slot (const QofInstance *inst, const char *path)
 {
-    return inst->kvp_data->get_slot({path}) != NULL;
+    return instance_get_slot (inst, {path}) != NULL;
 }
 
 void qof_instance_slot_path_delete (QofInstance const * inst, std::vector<std::string> const & path)
 {
-    delete inst->kvp_data->set (path, nullptr);
+    if (inst->kvp_data)
+        delete inst->kvp_data->set (path, nullptr);
 }
 
 void
 qof_instance_slot_delete (QofInstance const *inst, char const * path)
 {
-    delete inst->kvp_data->set ({path}, nullptr);
+    if (inst->kvp_data)
+        delete inst->kvp_data->set ({path}, nullptr);
 }
 
 void qof_instance_slot_path_delete_if_empty (QofInstance const * inst, std::vector<std::string> const & path)
 {
-    auto slot = inst->kvp_data->get_slot (path);
+    auto slot = instance_get_slot (inst, path);
     if (slot)
     {
         auto frame = slot->get <KvpFrame*> ();
@@ -1308,7 +1361,7 @@ void qof_instance_slot_path_delete_if_empty (QofInstance const * inst, std::vect
 void
 qof_instance_slot_delete_if_empty (QofInstance const *inst, char const * path)
 {
-    auto slot = inst->kvp_data->get_slot ({path});
+    auto slot = instance_get_slot (inst, {path});
     if (slot)
     {
         auto frame = slot->get <KvpFrame*> ();
@@ -1321,6 +1374,8 @@ std::vector <std::pair <std::string, KvpValue*>>
 qof_instance_get_slots_prefix (QofInstance const * inst, std::string const & prefix)
 {
     std::vector <std::pair <std::string, KvpValue*>> ret;
+    if (!inst->kvp_data)
+        return ret;
     inst->kvp_data->for_each_slot_temp ([&prefix, &ret] (std::string const & key, KvpValue * val) {
         if (key.find (prefix) == 0)
             ret.emplace_back (key, val);
@@ -1360,7 +1415,7 @@ qof_instance_foreach_slot (const QofInstance *inst, const char* head, const char
     if (category)
         path.emplace_back (category);
 
-    auto slot = inst->kvp_data->get_slot(path);
+    auto slot = instance_get_slot (inst, path);
     if (slot == nullptr || slot->get_type() != KvpValue::Type::FRAME)
         return;
     auto frame = slot->get<KvpFrame*>();
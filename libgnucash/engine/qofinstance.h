@@ -84,6 +84,10 @@ struct _QofInstanceClass
 
     /* Returns a list of my type of object which refers to an object */
     GList* (*get_typed_referring_object_list)(const QofInstance* inst, const QofInstance* ref);
+
+    /* Adds the memory the object holds besides its instance, private
+     * data and KVP, lists for example, to usage. May be NULL. */
+    void (*get_memory_usage)(const QofInstance* inst, QofMemoryUsage* usage);
 };
 
 /** Return the GType of a QofInstance */
@@ -206,6 +210,12 @@ GList* qof_instance_get_typed_referring_object_list(const QofInstance* inst, con
  */
 GList* qof_instance_get_referring_object_list_from_collection(const QofCollection* coll, const QofInstance* ref);
 
+/** Adds the approximate memory used by the instance to usage: the
+    instance with its private data, its KVP and whatever its class
+    reports. The type of usage is left alone.
+ */
+void qof_instance_get_memory_usage(const QofInstance* inst, QofMemoryUsage* usage);
+
 /* @} */
 /* @} */
 #endif /* QOF_INSTANCE_H */
@@ -0,0 +1,306 @@
+/********************************************************************\
+ * qofperf.cpp -- QOF performance counters and trace spans          *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+extern "C"
+{
+#include <config.h>
+
+#include <errno.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+#include "qof.h"
+}
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static QofLogModule log_module = QOF_MOD_UTIL;
+
+gint qof_perf_on = 0;
+
+struct QofPerfCounter
+{
+    std::atomic<int64_t> value {0};
+};
+
+namespace
+{
+
+struct SpanStats
+{
+    uint64_t count = 0;
+    int64_t total = 0;
+    int64_t max = 0;
+};
+
+struct TraceEvent
+{
+    const char *name;
+    int64_t start;
+    int64_t duration;
+    unsigned thread;
+};
+
+/* A trace of a long session would otherwise grow without bound. */
+const size_t max_trace_events = 1 << 20;
+
+/* Guards everything below. */
+std::mutex s_mutex;
+std::string s_filename;
+bool s_trace = false;
+int64_t s_epoch = 0;
+/* Call sites keep pointers to their counters, so they are never freed. */
+std::map<std::string, std::unique_ptr<QofPerfCounter>> s_counters;
+/* Keyed by the name's address; spans of the same name from different
+ * places are added up when written. */
+std::unordered_map<const char*, SpanStats> s_spans;
+std::vector<TraceEvent> s_events;
+size_t s_dropped = 0;
+
+std::atomic<unsigned> s_next_thread {1};
+thread_local unsigned t_thread = 0;
+
+unsigned
+this_thread ()
+{
+    if (!t_thread)
+        t_thread = s_next_thread++;
+    return t_thread;
+}
+
+std::string
+json_string (const char *str)
+{
+    std::string ret {"\""};
+    for (auto p = str; *p; ++p)
+    {
+        auto c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\')
+        {
+            ret += '\\';
+            ret += c;
+        }
+        else if (c < 0x20)
+        {
+            char buf[8];
+            snprintf (buf, sizeof buf, "\\u%04x", c);
+            ret += buf;
+        }
+        else
+            ret += c;
+    }
+    return ret + '"';
+}
+
+void
+write_results (FILE *file)
+{
+    std::map<std::string, SpanStats> spans;
+    for (auto const& span : s_spans)
+    {
+        auto& stats = spans[span.first];
+        stats.count += span.second.count;
+        stats.total += span.second.total;
+        stats.max = std::max (stats.max, span.second.max);
+    }
+
+    fprintf (file, "{\n\"counters\": {");
+    auto sep = "";
+    for (auto const& counter : s_counters)
+    {
+        fprintf (file, "%s\n  %s: %" G_GINT64_FORMAT, sep,
+                 json_string (counter.first.c_str ()).c_str (),
+                 static_cast<gint64>(counter.second->value.load ()));
+        sep = ",";
+    }
+    fprintf (file, "\n},\n\"spans\": {");
+    sep = "";
+    for (auto const& span : spans)
+    {
+        fprintf (file, "%s\n  %s: {\"count\": %" G_GUINT64_FORMAT
+                 ", \"total_us\": %" G_GINT64_FORMAT
+                 ", \"max_us\": %" G_GINT64_FORMAT "}", sep,
+                 json_string (span.first.c_str ()).c_str (),
+                 static_cast<guint64>(span.second.count),
+                 static_cast<gint64>(span.second.total),
+                 static_cast<gint64>(span.second.max));
+        sep = ",";
+    }
+    fprintf (file, "\n}");
+
+    if (s_trace)
+    {
+        fprintf (file, ",\n\"droppedEvents\": %" G_GUINT64_FORMAT
+                 ",\n\"displayTimeUnit\": \"ms\",\n\"traceEvents\": [",
+                 static_cast<guint64>(s_dropped));
+        sep = "";
+        for (auto const& ev : s_events)
+        {
+            fprintf (file, "%s\n  {\"name\": %s, \"cat\": \"gnucash\", "
+                     "\"ph\": \"X\", \"ts\": %" G_GINT64_FORMAT
+                     ", \"dur\": %" G_GINT64_FORMAT
+                     ", \"pid\": 1, \"tid\": %u}", sep,
+                     json_string (ev.name).c_str (),
+                     static_cast<gint64>(ev.start - s_epoch),
+                     static_cast<gint64>(ev.duration), ev.thread);
+            sep = ",";
+        }
+        fprintf (file, "\n]");
+    }
+    fprintf (file, "\n}\n");
+}
+
+}
+
+void
+qof_perf_init (const gchar *filename, gboolean trace)
+{
+    g_return_if_fail (filename && *filename);
+
+    std::lock_guard<std::mutex> lock (s_mutex);
+    s_filename = filename;
+    s_trace = trace;
+    if (!qof_perf_enabled ())
+    {
+        s_epoch = g_get_monotonic_time ();
+        g_atomic_int_set (&qof_perf_on, 1);
+    }
+    PINFO ("Profiling to %s", filename);
+}
+
+void
+qof_perf_init_from_env (void)
+{
+    const gchar *filename;
+
+    if (qof_perf_enabled ())
+        return;
+    if ((filename = g_getenv ("GNC_PERF_TRACE")) && *filename)
+        qof_perf_init (filename, TRUE);
+    else if ((filename = g_getenv ("GNC_PERF_STATS")) && *filename)
+        qof_perf_init (filename, FALSE);
+}
+
+void
+qof_perf_shutdown (void)
+{
+    std::string filename;
+
+    {
+        std::lock_guard<std::mutex> lock (s_mutex);
+        if (!qof_perf_enabled ())
+            return;
+        g_atomic_int_set (&qof_perf_on, 0);
+        filename = s_filename;
+    }
+
+    qof_perf_write (filename.c_str ());
+
+    std::lock_guard<std::mutex> lock (s_mutex);
+    for (auto& counter : s_counters)
+        counter.second->value = 0;
+    s_spans.clear ();
+    s_events.clear ();
+    s_events.shrink_to_fit ();
+    s_dropped = 0;
+}
+
+gboolean
+qof_perf_write (const gchar *filename)
+{
+    g_return_val_if_fail (filename, FALSE);
+
+    auto file = g_fopen (filename, "w");
+    if (!file)
+    {
+        PERR ("Can't write profile to %s: %s", filename, g_strerror (errno));
+        return FALSE;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (s_mutex);
+        write_results (file);
+    }
+
+    if (fclose (file) != 0)
+    {
+        PERR ("Can't write profile to %s: %s", filename, g_strerror (errno));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+QofPerfCounter *
+qof_perf_counter_get (const gchar *name)
+{
+    g_return_val_if_fail (name, nullptr);
+
+    std::lock_guard<std::mutex> lock (s_mutex);
+    auto& counter = s_counters[name];
+    if (!counter)
+        counter.reset (new QofPerfCounter);
+    return counter.get ();
+}
+
+void
+qof_perf_counter_add (QofPerfCounter *counter, gint64 n)
+{
+    if (counter && qof_perf_enabled ())
+        counter->value.fetch_add (n, std::memory_order_relaxed);
+}
+
+gint64
+qof_perf_span_begin (void)
+{
+    return qof_perf_enabled () ? g_get_monotonic_time () : 0;
+}
+
+void
+qof_perf_span_end (const gchar *name, gint64 start)
+{
+    if (!start || !name || !qof_perf_enabled ())
+        return;
+
+    auto duration = g_get_monotonic_time () - start;
+    auto thread = this_thread ();
+
+    std::lock_guard<std::mutex> lock (s_mutex);
+    auto& stats = s_spans[name];
+    stats.count++;
+    stats.total += duration;
+    stats.max = std::max (stats.max, static_cast<int64_t>(duration));
+
+    if (!s_trace)
+        return;
+    if (s_events.size () < max_trace_events)
+        s_events.push_back ({name, start, duration, thread});
+    else
+        s_dropped++;
+}
@@ -0,0 +1,133 @@
+/********************************************************************\
+ * qofperf.h -- QOF performance counters and trace spans            *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/** @addtogroup Utilities
+    @{ */
+/** @file qofperf.h
+    @brief Performance counters and trace spans.
+
+    Named counters and timed spans that the engine keeps while
+    profiling is switched on, so that the cause of a slow book can be
+    found on the user's machine without rebuilding GnuCash.
+
+    Profiling is off unless the environment variable GNC_PERF_STATS or
+    GNC_PERF_TRACE names a file when qof_init() runs, or the program
+    calls qof_perf_init() (gnucash's --perf-trace option). While off,
+    each instrumentation point costs one test of a global flag.
+
+    When profiling stops, in qof_close(), the file is written as JSON:
+    a "counters" object with the value of each counter and a "spans"
+    object with the count, total and maximum duration in microseconds
+    of each span. With GNC_PERF_TRACE, or a trace requested from
+    qof_perf_init(), every span is also recorded as a complete event in
+    "traceEvents", so the same file loads in chrome://tracing or
+    Perfetto.
+*/
+
+#ifndef QOF_PERF_H
+#define QOF_PERF_H
+
+#include <glib.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct QofPerfCounter QofPerfCounter;
+
+/** Start profiling. The results are written to filename when
+ *  profiling stops; if trace is TRUE they include every span in Chrome
+ *  trace format. Starting again replaces the file to write. */
+void qof_perf_init (const gchar *filename, gboolean trace);
+
+/** Start profiling if GNC_PERF_TRACE or GNC_PERF_STATS is set and
+ *  profiling was not started yet. Called by qof_init(). */
+void qof_perf_init_from_env (void);
+
+/** Stop profiling, write the results and forget them. */
+void qof_perf_shutdown (void);
+
+/** Write the results gathered so far to filename. Returns FALSE if
+ *  the file couldn't be written. */
+gboolean qof_perf_write (const gchar *filename);
+
+/** Set while profiling is on. Read it with qof_perf_enabled(). */
+extern gint qof_perf_on;
+
+/** Is profiling on? Inline, as every instrumentation point asks. */
+static inline gboolean
+qof_perf_enabled (void)
+{
+    return g_atomic_int_get (&qof_perf_on) != 0;
+}
+
+/** Return the counter called name, creating it on first use. Counters
+ *  are never freed, qof_perf_shutdown() only zeroes them, and are safe
+ *  to use from any thread. */
+QofPerfCounter *qof_perf_counter_get (const gchar *name);
+
+/** Add n to counter. */
+void qof_perf_counter_add (QofPerfCounter *counter, gint64 n);
+
+/** Return the start time of a span, or 0 if profiling is off. */
+gint64 qof_perf_span_begin (void);
+
+/** Record the span called name that began at start, as returned by
+ *  qof_perf_span_begin(). Does nothing if start is 0. name must stay
+ *  valid until profiling stops; string literals are the usual
+ *  choice. */
+void qof_perf_span_end (const gchar *name, gint64 start);
+
+/** Add n to the counter called name, if profiling is on. The counter
+ *  is looked up once per call site, which may be reached from several
+ *  threads. */
+#define QOF_PERF_COUNT(name, n) do {                                 \
+    if (qof_perf_enabled ())                                        \
+    {                                                               \
+        static gsize qof_perf_counter_ = 0;                         \
+        if (g_once_init_enter (&qof_perf_counter_))                \
+            g_once_init_leave (&qof_perf_counter_,                  \
+                               (gsize) qof_perf_counter_get (name)); \
+        qof_perf_counter_add ((QofPerfCounter*) qof_perf_counter_, (n)); \
+    }                                                               \
+} while (0)
+
+#ifdef __cplusplus
+}
+
+/** Records a span for as long as it is in scope. */
+class QofPerfSpan
+{
+public:
+    explicit QofPerfSpan (const gchar *name) :
+        m_name (name), m_start (qof_perf_span_begin ()) {}
+    ~QofPerfSpan () { qof_perf_span_end (m_name, m_start); }
+    QofPerfSpan (const QofPerfSpan&) = delete;
+    QofPerfSpan& operator= (const QofPerfSpan&) = delete;
+private:
+    const gchar *m_name;
+    gint64 m_start;
+};
+#endif
+
+#endif /* QOF_PERF_H */
+/** @} */
@@ -735,6 +735,7 @@ static GList * qof_query_run_internal (QofQuery *q,
     g_return_val_if_fail (q->books, NULL);
     g_return_val_if_fail (run_cb, NULL);
     ENTER (" q=%p", q);
+    QofPerfSpan span {"qof.query.run"};
 
     /* XXX: Prioritize the query terms? */
 
@@ -763,6 +764,7 @@ static GList * qof_query_run_internal (QofQuery *q,
         object_count = qcb.count;
     }
     PINFO ("matching objects=%p count=%d", matching_objects, object_count);
+    QOF_PERF_COUNT ("qof.query.matches", object_count);
 
     /* There is no absolute need to reverse this list, since it's being
      * sorted below. However, in the common case, we will be searching
@@ -205,6 +205,7 @@ QofSessionImpl::load (QofPercentageFunc percentage_func) noexcept
     
     if (!m_book_id.size ()) return;
     ENTER ("sess=%p book_id=%s", this, m_book_id.c_str ());
+    QofPerfSpan span {"qof.session.load"};
 
     /* At this point, we should are supposed to have a valid book
     * id and a lock on the file. */
@@ -429,6 +430,7 @@ QofSessionImpl::save (QofPercentageFunc percentage_func) noexcept
         return;
     m_saving = true;
     ENTER ("sess=%p book_id=%s", this, m_book_id.c_str ());
+    QofPerfSpan span {"qof.session.save"};
 
     /* If there is a backend, the book is dirty, and the backend is reachable
      * (i.e. we can communicate with it), then synchronize with the backend.  If
@@ -467,6 +469,7 @@ QofSessionImpl::safe_save (QofPercentageFunc percentage_func) noexcept
 {
     auto backend = qof_book_get_backend (m_book);
     if (!backend) return;
+    QofPerfSpan span {"qof.session.safe-save"};
     backend->set_percentage(percentage_func);
     backend->safe_sync(get_book ());
     auto err = backend->get_error();
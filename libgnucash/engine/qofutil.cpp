@@ -259,6 +259,7 @@ void
 qof_init (void)
 {
     qof_log_init();
+    qof_perf_init_from_env ();
     qof_string_cache_init();
     qof_object_initialize ();
     qof_query_init ();
@@ -272,6 +273,7 @@ qof_close(void)
     qof_object_shutdown ();
     QofBackend::release_backends();
     qof_string_cache_destroy ();
+    qof_perf_shutdown ();
     qof_log_shutdown();
 }
 
@@ -31,6 +31,7 @@ extern "C"
 #include <kvp-frame.hpp>
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
 
 class ImapTest : public testing::Test
 {
@@ -373,6 +374,66 @@ TEST_F (ImapBayesTest, import_map_with_delimiters)
     EXPECT_EQ (account, t_expense_account1);
 }
 
+/* With hundreds of tokens the plain product of the token probabilities
+ * underflows to zero for every account, so the match has to come from the
+ * rescaled products. */
+TEST_F (ImapBayesTest, FindAccountBayesManyTokens)
+{
+    const int pairs = 330;
+    std::vector<std::string> names;
+    for (int i = 0; i < pairs; ++i)
+    {
+        names.push_back ("food" + std::to_string (1000 + i));
+        names.push_back ("drink" + std::to_string (1000 + i));
+    }
+    GList *food_tokens {}, *drink_tokens {}, *tokens {};
+    for (int i = 0; i < 2 * pairs; i += 2)
+    {
+        food_tokens = g_list_prepend (food_tokens, const_cast<char*> (names[i].c_str ()));
+        drink_tokens = g_list_prepend (drink_tokens, const_cast<char*> (names[i + 1].c_str ()));
+        tokens = g_list_prepend (tokens, const_cast<char*> (names[i].c_str ()));
+        tokens = g_list_prepend (tokens, const_cast<char*> (names[i + 1].c_str ()));
+    }
+    GList *deciding {};
+    deciding = g_list_prepend (deciding, const_cast<char*> (pepper));
+    tokens = g_list_prepend (tokens, const_cast<char*> (pepper));
+
+    /* Every food token says Food with 0.9, every drink token says Food
+     * with 0.1, so they cancel out and only pepper (0.99) decides. */
+    for (int i = 0; i < 9; ++i)
+    {
+        gnc_account_imap_add_account_bayes (t_imap, food_tokens, t_expense_account1);
+        gnc_account_imap_add_account_bayes (t_imap, drink_tokens, t_expense_account2);
+    }
+    gnc_account_imap_add_account_bayes (t_imap, food_tokens, t_expense_account2);
+    gnc_account_imap_add_account_bayes (t_imap, drink_tokens, t_expense_account1);
+    for (int i = 0; i < 99; ++i)
+        gnc_account_imap_add_account_bayes (t_imap, deciding, t_expense_account1);
+    gnc_account_imap_add_account_bayes (t_imap, deciding, t_expense_account2);
+
+    double product = 0.99, product_difference = 0.01;
+    for (int i = 0; i < pairs; ++i)
+    {
+        product *= 0.9 * 0.1;
+        product_difference *= 0.1 * 0.9;
+    }
+    ASSERT_EQ (0.0, product);
+    ASSERT_EQ (0.0, product_difference);
+
+    auto account = gnc_account_imap_find_account_bayes (t_imap, tokens);
+    EXPECT_EQ (t_expense_account1, account);
+
+    /* Without pepper the remaining tokens are a tie, under the threshold. */
+    tokens = g_list_remove (tokens, pepper);
+    account = gnc_account_imap_find_account_bayes (t_imap, tokens);
+    EXPECT_EQ (nullptr, account);
+
+    g_list_free (tokens);
+    g_list_free (deciding);
+    g_list_free (food_tokens);
+    g_list_free (drink_tokens);
+}
+
 TEST_F (ImapBayesTest, get_bayes_info)
 {
     GList * tokens {nullptr};
@@ -29,6 +29,9 @@
 #include <iomanip>
 #include <string>
 #include <iostream>
+#include <set>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 #include <boost/version.hpp>
 
@@ -40,6 +43,36 @@ TEST (GncGUID, creation)
     GncGUID other;
 }
 
+TEST (GncGUID, random_version)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        auto str = gnc::GUID::create_random ().to_string ();
+        EXPECT_EQ (str[12], '4');
+        EXPECT_NE (std::string {"89ab"}.find (str[16]), std::string::npos);
+    }
+}
+
+TEST (GncGUID, random_threads)
+{
+    // Every thread has a generator of its own; they mustn't repeat each other.
+    const int nthreads = 4, count = 10000;
+    std::vector<std::vector<std::string>> results (nthreads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nthreads; ++i)
+        threads.emplace_back ([&results, i, count] {
+            for (int j = 0; j < count; ++j)
+                results[i].push_back (gnc::GUID::create_random ().to_string ());
+        });
+    for (auto & thread : threads)
+        thread.join ();
+
+    std::set<std::string> all;
+    for (auto const & result : results)
+        all.insert (result.begin (), result.end ());
+    EXPECT_EQ (all.size (), static_cast<size_t> (nthreads * count));
+}
+
 TEST (GncGUID, copy)
 {
     auto guid = gnc::GUID::create_random ();
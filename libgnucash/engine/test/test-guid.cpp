@@ -62,6 +62,7 @@ run_test (void)
     QofCollection *col;
     QofIdType type;
     GncGUID guid;
+    GPtrArray *ents = g_ptr_array_new ();
 
     sess = get_random_session ();
     book = qof_session_get_book (sess);
@@ -80,10 +81,27 @@ run_test (void)
                  "duplicate guid");
         ent->e_type = type;
         qof_collection_insert_entity (col, ent);
+        g_ptr_array_add (ents, ent);
         do_test ((NULL != qof_collection_lookup_entity (col, &guid)),
                  "guid not found");
     }
 
+    /* Removing entities must not lose the ones stored after them */
+    for (i = 0; i < NENT; i += 2)
+        qof_collection_remove_entity (static_cast<QofInstance*>(ents->pdata[i]));
+    do_test (qof_collection_count (col) == NENT / 2, "count after remove");
+    for (i = 0; i < NENT; i++)
+    {
+        ent = static_cast<QofInstance*>(ents->pdata[i]);
+        if (i % 2)
+            do_test (ent == qof_collection_lookup_entity
+                     (col, qof_instance_get_guid (ent)), "kept guid not found");
+        else
+            do_test (NULL == qof_collection_lookup_entity
+                     (col, qof_instance_get_guid (ent)), "removed guid found");
+    }
+    g_ptr_array_free (ents, TRUE);
+
     /* Make valgrind happy -- destroy the session. */
     qof_session_destroy(sess);
 }
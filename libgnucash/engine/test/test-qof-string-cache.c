@@ -77,8 +77,69 @@ test_qof_string_cache( void )
     g_assert(str1_1 != str1_4);
 }
 
+static void
+test_qof_string_cache_len( void )
+{
+    const gchar *buf = "memo-action";
+    gchar *memo = qof_string_cache_insert("memo");
+
+    /* A piece of a buffer finds the cached string without copying */
+    g_assert(qof_string_cache_lookup(buf, 4) == memo);
+    g_assert(qof_string_cache_lookup(buf, 5) == NULL);
+    g_assert(qof_string_cache_lookup(buf + 5, 6) == NULL);
+
+    g_assert(qof_string_cache_insert_len(buf, 4) == memo);  /* Refcount = 2 */
+    g_assert_cmpstr(qof_string_cache_insert_len(buf + 5, 6), ==, "action");
+    qof_string_cache_remove("action");
+    g_assert(qof_string_cache_lookup(buf + 5, 6) == NULL);
+
+    qof_string_cache_remove(memo);                          /* Refcount = 1 */
+    g_assert(qof_string_cache_lookup("memo", 4) == memo);
+    qof_string_cache_remove(memo);                          /* Refcount = 0 */
+    g_assert(qof_string_cache_lookup("memo", 4) == NULL);
+}
+
+static gpointer
+string_cache_thread( gpointer data )
+{
+    gchar str[16];
+    int i;
+
+    for (i = 0; i < 10000; i++)
+    {
+        gchar *cached;
+        g_snprintf(str, sizeof(str), "str%d", i % 100);
+        cached = qof_string_cache_insert(str);
+        g_assert_cmpstr(cached, ==, str);
+        qof_string_cache_remove(cached);
+    }
+    return NULL;
+}
+
+static void
+test_qof_string_cache_threads( void )
+{
+    GThread *threads[4];
+    gchar str[16];
+    int i;
+
+    for (i = 0; i < 4; i++)
+        threads[i] = g_thread_new("string-cache", string_cache_thread, NULL);
+    for (i = 0; i < 4; i++)
+        g_thread_join(threads[i]);
+
+    /* Every insert was matched by a remove */
+    for (i = 0; i < 100; i++)
+    {
+        g_snprintf(str, sizeof(str), "str%d", i);
+        g_assert(qof_string_cache_lookup(str, strlen(str)) == NULL);
+    }
+}
+
 void
 test_suite_qof_string_cache ( void )
 {
     GNC_TEST_ADD_FUNC( suitename, "string-cache", test_qof_string_cache);
+    GNC_TEST_ADD_FUNC( suitename, "string-cache-len", test_qof_string_cache_len);
+    GNC_TEST_ADD_FUNC( suitename, "string-cache-threads", test_qof_string_cache_threads);
 }
@@ -27,8 +27,10 @@
 #include "qof.h"
 
 extern void test_suite_qofbook();
+extern void test_suite_qofevent();
 extern void test_suite_qofinstance();
 extern void test_suite_qofobject();
+extern void test_suite_qofperf();
 extern void test_suite_gnc_date();
 extern void test_suite_qof_string_cache();
 
@@ -44,8 +46,10 @@ main (int   argc,
     g_test_bug_base("https://bugs.gnucash.org/show_bug.cgi?id="); /* init the bugzilla URL */
 
     test_suite_qofbook();
+    test_suite_qofevent();
     test_suite_qofinstance();
     test_suite_qofobject();
+    test_suite_qofperf();
     test_suite_gnc_date();
     test_suite_qof_string_cache();
 
@@ -35,6 +35,7 @@ extern "C"
 
 #include "../qof.h"
 #include "../qofbook-p.h"
+#include "../qofinstance-p.h"
 #include "../qofbookslots.h"
 /* For gnc_account_create_root() */
 #include "../Account.h"
@@ -719,6 +720,94 @@ test_book_shutting_down( Fixture *fixture, gconstpointer pData )
     g_assert( qof_book_shutting_down( fixture->book ) == FALSE );
 }
 
+static guint bulk_commits = 0;
+
+static void
+bulk_commit( QofInstance *inst )
+{
+    bulk_commits++;
+    g_assert_cmpint( qof_instance_get_editlevel( inst ), ==, 1 );
+    qof_commit_edit( inst );
+}
+
+static void
+test_book_bulk_edit( Fixture *fixture, gconstpointer pData )
+{
+    QofInstance *inst = g_object_new( QOF_TYPE_INSTANCE, NULL );
+
+    qof_instance_init_data( inst, "test type", fixture->book );
+    bulk_commits = 0;
+
+    g_test_message( "Testing hold outside of a bulk edit" );
+    g_assert( !qof_book_in_bulk_edit( fixture->book ) );
+    g_assert( !qof_book_bulk_edit_hold( fixture->book, inst, bulk_commit ) );
+    g_assert_cmpint( qof_instance_get_editlevel( inst ), ==, 0 );
+
+    g_test_message( "Testing nested bulk edits" );
+    qof_book_begin_bulk_edit( fixture->book );
+    qof_book_begin_bulk_edit( fixture->book );
+    g_assert( qof_book_in_bulk_edit( fixture->book ) );
+    g_assert( qof_book_bulk_edit_hold( fixture->book, inst, bulk_commit ) );
+    g_assert( !qof_book_bulk_edit_hold( fixture->book, inst, bulk_commit ) );
+    g_assert_cmpint( qof_instance_get_editlevel( inst ), ==, 1 );
+    qof_book_end_bulk_edit( fixture->book );
+    g_assert( qof_book_in_bulk_edit( fixture->book ) );
+    g_assert_cmpuint( bulk_commits, ==, 0 );
+    qof_book_end_bulk_edit( fixture->book );
+    g_assert( !qof_book_in_bulk_edit( fixture->book ) );
+    g_assert_cmpuint( bulk_commits, ==, 1 );
+    g_assert_cmpint( qof_instance_get_editlevel( inst ), ==, 0 );
+
+    g_object_unref( inst );
+}
+
+static void
+test_book_get_memory_usage( Fixture *fixture, gconstpointer pData )
+{
+    QofInstance *plain = g_object_new( QOF_TYPE_INSTANCE, NULL );
+    QofInstance *slotted = g_object_new( QOF_TYPE_INSTANCE, NULL );
+    GValue value = G_VALUE_INIT;
+    QofMemoryUsage *usage = NULL;
+    GList *list, *node;
+    gchar *report;
+
+    qof_instance_init_data( plain, "test type", fixture->book );
+    qof_instance_init_data( slotted, "test type", fixture->book );
+    g_value_init( &value, G_TYPE_STRING );
+    g_value_set_string( &value, "some notes" );
+    qof_instance_set_kvp( slotted, &value, 1, "notes" );
+    g_value_unset( &value );
+
+    g_test_message( "Testing the usage list for the book" );
+    g_assert( qof_book_get_memory_usage( NULL ) == NULL );
+    list = qof_book_get_memory_usage( fixture->book );
+    for ( node = list; node; node = node->next )
+    {
+        QofMemoryUsage *u = node->data;
+        g_assert_cmpuint( u->count, >, 0 );
+        if ( g_strcmp0( u->type, "test type" ) == 0 )
+            usage = u;
+    }
+    g_assert( usage );
+    g_assert_cmpuint( usage->count, ==, 2 );
+    g_assert_cmpuint( usage->kvp_slots, ==, 1 );
+    g_assert_cmpuint( usage->kvp_bytes, >, 0 );
+    g_assert_cmpuint( usage->bytes, >=,
+                      2 * sizeof( QofInstance ) + usage->kvp_bytes );
+    g_list_free_full( list, g_free );
+
+    g_test_message( "Testing the JSON report" );
+    report = qof_book_get_memory_report( fixture->book );
+    g_assert( strstr( report, "\"types\": {" ) );
+    g_assert( strstr( report, "\"test type\": {\"count\": 2," ) );
+    g_assert( strstr( report, "\"total\": {" ) );
+    g_assert( strstr( report, "\"string_cache\": {\"strings\": " ) );
+    g_free( report );
+
+    g_object_unref( plain );
+    g_object_unref( slotted );
+}
+
 static void
 test_book_set_get_data( Fixture *fixture, gconstpointer pData )
 {
@@ -938,6 +1027,8 @@ test_suite_qofbook ( void )
     GNC_TEST_ADD( suitename, "session dirty time", Fixture, NULL, setup, test_book_get_session_dirty_time, teardown );
     GNC_TEST_ADD( suitename, "set dirty callback", Fixture, NULL, setup, test_book_set_dirty_cb, teardown );
     GNC_TEST_ADD( suitename, "shutting down", Fixture, NULL, setup, test_book_shutting_down, teardown );
+    GNC_TEST_ADD( suitename, "bulk edit", Fixture, NULL, setup, test_book_bulk_edit, teardown );
+    GNC_TEST_ADD( suitename, "memory usage", Fixture, NULL, setup, test_book_get_memory_usage, teardown );
     GNC_TEST_ADD( suitename, "set get data", Fixture, NULL, setup, test_book_set_get_data, teardown );
     GNC_TEST_ADD( suitename, "get collection", Fixture, NULL, setup, test_book_get_collection, teardown );
     GNC_TEST_ADD( suitename, "foreach collection", Fixture, NULL, setup, test_book_foreach_collection, teardown );
@@ -0,0 +1,191 @@
+/********************************************************************
+ * test-qofevent.c: GLib g_test test suite for qofevent.            *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include <glib.h>
+#include <unittest-support.h>
+#include "qof.h"
+#include "qofinstance-p.h"
+
+static const gchar *suitename = "/qof/qofevent";
+void test_suite_qofevent ( void );
+
+typedef struct
+{
+    QofInstance *entity;
+    QofEventId event_id;
+    gpointer event_data;
+} Received;
+
+typedef struct
+{
+    QofBook *book;
+    QofInstance *a;
+    QofInstance *b;
+    GArray *received;
+    gint handler_id;
+} Fixture;
+
+static void
+record_event( QofInstance *ent, QofEventId event_type,
+              gpointer handler_data, gpointer event_data )
+{
+    Fixture *fixture = handler_data;
+    Received rec = { ent, event_type, event_data };
+    g_array_append_val( fixture->received, rec );
+}
+
+static void
+assert_received( Fixture *fixture, guint index, QofInstance *ent,
+                 QofEventId event_id )
+{
+    Received *rec = &g_array_index( fixture->received, Received, index );
+    g_assert( rec->entity == ent );
+    g_assert_cmpint( rec->event_id, ==, event_id );
+}
+
+static void
+setup( Fixture *fixture, gconstpointer pData )
+{
+    fixture->book = qof_book_new();
+    fixture->a = g_object_new( QOF_TYPE_INSTANCE, NULL );
+    qof_instance_init_data( fixture->a, "type-a", fixture->book );
+    fixture->b = g_object_new( QOF_TYPE_INSTANCE, NULL );
+    qof_instance_init_data( fixture->b, "type-b", fixture->book );
+    fixture->received = g_array_new( FALSE, FALSE, sizeof( Received ) );
+    fixture->handler_id = 0;
+}
+
+static void
+teardown( Fixture *fixture, gconstpointer pData )
+{
+    if (fixture->handler_id)
+        qof_event_unregister_handler( fixture->handler_id );
+    g_array_free( fixture->received, TRUE );
+    g_object_unref( fixture->a );
+    g_object_unref( fixture->b );
+    qof_book_destroy( fixture->book );
+}
+
+static void
+test_event_type_handler( Fixture *fixture, gconstpointer pData )
+{
+    fixture->handler_id =
+        qof_event_register_type_handler( "type-a",
+                                         QOF_EVENT_MODIFY | QOF_EVENT_DESTROY,
+                                         record_event, fixture );
+
+    qof_event_gen( fixture->a, QOF_EVENT_MODIFY, NULL );
+    qof_event_gen( fixture->a, QOF_EVENT_CREATE, NULL );
+    qof_event_gen( fixture->b, QOF_EVENT_MODIFY, NULL );
+    qof_event_gen( fixture->a, QOF_EVENT_DESTROY, NULL );
+
+    g_assert_cmpint( fixture->received->len, ==, 2 );
+    assert_received( fixture, 0, fixture->a, QOF_EVENT_MODIFY );
+    assert_received( fixture, 1, fixture->a, QOF_EVENT_DESTROY );
+}
+
+static void
+test_event_batch( Fixture *fixture, gconstpointer pData )
+{
+    gint data = 0;
+
+    fixture->handler_id = qof_event_register_handler( record_event, fixture );
+
+    qof_event_begin_batch();
+    qof_event_gen( fixture->a, QOF_EVENT_MODIFY, NULL );
+    qof_event_gen( fixture->b, QOF_EVENT_MODIFY, NULL );
+    qof_event_begin_batch();
+    qof_event_gen( fixture->a, QOF_EVENT_MODIFY, NULL );
+    qof_event_gen( fixture->a, QOF_EVENT_ADD, NULL );
+    qof_event_end_batch();
+    /* Events with data can't be held, they go out at once, after the
+     * events held for their entity */
+    qof_event_gen( fixture->b, QOF_EVENT_ADD, &data );
+    g_assert_cmpint( fixture->received->len, ==, 2 );
+    assert_received( fixture, 0, fixture->b, QOF_EVENT_MODIFY );
+    assert_received( fixture, 1, fixture->b, QOF_EVENT_ADD );
+    qof_event_end_batch();
+
+    g_assert_cmpint( fixture->received->len, ==, 4 );
+    assert_received( fixture, 2, fixture->a, QOF_EVENT_MODIFY );
+    assert_received( fixture, 3, fixture->a, QOF_EVENT_ADD );
+
+    /* Once the batch is over events are delivered as they come */
+    qof_event_gen( fixture->a, QOF_EVENT_MODIFY, NULL );
+    g_assert_cmpint( fixture->received->len, ==, 5 );
+}
+
+static void
+test_event_batch_items( Fixture *fixture, gconstpointer pData )
+{
+    fixture->handler_id = qof_event_register_handler( record_event, fixture );
+
+    qof_event_begin_batch();
+    qof_event_gen( fixture->a, QOF_EVENT_CREATE, NULL );
+    qof_event_gen_item( fixture->a, QOF_EVENT_ADD, fixture->b );
+    qof_event_gen_item( fixture->a, QOF_EVENT_REMOVE, fixture->b );
+    qof_event_gen_item( fixture->a, QOF_EVENT_ADD, fixture->b );
+    g_assert_cmpint( fixture->received->len, ==, 0 );
+    qof_event_end_batch();
+
+    /* The item ends up added, after the creation of its holder */
+    g_assert_cmpint( fixture->received->len, ==, 3 );
+    assert_received( fixture, 0, fixture->a, QOF_EVENT_CREATE );
+    assert_received( fixture, 1, fixture->a, QOF_EVENT_REMOVE );
+    assert_received( fixture, 2, fixture->a, QOF_EVENT_ADD );
+    g_assert( g_array_index( fixture->received, Received, 1 ).event_data ==
+              fixture->b );
+    g_assert( g_array_index( fixture->received, Received, 2 ).event_data ==
+              fixture->b );
+}
+
+static void
+test_event_batch_destroy( Fixture *fixture, gconstpointer pData )
+{
+    fixture->handler_id = qof_event_register_handler( record_event, fixture );
+
+    qof_event_begin_batch();
+    qof_event_gen( fixture->a, QOF_EVENT_MODIFY, NULL );
+    qof_event_gen( fixture->b, QOF_EVENT_MODIFY, NULL );
+    qof_instance_set_destroying( fixture->a, TRUE );
+    qof_event_gen( fixture->a, QOF_EVENT_DESTROY, NULL );
+    g_assert_cmpint( fixture->received->len, ==, 1 );
+    assert_received( fixture, 0, fixture->a, QOF_EVENT_DESTROY );
+    qof_event_end_batch();
+
+    /* The destroyed entity's modification isn't delivered any more */
+    g_assert_cmpint( fixture->received->len, ==, 2 );
+    assert_received( fixture, 1, fixture->b, QOF_EVENT_MODIFY );
+}
+
+void
+test_suite_qofevent ( void )
+{
+    GNC_TEST_ADD( suitename, "type handler", Fixture, NULL, setup,
+                  test_event_type_handler, teardown );
+    GNC_TEST_ADD( suitename, "batch", Fixture, NULL, setup,
+                  test_event_batch, teardown );
+    GNC_TEST_ADD( suitename, "batch items", Fixture, NULL, setup,
+                  test_event_batch_items, teardown );
+    GNC_TEST_ADD( suitename, "batch destroy", Fixture, NULL, setup,
+                  test_event_batch_destroy, teardown );
+}
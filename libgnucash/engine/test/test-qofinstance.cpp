@@ -216,7 +216,7 @@ test_instance_new_destroy( void )
     g_assert( qof_instance_get_guid( inst ) );
     g_assert( !qof_instance_get_collection( inst ) );
     g_assert( qof_instance_get_book( inst ) == NULL );
-    g_assert( inst->kvp_data );
+    g_assert( inst->kvp_data == nullptr );
     g_object_get( inst, "last-update", &time_priv, NULL);
     g_assert_cmpint( time_priv->t, == , 0 );
     g_assert_cmpint( qof_instance_get_editlevel( inst ), == , 0 );
@@ -0,0 +1,82 @@
+/********************************************************************
+ * test-qofperf.c: GLib g_test test suite for qofperf.              *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+#include <config.h>
+#include <string.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <unittest-support.h>
+#include "qof.h"
+
+static const gchar *suitename = "/qof/qofperf";
+void test_suite_qofperf ( void );
+
+static void
+count_twice( void )
+{
+    int i;
+    for (i = 0; i < 2; i++)
+        QOF_PERF_COUNT( "test.counter", 3 );
+}
+
+static void
+test_perf_counters_and_spans( void )
+{
+    gchar *filename = NULL;
+    gchar *contents = NULL;
+    gint64 start;
+    gint fd;
+
+    fd = g_file_open_tmp( "test-qofperf-XXXXXX.json", &filename, NULL );
+    g_assert_cmpint( fd, !=, -1 );
+    g_close( fd, NULL );
+
+    /* Nothing is recorded while profiling is off */
+    qof_perf_shutdown();
+    g_assert( !qof_perf_enabled() );
+    g_assert_cmpint( qof_perf_span_begin(), ==, 0 );
+    count_twice();
+
+    qof_perf_init( filename, TRUE );
+    g_assert( qof_perf_enabled() );
+    count_twice();
+    start = qof_perf_span_begin();
+    g_assert_cmpint( start, !=, 0 );
+    qof_perf_span_end( "test.span", start );
+    qof_perf_shutdown();
+    g_assert( !qof_perf_enabled() );
+
+    g_assert( g_file_get_contents( filename, &contents, NULL, NULL ) );
+    g_assert( strstr( contents, "\"test.counter\": 6" ) );
+    g_assert( strstr( contents, "\"test.span\": {\"count\": 1," ) );
+    g_assert( strstr( contents, "\"traceEvents\"" ) );
+    g_assert( strstr( contents, "\"name\": \"test.span\"" ) );
+
+    g_free( contents );
+    g_unlink( filename );
+    g_free( filename );
+}
+
+void
+test_suite_qofperf ( void )
+{
+    GNC_TEST_ADD_FUNC( suitename, "counters and spans", test_perf_counters_and_spans );
+}
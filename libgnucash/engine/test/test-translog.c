@@ -0,0 +1,267 @@
+/***************************************************************************
+ *            test-translog.c
+ *
+ *  Round trip transactions through the transaction log formats.
+ ****************************************************************************/
+/*
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ *  02110-1301, USA.
+ */
+
+#include <config.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include "qof.h"
+#include "Transaction.h"
+#include "TransLog.h"
+#include "cashobjects.h"
+#include "test-stuff.h"
+#include "test-engine-stuff.h"
+
+typedef struct
+{
+    Transaction *trans;
+    guint n_trans;
+} ReadData;
+
+static void
+check_trans (const TransLogEntry *entries, guint n_entries, gpointer user_data)
+{
+    ReadData *data = user_data;
+    Transaction *trans = data->trans;
+    guint i;
+
+    data->n_trans++;
+    do_test (n_entries == (guint)xaccTransCountSplits (trans), "split count");
+    for (i = 0; i < n_entries; i++)
+    {
+        const TransLogEntry *entry = &entries[i];
+        Split *split = xaccTransGetSplit (trans, i);
+
+        do_test (entry->flag == 'C', "flag");
+        do_test (guid_equal (&entry->trans_guid, xaccTransGetGUID (trans)),
+                 "transaction guid");
+        do_test (guid_equal (&entry->split_guid, xaccSplitGetGUID (split)),
+                 "split guid");
+        do_test (entry->date_posted == xaccTransGetDate (trans), "date posted");
+        do_test (g_strcmp0 (entry->description,
+                            xaccTransGetDescription (trans) ?
+                            xaccTransGetDescription (trans) : "") == 0,
+                 "description");
+        do_test (gnc_numeric_equal (entry->amount, xaccSplitGetAmount (split)),
+                 "amount");
+        do_test (gnc_numeric_equal (entry->value, xaccSplitGetValue (split)),
+                 "value");
+    }
+}
+
+/* A hand-edited text log: the second split has no amount and the
+ * transaction no date entered. */
+static const char empty_fields_log[] =
+    "mod\ttrans_guid\tsplit_guid\ttime_now\t"
+    "date_entered\tdate_posted\t"
+    "acc_guid\tacc_name\tnum\tdescription\t"
+    "notes\tmemo\taction\treconciled\t"
+    "amount\tvalue\tdate_reconciled\n"
+    "===== START\n"
+    "C\t0123456789abcdef0123456789abcdef\t00000000000000000000000000000001\t"
+    "2018-01-02 10:00:00\t\t2018-01-01 10:59:00\t"
+    "\t\t\tgroceries\t\t\t\tn\t-1000/100\t-1000/100\t"
+    "1970-01-01 00:00:00\n"
+    "C\t0123456789abcdef0123456789abcdef\t00000000000000000000000000000002\t"
+    "2018-01-02 10:00:00\t\t2018-01-01 10:59:00\t"
+    "\t\t\tgroceries\t\t\t\tn\t\t1000/100\t\n"
+    "===== END\n";
+
+typedef struct
+{
+    guint n_trans;
+    gboolean ok;
+} EmptyFieldsData;
+
+static void
+check_empty_fields (const TransLogEntry *entries, guint n_entries,
+                    gpointer user_data)
+{
+    EmptyFieldsData *data = user_data;
+
+    data->n_trans++;
+    data->ok = n_entries == 2 &&
+        !entries[0].date_entered_present && entries[0].date_posted_present &&
+        entries[0].amount_present && entries[0].value_present &&
+        entries[0].date_reconciled_present &&
+        gnc_numeric_equal (entries[0].amount, gnc_numeric_create (-1000, 100)) &&
+        !entries[1].date_entered_present && entries[1].date_posted_present &&
+        !entries[1].amount_present && entries[1].value_present &&
+        !entries[1].date_reconciled_present &&
+        gnc_numeric_zero_p (entries[1].amount) && entries[1].date_reconciled == 0;
+}
+
+/* Empty fields stay empty when a text log is read or converted. */
+static void
+run_empty_fields_test (const gchar *dir)
+{
+    gchar *text = g_build_filename (dir, "empty.log", NULL);
+    gchar *binary = g_build_filename (dir, "empty.jnl", NULL);
+    gchar *back = g_build_filename (dir, "empty-back.log", NULL);
+    gchar *back_data;
+    gsize back_len;
+    EmptyFieldsData data = { 0, FALSE };
+
+    g_file_set_contents (text, empty_fields_log, -1, NULL);
+    do_test (xaccLogReadFile (text, check_empty_fields, &data) == XACC_LOG_READ_OK &&
+             data.n_trans == 1 && data.ok, "empty fields in a text log");
+
+    do_test (xaccLogConvertFile (text, binary, XACC_LOG_BINARY),
+             "convert empty fields to binary");
+    data.n_trans = 0;
+    data.ok = FALSE;
+    do_test (xaccLogReadFile (binary, check_empty_fields, &data) == XACC_LOG_READ_OK &&
+             data.n_trans == 1 && data.ok, "empty fields in a journal");
+
+    do_test (xaccLogConvertFile (binary, back, XACC_LOG_TEXT),
+             "convert empty fields back to text");
+    g_file_get_contents (back, &back_data, &back_len, NULL);
+    do_test (back_len == strlen (empty_fields_log) &&
+             memcmp (back_data, empty_fields_log, back_len) == 0,
+             "empty fields round trip");
+
+    g_unlink (text);
+    g_unlink (binary);
+    g_unlink (back);
+    g_free (back_data);
+    g_free (text);
+    g_free (binary);
+    g_free (back);
+}
+
+static gchar *
+find_log_file (const gchar *dir, const gchar *suffix)
+{
+    GDir *gdir = g_dir_open (dir, 0, NULL);
+    const gchar *name;
+    gchar *path = NULL;
+
+    while (gdir && (name = g_dir_read_name (gdir)) != NULL)
+        if (g_str_has_suffix (name, suffix))
+            path = g_build_filename (dir, name, NULL);
+    if (gdir)
+        g_dir_close (gdir);
+    return path;
+}
+
+static void
+run_test (void)
+{
+    QofBook *book = qof_book_new ();
+    Transaction *trans = get_random_transaction (book);
+    gchar *dir = g_dir_make_tmp ("test-translog-XXXXXX", NULL);
+    gchar *base = g_build_filename (dir, "book", NULL);
+    gchar *journal, *text, *binary;
+    gchar *journal_data, *binary_data;
+    gsize journal_len, binary_len;
+    ReadData data = { trans, 0 };
+
+    xaccLogSetBaseName (base);
+    xaccLogSetFormat (XACC_LOG_BINARY);
+    xaccLogSetFlushInterval (16);
+    xaccLogEnable ();
+    xaccOpenLog ();
+    xaccTransWriteLog (trans, 'C');
+    xaccTransWriteLog (trans, 'C');
+    xaccCloseLog ();
+    xaccLogDisable ();
+
+    journal = find_log_file (dir, ".jnl");
+    do_test (journal != NULL, "journal written");
+    do_test (xaccLogReadFile (journal, check_trans, &data) == XACC_LOG_READ_OK,
+             "read journal");
+    do_test (data.n_trans == 2, "journal transaction count");
+
+    text = g_build_filename (dir, "converted.log", NULL);
+    do_test (xaccLogConvertFile (journal, text, XACC_LOG_TEXT), "convert to text");
+    data.n_trans = 0;
+    do_test (xaccLogReadFile (text, check_trans, &data) == XACC_LOG_READ_OK,
+             "read text log");
+    do_test (data.n_trans == 2, "text transaction count");
+
+    binary = g_build_filename (dir, "converted.jnl", NULL);
+    do_test (xaccLogConvertFile (text, binary, XACC_LOG_BINARY),
+             "convert back to binary");
+    g_file_get_contents (journal, &journal_data, &journal_len, NULL);
+    g_file_get_contents (binary, &binary_data, &binary_len, NULL);
+    do_test (journal_len == binary_len &&
+             memcmp (journal_data, binary_data, journal_len) == 0,
+             "binary round trip");
+
+    /* A record cut short by a crash is skipped */
+    g_file_set_contents (binary, binary_data, binary_len - 3, NULL);
+    data.n_trans = 0;
+    do_test (xaccLogReadFile (binary, check_trans, &data) == XACC_LOG_READ_OK,
+             "read truncated journal");
+    do_test (data.n_trans == 1, "truncated transaction count");
+
+    /* Records queued for the background writer come out in order */
+    g_unlink (journal);
+    g_unlink (binary);
+    g_free (journal);
+    xaccLogSetAsync (TRUE);
+    xaccLogEnable ();
+    xaccOpenLog ();
+    xaccTransWriteLog (trans, 'C');
+    xaccTransWriteLog (trans, 'C');
+    xaccTransWriteLog (trans, 'C');
+    xaccLogSync (FALSE);
+    journal = find_log_file (dir, ".jnl");
+    data.n_trans = 0;
+    do_test (xaccLogReadFile (journal, check_trans, &data) == XACC_LOG_READ_OK,
+             "read synced journal");
+    do_test (data.n_trans == 3, "synced transaction count");
+    xaccCloseLog ();
+    xaccLogDisable ();
+    xaccLogSetAsync (FALSE);
+
+    run_empty_fields_test (dir);
+
+    g_unlink (journal);
+    g_unlink (text);
+    g_rmdir (dir);
+    g_free (journal_data);
+    g_free (binary_data);
+    g_free (journal);
+    g_free (text);
+    g_free (binary);
+    g_free (base);
+    g_free (dir);
+    xaccLogSetFormat (XACC_LOG_TEXT);
+    qof_book_destroy (book);
+}
+
+int
+main (int argc, char **argv)
+{
+    qof_init();
+    if (cashobjects_register())
+    {
+        /* The text log can't hold tabs or newlines */
+        random_character_include_funky_chars (FALSE);
+        xaccLogDisable ();
+        run_test ();
+        print_test_results();
+    }
+    qof_close();
+    return get_rv();
+}
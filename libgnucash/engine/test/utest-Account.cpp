@@ -24,6 +24,7 @@ extern "C"
 #include <config.h>
 #include <string.h>
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <unittest-support.h>
 #include <gnc-event.h>
 #include <gnc-date.h>
@@ -43,6 +44,8 @@ void test_suite_account (void);
 
 #include <qofinstance-p.h>
 #include <kvp-frame.hpp>
+#include <algorithm>
+#include <vector>
 
 typedef struct
 {
@@ -1742,6 +1745,172 @@ test_gnc_account_lookup_by_full_name (Fixture *fixture, gconstpointer pData)
     target = gnc_account_lookup_by_full_name (root, names3);
     g_assert (target == NULL);
     g_free (code);
+    g_assert (gnc_account_lookup_by_full_name (root, "") == NULL);
+}
+
+static void
+test_gnc_account_lookup_index_tracks_changes (Fixture *fixture,
+                                              gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *target = gnc_account_lookup_by_full_name (root,
+                                                       "income:taxable:int");
+    Account *taxable, *expense;
+    gchar *full_name;
+
+    g_assert (target != NULL);
+    taxable = gnc_account_get_parent (target);
+    full_name = gnc_account_get_full_name (target);
+    g_assert_cmpstr (full_name, ==, "income:taxable:int");
+    g_free (full_name);
+
+    xaccAccountBeginEdit (taxable);
+    xaccAccountSetName (taxable, "taxed");
+    xaccAccountCommitEdit (taxable);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:int") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxed:int") == target);
+    full_name = gnc_account_get_full_name (target);
+    g_assert_cmpstr (full_name, ==, "income:taxed:int");
+    g_free (full_name);
+
+    expense = gnc_account_lookup_by_full_name (root, "expense");
+    g_assert (expense != NULL);
+    gnc_account_append_child (expense, target);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxed:int") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root, "expense:int") == target);
+
+    gnc_set_account_separator ("/");
+    g_assert (gnc_account_lookup_by_full_name (root, "expense/int") == target);
+    full_name = gnc_account_get_full_name (target);
+    g_assert_cmpstr (full_name, ==, "expense/int");
+    g_free (full_name);
+    gnc_set_account_separator (":");
+
+    xaccAccountBeginEdit (target);
+    xaccAccountSetCode (target, "9999");
+    xaccAccountCommitEdit (target);
+    g_assert (gnc_account_lookup_by_code (root, "9999") == target);
+    g_assert (gnc_account_lookup_by_code (root, "4160") == NULL);
+}
+
+/* Duplicate sibling names: the helper backtracks to later siblings of
+ * the same name, and the index must find the same accounts. */
+static void
+test_gnc_account_lookup_by_full_name_duplicates (Fixture *fixture,
+                                                 gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    QofBook *book = gnc_account_get_book (root);
+    Account *dup1 = xaccMallocAccount (book);
+    Account *dup2 = xaccMallocAccount (book);
+    Account *left1 = xaccMallocAccount (book);
+    Account *left2 = xaccMallocAccount (book);
+    Account *right2 = xaccMallocAccount (book);
+    Account *colon = xaccMallocAccount (book);
+    AccountTestFunctions *func = _utest_account_fill_functions ();
+    const char *full_names[] = {"dup", "dup:left", "dup:right", "dup:x",
+                                "assets:broker:stocks:baz",
+                                "assets:broker:stocks:baz2", "dup:a:b",
+                                "income:taxable:div", "income:exempt:div"};
+
+    xaccAccountSetName (dup1, "dup");
+    xaccAccountSetName (dup2, "dup");
+    xaccAccountSetName (left1, "left");
+    xaccAccountSetName (left2, "left");
+    xaccAccountSetName (right2, "right");
+    xaccAccountSetName (colon, "a:b");
+    gnc_account_append_child (root, dup1);
+    gnc_account_append_child (root, dup2);
+    gnc_account_append_child (dup1, left1);
+    gnc_account_append_child (dup2, left2);
+    gnc_account_append_child (dup2, right2);
+    gnc_account_append_child (dup2, colon);
+
+    g_assert (gnc_account_lookup_by_full_name (root, "dup") == dup1);
+    g_assert (gnc_account_lookup_by_full_name (root, "dup:left") == left1);
+    g_assert (gnc_account_lookup_by_full_name (root, "dup:right") == right2);
+    g_assert (gnc_account_lookup_by_full_name (root, "dup:a:b") == NULL);
+    for (guint i = 0; i < G_N_ELEMENTS (full_names); ++i)
+    {
+        gchar **names = g_strsplit (full_names[i], ":", -1);
+        g_assert (gnc_account_lookup_by_full_name (root, full_names[i]) ==
+                  func->gnc_account_lookup_by_full_name_helper (root, names));
+        g_strfreev (names);
+    }
+
+    /* Renaming the first "dup" leaves only the second to match. */
+    xaccAccountSetName (dup1, "single");
+    g_assert (gnc_account_lookup_by_full_name (root, "dup") == dup2);
+    g_assert (gnc_account_lookup_by_full_name (root, "dup:left") == left2);
+    g_assert (gnc_account_lookup_by_full_name (root, "single:left") == left1);
+    g_free (func);
+}
+
+/* A change in one book's account tree leaves the caches of another
+ * book's tree alone, and those of the changed tree are renewed. */
+static void
+test_gnc_account_lookup_index_per_tree (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *target = gnc_account_lookup_by_full_name (root, "income:taxable:int");
+    QofBook *book2 = qof_book_new ();
+    Account *root2 = gnc_account_create_root (book2);
+    Account *acct2 = xaccMallocAccount (book2);
+    gchar *full_name;
+
+    xaccAccountSetName (acct2, "income");
+    gnc_account_append_child (root2, acct2);
+    g_assert (gnc_account_lookup_by_full_name (root2, "income") == acct2);
+
+    xaccAccountSetName (acct2, "revenue");
+    g_assert (gnc_account_lookup_by_full_name (root2, "income") == NULL);
+    g_assert (gnc_account_lookup_by_full_name (root2, "revenue") == acct2);
+    g_assert (gnc_account_lookup_by_full_name (root, "income:taxable:int") == target);
+    full_name = gnc_account_get_full_name (target);
+    g_assert_cmpstr (full_name, ==, "income:taxable:int");
+    g_free (full_name);
+
+    /* Detaching a subtree gives it its own generation. */
+    gnc_account_remove_child (root2, acct2);
+    full_name = gnc_account_get_full_name (acct2);
+    g_assert_cmpstr (full_name, ==, "");
+    g_free (full_name);
+    gnc_account_append_child (root2, acct2);
+    full_name = gnc_account_get_full_name (acct2);
+    g_assert_cmpstr (full_name, ==, "revenue");
+    g_free (full_name);
+
+    qof_book_destroy (book2);
+}
+
+static gpointer
+full_name_thread (gpointer data)
+{
+    Account *acct = static_cast<Account*>(data);
+    for (int i = 0; i < 1000; ++i)
+    {
+        gchar *full_name = gnc_account_get_full_name (acct);
+        g_assert_cmpstr (full_name, ==, "income:taxed:int");
+        g_free (full_name);
+    }
+    return NULL;
+}
+
+/* Full names are filled in lazily by a const function; readers on
+ * several threads must all get the right name. */
+static void
+test_gnc_account_get_full_name_threads (Fixture *fixture, gconstpointer pData)
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *target = gnc_account_lookup_by_full_name (root, "income:taxable:int");
+    GThread *threads[4];
+
+    g_assert (target != NULL);
+    xaccAccountSetName (gnc_account_get_parent (target), "taxed");
+    for (guint i = 0; i < G_N_ELEMENTS (threads); ++i)
+        threads[i] = g_thread_new ("full-name", full_name_thread, target);
+    for (guint i = 0; i < G_N_ELEMENTS (threads); ++i)
+        g_thread_join (threads[i]);
 }
 
 static void
@@ -1932,6 +2101,37 @@ test_xaccAccountGetBalanceAsOfDate (Fixture *fixture, gconstpointer pData)
     dval = gnc_numeric_to_double (val);
     g_assert_cmpfloat (dval, == , dbal);
 }
+/* xaccAccountGetBalancesAtDates
+void
+xaccAccountGetBalancesAtDates (const Account *acc, const time64 *dates,
+                               gsize n_dates, gnc_numeric *amounts,
+                               gnc_numeric *values)*/
+static void
+test_xaccAccountGetBalancesAtDates (Fixture *fixture, gconstpointer pData)
+{
+    const gint day = 24 * 3600;
+    time64 now = gnc_time (NULL);
+    /* Deliberately out of order */
+    time64 dates[] = { now - 3 * day, now + 30 * day, now - 365 * day,
+                       now, now - 3 * day };
+    const gsize n_dates = G_N_ELEMENTS (dates);
+    gnc_numeric amounts[G_N_ELEMENTS (dates)];
+    gsize i;
+
+    xaccAccountRecomputeBalance (fixture->acct);
+    xaccAccountGetBalancesAtDates (fixture->acct, dates, n_dates,
+                                   amounts, NULL);
+    for (i = 0; i < n_dates; ++i)
+    {
+        /* xaccAccountGetBalanceAsOfDate excludes the date itself. */
+        gnc_numeric expected =
+            xaccAccountGetBalanceAsOfDate (fixture->acct, dates[i] + 1);
+        g_assert (gnc_numeric_equal (amounts[i], expected));
+    }
+    g_assert (gnc_numeric_equal (amounts[0], amounts[4]));
+    g_assert (gnc_numeric_equal (amounts[1],
+                                 xaccAccountGetBalance (fixture->acct)));
+}
 /* xaccAccountGetPresentBalance
 gnc_numeric
 xaccAccountGetPresentBalance (const Account *acc)// C: 4 in 2 */
@@ -2512,6 +2712,240 @@ test_xaccAccountTreeForEachTransaction (Fixture *fixture, gconstpointer pData )
     g_assert_cmpint (result, < , 9);
     g_free(td.name);
 }
+static gint
+thunk_atomic (Transaction *txn, gpointer data)
+{
+    Thunkdata *td = (Thunkdata*)data;
+    gint count = g_atomic_int_add (&td->count, 1) + 1;
+    if (td->name)
+    {
+        const gchar *txn_desc = xaccTransGetDescription (txn);
+        if (g_strcmp0 (td->name, txn_desc) == 0)
+            return count;
+    }
+    return 0;
+}
+
+/* xaccAccountTreeForEachTransactionParallel
+int
+xaccAccountTreeForEachTransactionParallel (const Account *acc,
+                                           TransactionCallback proc,
+                                           void *data, guint n_threads);*/
+static void
+test_xaccAccountTreeForEachTransactionParallel (Fixture *fixture, gconstpointer pData )
+{
+    Thunkdata td = {0, NULL};
+    Account *root = gnc_account_get_root (fixture->acct);
+    gint result;
+    result = xaccAccountTreeForEachTransactionParallel (root, thunk_atomic,
+                                                        &td, 4);
+    g_assert_cmpint (td.count, == , 9);
+    g_assert_cmpint (result, == , 0);
+    td.count = 0;
+    result = xaccAccountTreeForEachTransactionParallel (root, thunk_atomic,
+                                                        &td, 0);
+    g_assert_cmpint (td.count, == , 9);
+    g_assert_cmpint (result, == , 0);
+    td.count = 0;
+    td.name = g_strdup("pepper");
+    result = xaccAccountTreeForEachTransactionParallel (root, thunk_atomic,
+                                                        &td, 1);
+    g_assert_cmpint (td.count, == , result);
+    g_assert_cmpint (result, < , 9);
+    g_free(td.name);
+}
+#define PARALLEL_TXNS 5000
+#define PARALLEL_STOP 3187
+
+typedef struct
+{
+    GMutex mutex;
+    GHashTable *visits;
+    GHashTable *threads;
+    Transaction *stop;
+} ParallelData;
+
+static gint
+thunk_parallel (Transaction *txn, gpointer data)
+{
+    ParallelData *pd = (ParallelData*)data;
+    guint visits;
+    g_mutex_lock (&pd->mutex);
+    visits = GPOINTER_TO_UINT (g_hash_table_lookup (pd->visits, txn));
+    g_hash_table_insert (pd->visits, txn, GUINT_TO_POINTER (visits + 1));
+    g_hash_table_add (pd->threads, g_thread_self ());
+    g_mutex_unlock (&pd->mutex);
+    return txn == pd->stop ? PARALLEL_STOP : 0;
+}
+
+static void
+test_xaccAccountTreeForEachTransactionParallel_many (Fixture *fixture, gconstpointer pData )
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *money = gnc_account_lookup_by_name (root, "money");
+    Account *food = gnc_account_lookup_by_name (root, "food");
+    QofBook *book = gnc_account_get_book (root);
+    gnc_numeric amount = gnc_numeric_create (100, 100);
+    std::vector<Transaction*> txns;
+    ParallelData pd;
+    gint result;
+
+    g_assert (money && food);
+    for (guint i = 0; i < PARALLEL_TXNS; ++i)
+    {
+        Transaction *txn = xaccMallocTransaction (book);
+        Split *from = xaccMallocSplit (book);
+        Split *to = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccSplitSetParent (from, txn);
+        xaccSplitSetParent (to, txn);
+        xaccSplitSetAmount (from, gnc_numeric_neg (amount));
+        xaccSplitSetValue (from, gnc_numeric_neg (amount));
+        xaccSplitSetAmount (to, amount);
+        xaccSplitSetValue (to, amount);
+        gnc_account_insert_split (money, from);
+        gnc_account_insert_split (food, to);
+        qof_commit_edit (QOF_INSTANCE (txn));
+        txns.push_back (txn);
+    }
+
+    g_mutex_init (&pd.mutex);
+    pd.visits = g_hash_table_new (NULL, NULL);
+    pd.threads = g_hash_table_new (NULL, NULL);
+    pd.stop = NULL;
+
+    g_test_message ("Each transaction is visited exactly once");
+    result = xaccAccountTreeForEachTransactionParallel (root, thunk_parallel,
+                                                        &pd, 4);
+    g_assert_cmpint (result, == , 0);
+    g_assert_cmpuint (g_hash_table_size (pd.visits), == , PARALLEL_TXNS);
+    for (auto txn : txns)
+        g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (pd.visits, txn)),
+                          == , 1);
+    g_test_message ("Visited on %u threads", g_hash_table_size (pd.threads));
+
+    g_test_message ("A non-zero return stops the traversal and is returned");
+    g_hash_table_remove_all (pd.visits);
+    /* The transactions are handed out in address order, so the lowest one
+     * starts the first chunk and the rest of that chunk is never visited. */
+    pd.stop = *std::min_element (txns.begin(), txns.end());
+    result = xaccAccountTreeForEachTransactionParallel (root, thunk_parallel,
+                                                        &pd, 4);
+    g_assert_cmpint (result, == , PARALLEL_STOP);
+    g_assert_cmpuint (GPOINTER_TO_UINT (g_hash_table_lookup (pd.visits, pd.stop)),
+                      == , 1);
+    g_assert_cmpuint (g_hash_table_size (pd.visits), < , PARALLEL_TXNS);
+
+    g_hash_table_destroy (pd.visits);
+    g_hash_table_destroy (pd.threads);
+    g_mutex_clear (&pd.mutex);
+}
+
+#define BULK_TXNS 100
+
+/* The value of the counter called name in the profile contents. */
+static gint64
+perf_count (const gchar *contents, const gchar *name)
+{
+    auto key = g_strdup_printf ("\"%s\": ", name);
+    auto found = strstr (contents, key);
+    gint64 count = found ? g_ascii_strtoll (found + strlen (key), NULL, 10) : -1;
+    g_free (key);
+    return count;
+}
+
+static void
+test_bulk_edit_sort_and_balance (Fixture *fixture, gconstpointer pData )
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *money = gnc_account_lookup_by_name (root, "money");
+    Account *food = gnc_account_lookup_by_name (root, "food");
+    QofBook *book = gnc_account_get_book (root);
+    gnc_numeric amount = gnc_numeric_create (100, 100);
+    gchar *filename = NULL, *contents = NULL;
+    Split *prev = NULL;
+    gint fd;
+
+    g_assert (money && food);
+    fd = g_file_open_tmp ("utest-Account-XXXXXX.json", &filename, NULL);
+    g_assert_cmpint (fd, != , -1);
+    g_close (fd, NULL);
+    qof_perf_init (filename, FALSE);
+
+    qof_book_begin_bulk_edit (book);
+    /* Newest first, so that every split lands out of order. */
+    for (guint i = 0; i < BULK_TXNS; ++i)
+    {
+        Transaction *txn = xaccMallocTransaction (book);
+        Split *from = xaccMallocSplit (book);
+        Split *to = xaccMallocSplit (book);
+        xaccTransBeginEdit (txn);
+        xaccTransSetDatePostedSecsNormalized (txn, (BULK_TXNS - i) * 86400);
+        xaccSplitSetParent (from, txn);
+        xaccSplitSetParent (to, txn);
+        xaccSplitSetAmount (from, gnc_numeric_neg (amount));
+        xaccSplitSetValue (from, gnc_numeric_neg (amount));
+        xaccSplitSetAmount (to, amount);
+        xaccSplitSetValue (to, amount);
+        gnc_account_insert_split (money, from);
+        gnc_account_insert_split (food, to);
+        qof_commit_edit (QOF_INSTANCE (txn));
+        xaccAccountRecomputeBalance (money);
+        xaccAccountRecomputeBalance (food);
+    }
+    g_assert_cmpint (qof_instance_get_editlevel (money), == , 1);
+    g_assert_cmpint (qof_instance_get_editlevel (food), == , 1);
+    g_assert (gnc_numeric_zero_p (xaccAccountGetBalance (food)));
+    qof_book_end_bulk_edit (book);
+
+    g_test_message ("Each account is sorted and balanced once, at the end");
+    g_assert_cmpint (qof_instance_get_editlevel (money), == , 0);
+    g_assert_cmpint (qof_instance_get_editlevel (food), == , 0);
+    g_assert (gnc_numeric_equal (xaccAccountGetBalance (food),
+                                 gnc_numeric_create (BULK_TXNS, 1)));
+    g_assert (gnc_numeric_equal (xaccAccountGetBalance (money),
+                                 gnc_numeric_create (-BULK_TXNS, 1)));
+    for (auto node = xaccAccountGetSplitList (food); node; node = node->next)
+    {
+        auto split = static_cast<Split*>(node->data);
+        if (prev)
+            g_assert_cmpint (xaccSplitOrder (prev, split), <= , 0);
+        prev = split;
+    }
+
+    qof_perf_shutdown ();
+    g_assert (g_file_get_contents (filename, &contents, NULL, NULL));
+    g_assert_cmpint (perf_count (contents, "account.sort-splits"), == , 2);
+    g_assert_cmpint (perf_count (contents, "account.recompute-balance"), == , 2);
+    g_free (contents);
+    g_unlink (filename);
+    g_free (filename);
+}
+
+/* An account destroyed while a bulk edit holds it open goes at once,
+ * rather than when the edit ends. */
+static void
+test_bulk_edit_destroy (Fixture *fixture, gconstpointer pData )
+{
+    Account *root = gnc_account_get_root (fixture->acct);
+    Account *food = gnc_account_lookup_by_name (root, "food");
+    QofBook *book = gnc_account_get_book (root);
+    TestSignal sig;
+
+    g_assert (food);
+    qof_book_begin_bulk_edit (book);
+    gnc_account_set_start_balance (food, gnc_numeric_create (100, 1));
+    xaccAccountRecomputeBalance (food);
+    g_assert_cmpint (qof_instance_get_editlevel (food), == , 1);
+
+    sig = test_signal_new (QOF_INSTANCE (food), QOF_EVENT_DESTROY, NULL);
+    xaccAccountBeginEdit (food);
+    xaccAccountDestroy (food);
+    test_signal_assert_hits (sig, 1);
+    test_signal_free (sig);
+    g_assert (gnc_account_lookup_by_name (root, "food") == NULL);
+    qof_book_end_bulk_edit (book);
+}
 /* xaccAccountForEachTransaction
 gint
 xaccAccountForEachTransaction (const Account *acc, TransactionCallback proc,// C: 8 in 4 */
@@ -2572,12 +3006,17 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account lookup by code", Fixture, &complex, setup, test_gnc_account_lookup_by_code,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name helper", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name_helper,  teardown );
     GNC_TEST_ADD (suitename, "gnc account lookup by full name", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup by full name duplicates", Fixture, &complex, setup, test_gnc_account_lookup_by_full_name_duplicates,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup index per tree", Fixture, &complex, setup, test_gnc_account_lookup_index_per_tree,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account get full name threads", Fixture, &complex, setup, test_gnc_account_get_full_name_threads,  teardown );
+    GNC_TEST_ADD (suitename, "gnc account lookup index tracks changes", Fixture, &complex, setup, test_gnc_account_lookup_index_tracks_changes,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach child", Fixture, &complex, setup, test_gnc_account_foreach_child,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant", Fixture, &complex, setup, test_gnc_account_foreach_descendant,  teardown );
     GNC_TEST_ADD (suitename, "gnc account foreach descendant until", Fixture, &complex, setup, test_gnc_account_foreach_descendant_until,  teardown );
     GNC_TEST_ADD (suitename, "gnc account get full name", Fixture, &good_data, setup, test_gnc_account_get_full_name,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetProjectedMinimumBalance", Fixture, &some_data, setup, test_xaccAccountGetProjectedMinimumBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetBalanceAsOfDate", Fixture, &some_data, setup, test_xaccAccountGetBalanceAsOfDate,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountGetBalancesAtDates", Fixture, &some_data, setup, test_xaccAccountGetBalancesAtDates,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountGetPresentBalance", Fixture, &some_data, setup, test_xaccAccountGetPresentBalance,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountFindOpenLots", Fixture, &complex_data, setup, test_xaccAccountFindOpenLots,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachLot", Fixture, &complex_data, setup, test_xaccAccountForEachLot,  teardown );
@@ -2591,6 +3030,10 @@ test_suite_account (void)
     GNC_TEST_ADD (suitename, "gnc account merge children", Fixture, &complex_data, setup, test_gnc_account_merge_children,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountForEachTransaction", Fixture, &complex_data, setup, test_xaccAccountForEachTransaction,  teardown );
     GNC_TEST_ADD (suitename, "xaccAccountTreeForEachTransaction", Fixture, &complex_data, setup, test_xaccAccountTreeForEachTransaction,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountTreeForEachTransactionParallel", Fixture, &complex_data, setup, test_xaccAccountTreeForEachTransactionParallel,  teardown );
+    GNC_TEST_ADD (suitename, "xaccAccountTreeForEachTransactionParallel many", Fixture, &complex, setup, test_xaccAccountTreeForEachTransactionParallel_many,  teardown );
+    GNC_TEST_ADD (suitename, "bulk edit sort and balance", Fixture, &complex, setup, test_bulk_edit_sort_and_balance,  teardown );
+    GNC_TEST_ADD (suitename, "bulk edit destroy", Fixture, &complex, setup, test_bulk_edit_destroy,  teardown );
 
 
 }
@@ -89,10 +89,10 @@ setup (Fixture *fixture, gconstpointer pData)
     fixture->split->reconciled = YREC;
     fixture->split->gains = GAINS_STATUS_VALU_DIRTY;
     fixture->split->gains_split = gains_split;
+    /* acc was set behind the engine's back, so it has yet to be
+     * committed to it. */
+    fixture->func->split_set_orig (fixture->split, NULL, txn);
 
-    fixture->split->balance = amount;
-    fixture->split->cleared_balance = amount;
-    fixture->split->reconciled_balance = amount;
     qof_instance_mark_clean (QOF_INSTANCE (fixture->split));
     qof_instance_mark_clean (QOF_INSTANCE (acc));
     qof_instance_mark_clean (QOF_INSTANCE (txn));
@@ -127,7 +127,7 @@ test_gnc_split_init ()
 {
     Split *split = static_cast<Split*>(g_object_new (GNC_TYPE_SPLIT, NULL));
     g_assert (split->acc == NULL);
-    g_assert (split->orig_acc == NULL);
+    g_assert (!split->committed);
     g_assert (split->parent == NULL);
     g_assert (split->lot == NULL);
     g_assert_cmpstr (split->action, ==, "");
@@ -135,13 +135,15 @@ test_gnc_split_init ()
     g_assert_cmpint (split->reconciled, ==, NREC);
     g_assert (gnc_numeric_zero_p (split->amount));
     g_assert (gnc_numeric_zero_p (split->value));
-    g_assert (gnc_numeric_zero_p (split->balance));
-    g_assert (gnc_numeric_zero_p (split->cleared_balance));
-    g_assert (gnc_numeric_zero_p (split->reconciled_balance));
+    g_assert (gnc_numeric_zero_p (xaccSplitGetBalance (split)));
+    g_assert (gnc_numeric_zero_p (xaccSplitGetClearedBalance (split)));
+    g_assert (gnc_numeric_zero_p (xaccSplitGetReconciledBalance (split)));
     g_assert_cmpint (split->gains, ==, GAINS_STATUS_UNKNOWN);
     g_assert (split->gains_split == NULL);
-    /* Make sure that the parent's init has been run */
-    g_assert (split->inst.kvp_data != NULL);
+    /* Make sure that the parent's init has been run; the kvp frame
+       isn't created until first used. */
+    g_assert (split->inst.kvp_data == NULL);
+    g_assert (qof_instance_get_infant (split));
 
     g_object_unref (split);
 }
@@ -191,9 +193,8 @@ static void
 test_gnc_split_set_get_property ()
 {
     /* TODO: Several of the parameters set by gnc_split_init are not
-     * properties, and two members of struct split_s (orig_parent and
-     * reconciled) are neither initialized in gnc_split_init nor
-     * properties.
+     * properties, and a member of struct split_s (reconciled) is
+     * neither initialized in gnc_split_init nor a property.
      */
     QofBook *book = qof_book_new ();
     gnc_commodity *curr = gnc_commodity_new (book, "Gnu Rand", "CURRENCY", "GNR", "", 100);
@@ -297,7 +298,6 @@ test_xaccDupeSplit (Fixture *fixture, gconstpointer pData)
     g_assert (qof_instance_get_book (split) == qof_instance_get_book (f_split));
     g_assert (split->parent == f_split->parent);
     g_assert (split->acc == f_split->acc);
-    g_assert (split->orig_acc == f_split->orig_acc);
     g_assert (split->lot == f_split->lot);
     g_assert_cmpstr (split->memo, ==, f_split->memo);
     g_assert_cmpstr (split->action, ==, f_split->action);
@@ -307,9 +307,9 @@ test_xaccDupeSplit (Fixture *fixture, gconstpointer pData)
     g_assert (gnc_numeric_equal (split->value, f_split->value));
     g_assert (gnc_numeric_equal (split->amount, f_split->amount));
     /* xaccDupeSplit intentionally doesn't copy the balances */
-    g_assert (gnc_numeric_zero_p (split->balance));
-    g_assert (gnc_numeric_zero_p (split->cleared_balance));
-    g_assert (gnc_numeric_zero_p (split->reconciled_balance));
+    g_assert (gnc_numeric_zero_p (xaccSplitGetBalance (split)));
+    g_assert (gnc_numeric_zero_p (xaccSplitGetClearedBalance (split)));
+    g_assert (gnc_numeric_zero_p (xaccSplitGetReconciledBalance (split)));
     /* FIXME: gains and gains_split are not copied */
     g_assert_cmpint (split->gains, !=, f_split->gains);
     g_assert (split->gains_split != f_split->gains_split);
@@ -332,18 +332,21 @@ test_xaccSplitCloneNoKvp (Fixture *fixture, gconstpointer pData)
     g_assert (split->parent == NULL);
     g_assert (split->acc == f_split->acc);
     /* Clone doesn't copy the orig_acc */
-    g_assert (split->orig_acc == NULL);
+    g_assert (fixture->func->split_orig_acc (split) == NULL);
     g_assert (split->lot == f_split->lot);
     g_assert_cmpstr (split->memo, ==, f_split->memo);
     g_assert_cmpstr (split->action, ==, f_split->action);
-    g_assert (split->inst.kvp_data->empty());
+    g_assert (!qof_instance_has_kvp (QOF_INSTANCE (split)));
     g_assert_cmpint (split->reconciled, ==, f_split->reconciled);
     g_assert_cmpint (split->date_reconciled, == , f_split->date_reconciled);
     g_assert (gnc_numeric_equal (split->value, f_split->value));
     g_assert (gnc_numeric_equal (split->amount, f_split->amount));
-    g_assert (gnc_numeric_equal (split->balance, f_split->balance));
-    g_assert (gnc_numeric_equal (split->cleared_balance, f_split->cleared_balance));
-    g_assert (gnc_numeric_equal (split->reconciled_balance, f_split->reconciled_balance));
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (split),
+                                 xaccSplitGetBalance (f_split)));
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split),
+                                 xaccSplitGetClearedBalance (f_split)));
+    g_assert (gnc_numeric_equal (xaccSplitGetReconciledBalance (split),
+                                 xaccSplitGetReconciledBalance (f_split)));
     g_assert_cmpint (split->gains, ==, GAINS_STATUS_UNKNOWN);
     g_assert (split->gains_split == NULL);
 }
@@ -427,14 +430,16 @@ test_xaccSplitEqual (Fixture *fixture, gconstpointer pData)
     gchar *msg10 = "[xaccSplitEqual] transactions differ";
     gchar *msg11 = "[xaccTransEqual] one is NULL";
     gchar *msg12 = "[xaccSplitEqualCheckBal] balances differ: 321/1000 vs 0/1";
-    gchar *msg13 = "[xaccSplitEqualCheckBal] cleared balances differ: 321/1000 vs 0/1";
-    gchar *msg14 = "[xaccSplitEqualCheckBal] reconciled balances differ: 321/1000 vs 0/1";
+    gchar *msg13 = "[xaccSplitEqualCheckBal] cleared balances differ: 321/1000 vs 0/1000";
+    gchar *msg14 = "[xaccSplitEqualCheckBal] reconciled balances differ: 321/1000 vs 0/1000";
     gchar *logdomain = "gnc.engine";
     GLogLevelFlags loglevel = G_LOG_LEVEL_INFO;
     TestErrorStruct checkA = { loglevel, logdomain, msg01, 0 };
     TestErrorStruct checkB = { loglevel, logdomain, msg10, 0 };
     TestErrorStruct checkC = { loglevel, logdomain, msg11, 0 };
     TestErrorStruct checkD = { loglevel, logdomain, msg14, 0 };
+    Account *acc2 = xaccMallocAccount (xaccSplitGetBook (fixture->split));
+    gnc_numeric neg_amount = gnc_numeric_neg (fixture->split->amount);
     guint hdlr;
 
     test_add_error (&checkA);
@@ -498,7 +503,9 @@ test_xaccSplitEqual (Fixture *fixture, gconstpointer pData)
     g_assert_cmpint (checkB.hits, ==, 1);
     g_assert_cmpint (checkC.hits, ==, 1);
     g_assert_cmpint (checkD.hits, ==, 0);
-    /* Split2 doesn't have balances copied from fixture->split, so the balance test fails */
+    /* Running balances come from the account, which has fixture->split
+     * but not its dupe split2, so the balance test fails */
+    gnc_account_insert_split (fixture->split->acc, fixture->split);
     checkB.msg = msg12;
     checkC.msg = msg13;
     g_assert (xaccSplitEqual (fixture->split, split2, TRUE, TRUE, TRUE) == FALSE);
@@ -507,24 +514,38 @@ test_xaccSplitEqual (Fixture *fixture, gconstpointer pData)
     g_assert_cmpint (checkC.hits, ==, 1);
     g_assert_cmpint (checkD.hits, ==, 0);
 
-    split2->balance = fixture->split->balance;
+    /* Put split2 in an account of its own, whose starting balances
+     * cancel its cleared and reconciled amounts */
+    split2->acc = acc2;
+    gnc_account_set_start_cleared_balance (acc2, neg_amount);
+    gnc_account_set_start_reconciled_balance (acc2, neg_amount);
+    gnc_account_insert_split (acc2, split2);
     g_assert (xaccSplitEqual (fixture->split, split2, TRUE, TRUE, TRUE) == FALSE);
     g_assert_cmpint (checkA.hits, ==, 6);
     g_assert_cmpint (checkB.hits, ==, 2);
     g_assert_cmpint (checkC.hits, ==, 2);
     g_assert_cmpint (checkD.hits, ==, 0);
 
-    split2->cleared_balance = fixture->split->cleared_balance;
+    gnc_account_set_start_cleared_balance (acc2, gnc_numeric_zero ());
     g_assert (xaccSplitEqual (fixture->split, split2, TRUE, TRUE, TRUE) == FALSE);
     g_assert_cmpint (checkA.hits, ==, 6);
     g_assert_cmpint (checkB.hits, ==, 2);
     g_assert_cmpint (checkC.hits, ==, 2);
     g_assert_cmpint (checkD.hits, ==, 1);
 
+    gnc_account_set_start_reconciled_balance (acc2, gnc_numeric_zero ());
+    g_assert (xaccSplitEqual (fixture->split, split2, TRUE, TRUE, TRUE) == TRUE);
+    g_assert_cmpint (checkA.hits, ==, 6);
+    g_assert_cmpint (checkB.hits, ==, 2);
+    g_assert_cmpint (checkC.hits, ==, 2);
+    g_assert_cmpint (checkD.hits, ==, 1);
+
     test_clear_error_list ();
     g_assert (xaccSplitEqual (fixture->split, split2, TRUE, FALSE, TRUE) == TRUE);
+    gnc_account_remove_split (acc2, split2);
     g_object_unref (split1);
     g_object_unref (split2);
+    test_destroy (acc2);
     test_clear_error_list ();
     g_log_remove_handler (logdomain, hdlr);
 
@@ -577,11 +598,10 @@ test_xaccSplitCommitEdit (Fixture *fixture, gconstpointer pData)
     hdlr = g_log_set_handler (logdomain, loglevel,
                               (GLogFunc)test_list_handler, &checkA);
 
-    fixture->split->orig_acc = oacc;
-    fixture->split->orig_parent = opar;
+    fixture->func->split_set_orig (fixture->split, oacc, opar);
 
     gnc_engine_add_commit_error_callback ((EngineCommitErrorCallback)test_error_callback, &error);
-    sig1 = test_signal_new (QOF_INSTANCE (fixture->split->orig_parent), QOF_EVENT_MODIFY, NULL);
+    sig1 = test_signal_new (QOF_INSTANCE (opar), QOF_EVENT_MODIFY, NULL);
     sig2 = test_signal_new (QOF_INSTANCE (fixture->split->lot), QOF_EVENT_MODIFY, NULL);
 
     qof_instance_set_dirty (QOF_INSTANCE (fixture->split));
@@ -600,8 +620,8 @@ test_xaccSplitCommitEdit (Fixture *fixture, gconstpointer pData)
     test_signal_assert_hits (sig2, 3);
     g_assert_cmpint (error.hits, ==, 0);
     g_assert_cmpint (error.lasterr, ==, ERR_BACKEND_NO_ERR);
-    g_assert (fixture->split->orig_acc == fixture->split->acc);
-    g_assert (fixture->split->orig_parent == fixture->split->parent);
+    g_assert (fixture->func->split_orig_acc (fixture->split) == fixture->split->acc);
+    g_assert (fixture->func->split_orig_parent (fixture->split) == fixture->split->parent);
     g_assert_cmpint (checkA.hits, ==, 4);
     g_assert_cmpint (checkB.hits, ==, 2);
 
@@ -629,8 +649,8 @@ test_xaccSplitCommitEdit (Fixture *fixture, gconstpointer pData)
     g_assert_cmpint (checkB.hits, ==, 2);
     g_assert_cmpint (error.hits, ==, 0);
     g_assert_cmpint (error.lasterr, ==, ERR_BACKEND_NO_ERR);
-    g_assert (fixture->split->orig_acc == fixture->split->acc);
-    g_assert (fixture->split->orig_parent == fixture->split->parent);
+    g_assert (fixture->func->split_orig_acc (fixture->split) == fixture->split->acc);
+    g_assert (fixture->func->split_orig_parent (fixture->split) == fixture->split->parent);
 
 
     g_log_remove_handler (logdomain, hdlr);
@@ -665,9 +685,8 @@ test_xaccSplitRollbackEdit (Fixture *fixture, gconstpointer pData)
                             GNC_EVENT_ITEM_ADDED, NULL);
     sig3 = test_signal_new (QOF_INSTANCE (txn1),
                             GNC_EVENT_ITEM_ADDED, NULL);
-    fixture->split->orig_acc = NULL;
-    g_assert (fixture->split->acc != fixture->split->orig_acc);
-    fixture->split->orig_parent = NULL;
+    fixture->func->split_set_orig (fixture->split, NULL, NULL);
+    g_assert (fixture->split->acc != fixture->func->split_orig_acc (fixture->split));
 
     xaccSplitRollbackEdit (fixture->split);
     test_signal_assert_hits (sig1, 1);
@@ -675,22 +694,21 @@ test_xaccSplitRollbackEdit (Fixture *fixture, gconstpointer pData)
     test_signal_assert_hits (sig3, 0);
     g_assert (fixture->split->acc == NULL);
     g_assert (fixture->split->parent == NULL);
-    g_assert (fixture->split->orig_parent == NULL);
+    g_assert (fixture->func->split_orig_parent (fixture->split) == NULL);
 
     fixture->split->acc = acc;
-    fixture->split->orig_acc = acc;
-    fixture->split->orig_parent = txn1;
+    fixture->func->split_set_orig (fixture->split, acc, txn1);
     fixture->split->parent = txn2;
     qof_instance_set_destroying (fixture->split, TRUE);
 
     xaccSplitRollbackEdit (fixture->split);
     g_assert (fixture->split->acc == acc);
     g_assert (fixture->split->parent == txn1);
-    g_assert (fixture->split->orig_parent == txn1);
+    g_assert (fixture->func->split_orig_parent (fixture->split) == txn1);
     test_signal_assert_hits (sig1, 1);
     test_signal_assert_hits (sig2, 1);
     test_signal_assert_hits (sig3, 1);
-    g_assert (fixture->split->parent == fixture->split->orig_parent);
+    g_assert (fixture->split->parent == fixture->func->split_orig_parent (fixture->split));
     g_assert (fixture->split->parent == txn1);
 
     test_signal_free (sig1);
@@ -736,12 +754,12 @@ test_xaccSplitDetermineGainStatus (Fixture *fixture, gconstpointer pData)
 
     fixture->split->gains = GAINS_STATUS_UNKNOWN;
     fixture->split->gains_split = NULL;
-    g_assert (fixture->split->inst.kvp_data->get_slot({"gains_source"}) == NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (fixture->split))->get_slot({"gains_source"}) == NULL);
     xaccSplitDetermineGainStatus (fixture->split);
     g_assert (fixture->split->gains_split == NULL);
     g_assert_cmpint (fixture->split->gains, ==, GAINS_STATUS_A_VDIRTY | GAINS_STATUS_DATE_DIRTY);
 
-    fixture->split->inst.kvp_data->set({"gains-source"}, new KvpValue(guid_copy(g_guid)));
+    qof_instance_get_slots (QOF_INSTANCE (fixture->split))->set({"gains-source"}, new KvpValue(guid_copy(g_guid)));
     g_assert (fixture->split->gains_split == NULL);
     fixture->split->gains = GAINS_STATUS_UNKNOWN;
     xaccSplitDetermineGainStatus (fixture->split);
@@ -868,8 +886,91 @@ test_xaccSplitSetValue (Fixture *fixture, gconstpointer pData)
 /* xaccSplitGetBalance // C: 8 in 3 SCM: 4 in 3
  * xaccSplitGetClearedBalance // Not Used
  * xaccSplitGetReconciledBalance // Not Used
- Simple getters. No test.
 */
+static void
+set_balance_test_txn (Transaction *txn, gnc_commodity *curr, time64 posted,
+                      Split *split, Split *other_split, gnc_numeric amount)
+{
+    xaccTransBeginEdit (txn);
+    xaccTransSetCurrency (txn, curr);
+    xaccTransSetDatePostedSecs (txn, posted);
+    xaccSplitSetParent (split, txn);
+    xaccSplitSetParent (other_split, txn);
+    xaccSplitSetAmount (split, amount);
+    xaccSplitSetValue (split, amount);
+    xaccSplitSetAmount (other_split, gnc_numeric_neg (amount));
+    xaccSplitSetValue (other_split, gnc_numeric_neg (amount));
+    xaccTransCommitEdit (txn);
+}
+
+static void
+test_xaccSplitGetBalance ()
+{
+    QofBook *book = qof_book_new ();
+    gnc_commodity *gnaira = gnc_commodity_new (book, "Gnaira", "CURRENCY",
+                            "GNA", "", 240);
+    Account *acc = xaccMallocAccount (book);
+    Account *other = xaccMallocAccount (book);
+    Transaction *txn1 = xaccMallocTransaction (book);
+    Transaction *txn2 = xaccMallocTransaction (book);
+    Split *split1 = xaccMallocSplit (book);
+    Split *split2 = xaccMallocSplit (book);
+    Split *other1 = xaccMallocSplit (book);
+    Split *other2 = xaccMallocSplit (book);
+    gnc_numeric zero = gnc_numeric_zero ();
+    gnc_numeric five = gnc_numeric_create (1200, 240);
+    gnc_numeric ten = gnc_numeric_create (2400, 240);
+    gnc_numeric fifteen = gnc_numeric_create (3600, 240);
+    gnc_numeric twenty = gnc_numeric_create (4800, 240);
+    gnc_numeric twenty_five = gnc_numeric_create (6000, 240);
+
+    xaccAccountSetCommodity (acc, gnaira);
+    xaccAccountSetCommodity (other, gnaira);
+    xaccSplitSetAccount (split1, acc);
+    xaccSplitSetAccount (split2, acc);
+    xaccSplitSetAccount (other1, other);
+    xaccSplitSetAccount (other2, other);
+    set_balance_test_txn (txn1, gnaira, 100000, split1, other1, ten);
+    set_balance_test_txn (txn2, gnaira, 200000, split2, other2, five);
+
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (split1), ten));
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (split2), fifteen));
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split2), zero));
+    g_assert (gnc_numeric_equal (xaccSplitGetReconciledBalance (split2), zero));
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (other2),
+                                 gnc_numeric_neg (fifteen)));
+
+    /* Changing an amount changes the balances of that split and the
+     * ones after it */
+    set_balance_test_txn (txn1, gnaira, 100000, split1, other1, twenty);
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (split1), twenty));
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (split2), twenty_five));
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split2), zero));
+
+    /* and so does changing a reconcile flag, for the cleared and
+     * reconciled balances only */
+    xaccSplitSetReconcile (split1, CREC);
+    g_assert (gnc_numeric_equal (xaccSplitGetBalance (split2), twenty_five));
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split1), twenty));
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split2), twenty));
+    g_assert (gnc_numeric_equal (xaccSplitGetReconciledBalance (split2), zero));
+    xaccSplitSetReconcile (split2, YREC);
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split1), twenty));
+    g_assert (gnc_numeric_equal (xaccSplitGetClearedBalance (split2), twenty_five));
+    g_assert (gnc_numeric_equal (xaccSplitGetReconciledBalance (split1), zero));
+    g_assert (gnc_numeric_equal (xaccSplitGetReconciledBalance (split2), five));
+
+    test_destroy (split1);
+    test_destroy (split2);
+    test_destroy (other1);
+    test_destroy (other2);
+    test_destroy (txn1);
+    test_destroy (txn2);
+    test_destroy (acc);
+    test_destroy (other);
+    test_destroy (gnaira);
+    qof_book_destroy (book);
+}
 /* xaccSplitSetBaseValue
 void
 xaccSplitSetBaseValue (Split *s, gnc_numeric value,// C: 19 in 7
@@ -942,7 +1043,9 @@ test_xaccSplitSetBaseValue (Fixture *fixture, gconstpointer pData)
     qof_instance_mark_clean (QOF_INSTANCE (fixture->split));
     fixture->split->amount = old_amt;
     fixture->split->amount = old_val;
-    fixture->split->orig_parent = fixture->split->parent;
+    fixture->func->split_set_orig (fixture->split,
+                                   fixture->func->split_orig_acc (fixture->split),
+                                   fixture->split->parent);
     xaccAccountSetCommodity(fixture->split->acc, fixture->comm);
     xaccSplitSetBaseValue (fixture->split, value, gnaira);
     g_assert (!qof_instance_is_dirty (QOF_INSTANCE (fixture->split)));
@@ -1646,10 +1749,11 @@ test_xaccSplitSetParent (Fixture *fixture, gconstpointer pData)
 
     xaccTransBeginEdit (txn2);
     xaccTransSetCurrency (txn2, fixture->curr);
-    split->orig_parent = txn1;
+    fixture->func->split_set_orig (split, fixture->func->split_orig_acc (split),
+                                   txn1);
     xaccSplitSetParent (split, txn2);
     g_assert (split->parent == txn2);
-    g_assert (split->orig_parent == txn1);
+    g_assert (fixture->func->split_orig_parent (split) == txn1);
     test_signal_assert_hits (sig1, 1);
     test_signal_assert_hits (sig2, 1);
     g_assert (qof_instance_is_dirty (QOF_INSTANCE (split)));
@@ -1798,7 +1902,7 @@ test_xaccSplitGetOtherSplit (Fixture *fixture, gconstpointer pData)
     g_assert (xaccSplitGetOtherSplit (split1) == NULL);
 
     g_assert (xaccTransUseTradingAccounts (txn) == FALSE);
-    g_assert (split->inst.kvp_data->get_slot({"lot-split"}) == NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split))->get_slot({"lot-split"}) == NULL);
     g_assert_cmpint (xaccTransCountSplits (txn), !=, 2);
     g_assert (xaccSplitGetOtherSplit (split) == NULL);
 
@@ -1809,18 +1913,18 @@ test_xaccSplitGetOtherSplit (Fixture *fixture, gconstpointer pData)
     xaccSplitSetParent (split2, txn);
     g_assert (xaccSplitGetOtherSplit (split) == NULL);
 
-    split->inst.kvp_data->set({"lot-split"}, kvpnow);
-    g_assert (split->inst.kvp_data->get_slot({"lot-split"}));
+    qof_instance_get_slots (QOF_INSTANCE (split))->set({"lot-split"}, kvpnow);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split))->get_slot({"lot-split"}));
     g_assert (xaccSplitGetOtherSplit (split) == NULL);
 
-    split1->inst.kvp_data->set({"lot-split"}, kvpnow);
-    g_assert (split1->inst.kvp_data->get_slot({"lot-split"}));
+    qof_instance_get_slots (QOF_INSTANCE (split1))->set({"lot-split"}, kvpnow);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split1))->get_slot({"lot-split"}));
     g_assert (xaccSplitGetOtherSplit (split) == split2);
 
-    split->inst.kvp_data->set({"lot-split"}, NULL);
-    g_assert (split->inst.kvp_data->get_slot({"lot-split"}) == NULL);
-    split1->inst.kvp_data->set({"lot-split"}, NULL);
-    g_assert (split1->inst.kvp_data->get_slot({"lot-split"}) == NULL);
+    qof_instance_get_slots (QOF_INSTANCE (split))->set({"lot-split"}, NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split))->get_slot({"lot-split"}) == NULL);
+    qof_instance_get_slots (QOF_INSTANCE (split1))->set({"lot-split"}, NULL);
+    g_assert (qof_instance_get_slots (QOF_INSTANCE (split1))->get_slot({"lot-split"}) == NULL);
     qof_book_begin_edit (book);
     qof_instance_set (QOF_INSTANCE (book),
 		      "trading-accts", "t",
@@ -1918,6 +2022,7 @@ test_suite_split (void)
     GNC_TEST_ADD (suitename, "xaccSplitSetSharePrice", Fixture, NULL, setup, test_xaccSplitSetSharePrice, teardown);
     GNC_TEST_ADD (suitename, "xaccSplitSetAmount", Fixture, NULL, setup, test_xaccSplitSetAmount, teardown);
     GNC_TEST_ADD (suitename, "xaccSplitSetValue", Fixture, NULL, setup, test_xaccSplitSetValue, teardown);
+    GNC_TEST_ADD_FUNC (suitename, "xaccSplitGetBalance", test_xaccSplitGetBalance);
     GNC_TEST_ADD (suitename, "xaccSplitSetBaseValue", Fixture, NULL, setup, test_xaccSplitSetBaseValue, teardown);
     GNC_TEST_ADD_FUNC (suitename, "xaccSplitConvertAmount", test_xaccSplitConvertAmount);
     GNC_TEST_ADD_FUNC (suitename, "xaccSplitDestroy", test_xaccSplitDestroy);
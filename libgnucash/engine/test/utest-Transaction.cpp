@@ -920,10 +920,10 @@ test_xaccTransEqual (Fixture *fixture, gconstpointer pData)
         Split* split01 = xaccTransGetSplit (txn0, 1);
         Split* split10 = xaccTransGetSplit (txn1, 0);
         Split* split11 = xaccTransGetSplit (txn1, 1);
-        auto bal00 = gnc_numeric_to_string (split00->balance);
-        auto bal01 = gnc_numeric_to_string (split01->balance);
-        auto bal10 = gnc_numeric_to_string (split10->balance);
-        auto bal11 = gnc_numeric_to_string (split11->balance);
+        auto bal00 = gnc_numeric_to_string (xaccSplitGetBalance (split00));
+        auto bal01 = gnc_numeric_to_string (xaccSplitGetBalance (split01));
+        auto bal10 = gnc_numeric_to_string (xaccSplitGetBalance (split10));
+        auto bal11 = gnc_numeric_to_string (xaccSplitGetBalance (split11));
         check->msg = g_strdup_printf("[xaccSplitEqualCheckBal] balances differ: %s vs %s", bal10, bal00);
         check3->msg = g_strdup_printf("[xaccSplitEqualCheckBal] balances differ: %s vs %s", bal11, bal01);
 
@@ -934,8 +934,14 @@ test_xaccTransEqual (Fixture *fixture, gconstpointer pData)
         g_assert_cmpint (check2->hits, ==, 3);
         g_assert_cmpint (check3->hits, ==, 0);
 
-        split10->balance = split00->balance;
-        split11->balance = split01->balance;
+        /* The running balances come from the accounts, so give txn1's
+         * splits accounts of their own like txn0's. */
+        auto acc10 = xaccMallocAccount (book2);
+        auto acc11 = xaccMallocAccount (book2);
+        split10->acc = acc10;
+        split11->acc = acc11;
+        gnc_account_insert_split (acc10, split10);
+        gnc_account_insert_split (acc11, split11);
         g_assert (xaccTransEqual (txn1, txn0, TRUE, TRUE, TRUE, TRUE));
     }
     g_free (check3->msg);
@@ -737,6 +737,148 @@ gnc_pricedb_add_price(GNCPriceDB *db, GNCPrice *p)// C: 7 in 7 SCM: 1  Local: 0:
 test_gnc_pricedb_add_price (Fixture *fixture, gconstpointer pData)
 {
 }*/
+typedef struct
+{
+    GNCPriceDB *db;
+    guint adds;
+    guint removes;
+    guint unlisted;
+} BulkEvents;
+
+/* Price events must arrive while the pricedb holds the price: added
+ * ones after they are listed, removed ones before they are dropped. */
+static void
+bulk_event_handler (QofInstance *ent, QofEventId event_type,
+                    gpointer handler_data, gpointer event_data)
+{
+    BulkEvents *events = handler_data;
+    PriceList *list;
+    GNCPrice *price;
+
+    if (!GNC_IS_PRICE (ent) ||
+        !(event_type & (QOF_EVENT_ADD | QOF_EVENT_REMOVE)))
+        return;
+    price = GNC_PRICE (ent);
+    list = gnc_pricedb_get_prices (events->db,
+                                   gnc_price_get_commodity (price),
+                                   gnc_price_get_currency (price));
+    if (!g_list_find (list, price))
+        events->unlisted++;
+    gnc_price_list_destroy (list);
+    if (event_type == QOF_EVENT_ADD)
+        events->adds++;
+    else
+        events->removes++;
+}
+
+static void
+test_gnc_pricedb_add_prices_bulk (PriceDBFixture *fixture, gconstpointer pData)
+{
+    GNCPriceDB *db = fixture->pricedb;
+    QofBook *book = qof_instance_get_book(QOF_INSTANCE(db));
+    Commodities *c = fixture->com;
+    GList *prices = NULL, *added;
+    GNCPrice *price;
+    guint replaced;
+    BulkEvents events = {db, 0, 0, 0};
+    gint handler, n;
+
+    prices = g_list_append(prices,
+                           construct_price(book, c->usd, c->aud,
+                                           gnc_dmy2time64(11, 4, 2009),
+                                           PRICE_SOURCE_EDIT_DLG,
+                                           gnc_numeric_create(131200, 10000)));
+    prices = g_list_append(prices,
+                           construct_price(book, c->usd, c->aud,
+                                           gnc_dmy2time64(12, 4, 2009),
+                                           PRICE_SOURCE_TEMP,
+                                           gnc_numeric_create(131300, 10000)));
+    prices = g_list_append(prices,
+                           construct_price(book, c->usd, c->aud,
+                                           gnc_dmy2time64(5, 5, 2009),
+                                           PRICE_SOURCE_FQ,
+                                           gnc_numeric_create(131400, 10000)));
+    prices = g_list_append(prices,
+                           construct_price(book, c->usd, c->aud,
+                                           gnc_dmy2time64(5, 5, 2009),
+                                           PRICE_SOURCE_FQ,
+                                           gnc_numeric_create(131500, 10000)));
+
+    /* Fill the gnc_pricedb_nth_price cache, which must be reset. */
+    g_assert(gnc_pricedb_nth_price(db, c->usd, 0) != NULL);
+    handler = qof_event_register_handler(bulk_event_handler, &events);
+    added = gnc_pricedb_add_prices_bulk(db, prices, PRICE_BULK_BY_SOURCE,
+                                        &replaced);
+    qof_event_unregister_handler(handler);
+    g_assert_cmpint(g_list_length(added), ==, 2);
+    g_assert_cmpint(replaced, ==, 1);
+    g_assert_cmpint(gnc_pricedb_get_num_prices(db), ==, 43);
+    g_assert_cmpuint(events.adds, ==, 2);
+    g_assert_cmpuint(events.removes, ==, 1);
+    g_assert_cmpuint(events.unlisted, ==, 0);
+    for (n = 0; (price = gnc_pricedb_nth_price(db, c->usd, n)); n++)
+        g_assert(price->db == db);
+    g_assert_cmpint(n, ==, gnc_pricedb_num_prices(db, c->usd));
+    g_list_free(added);
+
+    price = gnc_pricedb_lookup_day_t64(db, c->usd, c->aud,
+                                       gnc_dmy2time64(11, 4, 2009));
+    g_assert(gnc_numeric_equal(gnc_price_get_value(price),
+                               gnc_numeric_create(131200, 10000)));
+    gnc_price_unref(price);
+    price = gnc_pricedb_lookup_day_t64(db, c->usd, c->aud,
+                                       gnc_dmy2time64(12, 4, 2009));
+    g_assert(gnc_numeric_equal(gnc_price_get_value(price),
+                               gnc_numeric_create(131190, 10000)));
+    gnc_price_unref(price);
+    price = gnc_pricedb_lookup_day_t64(db, c->usd, c->aud,
+                                       gnc_dmy2time64(5, 5, 2009));
+    g_assert(gnc_numeric_equal(gnc_price_get_value(price),
+                               gnc_numeric_create(131500, 10000)));
+    gnc_price_unref(price);
+    g_list_free_full(prices, (GDestroyNotify)gnc_price_unref);
+
+    prices = g_list_append(NULL,
+                           construct_price(book, c->usd, c->aud,
+                                           gnc_dmy2time64(5, 5, 2009),
+                                           PRICE_SOURCE_EDIT_DLG,
+                                           gnc_numeric_create(131600, 10000)));
+    added = gnc_pricedb_add_prices_bulk(db, prices, PRICE_BULK_KEEP_OLD,
+                                        &replaced);
+    g_assert(added == NULL);
+    g_assert_cmpint(replaced, ==, 0);
+    g_assert_cmpint(gnc_pricedb_get_num_prices(db), ==, 43);
+    g_list_free_full(prices, (GDestroyNotify)gnc_price_unref);
+
+    /* A price quoted the other way round on the same day is a duplicate. */
+    prices = g_list_append(NULL,
+                           construct_price(book, c->aud, c->usd,
+                                           gnc_dmy2time64(5, 5, 2009),
+                                           PRICE_SOURCE_EDIT_DLG,
+                                           gnc_numeric_create(7600, 10000)));
+    added = gnc_pricedb_add_prices_bulk(db, prices, PRICE_BULK_KEEP_OLD,
+                                        &replaced);
+    g_assert(added == NULL);
+    g_assert_cmpint(gnc_pricedb_get_num_prices(db), ==, 43);
+
+    events.adds = events.removes = events.unlisted = 0;
+    handler = qof_event_register_handler(bulk_event_handler, &events);
+    added = gnc_pricedb_add_prices_bulk(db, prices, PRICE_BULK_REPLACE,
+                                        &replaced);
+    qof_event_unregister_handler(handler);
+    g_assert_cmpint(g_list_length(added), ==, 1);
+    g_assert_cmpint(replaced, ==, 1);
+    g_assert_cmpint(gnc_pricedb_get_num_prices(db), ==, 43);
+    g_assert_cmpuint(events.adds, ==, 1);
+    g_assert_cmpuint(events.removes, ==, 1);
+    g_assert_cmpuint(events.unlisted, ==, 0);
+    g_list_free(added);
+    price = gnc_pricedb_lookup_day_t64(db, c->usd, c->aud,
+                                       gnc_dmy2time64(5, 5, 2009));
+    g_assert(price && gnc_price_get_commodity(price) == c->aud);
+    gnc_price_unref(price);
+    g_list_free_full(prices, (GDestroyNotify)gnc_price_unref);
+}
 /* remove_price
 static gboolean
 remove_price(GNCPriceDB *db, GNCPrice *p, gboolean cleanup)// Local: 4:0:0
@@ -1474,6 +1616,7 @@ test_suite_gnc_pricedb (void)
 // GNC_TEST_ADD (suitename, "insert or replace price", Fixture, NULL, setup, test_insert_or_replace_price, teardown);
 // GNC_TEST_ADD (suitename, "add price", Fixture, NULL, setup, test_add_price, teardown);
 // GNC_TEST_ADD (suitename, "gnc pricedb add price", Fixture, NULL, setup, test_gnc_pricedb_add_price, teardown);
+    GNC_TEST_ADD (suitename, "gnc pricedb add prices bulk", PriceDBFixture, NULL, setup, test_gnc_pricedb_add_prices_bulk, teardown);
 // GNC_TEST_ADD (suitename, "remove price", Fixture, NULL, setup, test_remove_price, teardown);
 // GNC_TEST_ADD (suitename, "gnc pricedb remove price", Fixture, NULL, setup, test_gnc_pricedb_remove_price, teardown);
 // GNC_TEST_ADD (suitename, "check one price date", Fixture, NULL, setup, test_check_one_price_date, teardown);
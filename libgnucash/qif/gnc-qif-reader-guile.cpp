@@ -0,0 +1,236 @@
+/********************************************************************\
+ * gnc-qif-reader-guile.cpp - Scheme bindings of the QIF reader     *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/* qif-import.scm loads these with
+ *   (load-extension "libgnc-qif" "gnc_qif_reader_guile_init")
+ * so that they are defined in the (gnucash import-export qif-import)
+ * module, also when the module is compiled or loaded by the tests
+ * without the gnc-module.
+ */
+
+#include <libguile.h>
+
+extern "C"
+{
+#include <config.h>
+
+void gnc_qif_reader_guile_init (void);
+}
+
+#include "gnc-qif-reader.hpp"
+
+#include <fstream>
+
+struct FormatName
+{
+    const char *name;
+    unsigned flag;
+    SCM symbol;
+};
+
+/* The symbols are filled in by gnc_qif_reader_guile_init. */
+static FormatName date_formats[] =
+{
+    { "m-d-y", QIF_DATE_MDY, SCM_BOOL_F },
+    { "d-m-y", QIF_DATE_DMY, SCM_BOOL_F },
+    { "y-m-d", QIF_DATE_YMD, SCM_BOOL_F },
+    { "y-d-m", QIF_DATE_YDM, SCM_BOOL_F },
+    { nullptr, 0, SCM_BOOL_F }
+};
+
+static FormatName number_formats[] =
+{
+    { "decimal", QIF_NUMBER_DECIMAL, SCM_BOOL_F },
+    { "comma", QIF_NUMBER_COMMA, SCM_BOOL_F },
+    { "integer", QIF_NUMBER_INTEGER, SCM_BOOL_F },
+    { nullptr, 0, SCM_BOOL_F }
+};
+
+static SCM sym_locale;
+static SCM sym_stripped;
+
+static scm_t_bits reader_tag;
+
+static unsigned
+format_flag (SCM symbol, const FormatName *names)
+{
+    for (auto name = names; name->name; ++name)
+        if (scm_is_eq (symbol, name->symbol))
+            return name->flag;
+    return 0;
+}
+
+static unsigned
+formats_to_mask (SCM formats, const FormatName *names)
+{
+    unsigned mask = 0;
+    for (; scm_is_pair (formats); formats = scm_cdr (formats))
+        mask |= format_flag (scm_car (formats), names);
+    return mask;
+}
+
+/* The symbols of formats that are in mask, in the order of formats. */
+static SCM
+filter_formats (SCM formats, unsigned mask, const FormatName *names)
+{
+    SCM result = SCM_EOL;
+    for (; scm_is_pair (formats); formats = scm_cdr (formats))
+        if (mask & format_flag (scm_car (formats), names))
+            result = scm_cons (scm_car (formats), result);
+    return scm_reverse_x (result, SCM_EOL);
+}
+
+/* (gnc-qif-check-date-format date-string possible-formats) */
+static SCM
+gnc_qif_scm_check_date_format (SCM date, SCM formats)
+{
+    auto str = scm_to_utf8_string (date);
+    auto fits = gnc_qif_check_date_format (str, formats_to_mask (formats, date_formats));
+    free (str);
+    return filter_formats (formats, fits, date_formats);
+}
+
+/* (gnc-qif-check-number-format value-string possible-formats) */
+static SCM
+gnc_qif_scm_check_number_format (SCM value, SCM formats)
+{
+    auto str = scm_to_utf8_string (value);
+    auto fits = gnc_qif_check_number_format (str, formats_to_mask (formats, number_formats));
+    free (str);
+    return filter_formats (formats, fits, number_formats);
+}
+
+static SCM
+conversion_symbol (GncQifConversion conversion)
+{
+    switch (conversion)
+    {
+    case QIF_CONVERSION_LOCALE:
+        return sym_locale;
+    case QIF_CONVERSION_STRIPPED:
+        return sym_stripped;
+    default:
+        return SCM_BOOL_F;
+    }
+}
+
+/* Kept apart from gnc_qif_scm_reader_open so that no C++ object is
+ * alive when that raises a Scheme error. */
+static GncQifReader*
+open_reader (const char *path, SCM *error)
+{
+    try
+    {
+        return new GncQifReader {path};
+    }
+    catch (const std::ifstream::failure& err)
+    {
+        *error = scm_from_utf8_string (err.what());
+        return nullptr;
+    }
+}
+
+/* (gnc-qif-reader-open path) maps the file and returns a reader for
+ * gnc-qif-reader-next-field. */
+static SCM
+gnc_qif_scm_reader_open (SCM path)
+{
+    SCM error = SCM_BOOL_F;
+    auto str = scm_to_locale_string (path);
+    auto reader = open_reader (str, &error);
+    free (str);
+    if (!reader)
+        scm_misc_error ("gnc-qif-reader-open", "~A", scm_list_1 (error));
+    SCM_RETURN_NEWSMOB (reader_tag, reader);
+}
+
+static GncQifReader*
+reader_of (SCM reader, const char *subr)
+{
+    scm_assert_smob_type (reader_tag, reader);
+    auto qif_reader = reinterpret_cast<GncQifReader*>(SCM_SMOB_DATA (reader));
+    if (!qif_reader)
+        scm_misc_error (subr, "The reader has been closed", SCM_EOL);
+    return qif_reader;
+}
+
+/* (gnc-qif-reader-next-field reader) returns the next non-empty line
+ * of the file as (line-num tag value conversion), conversion being #f,
+ * locale or stripped, or #f at the end of the file. */
+static SCM
+gnc_qif_scm_reader_next_field (SCM reader)
+{
+    auto qif_reader = reader_of (reader, "gnc-qif-reader-next-field");
+    GncQifField field;
+    if (!qif_reader->next_field (field))
+        return SCM_BOOL_F;
+    return scm_list_4 (scm_from_uint32 (field.line_num),
+                       SCM_MAKE_CHAR (field.tag),
+                       scm_from_utf8_string (field.value.c_str()),
+                       conversion_symbol (field.conversion));
+}
+
+/* (gnc-qif-reader-close reader) unmaps the file without waiting for
+ * the garbage collector. */
+static SCM
+gnc_qif_scm_reader_close (SCM reader)
+{
+    delete reader_of (reader, "gnc-qif-reader-close");
+    SCM_SET_SMOB_DATA (reader, 0);
+    return SCM_UNSPECIFIED;
+}
+
+static size_t
+free_reader (SCM reader)
+{
+    delete reinterpret_cast<GncQifReader*>(SCM_SMOB_DATA (reader));
+    return 0;
+}
+
+static void
+intern_formats (FormatName *names)
+{
+    for (auto name = names; name->name; ++name)
+        name->symbol = scm_permanent_object (scm_from_utf8_symbol (name->name));
+}
+
+void
+gnc_qif_reader_guile_init (void)
+{
+    intern_formats (date_formats);
+    intern_formats (number_formats);
+    sym_locale = scm_permanent_object (scm_from_utf8_symbol ("locale"));
+    sym_stripped = scm_permanent_object (scm_from_utf8_symbol ("stripped"));
+
+    reader_tag = scm_make_smob_type ("gnc-qif-reader", 0);
+    scm_set_smob_free (reader_tag, free_reader);
+
+    scm_c_define_gsubr ("gnc-qif-reader-open", 1, 0, 0,
+                        (scm_t_subr) gnc_qif_scm_reader_open);
+    scm_c_define_gsubr ("gnc-qif-reader-next-field", 1, 0, 0,
+                        (scm_t_subr) gnc_qif_scm_reader_next_field);
+    scm_c_define_gsubr ("gnc-qif-reader-close", 1, 0, 0,
+                        (scm_t_subr) gnc_qif_scm_reader_close);
+    scm_c_define_gsubr ("gnc-qif-check-date-format", 2, 0, 0,
+                        (scm_t_subr) gnc_qif_scm_check_date_format);
+    scm_c_define_gsubr ("gnc-qif-check-number-format", 2, 0, 0,
+                        (scm_t_subr) gnc_qif_scm_check_number_format);
+}
@@ -0,0 +1,509 @@
+/********************************************************************\
+ * gnc-qif-reader.cpp - read QIF files into raw records             *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+extern "C" {
+#include <config.h>
+#include <glib/gi18n.h>
+#include "gnc-glib-utils.h"
+}
+
+#include "gnc-qif-reader.hpp"
+
+#include <cstring>
+#include <fstream>
+
+GncQifReader::GncQifReader (const std::string& path)
+{
+    GError *error = nullptr;
+    m_file = g_mapped_file_new (path.c_str(), FALSE, &error);
+    if (!m_file)
+    {
+        std::string msg {error ? error->message : path};
+        g_clear_error (&error);
+        throw std::ifstream::failure (msg);
+    }
+
+    m_begin = g_mapped_file_get_contents (m_file);
+    m_pos = m_begin;
+    m_end = m_begin ? m_begin + g_mapped_file_get_length (m_file) : m_begin;
+
+    /* Skip a UTF-8 byte order mark. */
+    if (m_end - m_pos >= 3 && memcmp (m_pos, "\xEF\xBB\xBF", 3) == 0)
+        m_pos += 3;
+}
+
+GncQifReader::~GncQifReader ()
+{
+    if (m_file)
+        g_mapped_file_unref (m_file);
+}
+
+double
+GncQifReader::progress () const
+{
+    if (m_end == m_begin)
+        return 1.0;
+    return static_cast<double>(m_pos - m_begin) / (m_end - m_begin);
+}
+
+/* Lines end at CR, LF or CRLF. Empty lines are skipped, but still
+ * counted. */
+bool
+GncQifReader::next_line (const char*& start, size_t& len)
+{
+    while (m_pos < m_end)
+    {
+        auto line_start = m_pos;
+        auto p = m_pos;
+        while (p < m_end && *p != '\r' && *p != '\n')
+            ++p;
+        len = p - line_start;
+
+        if (p < m_end && *p == '\r')
+        {
+            ++p;
+            if (p < m_end && *p == '\n')
+                ++p;
+        }
+        else if (p < m_end)
+            ++p;
+
+        m_pos = p;
+        ++m_line_num;
+        if (len > 0)
+        {
+            start = line_start;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Values that aren't valid UTF-8 are converted from the locale's
+ * character set, or stripped of the invalid characters if that fails
+ * too. */
+static void
+fix_utf8 (GncQifField& field, std::vector<std::string>& warnings)
+{
+    auto& value = field.value;
+    field.conversion = QIF_CONVERSION_NONE;
+    if (gnc_utf8_validate (value.c_str(), -1, nullptr))
+        return;
+
+    auto warning = std::string (_("Line")) + " " + std::to_string (field.line_num) + ": ";
+    auto converted = g_locale_to_utf8 (value.c_str(), -1, nullptr, nullptr, nullptr);
+    if (!converted || !*converted || !gnc_utf8_validate (converted, -1, nullptr))
+    {
+        auto stripped = gnc_utf8_strip_invalid_strdup (value.c_str());
+        value = stripped;
+        g_free (stripped);
+        field.conversion = QIF_CONVERSION_STRIPPED;
+        warning += std::string (_("Some characters have been discarded.")) + " ";
+    }
+    else
+    {
+        value = converted;
+        field.conversion = QIF_CONVERSION_LOCALE;
+        warning += std::string (_("Some characters have been converted according to your locale.")) + " ";
+    }
+    g_free (converted);
+    warnings.push_back (warning + _("Converted to: ") + value);
+}
+
+/* See qif-parse:parse-bang-field. */
+static std::string
+parse_bang_field (const std::string& value)
+{
+    auto end = value.find_last_not_of (" \t");
+    auto trimmed = value.substr (0, end == std::string::npos ? 0 : end + 1);
+    auto lower = g_utf8_strdown (trimmed.c_str(), -1);
+    std::string section {lower};
+    g_free (lower);
+
+    /* Some banks write "!type bank" instead of "!Type:bank". */
+    if (section.compare (0, 5, "type ") == 0)
+        section[4] = ':';
+    return section;
+}
+
+bool
+GncQifReader::next_field (GncQifField& field)
+{
+    const char *start;
+    size_t len;
+    if (!next_line (start, len))
+        return false;
+
+    auto tag_end = start + 1;
+    auto tag = g_utf8_get_char_validated (start, len);
+    if (tag == static_cast<gunichar>(-1) || tag == static_cast<gunichar>(-2))
+        field.tag = static_cast<unsigned char>(start[0]);
+    else
+    {
+        field.tag = tag;
+        tag_end = g_utf8_next_char (start);
+    }
+    field.value.assign (tag_end, start + len - tag_end);
+    field.line_num = m_line_num;
+    fix_utf8 (field, m_warnings);
+    return true;
+}
+
+bool
+GncQifReader::next_record (GncQifRecord& record)
+{
+    record.fields.clear();
+    record.is_header = false;
+    record.section = m_section;
+
+    if (m_pending_header)
+    {
+        m_pending_header = false;
+        record.is_header = true;
+        return true;
+    }
+
+    GncQifField field;
+    while (next_field (field))
+    {
+        if (field.tag == '!')
+        {
+            m_section = parse_bang_field (field.value);
+            /* Hand out the fields read so far first if the previous
+             * record wasn't terminated. */
+            if (!record.fields.empty())
+            {
+                m_pending_header = true;
+                return true;
+            }
+            record.section = m_section;
+            record.is_header = true;
+            return true;
+        }
+
+        auto tag = field.tag;
+        record.fields.push_back (std::move (field));
+        if (tag == '^')
+            return true;
+    }
+    return !record.fields.empty();
+}
+
+/* Numbers as read by Scheme: anything too large for a date part
+ * saturates, it will fail the range checks anyway. */
+static long long
+part_value (const std::string& digits)
+{
+    long long value = 0;
+    for (auto c : digits)
+    {
+        value = value * 10 + (c - '0');
+        if (value > 1000000000LL)
+            return value;
+    }
+    return value;
+}
+
+static const char*
+skip_spaces (const char *p)
+{
+    while (*p == ' ')
+        ++p;
+    return p;
+}
+
+static const char*
+take_digits (const char *p, std::string& digits)
+{
+    auto start = p;
+    while (g_ascii_isdigit (*p))
+        ++p;
+    digits.assign (start, p);
+    return p;
+}
+
+/* Split a date written as "n1 sep n2 sep n3" (sep one of -/.') into
+ * its three parts. Otherwise, if it starts with eight digits, return
+ * those in eight. */
+static bool
+split_date (const std::string& date, std::string parts[3], std::string& eight)
+{
+    auto p = skip_spaces (date.c_str());
+    auto start = p;
+    eight.clear();
+
+    for (int i = 0; i < 3; i++)
+    {
+        p = take_digits (p, parts[i]);
+        if (parts[i].empty())
+            break;
+        if (i == 2)
+            return true;
+        p = skip_spaces (p);
+        if (!*p || !strchr ("-/.'", *p))
+            break;
+        p = skip_spaces (p + 1);
+    }
+
+    p = start;
+    for (int i = 0; i < 8; i++)
+        if (!g_ascii_isdigit (p[i]))
+            return false;
+    eight.assign (p, 8);
+    return false;
+}
+
+static unsigned
+check_date_parts (const std::string parts[3], unsigned possible)
+{
+    auto n1 = part_value (parts[0]);
+    auto n2 = part_value (parts[1]);
+    auto n3 = part_value (parts[2]);
+    auto is_date = [](long long d, long long m, long long y, const std::string& ys)
+    {
+        return d >= 1 && d <= 31 && m >= 1 && m <= 12 &&
+            (ys.size() != 4 || y > 1930);
+    };
+
+    unsigned result = 0;
+    if ((possible & QIF_DATE_DMY) && is_date (n1, n2, n3, parts[2]))
+        result |= QIF_DATE_DMY;
+    if ((possible & QIF_DATE_MDY) && is_date (n2, n1, n3, parts[2]))
+        result |= QIF_DATE_MDY;
+    if ((possible & QIF_DATE_YMD) && is_date (n3, n2, n1, parts[0]))
+        result |= QIF_DATE_YMD;
+    if ((possible & QIF_DATE_YDM) && is_date (n2, n3, n1, parts[0]))
+        result |= QIF_DATE_YDM;
+    return result;
+}
+
+/* Split an eight digit date as YYYYxxxx or xxxxYYYY. */
+static void
+split_eight (const std::string& eight, bool year_first, std::string parts[3])
+{
+    if (year_first)
+    {
+        parts[0] = eight.substr (0, 4);
+        parts[1] = eight.substr (4, 2);
+        parts[2] = eight.substr (6, 2);
+    }
+    else
+    {
+        parts[0] = eight.substr (0, 2);
+        parts[1] = eight.substr (2, 2);
+        parts[2] = eight.substr (4, 4);
+    }
+}
+
+unsigned
+gnc_qif_check_date_format (const std::string& date, unsigned possible)
+{
+    std::string parts[3], eight;
+
+    if (split_date (date, parts, eight))
+        return check_date_parts (parts, possible);
+    if (eight.empty())
+        return 0;
+
+    /* We don't know which way to read XXXXXXXX, so try both YYYYxxxx
+     * and xxxxYYYY and let the checks verify the year is valid. */
+    unsigned result = 0;
+    if (possible & (QIF_DATE_YMD | QIF_DATE_YDM))
+    {
+        split_eight (eight, true, parts);
+        result |= check_date_parts (parts, possible);
+    }
+    if (possible & (QIF_DATE_DMY | QIF_DATE_MDY))
+    {
+        split_eight (eight, false, parts);
+        result |= check_date_parts (parts, possible);
+    }
+    return result;
+}
+
+/* See qif-parse:fix-year. */
+static int
+fix_year (long long year, int y2k_threshold)
+{
+    if (year < y2k_threshold)
+        return static_cast<int>(2000 + year);
+    if (year > 19000)
+        return static_cast<int>(1900 + (year - 19000));
+    if (year < 1902)
+        return static_cast<int>(1900 + year);
+    return static_cast<int>(year);
+}
+
+bool
+gnc_qif_parse_date (const std::string& date, GncQifDateFormat fmt,
+                    int& day, int& month, int& year)
+{
+    std::string parts[3], eight;
+
+    if (!split_date (date, parts, eight))
+    {
+        if (eight.empty())
+            return false;
+        split_eight (eight, fmt == QIF_DATE_YMD || fmt == QIF_DATE_YDM, parts);
+    }
+
+    long long d, m, y;
+    auto n1 = part_value (parts[0]);
+    auto n2 = part_value (parts[1]);
+    auto n3 = part_value (parts[2]);
+    switch (fmt)
+    {
+    case QIF_DATE_DMY:
+        d = n1; m = n2; y = n3;
+        break;
+    case QIF_DATE_MDY:
+        d = n2; m = n1; y = n3;
+        break;
+    case QIF_DATE_YMD:
+        d = n3; m = n2; y = n1;
+        break;
+    case QIF_DATE_YDM:
+        d = n2; m = n3; y = n1;
+        break;
+    default:
+        return false;
+    }
+
+    if (d < 1 || d > 31 || m < 1 || m > 12 || y > 1000000000LL)
+        return false;
+    day = d;
+    month = m;
+    year = fix_year (y, 50);
+    return true;
+}
+
+/* Match one of the number regexps of qif-parse.scm:
+ *   ^ *[$]?[+-]?[$]?[0-9]+[+-]?$
+ *   ^ *[$]?[+-]?[$]?[0-9]?[0-9]?[0-9]?([<group>][0-9]{3})*(<radix>[0-9]*)?[+-]? *$
+ *   ^ *[$]?[+-]?[$]?[0-9]+<radix>[0-9]*[+-]? *$
+ * where group is one of the characters in groups.
+ */
+static bool
+match_radix_number (const char *str, const char *groups, char radix)
+{
+    auto p = skip_spaces (str);
+    if (*p == '$') ++p;
+    if (*p == '+' || *p == '-') ++p;
+    if (*p == '$') ++p;
+
+    auto digits = p;
+    while (g_ascii_isdigit (*p))
+        ++p;
+    auto n_digits = p - digits;
+
+    auto at_end = [](const char *q, bool trailing_spaces)
+    {
+        if (*q == '+' || *q == '-') ++q;
+        if (trailing_spaces)
+            q = skip_spaces (q);
+        return *q == '\0';
+    };
+
+    /* Plain digits or digits with a radix. */
+    if (n_digits > 0)
+    {
+        if (at_end (p, false))
+            return true;
+        if (*p == radix)
+        {
+            auto q = p + 1;
+            while (g_ascii_isdigit (*q))
+                ++q;
+            if (at_end (q, true))
+                return true;
+        }
+    }
+
+    /* Up to three digits followed by groups of three. */
+    if (n_digits > 3)
+        return false;
+    while (*p && strchr (groups, *p) && g_ascii_isdigit (p[1]) &&
+           g_ascii_isdigit (p[2]) && g_ascii_isdigit (p[3]))
+        p += 4;
+    if (*p == radix)
+    {
+        ++p;
+        while (g_ascii_isdigit (*p))
+            ++p;
+    }
+    return at_end (p, true);
+}
+
+/* ^[$]?[+-]?[$]?[0-9]+[+-]? *$ */
+static bool
+match_integer (const char *p)
+{
+    if (*p == '$') ++p;
+    if (*p == '+' || *p == '-') ++p;
+    if (*p == '$') ++p;
+    if (!g_ascii_isdigit (*p))
+        return false;
+    while (g_ascii_isdigit (*p))
+        ++p;
+    if (*p == '+' || *p == '-') ++p;
+    return *skip_spaces (p) == '\0';
+}
+
+unsigned
+gnc_qif_check_number_format (const std::string& value, unsigned possible)
+{
+    unsigned result = 0;
+    auto str = value.c_str();
+
+    if ((possible & QIF_NUMBER_DECIMAL) && match_radix_number (str, ",'", '.'))
+        result |= QIF_NUMBER_DECIMAL;
+    if ((possible & QIF_NUMBER_COMMA) && match_radix_number (str, ".'", ','))
+        result |= QIF_NUMBER_COMMA;
+    if ((possible & QIF_NUMBER_INTEGER) && match_integer (str))
+        result |= QIF_NUMBER_INTEGER;
+    return result;
+}
+
+unsigned
+gnc_qif_guess_date_formats (const std::vector<std::string>& dates,
+                            unsigned possible)
+{
+    for (const auto& date : dates)
+    {
+        if (!possible)
+            break;
+        possible = gnc_qif_check_date_format (date, possible);
+    }
+    return possible;
+}
+
+unsigned
+gnc_qif_guess_number_formats (const std::vector<std::string>& values,
+                              unsigned possible)
+{
+    for (const auto& value : values)
+    {
+        if (!possible)
+            break;
+        possible = gnc_qif_check_number_format (value, possible);
+    }
+    return possible;
+}
@@ -0,0 +1,156 @@
+/********************************************************************\
+ * gnc-qif-reader.hpp - read QIF files into raw records             *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, contact:                        *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+\********************************************************************/
+
+/** @file
+     @brief Stream a QIF file into raw records and guess the formats
+     of its date and number fields.
+     *
+     gnc-qif-reader.hpp
+     *
+     The reader does the line level work of qif-file:read-file (BOM,
+     line endings, character set) and the format checks of
+     qif-parse.scm without any regular expression, so large files can
+     be scanned in one pass over a memory mapped buffer. The Scheme
+     code calls it through the functions of gnc-qif-reader-guile.cpp.
+ */
+
+#ifndef GNC_QIF_READER_HPP
+#define GNC_QIF_READER_HPP
+
+extern "C" {
+#include <glib.h>
+}
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Date formats a QIF date field can be in, as a bit mask. */
+enum GncQifDateFormat : unsigned
+{
+    QIF_DATE_MDY = 1 << 0,
+    QIF_DATE_DMY = 1 << 1,
+    QIF_DATE_YMD = 1 << 2,
+    QIF_DATE_YDM = 1 << 3,
+    QIF_DATE_ANY = QIF_DATE_MDY | QIF_DATE_DMY | QIF_DATE_YMD | QIF_DATE_YDM
+};
+
+/** Number formats a QIF amount field can be in, as a bit mask. */
+enum GncQifNumberFormat : unsigned
+{
+    QIF_NUMBER_DECIMAL = 1 << 0,  // 1,500.00 or 2'000.00
+    QIF_NUMBER_COMMA   = 1 << 1,  // 5.000,00 or 4'500,00
+    QIF_NUMBER_INTEGER = 1 << 2,  // 456
+    QIF_NUMBER_ANY = QIF_NUMBER_DECIMAL | QIF_NUMBER_COMMA | QIF_NUMBER_INTEGER
+};
+
+/** What was done to a value that wasn't valid UTF-8. */
+enum GncQifConversion
+{
+    QIF_CONVERSION_NONE,
+    QIF_CONVERSION_LOCALE,      // converted from the locale's character set
+    QIF_CONVERSION_STRIPPED     // invalid characters dropped
+};
+
+/** One line of a record: the tag character and the rest of the line.
+ *  A tag that isn't ASCII is the first UTF-8 character of the line, or
+ *  its first byte read as Latin-1 if the line doesn't start with one. */
+struct GncQifField
+{
+    gunichar tag;
+    std::string value;
+    uint32_t line_num;
+    GncQifConversion conversion = QIF_CONVERSION_NONE;
+};
+
+/** The fields up to and including the '^' ending a record. A '!' line
+ *  is returned as a record of its own with is_header set; section then
+ *  holds the new section name as qif-parse:parse-bang-field builds it,
+ *  e.g. "type:bank" or "option:autoswitch".
+ */
+struct GncQifRecord
+{
+    std::string section;
+    bool is_header = false;
+    std::vector<GncQifField> fields;
+};
+
+class GncQifReader
+{
+public:
+    /** Map the file at path. Throws std::ifstream::failure if the file
+     *  can't be read. */
+    explicit GncQifReader (const std::string& path);
+    ~GncQifReader ();
+    GncQifReader (const GncQifReader&) = delete;
+    GncQifReader& operator= (const GncQifReader&) = delete;
+
+    /** Fill record with the next record of the file. Returns false at
+     *  the end of the file. */
+    bool next_record (GncQifRecord& record);
+
+    /** Fill field with the next non-empty line of the file, '!' lines
+     *  included and left as they are. This is what
+     *  qif-file:read-file reads. Don't mix it with next_record. Returns
+     *  false at the end of the file. */
+    bool next_field (GncQifField& field);
+
+    /** Fraction of the file read so far, for progress reporting. */
+    double progress () const;
+
+    /** Warnings about lines that weren't valid UTF-8. */
+    const std::vector<std::string>& warnings () const { return m_warnings; }
+
+private:
+    bool next_line (const char*& start, size_t& len);
+
+    GMappedFile *m_file = nullptr;
+    const char *m_pos = nullptr;
+    const char *m_end = nullptr;
+    const char *m_begin = nullptr;
+    uint32_t m_line_num = 0;
+    std::string m_section;
+    bool m_pending_header = false;
+    std::vector<std::string> m_warnings;
+};
+
+/** Return the formats among possible that date could be written in,
+ *  following qif-parse:check-date-format. */
+unsigned gnc_qif_check_date_format (const std::string& date, unsigned possible);
+
+/** Return the formats among possible that value could be written in,
+ *  following qif-parse:check-number-format. */
+unsigned gnc_qif_check_number_format (const std::string& value, unsigned possible);
+
+/** Narrow possible down to the formats that fit every one of the
+ *  values, stopping early once none is left. */
+unsigned gnc_qif_guess_date_formats (const std::vector<std::string>& dates,
+                                     unsigned possible = QIF_DATE_ANY);
+unsigned gnc_qif_guess_number_formats (const std::vector<std::string>& values,
+                                       unsigned possible = QIF_NUMBER_ANY);
+
+/** Split date according to the single format fmt into day, month and
+ *  year, fixing up the year like qif-parse:fix-year. Returns false if
+ *  the date can't be read in that format. */
+bool gnc_qif_parse_date (const std::string& date, GncQifDateFormat fmt,
+                         int& day, int& month, int& year);
+
+#endif
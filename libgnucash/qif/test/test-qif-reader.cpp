@@ -0,0 +1,249 @@
+/********************************************************************
+ * test-qif-reader.cpp: test suite for the QIF reader and its       *
+ *                      format guessing functions.                  *
+ *                                                                  *
+ * This program is free software; you can redistribute it and/or    *
+ * modify it under the terms of the GNU General Public License as   *
+ * published by the Free Software Foundation; either version 2 of   *
+ * the License, or (at your option) any later version.              *
+ *                                                                  *
+ * This program is distributed in the hope that it will be useful,  *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of   *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the    *
+ * GNU General Public License for more details.                     *
+ *                                                                  *
+ * You should have received a copy of the GNU General Public License*
+ * along with this program; if not, you can retrieve it from        *
+ * https://www.gnu.org/licenses/old-licenses/gpl-2.0.html            *
+ * or contact:                                                      *
+ *                                                                  *
+ * Free Software Foundation           Voice:  +1-617-542-5942       *
+ * 51 Franklin Street, Fifth Floor    Fax:    +1-617-542-2652       *
+ * Boston, MA  02110-1301,  USA       gnu@gnu.org                   *
+ ********************************************************************/
+
+#include "../gnc-qif-reader.hpp"
+#include <gtest/gtest.h>
+#include <glib/gstdio.h>
+
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+typedef struct
+{
+    const char *value;
+    unsigned formats;
+} format_test_data;
+
+TEST (GncQifReader, check_date_format)
+{
+    static const format_test_data dates[] =
+    {
+        { "12/31/1999", QIF_DATE_MDY },
+        { "31/12/1999", QIF_DATE_DMY },
+        { "1999-12-31", QIF_DATE_YMD },
+        { "20011201", QIF_DATE_YMD | QIF_DATE_YDM },
+        { "12312001", QIF_DATE_MDY },
+        { " 1/ 2'03", QIF_DATE_ANY },
+        { "01.02.2003", QIF_DATE_MDY | QIF_DATE_DMY },
+        { "1/2/1930", 0 },
+        { "", 0 },
+        { "abc", 0 },
+    };
+
+    for (const auto& data : dates)
+        EXPECT_EQ (data.formats,
+                   gnc_qif_check_date_format (data.value, QIF_DATE_ANY))
+            << "date " << data.value;
+
+    EXPECT_EQ (QIF_DATE_MDY,
+               gnc_qif_check_date_format ("05/06/07", QIF_DATE_MDY));
+}
+
+TEST (GncQifReader, check_number_format)
+{
+    static const format_test_data numbers[] =
+    {
+        { "1,500.00", QIF_NUMBER_DECIMAL },
+        { "2'000.00", QIF_NUMBER_DECIMAL },
+        { "5.000,00", QIF_NUMBER_COMMA },
+        { "456", QIF_NUMBER_ANY },
+        { "12-", QIF_NUMBER_ANY },
+        { "$-12.50", QIF_NUMBER_DECIMAL },
+        { ".50", QIF_NUMBER_DECIMAL },
+        { "1234,5", QIF_NUMBER_COMMA },
+        { "1,234", QIF_NUMBER_DECIMAL | QIF_NUMBER_COMMA },
+        { " 12 ", QIF_NUMBER_DECIMAL | QIF_NUMBER_COMMA },
+        { "1234 ", QIF_NUMBER_INTEGER },
+        { "12,34,567", 0 },
+    };
+
+    for (const auto& data : numbers)
+        EXPECT_EQ (data.formats,
+                   gnc_qif_check_number_format (data.value, QIF_NUMBER_ANY))
+            << "number " << data.value;
+}
+
+TEST (GncQifReader, guess_formats)
+{
+    EXPECT_EQ (QIF_DATE_DMY,
+               gnc_qif_guess_date_formats ({ "01/02/2003", "13/02/2003" }));
+    EXPECT_EQ (0u, gnc_qif_guess_date_formats ({ "13/02/2003", "02/13/2003",
+                                                 "01/01/2003" }));
+    EXPECT_EQ (QIF_NUMBER_COMMA,
+               gnc_qif_guess_number_formats ({ "12", "1.234", "1,5" }));
+}
+
+TEST (GncQifReader, parse_date)
+{
+    int day, month, year;
+
+    ASSERT_TRUE (gnc_qif_parse_date ("1/2/03", QIF_DATE_DMY, day, month, year));
+    EXPECT_EQ (1, day);
+    EXPECT_EQ (2, month);
+    EXPECT_EQ (2003, year);
+
+    ASSERT_TRUE (gnc_qif_parse_date ("12012001", QIF_DATE_MDY, day, month, year));
+    EXPECT_EQ (1, day);
+    EXPECT_EQ (12, month);
+    EXPECT_EQ (2001, year);
+
+    ASSERT_TRUE (gnc_qif_parse_date ("99.1.2", QIF_DATE_YMD, day, month, year));
+    EXPECT_EQ (2, day);
+    EXPECT_EQ (1, month);
+    EXPECT_EQ (1999, year);
+
+    EXPECT_FALSE (gnc_qif_parse_date ("13/13/03", QIF_DATE_MDY, day, month, year));
+}
+
+TEST (GncQifReader, read_records)
+{
+    static const char contents[] =
+        "\xef\xbb\xbf!Type:Bank \r\n"
+        "D1/2/03\r\n"
+        "T-1.00\r\n"
+        "^\r\n"
+        "\n"
+        "D1/3/03\r"
+        "T2\r"
+        "!Type:Cat\n"
+        "Nfoo\n"
+        "^\n";
+
+    gchar *path = nullptr;
+    auto fd = g_file_open_tmp ("test-qif-reader-XXXXXX.qif", &path, nullptr);
+    ASSERT_NE (-1, fd);
+    close (fd);
+    ASSERT_TRUE (g_file_set_contents (path, contents, sizeof (contents) - 1,
+                                      nullptr));
+
+    {
+        GncQifReader reader (path);
+        GncQifRecord record;
+
+        ASSERT_TRUE (reader.next_record (record));
+        EXPECT_TRUE (record.is_header);
+        EXPECT_EQ ("type:bank", record.section);
+
+        ASSERT_TRUE (reader.next_record (record));
+        EXPECT_FALSE (record.is_header);
+        ASSERT_EQ (3u, record.fields.size());
+        EXPECT_EQ (U'D', record.fields[0].tag);
+        EXPECT_EQ ("1/2/03", record.fields[0].value);
+        EXPECT_EQ (2u, record.fields[0].line_num);
+        EXPECT_EQ (U'T', record.fields[1].tag);
+        EXPECT_EQ ("-1.00", record.fields[1].value);
+        EXPECT_EQ (U'^', record.fields[2].tag);
+
+        /* A record cut short by a new section still comes out. */
+        ASSERT_TRUE (reader.next_record (record));
+        EXPECT_EQ ("type:bank", record.section);
+        ASSERT_EQ (2u, record.fields.size());
+        EXPECT_EQ (6u, record.fields[0].line_num);
+        EXPECT_EQ ("2", record.fields[1].value);
+
+        ASSERT_TRUE (reader.next_record (record));
+        EXPECT_TRUE (record.is_header);
+        EXPECT_EQ ("type:cat", record.section);
+
+        ASSERT_TRUE (reader.next_record (record));
+        EXPECT_EQ ("type:cat", record.section);
+        ASSERT_EQ (2u, record.fields.size());
+        EXPECT_EQ ("foo", record.fields[0].value);
+
+        EXPECT_FALSE (reader.next_record (record));
+        EXPECT_DOUBLE_EQ (1.0, reader.progress());
+        EXPECT_TRUE (reader.warnings().empty());
+    }
+
+    g_unlink (path);
+    g_free (path);
+}
+
+TEST (GncQifReader, read_fields)
+{
+    static const char contents[] =
+        "!Type:Bank\n"
+        "D1/2/03\r\n"
+        "\r\n"
+        "PCaf\xe9\n"
+        "\xc3\xa9t\xc3\xa9\n"
+        "\xe9x\n"
+        "^";
+
+    gchar *path = nullptr;
+    auto fd = g_file_open_tmp ("test-qif-reader-XXXXXX.qif", &path, nullptr);
+    ASSERT_NE (-1, fd);
+    close (fd);
+    ASSERT_TRUE (g_file_set_contents (path, contents, sizeof (contents) - 1,
+                                      nullptr));
+
+    {
+        GncQifReader reader {path};
+        GncQifField field;
+
+        /* '!' lines come out as they are. */
+        ASSERT_TRUE (reader.next_field (field));
+        EXPECT_EQ (U'!', field.tag);
+        EXPECT_EQ ("Type:Bank", field.value);
+        EXPECT_EQ (1u, field.line_num);
+        EXPECT_EQ (QIF_CONVERSION_NONE, field.conversion);
+
+        ASSERT_TRUE (reader.next_field (field));
+        EXPECT_EQ (U'D', field.tag);
+        EXPECT_EQ ("1/2/03", field.value);
+
+        /* The empty line is skipped but counted. */
+        ASSERT_TRUE (reader.next_field (field));
+        EXPECT_EQ (U'P', field.tag);
+        EXPECT_EQ (4u, field.line_num);
+        EXPECT_NE (QIF_CONVERSION_NONE, field.conversion);
+        EXPECT_TRUE (g_utf8_validate (field.value.c_str(), -1, nullptr));
+        EXPECT_EQ (1u, reader.warnings().size());
+
+        /* A tag that isn't ASCII is a whole UTF-8 character, */
+        ASSERT_TRUE (reader.next_field (field));
+        EXPECT_EQ (U'\u00e9', field.tag);
+        EXPECT_EQ ("t\xc3\xa9", field.value);
+        EXPECT_EQ (QIF_CONVERSION_NONE, field.conversion);
+
+        /* or a Latin-1 one if the line isn't UTF-8. */
+        ASSERT_TRUE (reader.next_field (field));
+        EXPECT_EQ (U'\u00e9', field.tag);
+        EXPECT_EQ ("x", field.value);
+
+        ASSERT_TRUE (reader.next_field (field));
+        EXPECT_EQ (U'^', field.tag);
+        EXPECT_EQ ("", field.value);
+        EXPECT_FALSE (reader.next_field (field));
+    }
+
+    g_unlink (path);
+    g_free (path);
+}
+
+TEST (GncQifReader, missing_file)
+{
+    EXPECT_THROW (GncQifReader ("/nonexistent/file.qif"), std::ifstream::failure);
+}